@@ -0,0 +1,150 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the parts of the Arduino and pico SDK API the
+ * application uses.
+ *
+ * Only compiled by the native environments. Time comes from the steady clock,
+ * Serial1 writes to stdout, and get_core_num() returns the core a thread was
+ * assigned with set_core_num(): the thread running setup()/loop() and the
+ * ctx0 event loop count as core 0, the thread standing in for core 1 and
+ * the ctx1 event loop as core 1. With E5_HOST_SIM, time and the current
+ * core come from the Simulator instead.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#define PICO_OK 0
+#define PICO_ERROR_TIMEOUT -1
+#define PICO_ERROR_GENERIC -2
+#define PICO_ERROR_NO_DATA -3
+#define PICO_ERROR_INVALID_ARG -5
+
+#ifdef E5_HOST_DEBUG
+#define DEBUGCORE(...) std::fprintf(stderr, __VA_ARGS__)
+#define DEBUGWIRE(...) std::fprintf(stderr, __VA_ARGS__)
+#define DEBUGV(...) std::fprintf(stderr, __VA_ARGS__)
+#else
+#define DEBUGCORE(...) do { } while (0)
+#define DEBUGWIRE(...) do { } while (0)
+#define DEBUGV(...) do { } while (0)
+#endif
+
+#define LED_BUILTIN 25
+#define HIGH 1
+#define LOW 0
+#define OUTPUT 1
+
+uint64_t time_us_64();
+uint32_t time_us_32();
+unsigned get_core_num();
+void set_core_num(unsigned core); ///< Host only
+/// Non-zero on a context's thread, as in a worker IRQ on the device
+unsigned __get_current_exception();
+void set_current_exception(unsigned exception); ///< Host only
+void tight_loop_contents();
+[[noreturn]] void panic_compact(const char *message);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+float analogReadTemp();
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+class String {
+        std::string m_text;
+
+    public:
+        String() = default;
+        String(std::string text) : m_text(std::move(text)) {}
+        [[nodiscard]] const char *c_str() const { return m_text.c_str(); }
+};
+
+/**
+ * @brief IPv4 address, stored in network byte order like lwIP's ip4_addr.
+ */
+class IPAddress {
+        uint32_t m_address = 0;
+
+    public:
+        IPAddress() = default;
+        IPAddress(const uint8_t a, const uint8_t b, const uint8_t c,
+                  const uint8_t d)
+            : m_address(a | b << 8 | c << 16 | static_cast<uint32_t>(d) << 24) {
+        }
+        IPAddress(const uint32_t address) : m_address(address) {}
+
+        IPAddress &operator=(const uint32_t address) {
+            m_address = address;
+            return *this;
+        }
+        operator uint32_t() const { return m_address; }
+        [[nodiscard]] uint32_t v4() const { return m_address; }
+        [[nodiscard]] bool isSet() const { return m_address != 0; }
+        [[nodiscard]] String toString() const;
+        bool fromString(const char *text);
+};
+
+class SerialPort {
+    public:
+        using Sink = void (*)(const char *data, size_t size, void *arg);
+
+    private:
+        std::FILE *m_out;
+        Sink m_sink = nullptr;
+        void *m_sink_arg = nullptr;
+
+        size_t output(const char *data, size_t size);
+
+    public:
+        explicit SerialPort(std::FILE *out) : m_out(out) {}
+
+        /**
+         * @brief Sends all output to @p sink instead; host only.
+         */
+        void setSink(const Sink sink, void *arg) {
+            m_sink = sink;
+            m_sink_arg = arg;
+        }
+
+        void begin(unsigned long = 0) {}
+        explicit operator bool() const { return true; }
+        size_t print(const char *text);
+        size_t print(unsigned value);
+        size_t printf(const char *format, ...);
+        size_t write(const uint8_t *data, size_t size);
+        int available() { return 0; }
+        int read() { return -1; }
+        void flush();
+};
+
+extern SerialPort Serial;  ///< stderr
+extern SerialPort Serial1; ///< stdout, the application's output
+
+class RP2040 {
+    public:
+        static void enableDoubleResetBootloader() {}
+        int getFreeHeap() { return 0; }
+        int getUsedHeap() { return 0; }
+        int getTotalHeap() { return 0; }
+        int getFreeStack() { return 0; }
+        int cpuid() { return static_cast<int>(get_core_num()); }
+        uint32_t getCycleCount(); ///< Nanoseconds, truncated
+        int f_cpu() { return 1000000000; } ///< A cycle is a nanosecond
+        [[noreturn]] void reboot();
+};
+
+extern RP2040 rp2040;
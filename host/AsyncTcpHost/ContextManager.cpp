@@ -0,0 +1,44 @@
+/**
+ * @file ContextManager.cpp
+ * @brief Backend-independent part of the host ContextManager, and the
+ * EventBridge and SyncBridge scheduling it provides.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#include "ContextManager.hpp"
+#include "EventBridge.hpp"
+#include "SyncBridge.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace async_tcp {
+
+    ContextManager::~ContextManager() { stop(); }
+
+    void ContextManager::cancel(EventBridge &bridge) const {
+        std::lock_guard lock(m_queue_mutex);
+        if (!bridge.m_queued) {
+            return;
+        }
+        bridge.m_queued = false;
+        m_ready.erase(std::remove(m_ready.begin(), m_ready.end(), &bridge),
+                      m_ready.end());
+        for (auto it = m_timers.begin(); it != m_timers.end();) {
+            it = it->second == &bridge ? m_timers.erase(it) : std::next(it);
+        }
+    }
+
+    void EventBridge::schedule(const uint32_t delay_us) const {
+        m_ctx.schedule(const_cast<EventBridge &>(*this), delay_us);
+    }
+
+    EventBridge::~EventBridge() { m_ctx.cancel(*this); }
+
+    uint32_t SyncBridge::execute(SyncPayloadPtr payload) {
+        return m_ctx.execute(*this, std::move(payload));
+    }
+
+} // namespace async_tcp
@@ -0,0 +1,117 @@
+/**
+ * @file ContextManager.hpp
+ * @brief Host implementation of the async-tcp ContextManager.
+ *
+ * On the device a ContextManager wraps an async_context_threadsafe_background
+ * running on the core that initialised it. On the host it is an event-loop
+ * thread that inherits the core number of the initialising thread, runs
+ * queued and timed bridges with the context lock held, and polls the
+ * non-blocking sockets of the TcpClients attached to it.
+ *
+ * With E5_HOST_SIM there is no thread: the Simulator runs the context's
+ * due bridges as events on the context's virtual core, and a SyncBridge
+ * call from the other core is charged the configured cross-core latency.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct async_context_threadsafe_background_config_t {
+        void *custom_alarm_pool = nullptr; ///< Unused on the host
+};
+
+inline async_context_threadsafe_background_config_t
+async_context_threadsafe_background_default_config() {
+    return {};
+}
+
+namespace async_tcp {
+
+    class EventBridge;
+    class SyncBridge;
+    class TcpClient;
+    struct SyncPayload;
+
+    class ContextManager {
+            friend class EventBridge;
+            friend class SyncBridge;
+            friend class TcpClient;
+            friend class Simulator;
+
+            struct SyncCall {
+                    SyncBridge *bridge;
+                    std::unique_ptr<SyncPayload> payload;
+                    uint32_t result = 0;
+                    bool done = false;
+            };
+
+            mutable std::recursive_mutex m_lock; ///< The context lock
+            mutable std::mutex m_queue_mutex;    ///< Guards the queues below
+            mutable std::condition_variable m_sync_done;
+            mutable std::deque<EventBridge *> m_ready;
+            mutable std::multimap<uint64_t, EventBridge *> m_timers;
+            mutable std::deque<SyncCall *> m_sync_calls;
+            mutable std::vector<TcpClient *> m_clients;
+
+            int m_wake_pipe[2] = {-1, -1};
+            std::thread m_thread;
+            std::atomic<bool> m_running{false};
+            uint8_t m_core = 0;
+
+            void loop();
+            void wake() const;
+            void schedule(EventBridge &bridge, uint32_t delay_us) const;
+            void cancel(EventBridge &bridge) const;
+            uint32_t execute(SyncBridge &bridge,
+                             std::unique_ptr<SyncPayload> payload) const;
+            void attach(TcpClient &client) const;
+            void detach(TcpClient &client) const;
+            void runDue(); ///< Simulator backend: runs the due bridges
+
+        public:
+            ContextManager() = default;
+            ContextManager(const ContextManager &) = delete;
+            ContextManager &operator=(const ContextManager &) = delete;
+            ~ContextManager();
+
+            /**
+             * @brief Starts the event loop on the calling thread's core.
+             */
+            bool initDefaultContext(
+                async_context_threadsafe_background_config_t &config);
+
+            /**
+             * @brief Stops the event loop; host only.
+             */
+            void stop();
+
+            /**
+             * @brief CPU time the event loop has used, in us; host only.
+             *
+             * Read from the loop thread's CPU clock, so it counts worker
+             * time and socket polling but not the time the thread sleeps.
+             * Zero with E5_HOST_SIM, which has no thread per context.
+             */
+            [[nodiscard]] uint64_t cpuUs();
+
+            [[nodiscard]] uint8_t getCore() const { return m_core; }
+            void acquireLock() const { m_lock.lock(); }
+            void releaseLock() const { m_lock.unlock(); }
+    };
+
+    using AsyncCtx = ContextManager;
+
+} // namespace async_tcp
@@ -0,0 +1,40 @@
+/**
+ * @file EphemeralBridge.hpp
+ * @brief Host implementation of the async-tcp EphemeralBridge.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "EventBridge.hpp"
+#include <memory>
+
+namespace async_tcp {
+
+    /**
+     * @class EphemeralBridge
+     * @brief One-shot bridge that owns itself and is freed after it runs.
+     */
+    class EphemeralBridge : public EventBridge {
+            std::unique_ptr<EphemeralBridge> m_self;
+
+        protected:
+            void afterWork() override { m_self.reset(); }
+
+        public:
+            explicit EphemeralBridge(const AsyncCtx &ctx) : EventBridge(ctx) {}
+
+            void takeOwnership(std::unique_ptr<EphemeralBridge> self) {
+                m_self = std::move(self);
+            }
+
+            /**
+             * @brief Runs the bridge once, @p run_in_ms from now.
+             */
+            void run(const uint32_t run_in_ms) { schedule(run_in_ms * 1000); }
+    };
+
+} // namespace async_tcp
@@ -0,0 +1,57 @@
+/**
+ * @file EventBridge.hpp
+ * @brief Host implementation of the async-tcp EventBridge base class.
+ *
+ * A bridge is a worker of one ContextManager: run() queues it and the
+ * context's event loop calls onWork() with the context lock held. Queuing a
+ * bridge that is already queued is a no-op, like a pending async_context
+ * worker.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ContextManager.hpp"
+#include <cstdint>
+
+namespace async_tcp {
+
+    class EventBridge {
+            friend class ContextManager;
+            friend class TcpClient;
+            bool m_queued = false; ///< Guarded by the context's queue mutex
+
+        protected:
+            const AsyncCtx &m_ctx;
+
+            virtual void onWork() = 0;
+
+            /**
+             * @brief Called by the event loop after onWork(); one-shot
+             * bridges free themselves here.
+             */
+            virtual void afterWork() {}
+
+            /**
+             * @brief Queues onWork() to run after @p delay_us.
+             */
+            void schedule(uint32_t delay_us) const;
+
+        public:
+            explicit EventBridge(const AsyncCtx &ctx) : m_ctx(ctx) {}
+            EventBridge(const EventBridge &) = delete;
+            EventBridge &operator=(const EventBridge &) = delete;
+            virtual ~EventBridge();
+
+            virtual void initialiseBridge() {}
+
+            /**
+             * @brief Takes the event payload before the bridge is run.
+             */
+            virtual void workload(void *) {}
+    };
+
+} // namespace async_tcp
@@ -0,0 +1,163 @@
+/**
+ * @file HostPlatform.cpp
+ * @brief Host implementation of the Arduino and pico SDK stand-ins.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#include "Arduino.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdarg>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace {
+
+    const auto start = std::chrono::steady_clock::now();
+    std::mutex random_mutex;
+    std::minstd_rand random_engine;
+
+} // namespace
+
+SerialPort Serial(stderr);
+SerialPort Serial1(stdout);
+RP2040 rp2040;
+
+#ifndef E5_HOST_SIM
+namespace {
+
+    thread_local unsigned core_num = 0;
+    thread_local unsigned current_exception = 0;
+
+} // namespace
+
+uint64_t time_us_64() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+}
+
+uint32_t time_us_32() { return static_cast<uint32_t>(time_us_64()); }
+
+unsigned get_core_num() { return core_num; }
+
+void set_core_num(const unsigned core) { core_num = core; }
+
+unsigned __get_current_exception() { return current_exception; }
+
+void set_current_exception(const unsigned exception) {
+    current_exception = exception;
+}
+
+void tight_loop_contents() { std::this_thread::yield(); }
+
+void delay(const unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(const unsigned int us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+#endif // E5_HOST_SIM
+
+void panic_compact(const char *message) {
+    std::fprintf(stderr, "panic: %s", message);
+    std::abort();
+}
+
+unsigned long millis() { return static_cast<unsigned long>(time_us_64() / 1000); }
+
+unsigned long micros() { return time_us_32(); }
+
+void pinMode(int, int) {}
+
+void digitalWrite(int, int) {}
+
+float analogReadTemp() { return 25.0f; }
+
+long random(const long max) { return max > 0 ? random(0, max) : 0; }
+
+long random(const long min, const long max) {
+    if (max <= min) {
+        return min;
+    }
+    std::lock_guard lock(random_mutex);
+    return std::uniform_int_distribution<long>(min, max - 1)(random_engine);
+}
+
+void randomSeed(const unsigned long seed) {
+    std::lock_guard lock(random_mutex);
+    random_engine.seed(static_cast<std::minstd_rand::result_type>(seed));
+}
+
+String IPAddress::toString() const {
+    char text[INET_ADDRSTRLEN] = {};
+    in_addr address{};
+    address.s_addr = m_address;
+    inet_ntop(AF_INET, &address, text, sizeof(text));
+    return String(text);
+}
+
+bool IPAddress::fromString(const char *text) {
+    in_addr address{};
+    if (inet_pton(AF_INET, text, &address) != 1) {
+        return false;
+    }
+    m_address = address.s_addr;
+    return true;
+}
+
+size_t SerialPort::output(const char *data, const size_t size) {
+    if (m_sink) {
+        m_sink(data, size, m_sink_arg);
+        return size;
+    }
+    return std::fwrite(data, 1, size, m_out);
+}
+
+size_t SerialPort::print(const char *text) {
+    return output(text, std::char_traits<char>::length(text));
+}
+
+size_t SerialPort::print(const unsigned value) {
+    return printf("%u", value);
+}
+
+size_t SerialPort::printf(const char *format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    const int length = std::vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length <= 0) {
+        return 0;
+    }
+    return output(text, std::min(static_cast<size_t>(length), sizeof(text) - 1));
+}
+
+size_t SerialPort::write(const uint8_t *data, const size_t size) {
+    return output(reinterpret_cast<const char *>(data), size);
+}
+
+void SerialPort::flush() { std::fflush(m_out); }
+
+#ifndef E5_HOST_SIM
+uint32_t RP2040::getCycleCount() {
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+}
+#endif // E5_HOST_SIM
+
+void RP2040::reboot() {
+    std::fflush(stdout);
+    std::exit(EXIT_FAILURE);
+}
@@ -0,0 +1,35 @@
+/**
+ * @file IoRxBuffer.cpp
+ * @brief Host implementation of the async-tcp receive buffer.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#include "IoRxBuffer.hpp"
+#include <algorithm>
+
+namespace async_tcp {
+
+    void IoRxBuffer::peekConsume(std::size_t size) {
+        while (size > 0 && !m_chunks.empty()) {
+            const std::size_t take = std::min(size, peekAvailable());
+            m_offset += take;
+            size -= take;
+            if (m_offset == m_chunks.front().size()) {
+                m_chunks.pop_front();
+                m_offset = 0;
+            }
+        }
+    }
+
+    std::size_t IoRxBuffer::size() const {
+        std::size_t total = 0;
+        for (const auto &chunk : m_chunks) {
+            total += chunk.size();
+        }
+        return total - m_offset;
+    }
+
+} // namespace async_tcp
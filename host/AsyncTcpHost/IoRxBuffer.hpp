@@ -0,0 +1,53 @@
+/**
+ * @file IoRxBuffer.hpp
+ * @brief Host implementation of the async-tcp receive buffer.
+ *
+ * Each socket read becomes one chunk, standing in for a pbuf: peekBuffer()
+ * and peekAvailable() describe the contiguous rest of the first chunk, as
+ * on the device.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <string>
+
+namespace async_tcp {
+
+    class IoRxBuffer {
+            std::deque<std::string> m_chunks;
+            std::size_t m_offset = 0; ///< Consumed bytes of the first chunk
+
+        public:
+            [[nodiscard]] std::size_t peekAvailable() const {
+                return m_chunks.empty() ? 0 : m_chunks.front().size() - m_offset;
+            }
+
+            [[nodiscard]] const char *peekBuffer() const {
+                return m_chunks.empty() ? nullptr
+                                        : m_chunks.front().data() + m_offset;
+            }
+
+            void peekConsume(std::size_t size);
+
+            void reset() {
+                m_chunks.clear();
+                m_offset = 0;
+            }
+
+            /**
+             * @brief Appends a received chunk; host only.
+             */
+            void append(const char *data, std::size_t size) {
+                m_chunks.emplace_back(data, size);
+            }
+
+            [[nodiscard]] std::size_t size() const;
+    };
+
+} // namespace async_tcp
@@ -0,0 +1,14 @@
+/**
+ * @file LwipHost.cpp
+ * @brief The lwIP PCB lists for the host build; there is no lwIP, so they
+ * stay empty and a PCB census counts nothing.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#include "lwip/priv/tcp_priv.h"
+
+struct tcp_pcb *tcp_active_pcbs = nullptr;
+struct tcp_pcb *tcp_tw_pcbs = nullptr;
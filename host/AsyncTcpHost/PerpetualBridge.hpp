@@ -0,0 +1,27 @@
+/**
+ * @file PerpetualBridge.hpp
+ * @brief Host implementation of the async-tcp PerpetualBridge.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "EventBridge.hpp"
+
+namespace async_tcp {
+
+    /**
+     * @class PerpetualBridge
+     * @brief Bridge that lives as long as its owner and may run many times.
+     */
+    class PerpetualBridge : public EventBridge {
+        public:
+            explicit PerpetualBridge(const AsyncCtx &ctx) : EventBridge(ctx) {}
+
+            void run() { schedule(0); }
+    };
+
+} // namespace async_tcp
@@ -0,0 +1,252 @@
+/**
+ * @file PosixContextManager.cpp
+ * @brief Event-loop thread backend of the host ContextManager.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#ifndef E5_HOST_SIM
+
+#include "ContextManager.hpp"
+#include "Arduino.h"
+#include "EventBridge.hpp"
+#include "SyncBridge.hpp"
+#include "TcpClient.hpp"
+#include <algorithm>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace async_tcp {
+
+    namespace {
+
+        /// Upper bound on a poll() wait, so timers and stop() stay prompt
+        constexpr int MAX_WAIT_MS = 10;
+
+        /// Workers run in user IRQ 31 on the device, the first the SDK picks
+        constexpr unsigned WORKER_EXCEPTION = 16 + 31;
+
+        /// Contexts on one core share an IRQ priority on the device, so
+        /// their workers never interleave; held while a pass runs them
+        std::mutex core_workers[2];
+
+    } // namespace
+
+    bool ContextManager::initDefaultContext(
+        async_context_threadsafe_background_config_t &) {
+        if (m_running) {
+            return false;
+        }
+        if (pipe(m_wake_pipe) != 0) {
+            return false;
+        }
+        for (const int fd : m_wake_pipe) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+        m_core = static_cast<uint8_t>(get_core_num());
+        m_running = true;
+        m_thread = std::thread([this] {
+            set_core_num(m_core);
+            set_current_exception(WORKER_EXCEPTION);
+            loop();
+        });
+        return true;
+    }
+
+    void ContextManager::stop() {
+        if (!m_running.exchange(false)) {
+            return;
+        }
+        wake();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+        for (int &fd : m_wake_pipe) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    uint64_t ContextManager::cpuUs() {
+        clockid_t clock;
+        timespec used{};
+        // Once stopped the thread is gone; its time is not kept
+        if (!m_running ||
+            pthread_getcpuclockid(m_thread.native_handle(), &clock) != 0 ||
+            clock_gettime(clock, &used) != 0) {
+            return 0;
+        }
+        return static_cast<uint64_t>(used.tv_sec) * 1000000u +
+               static_cast<uint64_t>(used.tv_nsec) / 1000u;
+    }
+
+    void ContextManager::wake() const {
+        constexpr char byte = 0;
+        // A full pipe already guarantees a wake-up
+        (void) !write(m_wake_pipe[1], &byte, 1);
+    }
+
+    void ContextManager::schedule(EventBridge &bridge,
+                                  const uint32_t delay_us) const {
+        {
+            std::lock_guard lock(m_queue_mutex);
+            if (bridge.m_queued) {
+                return;
+            }
+            bridge.m_queued = true;
+            if (delay_us == 0) {
+                m_ready.push_back(&bridge);
+            } else {
+                m_timers.emplace(time_us_64() + delay_us, &bridge);
+            }
+        }
+        wake();
+    }
+
+    uint32_t ContextManager::execute(SyncBridge &bridge,
+                                     std::unique_ptr<SyncPayload> payload) const {
+        if (get_core_num() == m_core) {
+            std::lock_guard lock(m_lock);
+            return bridge.onExecute(std::move(payload));
+        }
+        SyncCall call{&bridge, std::move(payload)};
+        std::unique_lock lock(m_queue_mutex);
+        m_sync_calls.push_back(&call);
+        wake();
+        m_sync_done.wait(lock, [&call] { return call.done; });
+        return call.result;
+    }
+
+    void ContextManager::attach(TcpClient &client) const {
+        std::lock_guard lock(m_lock);
+        if (std::find(m_clients.begin(), m_clients.end(), &client) ==
+            m_clients.end()) {
+            m_clients.push_back(&client);
+        }
+        wake();
+    }
+
+    void ContextManager::detach(TcpClient &client) const {
+        std::lock_guard lock(m_lock);
+        m_clients.erase(std::remove(m_clients.begin(), m_clients.end(), &client),
+                        m_clients.end());
+    }
+
+    void ContextManager::loop() {
+        std::vector<pollfd> fds;
+        std::vector<TcpClient *> polled;
+        std::size_t ready_count = 0;
+        std::deque<SyncCall *> calls;
+
+        while (m_running) {
+            int wait_ms = MAX_WAIT_MS;
+            {
+                std::lock_guard lock(m_queue_mutex);
+                if (!m_ready.empty() || !m_sync_calls.empty()) {
+                    wait_ms = 0;
+                } else if (!m_timers.empty()) {
+                    const uint64_t now = time_us_64();
+                    const uint64_t due = m_timers.begin()->first;
+                    wait_ms = due <= now ? 0
+                                         : static_cast<int>(std::min<uint64_t>(
+                                               (due - now + 999) / 1000,
+                                               MAX_WAIT_MS));
+                }
+            }
+
+            fds.clear();
+            polled.clear();
+            fds.push_back({m_wake_pipe[0], POLLIN, 0});
+            {
+                std::lock_guard lock(m_lock);
+                for (TcpClient *client : m_clients) {
+                    if (const short events = client->pollEvents(); events != 0) {
+                        fds.push_back({client->m_fd, events, 0});
+                        polled.push_back(client);
+                    }
+                }
+            }
+            poll(fds.data(), fds.size(), wait_ms);
+
+            if (fds[0].revents & POLLIN) {
+                char drain[64];
+                while (read(m_wake_pipe[0], drain, sizeof(drain)) > 0) {
+                }
+            }
+
+            std::lock_guard core(core_workers[m_core]);
+            {
+                std::lock_guard lock(m_lock);
+                for (std::size_t i = 0; i < polled.size(); ++i) {
+                    // A callback run earlier in this pass may have closed it
+                    if (fds[i + 1].revents != 0 &&
+                        std::find(m_clients.begin(), m_clients.end(),
+                                  polled[i]) != m_clients.end() &&
+                        polled[i]->m_fd == fds[i + 1].fd) {
+                        polled[i]->service(fds[i + 1].revents);
+                    }
+                }
+                const uint32_t now = time_us_32();
+                const auto clients = m_clients;
+                for (TcpClient *client : clients) {
+                    if (std::find(m_clients.begin(), m_clients.end(), client) !=
+                        m_clients.end()) {
+                        client->tick(now);
+                    }
+                }
+            }
+
+            {
+                std::lock_guard lock(m_queue_mutex);
+                const uint64_t now = time_us_64();
+                while (!m_timers.empty() && m_timers.begin()->first <= now) {
+                    m_ready.push_back(m_timers.begin()->second);
+                    m_timers.erase(m_timers.begin());
+                }
+                ready_count = m_ready.size();
+                calls.swap(m_sync_calls);
+            }
+
+            // Bridges stay in m_ready until they run, so one destroyed by an
+            // earlier bridge is cancelled rather than left dangling; those
+            // queued while running wait for the next pass
+            for (; ready_count > 0; --ready_count) {
+                std::lock_guard lock(m_lock);
+                EventBridge *bridge;
+                {
+                    std::lock_guard queue_lock(m_queue_mutex);
+                    if (m_ready.empty()) {
+                        break;
+                    }
+                    bridge = m_ready.front();
+                    m_ready.pop_front();
+                    bridge->m_queued = false;
+                }
+                bridge->onWork();
+                bridge->afterWork();
+            }
+
+            for (SyncCall *call : calls) {
+                uint32_t result;
+                {
+                    std::lock_guard lock(m_lock);
+                    result = call->bridge->onExecute(std::move(call->payload));
+                }
+                std::lock_guard lock(m_queue_mutex);
+                call->result = result;
+                call->done = true;
+                m_sync_done.notify_all();
+            }
+            calls.clear();
+        }
+    }
+
+} // namespace async_tcp
+
+#endif // E5_HOST_SIM
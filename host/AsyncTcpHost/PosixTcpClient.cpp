@@ -0,0 +1,238 @@
+/**
+ * @file PosixTcpClient.cpp
+ * @brief POSIX socket backend of the host TcpClient.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#ifndef E5_HOST_SIM
+
+#include "TcpClient.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace async_tcp {
+
+    namespace {
+
+        err_t toLwipError(const int error) {
+            switch (error) {
+                case ECONNREFUSED:
+                case ECONNRESET:
+                    return ERR_RST;
+                case ETIMEDOUT:
+                    return ERR_TIMEOUT;
+                case ENETUNREACH:
+                case EHOSTUNREACH:
+                    return ERR_RTE;
+                case ENOMEM:
+                case ENOBUFS:
+                    return ERR_MEM;
+                default:
+                    return ERR_ABRT;
+            }
+        }
+
+        /// Locks the client's context, if it has one
+        class ContextLock {
+                const AsyncCtx *m_ctx;
+
+            public:
+                explicit ContextLock(const AsyncCtx *ctx) : m_ctx(ctx) {
+                    if (m_ctx) {
+                        m_ctx->acquireLock();
+                    }
+                }
+                ~ContextLock() {
+                    if (m_ctx) {
+                        m_ctx->releaseLock();
+                    }
+                }
+        };
+
+    } // namespace
+
+    TcpClient::~TcpClient() {
+        ContextLock lock(context());
+        release(false);
+    }
+
+    int TcpClient::connect(const IPAddress &address, const uint16_t port) {
+        const AsyncCtx *ctx = context();
+        if (!ctx) {
+            return PICO_ERROR_GENERIC;
+        }
+        ContextLock lock(ctx);
+        if (m_state != CLOSED) {
+            return PICO_ERROR_GENERIC;
+        }
+        m_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (m_fd < 0) {
+            m_fd = -1;
+            return PICO_ERROR_GENERIC;
+        }
+        sockaddr_in remote{};
+        remote.sin_family = AF_INET;
+        remote.sin_port = htons(port);
+        remote.sin_addr.s_addr = address.v4();
+        m_remote = address;
+        m_rx.reset();
+        m_tx.clear();
+        if (::connect(m_fd, reinterpret_cast<sockaddr *>(&remote),
+                      sizeof(remote)) != 0 &&
+            errno != EINPROGRESS) {
+            // Reported through the error callback, as lwIP would
+            const err_t error = toLwipError(errno);
+            m_state = SYN_SENT;
+            ctx->attach(*this);
+            fail(error);
+            return PICO_OK;
+        }
+        m_state = SYN_SENT;
+        ctx->attach(*this);
+        return PICO_OK;
+    }
+
+    size_t TcpClient::write(const uint8_t *data, const size_t size) {
+        ContextLock lock(context());
+        if (m_state != ESTABLISHED && m_state != CLOSE_WAIT) {
+            return static_cast<size_t>(PICO_ERROR_GENERIC);
+        }
+        m_tx.append(reinterpret_cast<const char *>(data), size);
+        if (m_writer) {
+            m_writer->onWrite(size);
+        }
+        send();
+        return PICO_OK;
+    }
+
+    short TcpClient::pollEvents() const {
+        if (m_fd < 0) {
+            return 0;
+        }
+        switch (m_state) {
+            case SYN_SENT:
+                return POLLOUT;
+            case ESTABLISHED:
+                return static_cast<short>(POLLIN | (m_tx.empty() ? 0 : POLLOUT));
+            case CLOSE_WAIT:
+                return m_tx.empty() ? 0 : POLLOUT;
+            default:
+                return 0;
+        }
+    }
+
+    void TcpClient::service(const short revents) {
+        if (m_state == SYN_SENT) {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(m_fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            if (error != 0) {
+                fail(toLwipError(error));
+                return;
+            }
+            connected();
+            return;
+        }
+        if (revents & POLLOUT) {
+            send();
+        }
+        if (m_fd >= 0 && m_state == ESTABLISHED &&
+            revents & (POLLIN | POLLHUP | POLLERR)) {
+            receive();
+        }
+    }
+
+    void TcpClient::receive() {
+        char chunk[READ_CHUNK];
+        const ssize_t count = recv(m_fd, chunk, sizeof(chunk), 0);
+        if (count > 0) {
+            received(chunk, static_cast<std::size_t>(count));
+        } else if (count == 0) {
+            finReceived();
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            fail(toLwipError(errno));
+        }
+    }
+
+    void TcpClient::send() {
+        std::size_t accepted = 0;
+        while (!m_tx.empty()) {
+            const ssize_t sent =
+                ::send(m_fd, m_tx.data(), m_tx.size(), MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    fail(toLwipError(errno));
+                    return;
+                }
+                break;
+            }
+            m_tx.erase(0, static_cast<std::size_t>(sent));
+            accepted += static_cast<std::size_t>(sent);
+        }
+        if (accepted > 0) {
+            acked(accepted);
+        }
+    }
+
+    void TcpClient::tick(const uint32_t now_us) {
+        if (m_state == ESTABLISHED && m_on_poll &&
+            now_us - m_polled_us >= POLL_INTERVAL_US) {
+            m_polled_us = now_us;
+            polled();
+        }
+    }
+
+    void TcpClient::release(const bool abortive) {
+        if (m_fd >= 0) {
+            if (abortive) {
+                const linger reset{1, 0};
+                setsockopt(m_fd, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+            }
+            close(m_fd);
+            m_fd = -1;
+        }
+        if (const AsyncCtx *ctx = context()) {
+            ctx->detach(*this);
+        }
+        m_state = CLOSED;
+        m_tx.clear();
+    }
+
+    void TcpClient::shutdown() {
+        ContextLock lock(context());
+        // The kernel keeps the FIN exchange and TIME_WAIT; the client is
+        // reusable at once
+        release(false);
+    }
+
+    void TcpClient::abort() {
+        ContextLock lock(context());
+        release(true);
+    }
+
+    void TcpClient::discardUnsent() {
+        ContextLock lock(context());
+        m_tx.clear();
+    }
+
+    void TcpClient::setNoDelay(const bool no_delay) {
+        ContextLock lock(context());
+        if (m_fd >= 0) {
+            const int value = no_delay ? 1 : 0;
+            setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value));
+        }
+    }
+
+} // namespace async_tcp
+
+#endif // E5_HOST_SIM
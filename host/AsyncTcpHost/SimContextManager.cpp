@@ -0,0 +1,92 @@
+/**
+ * @file SimContextManager.cpp
+ * @brief Simulator backend of the host ContextManager.
+ *
+ * @author Goran
+ * @date 2025-09-27
+ * @ingroup AsyncTCPClient
+ */
+
+#ifdef E5_HOST_SIM
+
+#include "ContextManager.hpp"
+#include "Arduino.h"
+#include "EventBridge.hpp"
+#include "Simulator.hpp"
+#include "SyncBridge.hpp"
+#include <algorithm>
+
+namespace async_tcp {
+
+    bool ContextManager::initDefaultContext(
+        async_context_threadsafe_background_config_t &) {
+        if (m_running) {
+            return false;
+        }
+        m_core = static_cast<uint8_t>(get_core_num());
+        m_running = true;
+        return true;
+    }
+
+    void ContextManager::stop() { m_running = false; }
+
+    uint64_t ContextManager::cpuUs() { return 0; }
+
+    void ContextManager::wake() const {}
+
+    void ContextManager::schedule(EventBridge &bridge,
+                                  const uint32_t delay_us) const {
+        if (bridge.m_queued) {
+            return;
+        }
+        bridge.m_queued = true;
+        auto &sim = Simulator::current();
+        const uint64_t due = sim.now() + delay_us;
+        if (delay_us == 0) {
+            m_ready.push_back(&bridge);
+        } else {
+            m_timers.emplace(due, &bridge);
+        }
+        sim.post(m_core,
+                 std::max(due, sim.now() + sim.config().worker_latency_us),
+                 [this] { const_cast<ContextManager *>(this)->runDue(); });
+    }
+
+    void ContextManager::runDue() {
+        auto &sim = Simulator::current();
+        std::lock_guard lock(m_lock);
+        while (!m_timers.empty() && m_timers.begin()->first <= sim.now()) {
+            m_ready.push_back(m_timers.begin()->second);
+            m_timers.erase(m_timers.begin());
+        }
+        // Bridges queued while these run get their own event
+        for (std::size_t count = m_ready.size(); count > 0 && !m_ready.empty();
+             --count) {
+            EventBridge *bridge = m_ready.front();
+            m_ready.pop_front();
+            bridge->m_queued = false;
+            sim.charge(sim.config().worker_cost_us);
+            bridge->onWork();
+            bridge->afterWork();
+        }
+    }
+
+    uint32_t ContextManager::execute(SyncBridge &bridge,
+                                     std::unique_ptr<SyncPayload> payload) const {
+        if (get_core_num() == m_core) {
+            std::lock_guard lock(m_lock);
+            return bridge.onExecute(std::move(payload));
+        }
+        return Simulator::current().crossCall(m_core, [&] {
+            std::lock_guard lock(m_lock);
+            return bridge.onExecute(std::move(payload));
+        });
+    }
+
+    void ContextManager::attach(TcpClient &) const {}
+
+    void ContextManager::detach(TcpClient &) const {}
+
+} // namespace async_tcp
+
+#endif // E5_HOST_SIM
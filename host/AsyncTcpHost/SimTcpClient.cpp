@@ -0,0 +1,67 @@
+/**
+ * @file SimTcpClient.cpp
+ * @brief Simulator backend of the host TcpClient.
+ *
+ * Connections are made to the Simulator's network model; its events call
+ * the client's network-event methods on the client's context core. An ACK
+ * is the simulated peer acknowledging the bytes.
+ *
+ * @author Goran
+ * @date 2025-09-27
+ * @ingroup AsyncTCPClient
+ */
+
+#ifdef E5_HOST_SIM
+
+#include "Simulator.hpp"
+#include "TcpClient.hpp"
+
+namespace async_tcp {
+
+    TcpClient::~TcpClient() {
+        if (Simulator::active()) {
+            release(false);
+        }
+    }
+
+    int TcpClient::connect(const IPAddress &address, const uint16_t port) {
+        if (!context() || m_state != CLOSED) {
+            return PICO_ERROR_GENERIC;
+        }
+        m_remote = address;
+        m_rx.reset();
+        m_state = SYN_SENT;
+        m_fd = Simulator::current().connect(*this, port);
+        return PICO_OK;
+    }
+
+    size_t TcpClient::write(const uint8_t *data, const size_t size) {
+        if (m_state != ESTABLISHED && m_state != CLOSE_WAIT) {
+            return static_cast<size_t>(PICO_ERROR_GENERIC);
+        }
+        if (m_writer) {
+            m_writer->onWrite(size);
+        }
+        Simulator::current().write(m_fd, data, size);
+        return PICO_OK;
+    }
+
+    void TcpClient::release(const bool abortive) {
+        if (m_fd >= 0) {
+            Simulator::current().close(m_fd, abortive);
+            m_fd = -1;
+        }
+        m_state = CLOSED;
+    }
+
+    void TcpClient::shutdown() { release(false); }
+
+    void TcpClient::abort() { release(true); }
+
+    void TcpClient::discardUnsent() {}
+
+    void TcpClient::setNoDelay(bool) {}
+
+} // namespace async_tcp
+
+#endif // E5_HOST_SIM
@@ -0,0 +1,332 @@
+/**
+ * @file Simulator.cpp
+ * @brief Implementation of the discrete-event simulator and of the clock
+ * and core functions of the E5_HOST_SIM build.
+ *
+ * @author Goran
+ * @date 2025-09-27
+ * @ingroup AsyncTCPClient
+ */
+
+#ifdef E5_HOST_SIM
+
+#include "Simulator.hpp"
+#include "TcpClient.hpp"
+#include <algorithm>
+#include <cstdarg>
+
+uint64_t time_us_64() {
+    return async_tcp::Simulator::active() ? async_tcp::Simulator::current().now()
+                                          : 0;
+}
+
+uint32_t time_us_32() { return static_cast<uint32_t>(time_us_64()); }
+
+unsigned get_core_num() {
+    return async_tcp::Simulator::active() ? async_tcp::Simulator::current().core()
+                                          : 0;
+}
+
+void set_core_num(unsigned) {}
+
+// Events run one at a time, so loop and worker code never interleave
+unsigned __get_current_exception() { return 0; }
+
+void set_current_exception(unsigned) {}
+
+void tight_loop_contents() {}
+
+void delay(const unsigned long ms) {
+    // Busy-waits the calling core
+    async_tcp::Simulator::current().charge(static_cast<uint64_t>(ms) * 1000);
+}
+
+void delayMicroseconds(const unsigned int us) {
+    async_tcp::Simulator::current().charge(us);
+}
+
+uint32_t RP2040::getCycleCount() {
+    return static_cast<uint32_t>(time_us_64() * 1000);
+}
+
+namespace async_tcp {
+
+    Simulator *Simulator::s_current = nullptr;
+
+    Simulator::Simulator(const SimConfig &config)
+        : m_config(config), m_rng(config.seed) {
+        s_current = this;
+        Serial1.setSink(
+            [](const char *data, const size_t size, void *arg) {
+                static_cast<Simulator *>(arg)->uart(data, size);
+            },
+            this);
+    }
+
+    Simulator::~Simulator() {
+        Serial1.setSink(nullptr, nullptr);
+        s_current = nullptr;
+    }
+
+    uint32_t Simulator::jitter(const uint32_t range) {
+        return range ? m_rng() % (range + 1) : 0;
+    }
+
+    void Simulator::trace(const char *format, ...) {
+        if (!m_trace) {
+            return;
+        }
+        std::fprintf(m_trace, "%10llu c%u ",
+                     static_cast<unsigned long long>(m_now), m_core);
+        va_list args;
+        va_start(args, format);
+        std::vfprintf(m_trace, format, args);
+        va_end(args);
+        std::fputc('\n', m_trace);
+    }
+
+    void Simulator::post(const uint8_t core, const uint64_t at, Action action) {
+        const uint64_t order = m_config.shuffle_ties
+                                   ? (static_cast<uint64_t>(m_rng()) << 32) |
+                                         m_order++
+                                   : m_order++;
+        m_queue.push({at, at, order, core, std::move(action)});
+    }
+
+    void Simulator::onCore(const uint8_t core, const Action &action) {
+        const uint8_t caller = m_core;
+        m_core = core;
+        action();
+        m_busy_until[core] = std::max(m_busy_until[core], m_now);
+        m_core = caller;
+    }
+
+    bool Simulator::step() {
+        if (m_queue.empty()) {
+            return false;
+        }
+        Event event = std::move(const_cast<Event &>(m_queue.top()));
+        m_queue.pop();
+        if (event.at < m_busy_until[event.core]) {
+            // Waits for the core; events deferred to the same time keep the
+            // order they were due in, so one stream's segments stay in order
+            event.at = m_busy_until[event.core];
+            m_queue.push(std::move(event));
+            return true;
+        }
+        m_now = event.at;
+        m_core = event.core;
+        event.action();
+        m_busy_until[m_core] = m_now;
+        ++m_stats.events;
+        return true;
+    }
+
+    void Simulator::runUntil(const uint64_t at) {
+        while (!m_queue.empty() && m_queue.top().at < at) {
+            step();
+        }
+        m_now = std::max(m_now, at);
+    }
+
+    uint32_t Simulator::crossCall(const uint8_t core,
+                                  const std::function<uint32_t()> &call) {
+        const uint8_t caller = m_core;
+        const uint64_t issued = m_now;
+        m_core = core;
+        m_now = std::max(issued + m_config.xcore_latency_us,
+                         m_busy_until[core]);
+        const uint32_t result = call();
+        m_busy_until[core] = m_now;
+        const uint64_t returned = m_now + m_config.xcore_latency_us;
+        m_core = caller;
+        m_now = returned;
+        ++m_stats.xcore_calls;
+        m_stats.xcore_wait_us += returned - issued;
+        trace("execute on core %u, blocked %llu us", core,
+              static_cast<unsigned long long>(returned - issued));
+        return result;
+    }
+
+    void Simulator::uart(const char *data, const std::size_t size) {
+        if (m_uart_out) {
+            std::fwrite(data, 1, size, m_uart_out);
+        }
+        const uint64_t byte_ns = 10000000000ull / m_config.uart_baud;
+        const uint64_t now_ns = m_now * 1000;
+        m_uart_free_ns = std::max(m_uart_free_ns, now_ns) + size * byte_ns;
+        // The writer returns once the rest fits in the FIFO
+        const uint64_t fifo_ns = m_config.uart_fifo_bytes * byte_ns;
+        if (m_uart_free_ns > now_ns + fifo_ns) {
+            const uint64_t until = (m_uart_free_ns - fifo_ns + 999) / 1000;
+            m_stats.uart_stall_us += until - m_now;
+            trace("uart %zu B, stalled %llu us", size,
+                  static_cast<unsigned long long>(until - m_now));
+            m_now = until;
+        }
+        m_stats.uart_bytes += size;
+    }
+
+    void Simulator::listen(const uint16_t port, const SimService service) {
+        m_listeners.emplace_back(port, service);
+    }
+
+    bool Simulator::isOpen(const int connection) const {
+        return connection >= 0 &&
+               static_cast<std::size_t>(connection) < m_connections.size() &&
+               m_connections[connection].open;
+    }
+
+    uint8_t Simulator::coreOf(const int connection) const {
+        const AsyncCtx *ctx = m_connections[connection].client->context();
+        return ctx ? ctx->getCore() : 0;
+    }
+
+    int Simulator::connect(TcpClient &client, const uint16_t port) {
+        const auto listener =
+            std::find_if(m_listeners.begin(), m_listeners.end(),
+                         [port](const auto &entry) { return entry.first == port; });
+        const int connection = static_cast<int>(m_connections.size());
+        const SimService service =
+            listener != m_listeners.end() ? listener->second : SimService::ECHO;
+        m_connections.push_back({&client, service, true});
+        ++m_stats.connects;
+
+        const bool refused = listener == m_listeners.end() ||
+                             m_rng() % 1000 < m_config.refuse_permille;
+        const uint64_t at =
+            m_now + m_config.connect_us + jitter(m_config.connect_jitter_us);
+        trace("connect #%d to port %u", connection, port);
+        post(coreOf(connection), at, [this, connection, refused] {
+            if (!isOpen(connection)) {
+                return;
+            }
+            charge(m_config.lwip_cost_us);
+            TcpClient &client = *m_connections[connection].client;
+            if (refused) {
+                ++m_stats.refused;
+                trace("#%d refused", connection);
+                client.fail(ERR_RST);
+                return;
+            }
+            trace("#%d connected", connection);
+            client.connected();
+            if (m_connections[connection].service == SimService::QOTD) {
+                serveQuote(connection);
+            }
+            schedulePoll(connection);
+        });
+        return connection;
+    }
+
+    void Simulator::schedulePoll(const int connection) {
+        // lwIP's poll timer, every POLL_INTERVAL_US while open
+        post(coreOf(connection), m_now + TcpClient::POLL_INTERVAL_US,
+             [this, connection] {
+                 if (!isOpen(connection)) {
+                     return;
+                 }
+                 if (TcpClient &client = *m_connections[connection].client;
+                     client.status() == ESTABLISHED) {
+                     client.polled();
+                 }
+                 schedulePoll(connection);
+             });
+    }
+
+    void Simulator::serveQuote(const int connection) {
+        const uint32_t span = m_config.quote_max_bytes > m_config.quote_min_bytes
+                                  ? m_config.quote_max_bytes -
+                                        m_config.quote_min_bytes
+                                  : 0;
+        const std::size_t length = m_config.quote_min_bytes + jitter(span);
+        std::string quote = "Quote " + std::to_string(++m_quote_number) + ":";
+        while (quote.size() + 1 < length) {
+            quote += static_cast<char>('a' + m_rng() % 26);
+        }
+        quote += '\n';
+
+        uint64_t at = m_now + m_config.first_byte_us;
+        for (std::size_t offset = 0; offset < quote.size();
+             offset += m_config.segment_bytes) {
+            at += jitter(m_config.segment_jitter_us);
+            deliver(connection, at, quote.substr(offset, m_config.segment_bytes));
+            at += m_config.segment_gap_us;
+        }
+        post(coreOf(connection), at + m_config.fin_gap_us,
+             [this, connection, quote] {
+                 if (!isOpen(connection)) {
+                     return;
+                 }
+                 charge(m_config.lwip_cost_us);
+                 ++m_stats.quotes_served;
+                 m_served.push_back(quote);
+                 if (m_served.size() > SERVED_HISTORY) {
+                     m_served.pop_front();
+                 }
+                 trace("#%d FIN", connection);
+                 m_connections[connection].client->finReceived();
+             });
+    }
+
+    void Simulator::deliver(const int connection, const uint64_t at,
+                            std::string data) {
+        post(coreOf(connection), at,
+             [this, connection, data = std::move(data)] {
+                 if (!isOpen(connection)) {
+                     return;
+                 }
+                 charge(m_config.lwip_cost_us);
+                 ++m_stats.segments;
+                 trace("#%d segment %zu B", connection, data.size());
+                 m_connections[connection].client->received(data.data(),
+                                                            data.size());
+             });
+    }
+
+    void Simulator::write(const int connection, const uint8_t *data,
+                          const std::size_t size) {
+        if (!isOpen(connection)) {
+            return;
+        }
+        std::string text(reinterpret_cast<const char *>(data), size);
+        trace("#%d write %zu B", connection, size);
+        if (m_connections[connection].service != SimService::ECHO) {
+            return;
+        }
+        ++m_stats.echo_writes;
+        if (std::find(m_served.begin(), m_served.end(), text) ==
+            m_served.end()) {
+            ++m_stats.echo_mismatches;
+            trace("#%d write matches no served quote", connection);
+        }
+        const uint64_t at = m_now + m_config.ack_us + jitter(m_config.segment_jitter_us);
+        post(coreOf(connection), at, [this, connection, size] {
+            if (!isOpen(connection)) {
+                return;
+            }
+            charge(m_config.lwip_cost_us);
+            trace("#%d ACK %zu B", connection, size);
+            m_connections[connection].client->acked(size);
+        });
+        uint64_t echo_at = at;
+        for (std::size_t offset = 0; offset < text.size();
+             offset += m_config.segment_bytes) {
+            echo_at += jitter(m_config.segment_jitter_us);
+            deliver(connection, echo_at, text.substr(offset, m_config.segment_bytes));
+            echo_at += m_config.segment_gap_us;
+        }
+    }
+
+    void Simulator::close(const int connection, const bool abortive) {
+        if (!isOpen(connection)) {
+            return;
+        }
+        m_connections[connection].open = false;
+        m_stats.aborts += abortive ? 1 : 0;
+        trace("#%d %s", connection, abortive ? "abort" : "close");
+    }
+
+} // namespace async_tcp
+
+#endif // E5_HOST_SIM
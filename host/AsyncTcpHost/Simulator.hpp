@@ -0,0 +1,229 @@
+/**
+ * @file Simulator.hpp
+ * @brief Deterministic discrete-event model of the two cores, their async
+ * contexts, the UART and the network, for the E5_HOST_SIM build.
+ *
+ * The simulator runs the real application code single-threaded over virtual
+ * time. Every piece of work is an event bound to a core: a context's due
+ * bridges, an lwIP callback for an arriving segment or ACK, or a pass of
+ * the application loop. Each core runs one event at a time; an event that
+ * becomes due while its core is busy waits for it. Running code advances
+ * its core's clock through modelled costs: a fixed cost per bridge and per
+ * lwIP callback, blocking writes to a UART with a bounded FIFO, and the
+ * cross-core latency of a SyncBridge call, which runs the call on the other
+ * core once that core is free.
+ *
+ * Events do not preempt each other, unlike workers interrupting loop code
+ * on the device; a SyncBridge call runs ahead of events that became due on
+ * the target core during the caller's event. Both effects are bounded by
+ * the length of one event.
+ *
+ * Given the same SimConfig, runs are identical. Events due at the same time
+ * run in insertion order, or in seeded random order with shuffle_ties, so
+ * that different seeds explore different interleavings.
+ *
+ * @author Goran
+ * @date 2025-09-27
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "Arduino.h"
+#include "lwip/err.h"
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace async_tcp {
+
+    class TcpClient;
+
+    /**
+     * @brief Model parameters; all times in microseconds.
+     */
+    struct SimConfig {
+            uint32_t seed = 1;
+            bool shuffle_ties = true; ///< Seeded order of simultaneous events
+
+            // Cores and contexts
+            uint32_t worker_cost_us = 6;    ///< Running one bridge
+            uint32_t worker_latency_us = 2; ///< Queueing a bridge to its run
+            uint32_t xcore_latency_us = 3;  ///< SyncBridge call, each way
+            uint32_t lwip_cost_us = 4;      ///< One lwIP callback
+
+            // Serial1
+            uint32_t uart_baud = 115200;
+            uint32_t uart_fifo_bytes = 32;
+
+            // Network
+            uint32_t connect_us = 3000;
+            uint32_t connect_jitter_us = 2000;
+            uint32_t refuse_permille = 0; ///< Connects answered with RST
+            uint32_t segment_bytes = 1460;
+            uint32_t first_byte_us = 1500; ///< Connected to first segment
+            uint32_t segment_gap_us = 300;
+            uint32_t segment_jitter_us = 300;
+            uint32_t fin_gap_us = 200; ///< Last segment to FIN
+            uint32_t ack_us = 2500;    ///< Write to ACK and echoed data
+            uint32_t quote_min_bytes = 40;
+            uint32_t quote_max_bytes = 400;
+    };
+
+    /**
+     * @brief Server behaviour of a simulated port.
+     */
+    enum class SimService : uint8_t {
+        QOTD, ///< Sends one quote, then FIN
+        ECHO, ///< Echoes every write
+    };
+
+    struct SimStats {
+            uint64_t events = 0;
+            uint32_t connects = 0;
+            uint32_t refused = 0;
+            uint32_t aborts = 0;
+            uint32_t quotes_served = 0;
+            uint32_t segments = 0;
+            uint32_t echo_writes = 0;
+            uint32_t echo_mismatches = 0; ///< Writes that match no served quote
+            uint32_t xcore_calls = 0;
+            uint64_t xcore_wait_us = 0; ///< Caller blocked in SyncBridge calls
+            uint64_t uart_bytes = 0;
+            uint64_t uart_stall_us = 0; ///< Writers blocked on a full FIFO
+    };
+
+    class Simulator {
+        public:
+            using Action = std::function<void()>;
+
+        private:
+            struct Event {
+                    uint64_t at;
+                    uint64_t due; ///< Time first posted for; a busy core defers at
+                    uint64_t order;
+                    uint8_t core;
+                    Action action;
+            };
+
+            struct Later {
+                    bool operator()(const Event &a, const Event &b) const {
+                        if (a.at != b.at) {
+                            return a.at > b.at;
+                        }
+                        return a.due != b.due ? a.due > b.due : a.order > b.order;
+                    }
+            };
+
+            struct Connection {
+                    TcpClient *client;
+                    SimService service;
+                    bool open;
+            };
+
+            static constexpr std::size_t SERVED_HISTORY = 8;
+            static Simulator *s_current;
+
+            SimConfig m_config;
+            std::mt19937 m_rng;
+            std::priority_queue<Event, std::vector<Event>, Later> m_queue;
+            uint64_t m_order = 0;
+            uint64_t m_now = 0;
+            uint8_t m_core = 0;
+            uint64_t m_busy_until[2] = {};
+            uint64_t m_uart_free_ns = 0;
+            std::vector<std::pair<uint16_t, SimService>> m_listeners;
+            std::vector<Connection> m_connections;
+            std::deque<std::string> m_served; ///< Last quotes sent in full
+            uint32_t m_quote_number = 0;
+            std::FILE *m_trace = nullptr;
+            std::FILE *m_uart_out = nullptr;
+            SimStats m_stats;
+
+            [[nodiscard]] uint32_t jitter(uint32_t range);
+            [[nodiscard]] bool isOpen(int connection) const;
+            [[nodiscard]] uint8_t coreOf(int connection) const;
+            void serveQuote(int connection);
+            void schedulePoll(int connection);
+            void deliver(int connection, uint64_t at, std::string data);
+
+        public:
+            explicit Simulator(const SimConfig &config);
+            ~Simulator();
+            Simulator(const Simulator &) = delete;
+            Simulator &operator=(const Simulator &) = delete;
+
+            /**
+             * @brief The simulator that time_us_64() and get_core_num() read.
+             */
+            static Simulator &current() { return *s_current; }
+            static bool active() { return s_current != nullptr; }
+
+            [[nodiscard]] uint64_t now() const { return m_now; }
+            [[nodiscard]] uint8_t core() const { return m_core; }
+            [[nodiscard]] const SimConfig &config() const { return m_config; }
+            [[nodiscard]] const SimStats &stats() const { return m_stats; }
+
+            /**
+             * @brief Writes one line per event to @p out; nullptr disables.
+             */
+            void setTrace(std::FILE *out) { m_trace = out; }
+
+            /**
+             * @brief Copies Serial1 output to @p out; nullptr discards it.
+             */
+            void setUartOutput(std::FILE *out) { m_uart_out = out; }
+
+            void trace(const char *format, ...);
+
+            /**
+             * @brief Runs @p action on @p core at time @p at, or later if
+             * the core is busy then.
+             */
+            void post(uint8_t core, uint64_t at, Action action);
+
+            /**
+             * @brief Runs @p action now as code of @p core; for setup.
+             */
+            void onCore(uint8_t core, const Action &action);
+
+            /**
+             * @brief Advances the running core's clock by @p us.
+             */
+            void charge(const uint64_t us) { m_now += us; }
+
+            /**
+             * @brief Runs @p call on @p core as a blocking cross-core call.
+             */
+            uint32_t crossCall(uint8_t core, const std::function<uint32_t()> &call);
+
+            /**
+             * @brief Sends @p size bytes through the modelled UART.
+             */
+            void uart(const char *data, std::size_t size);
+
+            // Network
+            void listen(uint16_t port, SimService service);
+            int connect(TcpClient &client, uint16_t port);
+            void write(int connection, const uint8_t *data, std::size_t size);
+            void close(int connection, bool abortive);
+
+            /**
+             * @brief Runs the next event.
+             *
+             * @return false when no event is left
+             */
+            bool step();
+
+            /**
+             * @brief Runs events due before @p at.
+             */
+            void runUntil(uint64_t at);
+    };
+
+} // namespace async_tcp
@@ -0,0 +1,47 @@
+/**
+ * @file SyncBridge.hpp
+ * @brief Host implementation of the async-tcp SyncBridge.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ContextManager.hpp"
+#include <cstdint>
+#include <memory>
+
+namespace async_tcp {
+
+    struct SyncPayload {
+            virtual ~SyncPayload() = default;
+    };
+
+    using SyncPayloadPtr = std::unique_ptr<SyncPayload>;
+
+    /**
+     * @class SyncBridge
+     * @brief Runs onExecute() on the bridge's context and waits for it.
+     *
+     * Called on the context's core, onExecute() runs inline under the
+     * context lock; from the other core the call is queued on the context's
+     * event loop and the caller blocks until it has run.
+     */
+    class SyncBridge {
+            friend class ContextManager;
+
+        protected:
+            const AsyncCtx &m_ctx;
+
+            virtual uint32_t onExecute(SyncPayloadPtr payload) = 0;
+
+        public:
+            explicit SyncBridge(const AsyncCtx &ctx) : m_ctx(ctx) {}
+            virtual ~SyncBridge() = default;
+
+            uint32_t execute(SyncPayloadPtr payload);
+    };
+
+} // namespace async_tcp
@@ -0,0 +1,85 @@
+/**
+ * @file TcpClient.cpp
+ * @brief Backend-independent part of the host TcpClient: callback
+ * registration and the translation of network events into bridge runs.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#include "TcpClient.hpp"
+#include <algorithm>
+
+namespace async_tcp {
+
+    void TcpClient::fire(EventBridge *bridge, void *data) {
+        if (bridge) {
+            bridge->workload(data);
+            bridge->schedule(0);
+        }
+    }
+
+    void TcpClient::connected() {
+        m_state = ESTABLISHED;
+        m_polled_us = time_us_32();
+        fire(m_on_connected.get(), nullptr);
+    }
+
+    void TcpClient::received(const char *data, const std::size_t size) {
+        m_rx.append(data, size);
+        fire(m_on_received.get(), &m_rx);
+    }
+
+    void TcpClient::finReceived() {
+        m_state = CLOSE_WAIT;
+        fire(m_on_fin.get(), &m_rx);
+    }
+
+    void TcpClient::acked(std::size_t bytes) {
+        if (!m_on_ack) {
+            return;
+        }
+        // Coalesced while pending, as TcpAckHandler expects
+        while (bytes > 0) {
+            const auto step =
+                static_cast<uint16_t>(std::min<std::size_t>(bytes, UINT16_MAX));
+            fire(m_on_ack.get(), new uint16_t(step));
+            bytes -= step;
+        }
+    }
+
+    void TcpClient::polled() { fire(m_on_poll.get(), nullptr); }
+
+    void TcpClient::fail(const err_t error) {
+        release(false);
+        if (m_on_error) {
+            fire(m_on_error.get(), new err_t(error));
+        }
+    }
+
+    void TcpClient::setOnConnectedCallback(std::unique_ptr<EventBridge> bridge) {
+        m_on_connected = std::move(bridge);
+    }
+
+    void TcpClient::setOnReceivedCallback(std::unique_ptr<EventBridge> bridge) {
+        m_on_received = std::move(bridge);
+    }
+
+    void TcpClient::setOnFinCallback(std::unique_ptr<EventBridge> bridge) {
+        m_on_fin = std::move(bridge);
+    }
+
+    void TcpClient::setOnPollCallback(std::unique_ptr<EventBridge> bridge) {
+        m_on_poll = std::move(bridge);
+    }
+
+    void TcpClient::setOnAckCallback(std::unique_ptr<EventBridge> bridge) {
+        m_on_ack = std::move(bridge);
+    }
+
+    void TcpClient::setOnErrorCallback(std::unique_ptr<EventBridge> bridge) {
+        m_on_error = std::move(bridge);
+    }
+
+} // namespace async_tcp
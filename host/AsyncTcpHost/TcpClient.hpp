@@ -0,0 +1,161 @@
+/**
+ * @file TcpClient.hpp
+ * @brief Host implementation of the async-tcp TcpClient.
+ *
+ * Network events are turned into the same callbacks as lwIP's: connected,
+ * received (each arrival is one IoRxBuffer chunk), FIN, ACK, error (with
+ * lwIP error codes) and poll, every POLL_INTERVAL_US while connected.
+ *
+ * Two backends provide the network. By default the client uses a
+ * non-blocking IPv4 socket polled by the event loop of the ContextManager
+ * given in its TcpClientSyncAccessor; an ACK is the kernel accepting the
+ * bytes, and public methods take the context lock, so they may be called
+ * from any thread. With E5_HOST_SIM the Simulator's network model delivers
+ * the events in virtual time instead.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "Arduino.h"
+#include "ContextManager.hpp"
+#include "EventBridge.hpp"
+#include "IoRxBuffer.hpp"
+#include "TcpWriter.hpp"
+#include "lwip/err.h"
+#include "lwip/tcpbase.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace async_tcp {
+
+    class TcpClient;
+
+    /**
+     * @brief Binds a client to the context that runs its callbacks.
+     */
+    class TcpClientSyncAccessor {
+            const AsyncCtx &m_ctx;
+
+        public:
+            TcpClientSyncAccessor(const AsyncCtx &ctx, TcpClient &)
+                : m_ctx(ctx) {}
+
+            [[nodiscard]] const AsyncCtx &context() const { return m_ctx; }
+    };
+
+    class TcpClient {
+            friend class ContextManager;
+            friend class Simulator;
+
+        public:
+            static constexpr uint32_t POLL_INTERVAL_US = 500000;
+            static constexpr std::size_t READ_CHUNK = 1460; ///< One MSS
+
+        private:
+            int m_fd = -1; ///< Socket, or the simulator's connection number
+            uint8_t m_state = CLOSED;
+            int m_client_id = 0;
+            IPAddress m_remote;
+            IoRxBuffer m_rx;
+            std::string m_tx; ///< Written, not yet accepted by the kernel
+            uint32_t m_polled_us = 0;
+
+            std::unique_ptr<TcpClientSyncAccessor> m_accessor;
+            std::unique_ptr<TcpWriter> m_writer;
+            std::unique_ptr<EventBridge> m_on_connected;
+            std::unique_ptr<EventBridge> m_on_received;
+            std::unique_ptr<EventBridge> m_on_fin;
+            std::unique_ptr<EventBridge> m_on_poll;
+            std::unique_ptr<EventBridge> m_on_ack;
+            std::unique_ptr<EventBridge> m_on_error;
+
+            [[nodiscard]] const AsyncCtx *context() const {
+                return m_accessor ? &m_accessor->context() : nullptr;
+            }
+
+            // Network events, context lock held; called by the backend
+            void connected();
+            void received(const char *data, std::size_t size);
+            void finReceived();
+            void acked(std::size_t bytes);
+            void polled();
+            void fail(err_t error);
+            void release(bool abortive);
+            static void fire(EventBridge *bridge, void *data);
+
+            // POSIX backend, run by the context's event loop
+            [[nodiscard]] short pollEvents() const;
+            void service(short revents);
+            void tick(uint32_t now_us);
+            void receive();
+            void send();
+
+        public:
+            TcpClient() = default;
+            TcpClient(const TcpClient &) = delete;
+            TcpClient &operator=(const TcpClient &) = delete;
+            ~TcpClient();
+
+            /**
+             * @brief Starts a non-blocking connect.
+             *
+             * @return PICO_OK, or PICO_ERROR_GENERIC if the client has no
+             * context, is not closed or the socket cannot be created
+             */
+            int connect(const IPAddress &address, uint16_t port);
+
+            /**
+             * @brief Queues @p size bytes for sending.
+             *
+             * @return PICO_OK, or PICO_ERROR_GENERIC if not connected
+             */
+            size_t write(const uint8_t *data, size_t size);
+
+            [[nodiscard]] uint8_t status() const { return m_state; }
+            [[nodiscard]] int getClientId() const { return m_client_id; }
+            void setClientId(const int client_id) { m_client_id = client_id; }
+            [[nodiscard]] IPAddress remoteIP() const { return m_remote; }
+
+            void setSyncAccessor(std::unique_ptr<TcpClientSyncAccessor> accessor) {
+                m_accessor = std::move(accessor);
+            }
+            void setWriter(std::unique_ptr<TcpWriter> writer) {
+                m_writer = std::move(writer);
+            }
+            [[nodiscard]] TcpWriter *getWriter() const { return m_writer.get(); }
+
+            void setOnConnectedCallback(std::unique_ptr<EventBridge> bridge);
+            void setOnReceivedCallback(std::unique_ptr<EventBridge> bridge);
+            void setOnFinCallback(std::unique_ptr<EventBridge> bridge);
+            void setOnPollCallback(std::unique_ptr<EventBridge> bridge);
+            void setOnAckCallback(std::unique_ptr<EventBridge> bridge);
+            void setOnErrorCallback(std::unique_ptr<EventBridge> bridge);
+
+            void keepAlive() {}
+            void setNoDelay(bool no_delay);
+
+            /**
+             * @brief Closes the connection with a FIN.
+             */
+            void shutdown();
+
+            /**
+             * @brief Closes the connection with a RST; no error callback.
+             */
+            void abort();
+
+            void stop() { shutdown(); }
+
+            /**
+             * @brief Drops data not yet accepted by the kernel; host only.
+             */
+            void discardUnsent();
+    };
+
+} // namespace async_tcp
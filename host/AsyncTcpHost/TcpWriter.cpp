@@ -0,0 +1,47 @@
+/**
+ * @file TcpWriter.cpp
+ * @brief Host implementation of the async-tcp TcpWriter.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#include "TcpWriter.hpp"
+#include "Arduino.h"
+#include "TcpClient.hpp"
+
+namespace async_tcp {
+
+    void TcpWriter::onWrite(const std::size_t bytes) {
+        if (m_in_flight == 0) {
+            m_since_us = time_us_32();
+        }
+        m_in_flight += static_cast<uint32_t>(bytes);
+    }
+
+    void TcpWriter::onAckReceived(const uint16_t length) {
+        m_in_flight = length >= m_in_flight ? 0 : m_in_flight - length;
+        m_since_us = time_us_32();
+    }
+
+    void TcpWriter::onError([[maybe_unused]] const err_t error) {
+        DEBUGWIRE("[TcpWriter][:i%d] error %d, %lu bytes dropped\n",
+                  m_client.getClientId(), static_cast<int>(error),
+                  static_cast<unsigned long>(m_in_flight));
+        m_in_flight = 0;
+    }
+
+    bool TcpWriter::hasTimedOut() const {
+        return m_in_flight > 0 && time_us_32() - m_since_us >= m_timeout_us;
+    }
+
+    void TcpWriter::onWriteTimeout() {
+        DEBUGWIRE("[TcpWriter][:i%d] write timed out, %lu bytes dropped\n",
+                  m_client.getClientId(),
+                  static_cast<unsigned long>(m_in_flight));
+        m_client.discardUnsent();
+        m_in_flight = 0;
+    }
+
+} // namespace async_tcp
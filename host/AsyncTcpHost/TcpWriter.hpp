@@ -0,0 +1,48 @@
+/**
+ * @file TcpWriter.hpp
+ * @brief Host implementation of the async-tcp TcpWriter.
+ *
+ * On the device the writer splits writes into chunks paced by lwIP's ACKs.
+ * The host client hands whole writes to the kernel, so the writer only
+ * keeps the bookkeeping the handlers use: bytes in flight and how long the
+ * oldest of them has waited for an ACK. An "ACK" is the kernel accepting
+ * the bytes.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ContextManager.hpp"
+#include "lwip/err.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace async_tcp {
+
+    class TcpClient;
+
+    class TcpWriter {
+            TcpClient &m_client;
+            uint32_t m_in_flight = 0;
+            uint32_t m_since_us = 0; ///< Oldest unacknowledged write
+            uint32_t m_timeout_us = 5000000;
+
+        public:
+            TcpWriter(const AsyncCtx &, TcpClient &client)
+                : m_client(client) {}
+
+            /**
+             * @brief Records a write handed to the client; host only.
+             */
+            void onWrite(std::size_t bytes);
+
+            void onAckReceived(uint16_t length);
+            void onError(err_t error);
+            [[nodiscard]] bool hasTimedOut() const;
+            void onWriteTimeout();
+    };
+
+} // namespace async_tcp
@@ -0,0 +1,17 @@
+/**
+ * @file sync.h
+ * @brief pico SDK event and barrier instructions for the host build.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+inline void __sev() {}
+inline void __wfe() { std::this_thread::yield(); }
+inline void __dmb() { std::atomic_thread_fence(std::memory_order_seq_cst); }
@@ -0,0 +1,20 @@
+/**
+ * @file memp.h
+ * @brief lwIP memory pool identifiers for the host build.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "lwip/opt.h"
+
+typedef enum {
+    MEMP_TCP_PCB,
+    MEMP_TCP_SEG,
+    MEMP_PBUF,
+    MEMP_PBUF_POOL,
+    MEMP_MAX
+} memp_t;
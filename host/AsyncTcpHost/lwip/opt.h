@@ -0,0 +1,17 @@
+/**
+ * @file opt.h
+ * @brief lwIP options the application reads, for the host build.
+ *
+ * The host has no lwIP: statistics are off and the PCB pool size is only
+ * used to bound the census walk.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#define LWIP_STATS 0
+#define MEMP_STATS 0
+#define MEMP_NUM_TCP_PCB 5
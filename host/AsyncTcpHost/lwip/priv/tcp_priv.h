@@ -0,0 +1,15 @@
+/**
+ * @file tcp_priv.h
+ * @brief lwIP's PCB lists for the host build; always empty.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "lwip/tcp.h"
+
+extern struct tcp_pcb *tcp_active_pcbs;
+extern struct tcp_pcb *tcp_tw_pcbs;
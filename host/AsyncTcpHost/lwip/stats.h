@@ -0,0 +1,12 @@
+/**
+ * @file stats.h
+ * @brief lwIP statistics for the host build: disabled.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "lwip/opt.h"
@@ -0,0 +1,19 @@
+/**
+ * @file tcp.h
+ * @brief The lwIP PCB fields the application reads, for the host build.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "lwip/err.h"
+#include "lwip/opt.h"
+#include "lwip/tcpbase.h"
+
+struct tcp_pcb {
+        struct tcp_pcb *next;
+        enum tcp_state state;
+};
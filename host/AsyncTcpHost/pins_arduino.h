@@ -0,0 +1,12 @@
+/**
+ * @file pins_arduino.h
+ * @brief Board pin definitions for the host build.
+ *
+ * @author Goran
+ * @date 2025-09-26
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "Arduino.h"
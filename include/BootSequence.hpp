@@ -0,0 +1,174 @@
+/**
+ * @file BootSequence.hpp
+ * @brief Non-blocking WiFi and DNS startup with per-phase timings.
+ *
+ * This file contains the BootSequence class which brings up the WiFi link
+ * and resolves every registered endpoint without blocking the loop. Lookups
+ * for all endpoints run concurrently once the link is up, and addresses
+ * cached in flash by DnsCache are applied immediately so a warm reboot does
+ * not wait for DNS at all. Each boot phase is timestamped so that the time to
+ * the first quote can be reported.
+ *
+ * @author Goran
+ * @date 2025-09-20
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "DnsCache.hpp"
+#include "EndpointSelector.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <lwip/ip_addr.h>
+
+namespace e5 {
+
+    /**
+     * @brief Timestamped boot phases, in the order they usually complete.
+     */
+    enum class BootPhase : uint8_t {
+        CTX0,          ///< Core 0 context and clients set up
+        CTX1,          ///< Core 1 context set up
+        LINK,          ///< WiFi associated with an IP address
+        READY,         ///< Every service has an address; may connect
+        FIRST_CONNECT, ///< First QOTD connection attempt started
+        DNS,           ///< Every lookup answered, failed or timed out
+        FIRST_QUOTE,   ///< First QOTD cycle completed
+        COUNT
+    };
+
+    /**
+     * @class BootSequence
+     * @brief Drives link bring-up and concurrent DNS from the loop.
+     *
+     * begin() starts the WiFi association without waiting for it and applies
+     * cached addresses to the registered EndpointSelectors. poll() watches
+     * the link and, once it is up, issues one asynchronous lwIP lookup per
+     * endpoint; lookups the resolver cannot take yet are retried on the next
+     * poll. Answers update the selector and the cache, so an address that
+     * changed since the last boot is corrected even when the cached one was
+     * already used.
+     *
+     * The lookup callbacks run in lwIP's context and only write their own
+     * slot; everything else is used from the loop on core 0. mark() may be
+     * called from either core, each phase from one core only.
+     */
+    class BootSequence {
+        public:
+            static constexpr std::size_t MAX_SERVICES = 2;
+            static constexpr std::size_t MAX_LOOKUPS =
+                MAX_SERVICES * MAX_ENDPOINTS;
+            /// The loop no longer sleeps while booting; pace link checks
+            static constexpr uint32_t LINK_CHECK_US = 250;
+
+        private:
+            enum class LookupState : uint8_t {
+                QUEUED,    ///< Not yet accepted by the resolver
+                IN_FLIGHT, ///< Waiting for the callback
+                ANSWERED,  ///< address is valid
+                FAILED,
+                DONE,      ///< Answer or failure accounted for
+            };
+
+            struct Lookup {
+                    EndpointSelector *selector = nullptr;
+                    EndpointSelector::Index index = 0;
+                    volatile LookupState state = LookupState::QUEUED;
+                    volatile uint32_t address = 0;
+            };
+
+            DnsCache &m_cache;
+            const char *m_ssid;
+            const char *m_password;
+            uint32_t m_link_timeout_us = 20000000;
+            uint32_t m_dns_timeout_us = 5000000;
+
+            EndpointSelector *m_services[MAX_SERVICES] = {};
+            std::size_t m_service_count = 0;
+            Lookup m_lookups[MAX_LOOKUPS];
+            std::size_t m_lookup_count = 0;
+
+            volatile uint32_t m_phase_us[static_cast<std::size_t>(
+                BootPhase::COUNT)] = {};
+            uint32_t m_started_us = 0;
+            uint32_t m_link_checked_us = 0;
+            bool m_link_failed = false;
+
+            uint8_t m_cached = 0;   ///< Endpoints addressed from the cache
+            uint8_t m_resolved = 0; ///< Lookups answered
+            uint8_t m_failed = 0;   ///< Lookups failed or timed out
+            uint8_t m_changed = 0;  ///< Answers that differed from the cache
+
+            static void onFound(const char *name, const ip_addr_t *address,
+                                void *arg);
+            void issueLookups();
+            void collectLookups();
+            [[nodiscard]] bool servicesAddressed() const;
+
+        public:
+            /**
+             * @brief Constructs a BootSequence.
+             *
+             * @param cache Flash cache of resolved addresses
+             * @param ssid WiFi network name
+             * @param password WiFi passphrase
+             */
+            BootSequence(DnsCache &cache, const char *ssid,
+                         const char *password)
+                : m_cache(cache), m_ssid(ssid), m_password(password) {}
+
+            /**
+             * @brief Registers a service whose endpoints must be resolved.
+             *
+             * Call before begin(), after the endpoints have been added.
+             *
+             * @return false when MAX_SERVICES are already registered
+             */
+            bool addService(EndpointSelector &selector);
+
+            /**
+             * @brief Starts the WiFi association and applies cached
+             * addresses. Returns immediately.
+             */
+            void begin();
+
+            /**
+             * @brief Advances link and DNS; call on every loop pass.
+             */
+            void poll();
+
+            /**
+             * @brief Records the time of @p phase, once.
+             */
+            void mark(BootPhase phase);
+
+            /**
+             * @brief Sets how long to wait for the link and for DNS.
+             */
+            void setTimeouts(uint32_t link_timeout_us,
+                             uint32_t dns_timeout_us);
+
+            [[nodiscard]] bool reached(const BootPhase phase) const {
+                return m_phase_us[static_cast<std::size_t>(phase)] != 0;
+            }
+            /**
+             * @brief Time of @p phase in ms since reset, 0 if not reached.
+             */
+            [[nodiscard]] uint32_t phaseMs(const BootPhase phase) const {
+                return m_phase_us[static_cast<std::size_t>(phase)] / 1000;
+            }
+            [[nodiscard]] uint32_t phaseUs(const BootPhase phase) const {
+                return m_phase_us[static_cast<std::size_t>(phase)];
+            }
+            [[nodiscard]] bool ready() const {
+                return reached(BootPhase::READY);
+            }
+            [[nodiscard]] bool linkFailed() const { return m_link_failed; }
+            [[nodiscard]] uint8_t cached() const { return m_cached; }
+            [[nodiscard]] uint8_t resolved() const { return m_resolved; }
+            [[nodiscard]] uint8_t failed() const { return m_failed; }
+            [[nodiscard]] uint8_t changed() const { return m_changed; }
+    };
+
+} // namespace e5
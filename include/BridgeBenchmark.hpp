@@ -0,0 +1,187 @@
+/**
+ * @file BridgeBenchmark.hpp
+ * @brief Latency and rate of the cross-context hand-off primitives.
+ *
+ * This file contains the BridgeBenchmark class which measures, for the three
+ * bridge types the application builds on and an atomic mailbox as a
+ * reference, how long a message without data takes to reach the other side
+ * (one way), to be acknowledged back (round trip), and how many messages per
+ * second get through when sent back to back:
+ *
+ * - sync: SyncBridge::execute(), blocking, as QuoteBuffer uses it
+ * - ephemeral: a self-owning EphemeralBridge per message, as PrintHandler
+ * - perpetual: one PerpetualBridge run() again and again, as the
+ *   connection bridges and PriorityDispatcher
+ * - mailbox: a sequence number in an atomic, polled by the target core's
+ *   loop
+ *
+ * Each runs from the target context's own core and from the other core;
+ * cross-core, also with the target core busy-looping in its loop and with
+ * its context inside a long handler.
+ *
+ * @author Goran
+ * @date 2025-09-30
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ContextManager.hpp"
+#include "PerpetualBridge.hpp"
+#include "SerialPrinter.hpp"
+#include "SyncBridge.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace e5 {
+
+    using namespace async_tcp;
+
+    /**
+     * @brief What the target core is doing while messages are sent to it.
+     */
+    enum class TargetLoad : uint8_t {
+        IDLE,        ///< Loop polling, context idle
+        BUSY_LOOP,   ///< Loop spinning BUSY_SPIN_US between polls
+        LONG_HANDLER ///< Context running LONG_HANDLER_US handlers back to back
+    };
+
+    /**
+     * @brief Figures of one primitive, placement and target load.
+     */
+    struct BridgeStats {
+            uint32_t messages = 0;
+            uint32_t round_trip_ns = 0;     ///< Mean
+            uint32_t round_trip_max_ns = 0;
+            uint32_t one_way_ns = 0;        ///< Mean, from a 1 us clock
+            uint32_t rate_per_s = 0;        ///< Messages handled per second
+            uint32_t delivered = 0;         ///< Of the rate run's messages
+            uint32_t timeouts = 0;
+    };
+
+    /**
+     * @class BridgeBenchmark
+     * @brief Sends empty messages to a target context and times them.
+     *
+     * The target side is a probe that stamps the arrival time and counts the
+     * message; the sender spins on the count. Round trips and rates are
+     * timed with the sender's cycle counter, one-way latency with
+     * time_us_32(), which both cores share. A perpetual bridge that is run
+     * while still queued runs once, so its rate run delivers fewer messages
+     * than were sent.
+     *
+     * serve() must be called from the target core's loop for the mailbox
+     * and for the BUSY_LOOP and LONG_HANDLER loads. On the device the
+     * context's work runs in an interrupt and preempts the loop, so a busy
+     * loop delays only the mailbox and a long handler delays everything; on
+     * the host each context has its own thread and the loads mostly compete
+     * for the CPU.
+     */
+    class BridgeBenchmark {
+        public:
+            static constexpr uint32_t BUSY_SPIN_US = 1000;
+            static constexpr uint32_t LONG_HANDLER_US = 500;
+            static constexpr uint32_t RATE_MESSAGES = 256;
+            static constexpr uint32_t TIMEOUT_US = 100000; ///< Per message
+
+            /**
+             * @brief Arrival side shared by all primitives.
+             *
+             * Written only on the target core, by one primitive at a time.
+             */
+            struct Probe {
+                    std::atomic<uint32_t> delivered{0};
+                    std::atomic<uint32_t> arrived_us{0};
+
+                    void arrive();
+            };
+
+        private:
+            enum class Primitive : uint8_t { SYNC, EPHEMERAL, PERPETUAL, MAILBOX };
+
+            class SyncProbe final : public SyncBridge {
+                    Probe &m_probe;
+
+                protected:
+                    uint32_t onExecute(SyncPayloadPtr) override {
+                        m_probe.arrive();
+                        return 0;
+                    }
+
+                public:
+                    SyncProbe(const AsyncCtx &ctx, Probe &probe)
+                        : SyncBridge(ctx), m_probe(probe) {}
+                    void send() { execute(nullptr); } // No payload
+            };
+
+            class PerpetualProbe final : public PerpetualBridge {
+                    Probe &m_probe;
+
+                protected:
+                    void onWork() override { m_probe.arrive(); }
+
+                public:
+                    PerpetualProbe(const AsyncCtx &ctx, Probe &probe)
+                        : PerpetualBridge(ctx), m_probe(probe) {}
+            };
+
+            class LongHandler final : public PerpetualBridge {
+                    const std::atomic<TargetLoad> &m_load;
+
+                protected:
+                    void onWork() override;
+
+                public:
+                    LongHandler(const AsyncCtx &ctx,
+                                const std::atomic<TargetLoad> &load)
+                        : PerpetualBridge(ctx), m_load(load) {}
+            };
+
+            const AsyncCtx &m_ctx;
+            Probe m_probe;
+            SyncProbe m_sync;
+            PerpetualProbe m_perpetual;
+            LongHandler m_long_handler;
+            std::atomic<TargetLoad> m_load{TargetLoad::IDLE};
+            std::atomic<uint32_t> m_mail_sent{0};  ///< Written by the sender
+            std::atomic<uint32_t> m_mail_seen{0};  ///< Written by serve()
+
+            [[nodiscard]] bool await(uint32_t delivered) const;
+            void send(Primitive primitive);
+            BridgeStats measure(Primitive primitive, uint32_t messages);
+
+        public:
+            explicit BridgeBenchmark(const AsyncCtx &ctx);
+            BridgeBenchmark(const BridgeBenchmark &) = delete;
+            BridgeBenchmark &operator=(const BridgeBenchmark &) = delete;
+
+            /**
+             * @brief Initialises the bridges; call once the context is up.
+             */
+            void begin();
+
+            /**
+             * @brief Target side; call on every pass of the target core's
+             * loop.
+             */
+            void serve();
+
+            /**
+             * @brief Runs every case for one placement and prints a
+             * `[BRIDGE]` JSON line per case.
+             *
+             * Call from thread-mode code: with @p cross_core false on the
+             * target context's core, e.g. from setup1(), otherwise on the
+             * other core while the target core's loop calls serve(). The
+             * mailbox and the target loads are only measured cross-core.
+             *
+             * @param printer Printer for the results
+             * @param cross_core Whether the caller is on the other core
+             * @param messages Messages per round-trip run
+             */
+            void run(const SerialPrinter &printer, bool cross_core,
+                     uint32_t messages);
+    };
+
+} // namespace e5
@@ -0,0 +1,83 @@
+/**
+ * @file ClosePolicy.hpp
+ * @brief How a connection is closed, and a census of lwIP's TCP PCBs.
+ *
+ * This file contains the CloseStrategy options, closeClient() which applies
+ * one to a TcpClient, and takePcbCensus() which counts the PCBs lwIP holds
+ * by state. A graceful close keeps the PCB until the FIN handshake is over,
+ * and for TIME_WAIT after that when this side closed first; at high cycle
+ * rates those PCBs can use up lwIP's pool, so per-cycle protocols may close
+ * abortively instead.
+ *
+ * @author Goran
+ * @date 2025-09-24
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "TcpClient.hpp"
+#include <cstdint>
+
+namespace e5 {
+
+    using namespace async_tcp;
+
+    /**
+     * @brief Close strategy of a connection, set per protocol.
+     */
+    enum class CloseStrategy : uint8_t {
+        GRACEFUL,          ///< shutdown(): FIN handshake, PCB may linger
+        ABORT_AFTER_DRAIN, ///< abort(): RST, PCB freed at once
+        REUSE_AWARE,       ///< GRACEFUL while PCBs are spare, else abort
+    };
+
+    /**
+     * @brief Short strategy name for reports.
+     */
+    const char *closeStrategyName(CloseStrategy strategy);
+
+    /**
+     * @brief PCBs lwIP holds, by state.
+     */
+    struct PcbCensus {
+            uint16_t active = 0;    ///< On the active list, any state
+            uint16_t closing = 0;   ///< Active, in FIN_WAIT to LAST_ACK
+            uint16_t time_wait = 0; ///< On the TIME_WAIT list
+            uint16_t capacity = 0;  ///< MEMP_NUM_TCP_PCB
+
+            [[nodiscard]] uint16_t spare() const {
+                const uint16_t used = active + time_wait;
+                return used < capacity ? capacity - used : 0;
+            }
+    };
+
+    /**
+     * @brief PCBs REUSE_AWARE keeps spare for the next connect.
+     */
+    constexpr uint16_t REUSE_SPARE_PCBS = 1;
+
+    /**
+     * @brief Counts the PCBs on lwIP's active and TIME_WAIT lists.
+     *
+     * Call on core 0, from the loop or a ctx0 handler, where lwIP runs. The
+     * lists are read without lwIP's lock; PCBs are pool memory, so a walk
+     * that races a state change stays inside the pool, is bounded by the
+     * pool size and is at most one PCB off.
+     */
+    PcbCensus takePcbCensus();
+
+    /**
+     * @brief Closes @p client with @p strategy.
+     *
+     * Must be called where TcpClient::shutdown() may be: on the connection's
+     * context or the loop of the same core. An abortive close should only
+     * follow a full drain of the RX data; the caller is responsible for
+     * that. abort() detaches the client's callbacks first, so it is not
+     * reported back as an error event.
+     *
+     * @return true if the connection was aborted
+     */
+    bool closeClient(TcpClient &client, CloseStrategy strategy);
+
+} // namespace e5
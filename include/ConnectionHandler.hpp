@@ -0,0 +1,172 @@
+/**
+ * @file ConnectionHandler.hpp
+ * @brief Connection-generic event handler and its per-connection bridge.
+ *
+ * This file contains the ConnectionHandler base class and the
+ * ConnectionBridge that binds it to a single TcpClient. A ConnectionHandler
+ * holds no per-connection state; everything it needs is looked up in a
+ * ConnectionTable by slot. One handler object per event type can therefore
+ * serve any number of connections.
+ *
+ * TcpClient takes unique ownership of each callback bridge and the lwIP
+ * payloads carry no client identity, so every connection still needs its own
+ * bridge. ConnectionBridge is that minimal per-connection part: the bridge
+ * base, a handler reference and a one-byte slot.
+ *
+ * When a PriorityDispatcher is attached to a handler, its bridges do not run
+ * the handler directly; they post themselves to the dispatcher in the
+ * handler's priority class.
+ *
+ * @author Goran
+ * @date 2025-09-04
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ConnectionTable.hpp"
+#include "ContextManager.hpp"
+#include "PerpetualBridge.hpp"
+#include "PriorityDispatcher.hpp"
+#include <memory>
+
+namespace e5 {
+
+    using namespace async_tcp;
+
+    /**
+     * @class ConnectionHandler
+     * @brief Base class for handlers shared across connections.
+     *
+     * Derived classes implement onWork() for a given slot and, where the
+     * lwIP callback delivers a payload, workload() to copy it into the
+     * ConnectionTable.
+     */
+    class ConnectionHandler {
+        protected:
+            ConnectionTable &m_table; ///< Shared per-connection state
+            WorkPriority m_priority; ///< Class used with a dispatcher
+            PriorityDispatcher *m_dispatcher = nullptr; ///< Optional dispatcher
+
+        public:
+            /**
+             * @brief Constructs a ConnectionHandler.
+             *
+             * @param table Table holding the per-connection state
+             * @param priority Priority class used when a dispatcher is set
+             */
+            explicit ConnectionHandler(
+                ConnectionTable &table,
+                const WorkPriority priority = WorkPriority::NETWORK_CRITICAL)
+                : m_table(table), m_priority(priority) {}
+
+            virtual ~ConnectionHandler() = default;
+
+            /**
+             * @brief Handles the event for the connection in @p slot.
+             *
+             * Executed on the context the connection's bridge was created
+             * for.
+             */
+            virtual void onWork(ConnectionTable::Slot slot) = 0;
+
+            /**
+             * @brief Accepts the bridge payload for the connection in @p slot.
+             *
+             * Handlers take ownership of @p data and must free it after
+             * copying, as described in the bridge payload contract.
+             */
+            virtual void workload(ConnectionTable::Slot /*slot*/,
+                                  void * /*data*/) {}
+
+            /**
+             * @brief Whether the last onWork() for @p slot left work pending.
+             *
+             * When true, the bridge reschedules the handler behind other
+             * pending work on the context (see ResumableHandler).
+             */
+            [[nodiscard]] virtual bool
+            hasMoreWork(ConnectionTable::Slot /*slot*/) const {
+                return false;
+            }
+
+            /**
+             * @brief Creates the per-connection bridge for @p io.
+             *
+             * The client is attached to the table (keyed by its client ID)
+             * and the returned bridge is already initialised, ready to be
+             * passed to one of the TcpClient::setOn...Callback() methods.
+             *
+             * @param ctx Context that will execute the handler
+             * @param io Client whose events the bridge forwards
+             * @return Initialised bridge, or nullptr when the table is full
+             */
+            std::unique_ptr<PerpetualBridge> bridge(const AsyncCtx &ctx,
+                                                    TcpClient &io);
+
+            /**
+             * @brief Routes this handler's events through @p dispatcher.
+             *
+             * The dispatcher must run on the same context as the handler's
+             * bridges. Pass nullptr to run handlers directly again.
+             */
+            void setDispatcher(PriorityDispatcher *dispatcher) {
+                m_dispatcher = dispatcher;
+            }
+
+            [[nodiscard]] PriorityDispatcher *dispatcher() const {
+                return m_dispatcher;
+            }
+
+            [[nodiscard]] WorkPriority priority() const { return m_priority; }
+    };
+
+    /**
+     * @class ConnectionBridge
+     * @brief Per-connection PerpetualBridge forwarding to a shared handler.
+     */
+    class ConnectionBridge final : public PerpetualBridge,
+                                   public PrioritizedWork {
+            ConnectionHandler &m_handler; ///< Shared handler for this event
+            ConnectionTable::Slot m_slot; ///< Connection slot in the table
+
+            bool post() {
+                auto *dispatcher = m_handler.dispatcher();
+                return dispatcher &&
+                       dispatcher->post(*this, m_handler.priority());
+            }
+
+            void runHandler() {
+                m_handler.onWork(m_slot);
+                if (m_handler.hasMoreWork(m_slot) && !post()) {
+                    run(); // re-arm behind the context's other workers
+                }
+            }
+
+        protected:
+            void onWork() override {
+                if (!post()) {
+                    runHandler();
+                }
+            }
+
+        public:
+            /**
+             * @brief Constructs a ConnectionBridge.
+             *
+             * @param ctx Context that will execute the handler
+             * @param handler Shared handler for the event type
+             * @param slot Connection slot in the handler's table
+             */
+            ConnectionBridge(const AsyncCtx &ctx, ConnectionHandler &handler,
+                             const ConnectionTable::Slot slot)
+                : PerpetualBridge(ctx), m_handler(handler), m_slot(slot) {}
+
+            void workload(void *data) override {
+                m_handler.workload(m_slot, data);
+            }
+
+            void runPrioritized() override { runHandler(); }
+    };
+
+} // namespace e5
@@ -0,0 +1,242 @@
+/**
+ * @file ConnectionManager.hpp
+ * @brief Per-client connection state machine with reconnect backoff.
+ *
+ * This file contains the ConnectionManager class which owns the connection
+ * lifecycle of one TcpClient: when to connect, when the connection is ready
+ * for writes, how long a cycle may take and when to try again after a
+ * failure. Application code asks the manager for a cycle or hands it data to
+ * write instead of calling TcpClient::connect() and TcpClient::write()
+ * directly.
+ *
+ * @author Goran
+ * @date 2025-09-12
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ConnectionTable.hpp"
+#include "TcpClient.hpp"
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace e5 {
+
+    using namespace async_tcp;
+
+    /**
+     * @brief How a managed connection is used.
+     */
+    enum class ConnectionMode : uint8_t {
+        PERSISTENT, ///< Connected at startup, reconnected whenever it drops
+        PER_CYCLE,  ///< One connection per requested cycle, closed by the peer
+    };
+
+    /**
+     * @brief Lifecycle state of a managed connection.
+     */
+    enum class ConnectionState : uint8_t {
+        IDLE,        ///< Not connected, ready to connect
+        CONNECTING,  ///< connect() issued, waiting for the connected event
+        ESTABLISHED, ///< Connected; queued writes are flushed
+        BACKOFF,     ///< Waiting before the next attempt
+    };
+
+    /**
+     * @class ConnectionManager
+     * @brief Drives one TcpClient through connect, use, close and retry.
+     *
+     * Handlers on the connection's context report connected, FIN and error
+     * events through the ConnectionTable event counters; poll() is called
+     * from the loop on the same core, compares the counters with the values
+     * it last saw and advances the state machine. The counters have a single
+     * writer each, so no locking is needed.
+     *
+     * - Writes issued before the connection is ESTABLISHED are queued (up to
+     *   WRITE_QUEUE_CAPACITY messages, oldest dropped first) and flushed once
+     *   the connected event is seen. A flushed write the client rejects is
+     *   dropped too; droppedWrites() counts both.
+     * - After an error, a FIN on a PERSISTENT connection or a connect
+     *   timeout, the next attempt waits for a jittered exponential backoff:
+     *   a random delay between half and all of base * 2^failures, capped.
+     * - A PER_CYCLE connection that has not closed by its cycle deadline is
+     *   shut down and counted as failed.
+     *
+     * All methods except the statistics accessors must be called on the
+     * core that runs the loop for this connection.
+     */
+    class ConnectionManager {
+        public:
+            static constexpr std::size_t WRITE_QUEUE_CAPACITY = 4;
+
+        private:
+            ConnectionTable &m_table;
+            TcpClient &m_client;
+            IPAddress m_address;
+            uint16_t m_port;
+            ConnectionMode m_mode;
+            ConnectionTable::Slot m_slot = ConnectionTable::NO_SLOT;
+
+            ConnectionState m_state = ConnectionState::IDLE;
+            uint32_t m_state_since_us = 0; ///< Entry time of the current state
+            uint32_t m_attempt_us = 0;     ///< Start of the current attempt
+            uint32_t m_backoff_us = 0;     ///< Length of the current backoff
+            uint8_t m_failures = 0;        ///< Consecutive failed attempts
+
+            uint16_t m_seen_connects = 0; ///< Last table counters seen
+            uint16_t m_seen_closes = 0;
+            uint16_t m_seen_errors = 0;
+
+            uint32_t m_backoff_base_us = 500000;
+            uint32_t m_backoff_max_us = 30000000;
+            uint32_t m_connect_timeout_us = 10000000;
+            uint32_t m_cycle_deadline_us = 5000000;
+
+            std::deque<std::string> m_write_queue; ///< Writes held until ready
+
+            uint32_t m_connects = 0;
+            uint32_t m_connect_latency_total_us = 0;
+            uint32_t m_connect_latency_max_us = 0;
+            uint32_t m_last_connect_us = 0;
+            uint32_t m_completed_cycles = 0;
+            uint32_t m_cycles = 0;
+            uint32_t m_failed_cycles = 0;   ///< PER_CYCLE only
+            uint32_t m_failed_attempts = 0; ///< Connect or connection failures
+            uint32_t m_wasted_cycles = 0;
+            uint32_t m_abandoned_cycles = 0; ///< Given up by abandon()
+            uint32_t m_dropped_writes = 0;
+
+            void enter(ConnectionState state, uint32_t now_us);
+            bool connect(uint32_t now_us);
+            void backoff(uint32_t now_us);
+            void fail(const char *reason, uint32_t now_us);
+            void onClosed(uint32_t now_us);
+            void flush();
+            bool syncEvents(bool &connected, bool &closed, bool &errored);
+
+        public:
+            /**
+             * @brief Constructs a ConnectionManager.
+             *
+             * @param table Table the connection's handlers report events to
+             * @param client Client to manage; its ID must be set and its
+             * bridges created before start()
+             * @param address Remote address
+             * @param port Remote port
+             * @param mode PERSISTENT or PER_CYCLE
+             */
+            ConnectionManager(ConnectionTable &table, TcpClient &client,
+                              const IPAddress &address, uint16_t port,
+                              ConnectionMode mode);
+
+            /**
+             * @brief Resolves the client's table slot.
+             *
+             * A PERSISTENT connection connects on the first poll(), so the
+             * loop decides when the handlers may start running.
+             */
+            void start();
+
+            /**
+             * @brief Advances the state machine; call on every loop pass.
+             */
+            void poll();
+
+            /**
+             * @brief Starts a PER_CYCLE connection if the previous one is
+             * done.
+             *
+             * @return true if a connection attempt was started; false if the
+             * cycle was wasted (previous cycle still running or backing off)
+             */
+            bool requestCycle();
+
+            /**
+             * @brief Writes @p data now if the connection is ESTABLISHED,
+             * otherwise queues it until it is.
+             */
+            void write(std::string data);
+
+            /**
+             * @brief Abandons the current attempt without counting a failure.
+             *
+             * The connection is muted in the table so that data still in
+             * flight is dropped, shut down, and the manager returns to IDLE.
+             * Used for the loser of an endpoint race.
+             */
+            void abandon();
+
+            /**
+             * @brief Updates the endpoint used by subsequent attempts.
+             */
+            void setEndpoint(const IPAddress &address, const uint16_t port) {
+                m_address = address;
+                m_port = port;
+            }
+
+            /**
+             * @brief Sets the backoff range.
+             */
+            void setBackoff(uint32_t base_us, uint32_t max_us);
+
+            /**
+             * @brief Sets the connect timeout and the PER_CYCLE deadline.
+             */
+            void setDeadlines(uint32_t connect_timeout_us,
+                              uint32_t cycle_deadline_us);
+
+            [[nodiscard]] ConnectionState state() const { return m_state; }
+            [[nodiscard]] bool ready() const {
+                return m_state == ConnectionState::ESTABLISHED;
+            }
+
+            [[nodiscard]] uint32_t connects() const { return m_connects; }
+            /// Table slot of the client, NO_SLOT before start()
+            [[nodiscard]] ConnectionTable::Slot slot() const { return m_slot; }
+            [[nodiscard]] uint32_t connectLatencyAvgUs() const {
+                return m_connects ? m_connect_latency_total_us / m_connects : 0;
+            }
+            [[nodiscard]] uint32_t connectLatencyMaxUs() const {
+                return m_connect_latency_max_us;
+            }
+            [[nodiscard]] uint32_t lastConnectUs() const {
+                return m_last_connect_us;
+            }
+            /**
+             * @brief Cycles whose connection attempt started; each ends up
+             * completed, failed or abandoned.
+             */
+            [[nodiscard]] uint32_t cycles() const { return m_cycles; }
+            [[nodiscard]] uint32_t completedCycles() const {
+                return m_completed_cycles;
+            }
+            /**
+             * @brief Requested cycles that failed; always 0 for a
+             * PERSISTENT connection, which has no cycles.
+             */
+            [[nodiscard]] uint32_t failedCycles() const {
+                return m_failed_cycles;
+            }
+            /**
+             * @brief Failed connects and connections that ended in an
+             * error or timeout, in either mode.
+             */
+            [[nodiscard]] uint32_t failedAttempts() const {
+                return m_failed_attempts;
+            }
+            [[nodiscard]] uint32_t wastedCycles() const {
+                return m_wasted_cycles;
+            }
+            [[nodiscard]] uint32_t abandonedCycles() const {
+                return m_abandoned_cycles;
+            }
+            [[nodiscard]] uint32_t droppedWrites() const {
+                return m_dropped_writes;
+            }
+    };
+
+} // namespace e5
@@ -0,0 +1,386 @@
+/**
+ * @file ConnectionTable.hpp
+ * @brief Compact per-connection state table keyed by TcpClient ID.
+ *
+ * This file contains the ConnectionTable class which stores the state that
+ * connection handlers used to keep in their own members (RX buffer pointer,
+ * pending ACK length, last error and basic statistics). The state is laid out
+ * as a struct of arrays so that one handler object per event type can serve
+ * every connection by indexing the table with a small slot number.
+ *
+ * @author Goran
+ * @date 2025-09-04
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ClosePolicy.hpp"
+#include "IoRxBuffer.hpp"
+#include "TcpClient.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <lwip/err.h>
+
+namespace e5 {
+
+    using namespace async_tcp;
+
+    class CycleTimeline;
+    class WriteDeadline;
+
+    /**
+     * @brief Maximum number of connections tracked by a ConnectionTable.
+     */
+    constexpr std::size_t MAX_CONNECTIONS = 32;
+
+    /**
+     * @brief Distinct lwIP error codes counted per connection (ERR_OK to
+     * ERR_ARG, -16); anything beyond is counted as ERR_ARG.
+     */
+    constexpr std::size_t ERROR_CODES = 17;
+
+    /**
+     * @brief Copy of one connection's counters, see
+     * ConnectionTable::snapshot().
+     */
+    struct ConnectionStats {
+            int client_id = 0;
+            uint32_t rx_bytes = 0;
+            uint32_t rx_events = 0;   ///< Receive callbacks
+            uint32_t tx_bytes = 0;
+            uint32_t writes = 0;      ///< Successful write() calls
+            uint32_t acks = 0;        ///< ACK callbacks
+            uint32_t acked_bytes = 0;
+            uint32_t rtt_avg_us = 0;  ///< Write to first ACK, EWMA 1/8
+            uint16_t errors = 0;
+            uint16_t timeouts = 0;    ///< Poll and write deadline timeouts
+            uint16_t connects = 0;
+            uint16_t closes = 0;
+            uint16_t aborts = 0;      ///< Closes that aborted the PCB
+            uint8_t errors_by_code[ERROR_CODES] = {}; ///< Index is -err_t
+    };
+
+    /**
+     * @class ConnectionTable
+     * @brief Struct-of-arrays store for per-connection handler state.
+     *
+     * Each attached TcpClient is assigned a slot. The slot is resolved once
+     * from TcpClient::getClientId() when the connection's bridges are
+     * created, so the hot path indexes the columns directly and never
+     * searches.
+     *
+     * All columns of a slot are written from the context that owns the
+     * connection (lwIP callbacks and bridged handlers run on the same
+     * AsyncCtx), so no locking is required. The write counters are the
+     * exception: they are written by the loop, their only writer.
+     *
+     * Counters are aligned 32 and 16 bit words, so snapshot() can copy them
+     * from any core without a lock. Each counter is read atomically, but the
+     * snapshot as a whole is not: a counter may be one event ahead of
+     * another.
+     */
+    class ConnectionTable {
+        public:
+            using Slot = uint8_t;
+            static constexpr Slot NO_SLOT = 0xFF;
+
+        private:
+            std::size_t m_size = 0; ///< Number of attached connections
+
+            int m_client_id[MAX_CONNECTIONS] = {}; ///< Key column
+            TcpClient *m_client[MAX_CONNECTIONS] = {}; ///< Owning client
+            IoRxBuffer *m_rx_buffer[MAX_CONNECTIONS] = {}; ///< Last RX buffer
+            WriteDeadline *m_write_deadline[MAX_CONNECTIONS] = {}; ///< Optional
+            CycleTimeline *m_timeline[MAX_CONNECTIONS] = {}; ///< Optional
+            uint32_t m_pending_ack[MAX_CONNECTIONS] = {}; ///< ACKed bytes not
+                                                          ///< yet delivered
+            uint32_t m_ack_at_us[MAX_CONNECTIONS] = {}; ///< Arrival of the
+                                                        ///< oldest pending ACK
+            err_t m_last_error[MAX_CONNECTIONS] = {}; ///< Last lwIP error
+
+            uint32_t m_rx_bytes[MAX_CONNECTIONS] = {};    ///< Bytes received
+            uint32_t m_acked_bytes[MAX_CONNECTIONS] = {}; ///< Bytes ACKed
+            uint16_t m_errors[MAX_CONNECTIONS] = {};      ///< Error events
+            uint16_t m_connects[MAX_CONNECTIONS] = {};    ///< Connected events
+            uint16_t m_closes[MAX_CONNECTIONS] = {};      ///< Orderly closes
+            uint16_t m_timeouts[MAX_CONNECTIONS] = {};    ///< Poll timeouts
+            uint32_t m_rx_events[MAX_CONNECTIONS] = {};   ///< RX callbacks
+            uint32_t m_acks[MAX_CONNECTIONS] = {};        ///< ACK callbacks
+            uint32_t m_tx_bytes[MAX_CONNECTIONS] = {};    ///< Bytes written
+            uint32_t m_writes[MAX_CONNECTIONS] = {};      ///< write() calls
+            uint32_t m_write_at_us[MAX_CONNECTIONS] = {}; ///< Oldest write
+                                                          ///< awaiting an ACK
+            uint32_t m_rtt_us[MAX_CONNECTIONS] = {};      ///< RTT EWMA
+            uint8_t m_error_codes[MAX_CONNECTIONS]
+                                 [ERROR_CODES] = {}; ///< Saturating
+            bool m_muted[MAX_CONNECTIONS] = {}; ///< Discard received data
+            bool m_rx_started[MAX_CONNECTIONS] = {}; ///< First chunk handled
+            CloseStrategy m_close_strategy[MAX_CONNECTIONS] = {};
+            uint16_t m_aborts[MAX_CONNECTIONS] = {}; ///< Abortive closes
+
+        public:
+            ConnectionTable() = default;
+
+            /**
+             * @brief Attaches a client and returns its slot.
+             *
+             * The client is keyed by TcpClient::getClientId(), so the ID must
+             * be set before attaching. Attaching the same ID twice returns
+             * the existing slot.
+             *
+             * @param io TCP client to attach
+             * @return Slot index, or NO_SLOT when the table is full
+             */
+            Slot attach(TcpClient &io);
+
+            /**
+             * @brief Looks up the slot for a client ID.
+             *
+             * @param client_id ID as returned by TcpClient::getClientId()
+             * @return Slot index, or NO_SLOT if the ID is not attached
+             */
+            [[nodiscard]] Slot find(int client_id) const;
+
+            /**
+             * @brief Returns the number of attached connections.
+             */
+            [[nodiscard]] std::size_t size() const { return m_size; }
+
+            [[nodiscard]] TcpClient &client(const Slot slot) const {
+                return *m_client[slot];
+            }
+
+            [[nodiscard]] int clientId(const Slot slot) const {
+                return m_client_id[slot];
+            }
+
+            [[nodiscard]] IoRxBuffer *rxBuffer(const Slot slot) const {
+                return m_rx_buffer[slot];
+            }
+
+            void setRxBuffer(const Slot slot, IoRxBuffer *rx_buffer) {
+                m_rx_buffer[slot] = rx_buffer;
+            }
+
+            /**
+             * @brief Write timeout timer of the connection, if any.
+             *
+             * When set, ACK and error handlers keep it up to date and
+             * TcpPollHandler leaves timeout detection to it.
+             */
+            [[nodiscard]] WriteDeadline *writeDeadline(const Slot slot) const {
+                return m_write_deadline[slot];
+            }
+
+            void setWriteDeadline(const Slot slot, WriteDeadline *deadline) {
+                m_write_deadline[slot] = deadline;
+            }
+
+            /**
+             * @brief Cycle timeline the connection's handlers stamp, if any.
+             */
+            [[nodiscard]] CycleTimeline *timeline(const Slot slot) const {
+                return m_timeline[slot];
+            }
+
+            void setTimeline(const Slot slot, CycleTimeline *timeline) {
+                m_timeline[slot] = timeline;
+            }
+
+            /**
+             * @brief Accumulates an ACK length reported by lwIP.
+             *
+             * ACKs that arrive before the handler runs are summed rather than
+             * overwritten, so coalesced bridge runs do not lose bytes.
+             */
+            void addPendingAck(const Slot slot, const uint16_t len,
+                               const uint32_t now_us) {
+                if (m_pending_ack[slot] == 0) {
+                    m_ack_at_us[slot] = now_us;
+                }
+                m_pending_ack[slot] += len;
+                ++m_acks[slot];
+                if (const uint32_t write_at = m_write_at_us[slot]) {
+                    // First ACK after a write: one RTT sample
+                    const uint32_t sample = now_us - write_at;
+                    m_rtt_us[slot] = m_rtt_us[slot]
+                                         ? m_rtt_us[slot] -
+                                               m_rtt_us[slot] / 8 + sample / 8
+                                         : sample;
+                    m_write_at_us[slot] = 0;
+                }
+            }
+
+            /**
+             * @brief Arrival time of the oldest ACK not yet delivered.
+             */
+            [[nodiscard]] uint32_t pendingAckSince(const Slot slot) const {
+                return m_ack_at_us[slot];
+            }
+
+            /**
+             * @brief Returns and clears the accumulated ACK length.
+             */
+            uint32_t takePendingAck(const Slot slot) {
+                const uint32_t len = m_pending_ack[slot];
+                m_pending_ack[slot] = 0;
+                m_acked_bytes[slot] += len;
+                return len;
+            }
+
+            void setLastError(const Slot slot, const err_t error) {
+                m_last_error[slot] = error;
+                ++m_errors[slot];
+                const std::size_t code =
+                    error < 0 ? std::min<std::size_t>(-error, ERROR_CODES - 1)
+                              : 0;
+                if (m_error_codes[slot][code] < UINT8_MAX) {
+                    ++m_error_codes[slot][code];
+                }
+            }
+
+            [[nodiscard]] err_t lastError(const Slot slot) const {
+                return m_last_error[slot];
+            }
+
+            void addRxBytes(const Slot slot, const std::size_t bytes) {
+                m_rx_bytes[slot] += bytes;
+            }
+
+            void countRxEvent(const Slot slot) { ++m_rx_events[slot]; }
+
+            /**
+             * @brief Counts a successful write; called from the loop.
+             *
+             * Starts an RTT sample unless one is already running. The ACK
+             * side clears it with a single store, so the loop and the lwIP
+             * callback never update the same word with a read-modify-write.
+             */
+            void addWrite(const Slot slot, const std::size_t bytes,
+                          const uint32_t now_us) {
+                m_tx_bytes[slot] += bytes;
+                ++m_writes[slot];
+                if (m_write_at_us[slot] == 0) {
+                    m_write_at_us[slot] = now_us ? now_us : 1;
+                }
+            }
+
+            void countTimeout(const Slot slot) { ++m_timeouts[slot]; }
+
+            [[nodiscard]] uint32_t rxBytes(const Slot slot) const {
+                return m_rx_bytes[slot];
+            }
+
+            [[nodiscard]] uint32_t ackedBytes(const Slot slot) const {
+                return m_acked_bytes[slot];
+            }
+
+            [[nodiscard]] uint16_t errors(const Slot slot) const {
+                return m_errors[slot];
+            }
+
+            /**
+             * @brief Records that the connection reached ESTABLISHED.
+             *
+             * Event counters have a single writer (the handler on the
+             * connection's context); readers such as ConnectionManager keep
+             * the last value they saw and compare.
+             */
+            void markConnected(const Slot slot) { ++m_connects[slot]; }
+
+            [[nodiscard]] uint16_t connects(const Slot slot) const {
+                return m_connects[slot];
+            }
+
+            /**
+             * @brief Records that the connection was closed after a FIN.
+             */
+            void markClosed(const Slot slot) { ++m_closes[slot]; }
+
+            [[nodiscard]] uint16_t closes(const Slot slot) const {
+                return m_closes[slot];
+            }
+
+            /**
+             * @brief Marks a connection whose data must be discarded.
+             *
+             * Set by the loop for the loser of an endpoint race while it is
+             * being closed; receive and FIN handlers drop its data instead
+             * of delivering it.
+             */
+            void setMuted(const Slot slot, const bool muted) {
+                m_muted[slot] = muted;
+            }
+
+            [[nodiscard]] bool muted(const Slot slot) const {
+                return m_muted[slot];
+            }
+
+            /**
+             * @brief Marks whether the first chunk of the connection's
+             * message has been handled.
+             *
+             * Cleared by the loop before each connect; set by the receive
+             * handler, which starts the message on the first chunk and
+             * appends every later one.
+             */
+            void setRxStarted(const Slot slot, const bool started) {
+                m_rx_started[slot] = started;
+            }
+
+            [[nodiscard]] bool rxStarted(const Slot slot) const {
+                return m_rx_started[slot];
+            }
+
+            /**
+             * @brief Sets how close() ends the connection; GRACEFUL unless
+             * set.
+             */
+            void setCloseStrategy(const Slot slot,
+                                  const CloseStrategy strategy) {
+                m_close_strategy[slot] = strategy;
+            }
+
+            [[nodiscard]] CloseStrategy closeStrategy(const Slot slot) const {
+                return m_close_strategy[slot];
+            }
+
+            /**
+             * @brief Closes the connection with its close strategy.
+             *
+             * Called by the FIN handler once the RX data is drained, and by
+             * the connection manager when it gives a connection up; both run
+             * on the connection's core.
+             */
+            void close(const Slot slot) {
+                if (closeClient(*m_client[slot], m_close_strategy[slot]) &&
+                    m_aborts[slot] < UINT16_MAX) {
+                    ++m_aborts[slot];
+                }
+            }
+
+            /**
+             * @brief Copies the counters of a connection without locking.
+             *
+             * Timeouts include those detected by the connection's
+             * WriteDeadline, if it has one.
+             */
+            [[nodiscard]] ConnectionStats snapshot(Slot slot) const;
+
+            /**
+             * @brief Bytes of table storage used by one slot.
+             *
+             * Derived from the size of the whole table, so a new column is
+             * counted without editing this; the slot count and padding are
+             * shared out over the slots.
+             */
+            static constexpr std::size_t bytesPerSlot();
+    };
+
+    constexpr std::size_t ConnectionTable::bytesPerSlot() {
+        return sizeof(ConnectionTable) / MAX_CONNECTIONS;
+    }
+
+} // namespace e5
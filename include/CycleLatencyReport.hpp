@@ -0,0 +1,171 @@
+/**
+ * @file CycleLatencyReport.hpp
+ * @brief End-to-end QOTD cycle latency percentiles checked against budgets.
+ *
+ * This file contains the CycleLatencyReport class which accumulates finished
+ * CycleTimeline records over any number of cycles. Where the timeline keeps
+ * the last CAPACITY cycles, the report keeps a histogram per stage that is
+ * fine enough for p99.9 over tens of thousands of cycles. Latency budgets
+ * such as "cycle:p99=50000" are checked against it; the host driver turns a
+ * breach into its exit status and the board prints a verdict line.
+ *
+ * @author Goran
+ * @date 2025-09-29
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "CycleTimeline.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace e5 {
+
+    /**
+     * @class CycleLatencyReport
+     * @brief Per-stage latency distribution of finished cycles.
+     *
+     * Span 0 is the whole cycle, from CONNECT to PRINTED. Span i is stage i
+     * measured from stage i - 1, so the spans add up to the cycle and the
+     * largest shows where the time goes. A span is counted when both of its
+     * stages were reached. A span whose end was stamped before its start,
+     * which only the echo stages of different handlers can do, is counted
+     * as reversed rather than as a sample.
+     *
+     * A completed cycle whose echo write differs in length from the QOTD
+     * bytes received is a mismatch; it lost or duplicated part of the quote,
+     * and fails the run like a failed cycle.
+     *
+     * Histograms have SUB_BUCKETS linear buckets per power of two, so a
+     * percentile is within 1/SUB_BUCKETS of the true value, and are exact
+     * below SUB_BUCKETS us. Not thread-safe; add() and the readers belong to
+     * the loop that drives the cycles.
+     */
+    class CycleLatencyReport {
+        public:
+            static constexpr std::size_t SPANS =
+                static_cast<std::size_t>(CycleStage::COUNT);
+            static constexpr std::size_t MAX_BUDGETS = 8;
+            static constexpr uint32_t SUB_BUCKETS = 8;
+            static constexpr uint32_t MAX_US = (1u << 24) - 1; ///< About 16 s
+
+            /**
+             * @brief Upper bound of one span's percentile.
+             */
+            struct Budget {
+                    uint8_t span = 0;
+                    uint16_t per_mille = 0; ///< 500 = p50, 999 = p99.9
+                    uint32_t limit_us = 0;
+            };
+
+        private:
+            static constexpr uint32_t SUB_BITS = 3; // log2(SUB_BUCKETS)
+            static constexpr std::size_t BUCKETS =
+                SUB_BUCKETS + (24 - SUB_BITS) * SUB_BUCKETS;
+
+            struct Histogram {
+                    std::array<uint32_t, BUCKETS> buckets{};
+                    uint32_t count = 0;
+                    uint32_t reversed = 0; ///< End stamped before start
+                    uint32_t max_us = 0;
+                    uint64_t total_us = 0;
+            };
+
+            Histogram m_spans[SPANS];
+            Budget m_budgets[MAX_BUDGETS];
+            std::size_t m_budget_count = 0;
+            uint32_t m_cycles = 0;
+            uint32_t m_quotes = 0; ///< Cycles that reached COMPLETE
+            uint32_t m_mismatched = 0; ///< Echoes not the length of the quote
+
+            static std::size_t bucketOf(uint32_t us);
+            static uint32_t bucketUpperUs(std::size_t bucket);
+            static void add(Histogram &histogram, uint32_t us);
+
+        public:
+            /**
+             * @brief Counts a finished cycle.
+             */
+            void add(const CycleRecord &record);
+
+            /**
+             * @brief Whether @p record completed a quote and echoed a
+             * different number of bytes than it received.
+             */
+            static bool mismatched(const CycleRecord &record);
+
+            /**
+             * @brief Whether the loop can move on from @p record.
+             *
+             * That is once its echo has been printed, once the cycle has
+             * ended without a quote, or @p timeout_us after its connect.
+             *
+             * @param cycle_ended No cycle is in progress
+             */
+            static bool settled(const CycleRecord &record, bool cycle_ended,
+                                uint32_t timeout_us);
+
+            /**
+             * @brief Replaces the budgets with a comma-separated list.
+             *
+             * Each entry is "span:pNN=us", e.g. "cycle:p99=50000" or
+             * "printed:p99.9=2000", with spans named as by spanName().
+             *
+             * @return false, leaving no budgets, if an entry does not parse
+             * or there are more than MAX_BUDGETS
+             */
+            bool setBudgets(const char *spec);
+
+            /**
+             * @brief Percentile of a span in us, capped at its maximum.
+             *
+             * @param per_mille 500 for the median, 999 for p99.9
+             */
+            [[nodiscard]] uint32_t percentileUs(std::size_t span,
+                                                uint16_t per_mille) const;
+
+            /**
+             * @brief Mean of a span in us; 0 if it has no samples.
+             */
+            [[nodiscard]] uint32_t meanUs(std::size_t span) const;
+
+            /**
+             * @brief Budgets whose percentile is over the limit.
+             */
+            [[nodiscard]] std::size_t exceeded() const;
+
+            /**
+             * @brief Whether the run passes: at least one quote, none of
+             * @p failed_cycles, no echo mismatch and no budget exceeded.
+             *
+             * Callers use it for the exit status as well, so the verdict
+             * printed by report() matches it.
+             */
+            [[nodiscard]] bool passed(uint32_t failed_cycles) const;
+
+            /**
+             * @brief "[PIPELINE]" lines: counts, a row per span with
+             * p50/p99/p99.9, then one line per budget and the verdict of
+             * passed(@p failed_cycles).
+             */
+            [[nodiscard]] std::string report(uint32_t failed_cycles) const;
+
+            /**
+             * @brief "cycle" for span 0, else the name of its end stage.
+             */
+            static const char *spanName(std::size_t span);
+
+            [[nodiscard]] uint32_t cycles() const { return m_cycles; }
+            [[nodiscard]] uint32_t mismatches() const { return m_mismatched; }
+            [[nodiscard]] uint32_t printed() const {
+                return m_spans[0].count;
+            }
+            [[nodiscard]] std::size_t budgets() const {
+                return m_budget_count;
+            }
+    };
+
+} // namespace e5
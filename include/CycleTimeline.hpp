@@ -0,0 +1,207 @@
+/**
+ * @file CycleTimeline.hpp
+ * @brief Per-stage timestamps of the last QOTD cycles in a fixed ring.
+ *
+ * This file contains the CycleTimeline class which records, for every QOTD
+ * cycle, when it passed each stage from the connect() call to the echoed
+ * quote being printed, together with byte and chunk counts. The records live
+ * in a preallocated ring of the last CAPACITY cycles; per-stage latency
+ * percentiles are computed from the ring on the device, and the raw records
+ * can be dumped for offline analysis.
+ *
+ * @author Goran
+ * @date 2025-09-22
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace e5 {
+
+    /**
+     * @brief Stages of a QOTD cycle, in the order they are passed.
+     */
+    enum class CycleStage : uint8_t {
+        CONNECT,        ///< connect() issued for the cycle
+        CONNECTED,      ///< First connected handler of the cycle
+        FIRST_RX,       ///< First received chunk
+        LAST_CHUNK,     ///< Latest chunk received before FIN
+        FIN,            ///< FIN handler started
+        COMPLETE,       ///< QuoteBuffer::setComplete() returned, after the
+                        ///< FIN handler drained what was left
+        ECHO_WRITE,     ///< Quote handed to the echo connection
+        ECHO_ACK,       ///< Whole echo write ACKed
+        ECHO_LAST_BYTE, ///< Last echoed byte received
+        PRINTED,        ///< Last echoed byte printed on core 1
+        COUNT
+    };
+
+    /**
+     * @brief Short stage name for reports.
+     */
+    const char *stageName(CycleStage stage);
+
+    /**
+     * @brief Timestamps and counts of one cycle.
+     *
+     * Timestamps are time_us_32() values; 0 means the stage was not reached.
+     * The first CHUNK_STAMPS received chunks keep their own timestamp;
+     * FIRST_RX and LAST_CHUNK cover the first and latest of all of them.
+     */
+    struct CycleRecord {
+            static constexpr std::size_t CHUNK_STAMPS = 8;
+
+            uint32_t id = 0; ///< Cycle number, from 1
+            uint32_t stage_us[static_cast<std::size_t>(CycleStage::COUNT)] =
+                {};
+            uint32_t chunk_us[CHUNK_STAMPS] = {}; ///< Received chunks
+            uint16_t rx_bytes = 0;      ///< QOTD bytes received
+            uint16_t chunks = 0;        ///< Received and drained chunks
+            uint16_t rx_chunks = 0;     ///< Received chunks
+            uint16_t echo_bytes = 0;    ///< Bytes written to the echo server
+            uint16_t echo_acked = 0;    ///< Echo bytes ACKed
+            uint16_t echo_rx_bytes = 0; ///< Echoed bytes received
+
+            [[nodiscard]] uint32_t at(const CycleStage stage) const {
+                return stage_us[static_cast<std::size_t>(stage)];
+            }
+    };
+
+    /**
+     * @class CycleTimeline
+     * @brief Ring of the last CAPACITY cycle records.
+     *
+     * begin() is called from the loop when a cycle's connect() is issued and
+     * takes the oldest record. The QOTD stages are stamped on the current
+     * record by the QOTD handlers; the echo stages on the record whose quote
+     * was written to the echo connection first, so repeated echoes of the
+     * same quote are not counted again. Each stage is stamped once, by the
+     * first event that reaches it, except LAST_CHUNK.
+     *
+     * Writers are the loop and the handlers on core 0, and the print
+     * observer on core 1; each field has a single writer. Readers on either
+     * core may see a cycle in progress, which only shows as stages not yet
+     * reached.
+     */
+    class CycleTimeline {
+        public:
+            static constexpr std::size_t CAPACITY = 32;
+
+            /**
+             * @brief Latency between two stages over the records in the ring.
+             */
+            struct Latency {
+                    uint16_t count = 0; ///< Records that reached both stages
+                    uint32_t p50_us = 0;
+                    uint32_t p90_us = 0;
+                    uint32_t p99_us = 0;
+                    uint32_t max_us = 0;
+            };
+
+        private:
+            CycleRecord m_ring[CAPACITY];
+            std::atomic<uint32_t> m_cycles{0}; ///< Records started
+            std::atomic<int16_t> m_echo{-1};   ///< Record of the echo
+            std::atomic<const std::string *> m_watched_print{nullptr};
+
+            [[nodiscard]] CycleRecord *current();
+            [[nodiscard]] CycleRecord *echo();
+            static void stamp(CycleRecord &record, CycleStage stage);
+
+        public:
+            CycleTimeline() = default;
+            CycleTimeline(const CycleTimeline &) = delete;
+            CycleTimeline &operator=(const CycleTimeline &) = delete;
+
+            /**
+             * @brief Starts a new record and stamps CONNECT.
+             *
+             * @return Cycle number of the record
+             */
+            uint32_t begin();
+
+            /**
+             * @brief Withdraws the record of the last begin(), for a cycle
+             * that did not start after all.
+             *
+             * Lets the loop call begin() before connect(), which on a
+             * preemptive host may otherwise run the whole cycle before the
+             * record exists.
+             */
+            void discard();
+
+            /**
+             * @brief Stamps @p stage on the current record, once.
+             */
+            void mark(CycleStage stage);
+
+            /**
+             * @brief Counts a received chunk of the quote; stamps FIRST_RX
+             * once, LAST_CHUNK every time and the chunk's own timestamp
+             * while there is room.
+             */
+            void addChunk(std::size_t bytes);
+
+            /**
+             * @brief Counts a chunk drained by the FIN handler.
+             *
+             * No stage is stamped, so LAST_CHUNK stays before FIN and the
+             * drain shows in the FIN to COMPLETE span.
+             */
+            void addDrained(std::size_t bytes);
+
+            /**
+             * @brief Attaches the echo stages to the current record.
+             *
+             * Only the first echo of a completed quote is attached.
+             */
+            void echoWrite(std::size_t bytes);
+
+            /**
+             * @brief Counts ACKed echo bytes; stamps ECHO_ACK when all are.
+             */
+            void echoAcked(std::size_t bytes);
+
+            /**
+             * @brief Counts echoed bytes received.
+             *
+             * When the last byte arrives, ECHO_LAST_BYTE is stamped and
+             * @p message, the print that carries it, is watched so that
+             * PRINTED is stamped when it is emitted.
+             */
+            void echoReceived(std::size_t bytes, const std::string *message);
+
+            /**
+             * @brief Print observer; stamps PRINTED for the watched message.
+             *
+             * Matches PrintHandler's emit observer signature, with the
+             * timeline as @p arg.
+             */
+            static void onEmit(const std::string &message, void *arg);
+
+            /**
+             * @brief Copies the record @p age cycles back (0 = latest).
+             *
+             * @return false if there is no such record in the ring
+             */
+            bool record(std::size_t age, CycleRecord &out) const;
+
+            /**
+             * @brief Latency percentiles from @p from to @p to.
+             */
+            [[nodiscard]] Latency latency(CycleStage from, CycleStage to) const;
+
+            [[nodiscard]] uint32_t cycles() const {
+                return m_cycles.load(std::memory_order_acquire);
+            }
+            [[nodiscard]] std::size_t size() const {
+                return cycles() < CAPACITY ? cycles() : CAPACITY;
+            }
+    };
+
+} // namespace e5
@@ -0,0 +1,34 @@
+/**
+ * @file DispatchBenchmark.hpp
+ * @brief On-device benchmark of inline vs queued context dispatch.
+ *
+ * @author Goran
+ * @date 2025-09-05
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "QuoteBuffer.hpp"
+#include "SerialPrinter.hpp"
+#include <cstddef>
+
+namespace e5 {
+
+    /**
+     * @brief Measures same-core SerialPrinter and QuoteBuffer latency with the
+     * inline path enabled and disabled.
+     *
+     * Must be called from thread-mode code on the core that owns the
+     * printer's and buffer's context (ctx1 in this application), e.g. from
+     * setup1(). Prints use an empty message so the UART does not dominate
+     * the figures. Results are printed as one `[BENCH]` line per case.
+     *
+     * @param printer Printer bound to the calling core's context
+     * @param buffer Quote buffer bound to the calling core's context
+     * @param iterations Operations per case
+     */
+    void runDispatchBenchmark(const SerialPrinter &printer,
+                              QuoteBuffer &buffer, std::size_t iterations);
+
+} // namespace e5
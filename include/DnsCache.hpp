@@ -0,0 +1,115 @@
+/**
+ * @file DnsCache.hpp
+ * @brief Resolved host addresses kept in flash across reboots.
+ *
+ * This file contains the DnsCache class which stores the addresses of the
+ * application's endpoints in the emulated EEPROM (the last flash sector), so
+ * that a warm reboot can connect as soon as the link is up instead of
+ * waiting for DNS.
+ *
+ * @author Goran
+ * @date 2025-09-20
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace e5 {
+
+    /**
+     * @class DnsCache
+     * @brief Host name to IPv4 address cache with a time-to-live in boots.
+     *
+     * The board has no wall clock at boot, so an entry's age is counted in
+     * boots: load() takes the boot counter stored with the entries plus one,
+     * and an entry refreshed more than the TTL boots ago is no longer
+     * returned by lookup(). commit() stores the counter every boot, with the
+     * entries, so every boot that commits ages them. Entries are keyed by a
+     * 32-bit FNV-1a hash of the host name.
+     *
+     * The image lives in RAM between load() and commit(). commit() writes the
+     * flash sector, which stalls both cores for a few milliseconds and wears
+     * it, so it should be called once the application is idle enough to
+     * afford it; it writes at most once per boot.
+     *
+     * Used from the loop on core 0 only; not thread-safe.
+     */
+    class DnsCache {
+        public:
+            static constexpr std::size_t MAX_ENTRIES = 8;
+            static constexpr std::size_t EEPROM_SIZE = 256;
+
+        private:
+            static constexpr uint32_t MAGIC = 0xE5D5CA01;
+
+            struct Entry {
+                    uint32_t host_hash = 0; ///< 0 when the entry is free
+                    uint32_t address = 0;
+                    uint16_t refreshed_boot = 0;
+            };
+
+            struct Image {
+                    uint32_t magic = 0;
+                    uint16_t boots = 0;
+                    Entry entries[MAX_ENTRIES];
+                    uint32_t checksum = 0;
+            };
+            static_assert(sizeof(Image) <= EEPROM_SIZE,
+                          "DnsCache image does not fit the EEPROM area");
+
+            Image m_image;     ///< boots is the boot of the last commit()
+            uint16_t m_boot = 0; ///< This boot, kept in RAM
+            uint16_t m_ttl_boots;
+            bool m_committed = false; ///< commit() wrote this boot
+
+            [[nodiscard]] static uint32_t hash(const char *host);
+            [[nodiscard]] static uint32_t checksum(const Image &image);
+            [[nodiscard]] Entry *find(uint32_t host_hash);
+
+        public:
+            /**
+             * @brief Constructs an empty cache.
+             *
+             * @param ttl_boots Boots an entry stays valid without a refresh
+             */
+            explicit DnsCache(const uint16_t ttl_boots = 16)
+                : m_ttl_boots(ttl_boots) {}
+
+            /**
+             * @brief Reads the cache from flash and counts this boot in RAM.
+             *
+             * A missing or corrupted image starts an empty cache.
+             */
+            void load();
+
+            /**
+             * @brief Looks up a fresh address for @p host.
+             *
+             * @return true if an entry within its TTL was found
+             */
+            bool lookup(const char *host, IPAddress &address) const;
+
+            /**
+             * @brief Records a resolved address for @p host.
+             *
+             * Refreshes the entry's age; when the cache is full the oldest
+             * entry is replaced.
+             */
+            void store(const char *host, const IPAddress &address);
+
+            /**
+             * @brief Writes the cache and this boot's counter to flash,
+             * once per boot.
+             *
+             * @return true if flash was written
+             */
+            bool commit();
+
+            [[nodiscard]] uint16_t boots() const { return m_boot; }
+    };
+
+} // namespace e5
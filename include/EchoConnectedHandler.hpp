@@ -17,61 +17,53 @@
 
 #pragma once
 
-#include "ContextManager.hpp"
-#include "PerpetualBridge.hpp"
+#include "ConnectionHandler.hpp"
 #include "SerialPrinter.hpp"
-#include "TcpClient.hpp"
 namespace e5 {
     using namespace async_tcp;
     /**
      * @class EchoConnectedHandler
-     * @brief Handles the connection established event for an echo client.
+     * @brief Handles the connection established event for echo clients.
      *
      * This handler is triggered when a TCP connection is successfully
-     * established for an echo client. It implements the EventBridge pattern to
-     * ensure that the handling occurs on the correct core with proper thread
-     * safety.
+     * established for an echo client. It is bridged per connection through a
+     * ConnectionBridge to ensure that the handling occurs on the correct core
+     * with proper thread safety; one instance serves every echo connection.
      *
      * The handler can access the TCP client to send data or perform other
      * operations, and can use the SerialPrinter to output status messages.
      */
-    class EchoConnectedHandler final : public PerpetualBridge {
-            TcpClient &m_io; /**< Reference to the TCP client handling the
-                                     connection. */
+    class EchoConnectedHandler final : public ConnectionHandler {
             SerialPrinter &m_serial_printer; /**< Reference to the serial
                                                 printer for output. */
 
-        protected:
+        public:
+            /**
+             * @brief Constructs an EchoConnectedHandler.
+             *
+             * @param table Table holding the per-connection state
+             * @param serial_printer Reference to the serial printer for output
+             * messages
+             */
+            EchoConnectedHandler(ConnectionTable &table,
+                                 SerialPrinter &serial_printer)
+                : ConnectionHandler(table, WorkPriority::NORMAL),
+                  m_serial_printer(serial_printer) {
+            }
+
             /**
              * @brief Handles the connection established event.
              *
              * This method is called when the TCP connection is established. It
              * implements the specific logic for handling the connection event,
-             * such as sending initial data or notifying the user through the
-             * serial printer.
+             * such as configuring connection parameters and notifying the user
+             * through the serial printer.
              *
              * The method is executed on the core where the ContextManager was
              * initialized, ensuring proper core affinity for non-thread-safe
              * operations.
              */
-            void onWork() override;
-
-        public:
-            /**
-             * @brief Constructs an EchoConnectedHandler.
-             *
-             * @param ctx Shared pointer to the context manager that will
-             * execute this handler
-             * @param io Reference to the TCP client that established the
-             * connection
-             * @param serial_printer Reference to the serial printer for output
-             * messages
-             */
-            explicit EchoConnectedHandler(const AsyncCtx &ctx,
-                                          TcpClient &io,
-                                          SerialPrinter &serial_printer)
-                : PerpetualBridge(ctx), m_io(io), m_serial_printer(serial_printer) {
-            }
+            void onWork(ConnectionTable::Slot slot) override;
     };
 
 } // namespace e5
\ No newline at end of file
@@ -14,9 +14,9 @@
 
 #pragma once
 #include "IoRxBuffer.hpp"
-#include "PerpetualBridge.hpp"
-#include "SerialPrinter.hpp"
 #include "QuoteBuffer.hpp"
+#include "ResumableHandler.hpp"
+#include "SerialPrinter.hpp"
 
 namespace e5 {
     using namespace async_tcp;
@@ -26,56 +26,60 @@ namespace e5 {
      * @brief Handles the data received event for an echo client.
      *
      * This handler is triggered when data is received on a TCP connection
-     * for an echo client. It implements the EventBridge pattern to ensure that
-     * the handling occurs on the correct core with proper thread safety.
+     * for an echo client. It is bridged per connection through a
+     * ConnectionBridge to ensure that the handling occurs on the correct core
+     * with proper thread safety; one instance serves every echo connection.
      *
      * The handler processes naturally chunked data (since Nagle's algorithm is
-     * disabled) and then outputs it through the SerialPrinter.
+     * disabled) and then outputs it through the SerialPrinter. At most one
+     * slice budget of bytes is printed per invocation; the rest stays in the
+     * IoRxBuffer for the next slice.
      */
-    class EchoReceivedHandler final : public PerpetualBridge {
+    class EchoReceivedHandler final : public ResumableHandler {
             SerialPrinter &m_serial_printer; /**< Reference to the serial
                                                 printer for output. */
             QuoteBuffer &m_qotd_buffer; /**< Reference to the quote buffer for
                                             storing received data. */
-            // Store the received RxBuffer for async processing
-            IoRxBuffer *m_rx_buffer = nullptr;
 
         protected:
             /**
-             * @brief Handles the data received event.
+             * @brief Handles one slice of the data received event.
              *
              * This method is called when data is received on the TCP
-             * connection. It processes the available data and outputs
-             * it through the SerialPrinter.
+             * connection. It prints up to the slice budget of the available
+             * data through the SerialPrinter.
              *
              * The method is executed on the core where the ContextManager was
              * initialized, ensuring proper core affinity for non-thread-safe
              * operations.
              */
-            void onWork() override;
+            SliceResult onSlice(ConnectionTable::Slot slot,
+                                SliceBudget &budget) override;
 
         public:
             /**
              * @brief Constructs an EchoReceivedHandler.
              *
-             * @param ctx Shared pointer to the context manager that will
-             * execute this handler
+             * @param table Table holding the per-connection state
              * @param serial_printer Reference to the serial printer for output
              * messages
              * @param qotd_buffer Reference to the quote buffer for storing
              * received data
              */
-            EchoReceivedHandler(const AsyncCtx &ctx,
-                                         SerialPrinter &serial_printer,
-                                         QuoteBuffer &qotd_buffer)
-                : PerpetualBridge(ctx),
+            EchoReceivedHandler(ConnectionTable &table,
+                                SerialPrinter &serial_printer,
+                                QuoteBuffer &qotd_buffer)
+                : ResumableHandler(table, WorkPriority::NETWORK_CRITICAL, 256,
+                                   1000),
                   m_serial_printer(serial_printer),
                   m_qotd_buffer(qotd_buffer) {
             }
 
             // Override the virtual workload for RxBuffer
-            void workload(void *data) override {
-                m_rx_buffer = static_cast<IoRxBuffer*>(data);
+            void workload(const ConnectionTable::Slot slot,
+                          void *data) override {
+                m_table.setRxBuffer(slot, static_cast<IoRxBuffer *>(data));
+                m_table.countRxEvent(slot);
             }
     };
 
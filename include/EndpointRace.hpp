@@ -0,0 +1,120 @@
+/**
+ * @file EndpointRace.hpp
+ * @brief Races per-cycle connections to the best endpoints of a service.
+ *
+ * This file contains the EndpointRace class which starts each cycle of a
+ * PER_CYCLE service on the best endpoints an EndpointSelector offers, one
+ * ConnectionManager per candidate. The first connection to be established,
+ * or to claim the shared QuoteClaim when one is set, wins the cycle; the
+ * others are abandoned. Outcomes are fed back into the
+ * selector so that the ranking follows the fastest live endpoint.
+ *
+ * @author Goran
+ * @date 2025-09-17
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ConnectionManager.hpp"
+#include "EndpointSelector.hpp"
+#include "QuoteClaim.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace e5 {
+
+    /**
+     * @class EndpointRace
+     * @brief Runs each cycle on up to MAX_RACERS endpoints at once.
+     *
+     * The racers' managers are polled by poll(); their connect, completion
+     * and failure counters are compared with the values last seen to drive
+     * the race, in the same way the managers themselves read the
+     * ConnectionTable event counters.
+     *
+     * Used from the loop only; not thread-safe.
+     */
+    class EndpointRace {
+        public:
+            static constexpr std::size_t MAX_RACERS = 2;
+
+        private:
+            struct Racer {
+                    ConnectionManager *manager = nullptr;
+                    EndpointSelector::Index endpoint =
+                        EndpointSelector::NO_ENDPOINT;
+                    bool running = false; ///< Taking part in this cycle
+                    uint32_t seen_connects = 0;
+                    uint32_t seen_completed = 0;
+                    uint32_t seen_failed = 0;
+            };
+
+            EndpointSelector &m_selector;
+            Racer m_racers[MAX_RACERS];
+            std::size_t m_count = 0;
+            QuoteClaim *m_claim = nullptr; ///< Decides the winner when set
+
+            bool m_active = false;      ///< A cycle is in progress
+            int8_t m_winner = -1;       ///< Racer that won this cycle
+            bool m_completed = false;   ///< The winner finished its cycle
+            uint32_t m_started_us = 0;  ///< Start of this cycle
+
+            uint32_t m_cycles = 0;
+            uint32_t m_raced = 0;   ///< Cycles started on two endpoints
+            uint32_t m_failed = 0;  ///< Cycles no racer completed
+            uint32_t m_wasted = 0;  ///< Requests while a cycle was running
+            uint32_t m_last_cycle_us = 0;
+
+            /// Makes racer @p index the winner and abandons the others
+            void win(std::size_t index);
+
+        public:
+            /**
+             * @brief Constructs an EndpointRace over @p selector.
+             */
+            explicit EndpointRace(EndpointSelector &selector)
+                : m_selector(selector) {}
+
+            /**
+             * @brief Adds a PER_CYCLE manager used to race one endpoint.
+             *
+             * @return false when MAX_RACERS managers are already attached
+             */
+            bool addRacer(ConnectionManager &manager);
+
+            /**
+             * @brief Lets the racer holding @p claim win each cycle.
+             *
+             * The handlers claim it on ctx0 before the loop sees either
+             * connect, so the winner is the connection already writing the
+             * shared buffer. The claim is reset when a cycle starts.
+             */
+            void setClaim(QuoteClaim &claim) { m_claim = &claim; }
+
+            /**
+             * @brief Starts a cycle on the best endpoints.
+             *
+             * @return true if at least one connection attempt was started
+             */
+            bool requestCycle();
+
+            /**
+             * @brief Polls the racers and settles the race; call on every
+             * loop pass.
+             */
+            void poll();
+
+            [[nodiscard]] uint32_t cycles() const { return m_cycles; }
+            [[nodiscard]] uint32_t raced() const { return m_raced; }
+            [[nodiscard]] uint32_t failed() const { return m_failed; }
+            [[nodiscard]] uint32_t completed() const {
+                return m_cycles - m_failed - (m_active ? 1 : 0);
+            }
+            [[nodiscard]] uint32_t wasted() const { return m_wasted; }
+            [[nodiscard]] uint32_t lastCycleUs() const {
+                return m_last_cycle_us;
+            }
+    };
+
+} // namespace e5
@@ -0,0 +1,131 @@
+/**
+ * @file EndpointSelector.hpp
+ * @brief Latency-ranked server endpoints with automatic quarantine.
+ *
+ * This file contains the EndpointSelector class which keeps a small set of
+ * candidate servers for one service, estimates their connect and full-cycle
+ * times with an exponentially weighted moving average, and ranks them so the
+ * application always talks to the fastest live endpoint. Endpoints that keep
+ * failing are taken out of rotation for a growing period.
+ *
+ * @author Goran
+ * @date 2025-09-17
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace e5 {
+
+    /**
+     * @brief Maximum number of endpoints per EndpointSelector.
+     */
+    constexpr std::size_t MAX_ENDPOINTS = 4;
+
+    /**
+     * @class EndpointSelector
+     * @brief Ranks the endpoints of one service by measured cycle time.
+     *
+     * Each endpoint keeps two EWMAs (weight 1/4 for the newest sample): the
+     * time from connect() to the connected event and the time of a full
+     * cycle (e.g. connect to FIN for QOTD). Endpoints are ranked by cycle
+     * time, falling back to connect time; endpoints without samples rank
+     * first so that every endpoint gets measured.
+     *
+     * After FAILURE_LIMIT consecutive failures an endpoint is quarantined for
+     * a base period that doubles with each quarantine (capped). It is
+     * offered again as a probe once the period is over; a success clears
+     * its failure history.
+     *
+     * Used from the loop only; not thread-safe.
+     */
+    class EndpointSelector {
+        public:
+            using Index = uint8_t;
+            static constexpr Index NO_ENDPOINT = 0xFF;
+            static constexpr uint8_t FAILURE_LIMIT = 3;
+
+            struct Endpoint {
+                    const char *host = nullptr;
+                    uint16_t port = 0;
+                    IPAddress address;
+                    bool resolved = false;
+
+                    uint32_t connect_ewma_us = 0;
+                    uint32_t cycle_ewma_us = 0;
+                    uint16_t connect_samples = 0;
+                    uint16_t cycle_samples = 0;
+
+                    uint8_t consecutive_failures = 0;
+                    uint8_t quarantines = 0;
+                    uint32_t quarantined_at_us = 0;
+                    uint32_t quarantine_us = 0; ///< 0 when in rotation
+
+                    uint32_t wins = 0;     ///< Races won
+                    uint32_t failures = 0; ///< Failed attempts in total
+            };
+
+        private:
+            Endpoint m_endpoints[MAX_ENDPOINTS];
+            std::size_t m_size = 0;
+            uint32_t m_quarantine_base_us = 10000000;
+            uint32_t m_quarantine_max_us = 300000000;
+
+            [[nodiscard]] bool live(const Endpoint &endpoint,
+                                    uint32_t now_us) const;
+            [[nodiscard]] static uint32_t score(const Endpoint &endpoint);
+
+        public:
+            EndpointSelector() = default;
+
+            /**
+             * @brief Adds a candidate endpoint.
+             *
+             * @param host Host name or dotted address; must outlive the
+             * selector
+             * @param port TCP port
+             * @return Index of the endpoint, or NO_ENDPOINT when full
+             */
+            Index add(const char *host, uint16_t port);
+
+            /**
+             * @brief Sets the resolved address of an endpoint.
+             *
+             * Measurements and quarantine are kept: the address of a host
+             * may change, its service usually does not.
+             */
+            void setAddress(Index index, const IPAddress &address);
+
+            /**
+             * @brief Writes up to @p count best live endpoints to @p out,
+             * best first.
+             *
+             * If no endpoint is live, the one whose quarantine ends first is
+             * returned so that the service is never left without a target.
+             *
+             * @return Number of indices written
+             */
+            std::size_t best(Index *out, std::size_t count);
+
+            void recordConnect(Index index, uint32_t connect_us);
+            void recordCycle(Index index, uint32_t cycle_us);
+            void recordWin(Index index) { ++m_endpoints[index].wins; }
+            void recordFailure(Index index);
+
+            /**
+             * @brief Sets the first quarantine period and its cap.
+             */
+            void setQuarantine(uint32_t base_us, uint32_t max_us);
+
+            [[nodiscard]] std::size_t size() const { return m_size; }
+            [[nodiscard]] const Endpoint &endpoint(const Index index) const {
+                return m_endpoints[index];
+            }
+            [[nodiscard]] bool quarantined(Index index) const;
+    };
+
+} // namespace e5
@@ -0,0 +1,112 @@
+/**
+ * @file InlineDispatch.hpp
+ * @brief Same-core fast path for work bound to an async context.
+ *
+ * This file contains the InlineDispatch class which lets a component run its
+ * work inline when the caller is already executing on the core that owns the
+ * target context, instead of going through the context's pending-worker
+ * queue. The context lock is still taken, so inline work is serialised with
+ * the context's workers exactly as queued work would be. Wait and hold times
+ * are recorded in the context's LockProfiler as LOOP_CODE.
+ *
+ * @author Goran
+ * @date 2025-09-05
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ContextManager.hpp"
+#include <cstdint>
+
+namespace e5 {
+
+    using namespace async_tcp;
+
+    /**
+     * @class InlineDispatch
+     * @brief Decides between inline and queued execution for one context.
+     *
+     * Usage:
+     * ```cpp
+     * if (m_dispatch.tryEnter()) {
+     *     doWork();          // runs on the context core, under its lock
+     *     m_dispatch.leave();
+     * } else {
+     *     m_dispatch.countQueued();
+     *     queueWork();       // regular bridge path
+     * }
+     * ```
+     *
+     * A reentrancy guard makes nested calls (e.g. a worker that prints while
+     * an inline print is in progress on the same core) fall back to the
+     * queue. Counters are kept per calling core so that each slot has a
+     * single writer and needs no locking.
+     */
+    class InlineDispatch {
+            const AsyncCtx &m_ctx; ///< Context the work is bound to
+            bool m_enabled = true; ///< Inline path enabled
+            volatile bool m_active = false; ///< Inline work in progress
+            uint32_t m_acquired_us = 0; ///< Lock acquisition time
+
+            uint32_t m_inline[2] = {}; ///< Inline dispatches per core
+            uint32_t m_queued[2] = {}; ///< Queued dispatches per core
+
+        public:
+            /**
+             * @brief Constructs an InlineDispatch for @p ctx.
+             *
+             * @param ctx Context the dispatched work is bound to
+             */
+            explicit InlineDispatch(const AsyncCtx &ctx) : m_ctx(ctx) {}
+
+            /**
+             * @brief Enters the inline path if the caller may run the work
+             * directly.
+             *
+             * Succeeds only when the inline path is enabled, the caller runs
+             * on the context's core and no inline work is already in
+             * progress. On success the context lock is held until leave().
+             *
+             * @return true if the caller must run the work and call leave()
+             */
+            bool tryEnter();
+
+            /**
+             * @brief Leaves the inline path and releases the context lock.
+             */
+            void leave();
+
+            /**
+             * @brief Records that the work was queued instead.
+             */
+            void countQueued();
+
+            /**
+             * @brief Enables or disables the inline path.
+             *
+             * Disabled dispatch always queues; used to benchmark both paths.
+             */
+            void setEnabled(const bool enabled) { m_enabled = enabled; }
+
+            /**
+             * @brief Context the dispatched work is bound to.
+             */
+            [[nodiscard]] const AsyncCtx &context() const { return m_ctx; }
+
+            /**
+             * @brief Number of inline dispatches across both cores.
+             */
+            [[nodiscard]] uint32_t inlineCount() const {
+                return m_inline[0] + m_inline[1];
+            }
+
+            /**
+             * @brief Number of queued dispatches across both cores.
+             */
+            [[nodiscard]] uint32_t queuedCount() const {
+                return m_queued[0] + m_queued[1];
+            }
+    };
+
+} // namespace e5
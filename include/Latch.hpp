@@ -0,0 +1,72 @@
+/**
+ * @file Latch.hpp
+ * @brief One-shot event for publishing startup state between cores.
+ *
+ * This file contains the Latch class which replaces volatile spin flags for
+ * cross-core handshakes. Opening the latch is a release store and observing
+ * it open is an acquire load, so everything written before open() is visible
+ * to a waiter that returns from wait(). On the device a waiter sleeps with
+ * WFE and open() wakes it with SEV; on the host it blocks on a condition
+ * variable.
+ *
+ * @author Goran
+ * @date 2025-09-21
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#ifndef ARDUINO
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace e5 {
+
+    /**
+     * @class Latch
+     * @brief Starts closed, opens once and stays open.
+     *
+     * Any number of waiters on either core may wait; open() may be called
+     * from any core. Spurious WFE wakeups are harmless because the waiter
+     * re-checks the latch, and an SEV sent between that check and the WFE
+     * is kept in the event register, so no wakeup is lost.
+     */
+    class Latch {
+            std::atomic<bool> m_open{false};
+            std::atomic<uint32_t> m_opened_us{0};
+#ifndef ARDUINO
+            mutable std::mutex m_mutex;
+            mutable std::condition_variable m_opened;
+#endif
+
+        public:
+            Latch() = default;
+            Latch(const Latch &) = delete;
+            Latch &operator=(const Latch &) = delete;
+
+            /**
+             * @brief Opens the latch and wakes every waiter.
+             */
+            void open();
+
+            /**
+             * @brief Blocks until the latch is open.
+             */
+            void wait() const;
+
+            [[nodiscard]] bool isOpen() const {
+                return m_open.load(std::memory_order_acquire);
+            }
+
+            /**
+             * @brief time_us_32() when the latch was opened, 0 before.
+             */
+            [[nodiscard]] uint32_t openedUs() const {
+                return m_opened_us.load(std::memory_order_relaxed);
+            }
+    };
+
+} // namespace e5
@@ -0,0 +1,217 @@
+/**
+ * @file LockProfiler.hpp
+ * @brief Always-on contention metrics for async-context locks.
+ *
+ * This file contains the LockProfiler class which records how long callers
+ * wait for, and then hold, the lock of an async context, and how long the
+ * calls that take it internally take as a whole. Samples are kept in
+ * log2 microsecond histograms per caller class and per recording lane (loop
+ * code or context workers of a core), so the figures can be compared across
+ * cores without a debugger attached (cf. scripts/mutex_assert.gdb).
+ *
+ * @author Goran
+ * @date 2025-09-10
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ContextManager.hpp"
+#include "Log2Histogram.hpp"
+#include <Arduino.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace e5 {
+
+    using namespace async_tcp;
+
+    /**
+     * @brief Who took the context lock.
+     */
+    enum class LockCaller : uint8_t {
+        BRIDGE_EXECUTE = 0,  ///< Blocking SyncBridge execution (QuoteBuffer)
+        WORKER_DISPATCH = 1, ///< Workers run by the context (dispatcher pass)
+        LOOP_CODE = 2,       ///< Inline work from loop()/loop1() code
+        ENQUEUE = 3,         ///< Queueing work (SerialPrinter, dispatcher post)
+    };
+
+    constexpr std::size_t LOCK_CALLER_CLASSES = 4;
+
+    /**
+     * @class LockProfiler
+     * @brief Wait/hold histograms for one context's lock.
+     *
+     * Each histogram has LOCK_HISTOGRAM_BUCKETS log2 buckets: bucket 0 holds
+     * samples under 1 us, bucket n samples in [2^(n-1), 2^n) us and the last
+     * bucket everything above. A wait of at least the contention threshold
+     * counts as contended.
+     *
+     * A wait is the time spent in acquireLock() itself. Where the lock is
+     * taken inside a call that cannot be timed apart, such as a SyncBridge
+     * round trip, or where work waits for a pass rather than for the lock,
+     * the time is recorded as latency instead and never counts as
+     * contended.
+     *
+     * Samples are indexed by lane: thread-mode code (loop(), loop1()) or the
+     * context workers of the calling core. Workers run in an IRQ that
+     * preempts thread-mode code, so the two get separate series; workers of
+     * contexts on the same core run at one IRQ priority and never interleave.
+     * Each series therefore has a single writer at a time and recording
+     * takes no lock.
+     *
+     * Profilers are registered per context with attach() before the context
+     * is used; of() returns nullptr for unregistered contexts and recording
+     * is then skipped.
+     */
+    class LockProfiler {
+        public:
+            static constexpr std::size_t LOCK_HISTOGRAM_BUCKETS = 12;
+            static constexpr std::size_t MAX_PROFILED_CONTEXTS = 3;
+            static constexpr std::size_t LOCK_LANES = 4; ///< 2 cores x 2
+
+            using Histogram = Log2Histogram<LOCK_HISTOGRAM_BUCKETS>;
+
+            struct Series {
+                    Histogram wait;
+                    Histogram hold;
+                    Histogram latency; ///< Calls not split into wait/hold
+                    uint32_t contended = 0;
+            };
+
+        private:
+            const char *m_name;
+            uint32_t m_contention_threshold_us = 2;
+            // [caller class][lane]
+            std::array<std::array<Series, LOCK_LANES>, LOCK_CALLER_CLASSES>
+                m_series{};
+
+            static const AsyncCtx *s_contexts[MAX_PROFILED_CONTEXTS];
+            static LockProfiler *s_profilers[MAX_PROFILED_CONTEXTS];
+
+        public:
+            explicit LockProfiler(const char *name) : m_name(name) {}
+
+            /**
+             * @brief Registers @p profiler for @p ctx.
+             *
+             * Call once per context during setup, before other cores use
+             * it.
+             */
+            static bool attach(const AsyncCtx &ctx, LockProfiler &profiler);
+
+            /**
+             * @brief Returns the profiler registered for @p ctx, or nullptr.
+             */
+            static LockProfiler *of(const AsyncCtx &ctx);
+
+            /**
+             * @brief Lane of thread-mode code (@p worker false) or of the
+             * context workers (@p worker true) of @p core.
+             */
+            static constexpr std::size_t lane(const uint8_t core,
+                                              const bool worker) {
+                return core * 2u + (worker ? 1u : 0u);
+            }
+
+            /**
+             * @brief Lane of the calling code.
+             */
+            static std::size_t currentLane() {
+                return lane(static_cast<uint8_t>(get_core_num()),
+                            __get_current_exception() != 0);
+            }
+
+            /**
+             * @brief Records a lock wait of @p wait_us by @p caller.
+             */
+            void recordWait(LockCaller caller, uint32_t wait_us);
+
+            /**
+             * @brief Records a lock hold of @p hold_us by @p caller.
+             */
+            void recordHold(LockCaller caller, uint32_t hold_us);
+
+            /**
+             * @brief Records @p latency_us of a call by @p caller that takes
+             * the lock without exposing the wait.
+             */
+            void recordLatency(LockCaller caller, uint32_t latency_us);
+
+            void setContentionThreshold(const uint32_t us) {
+                m_contention_threshold_us = us;
+            }
+
+            [[nodiscard]] const Series &series(LockCaller caller,
+                                               std::size_t lane) const {
+                return m_series[static_cast<std::size_t>(caller)][lane];
+            }
+
+            [[nodiscard]] const char *name() const { return m_name; }
+
+            /**
+             * @brief Formats one line per caller class and lane with samples.
+             *
+             * Lines look like
+             * `[LOCK] ctx1 enqueue c0/worker n=.. contended=.. wait p50/p99/max=../../.. hold p50/p99/max=../../..`,
+             * with `c0/loop` for thread-mode code. Series with latency
+             * samples add `latency p50/p99/max=../../..`; fields without
+             * samples are left out.
+             */
+            [[nodiscard]] std::string report() const;
+
+            /**
+             * @brief Clears all histograms.
+             */
+            void reset();
+    };
+
+    /**
+     * @class LockTimer
+     * @brief RAII helper recording wait and hold time for a lock section.
+     *
+     * Construct immediately before taking the lock, call acquired() once it
+     * is held; the destructor records the hold time. If acquired() is never
+     * called, the whole scope is recorded as latency (for calls such as
+     * SyncBridge::execute() that take and release the lock internally).
+     */
+    class LockTimer {
+            LockProfiler *m_profiler;
+            LockCaller m_caller;
+            uint32_t m_start_us;
+            uint32_t m_acquired_us = 0;
+            bool m_acquired = false;
+
+        public:
+            LockTimer(const AsyncCtx &ctx, const LockCaller caller)
+                : m_profiler(LockProfiler::of(ctx)), m_caller(caller),
+                  m_start_us(time_us_32()) {}
+
+            LockTimer(const LockTimer &) = delete;
+            LockTimer &operator=(const LockTimer &) = delete;
+
+            void acquired() {
+                m_acquired_us = time_us_32();
+                m_acquired = true;
+                if (m_profiler) {
+                    m_profiler->recordWait(m_caller,
+                                           m_acquired_us - m_start_us);
+                }
+            }
+
+            ~LockTimer() {
+                if (!m_profiler) {
+                    return;
+                }
+                const uint32_t now = time_us_32();
+                if (m_acquired) {
+                    m_profiler->recordHold(m_caller, now - m_acquired_us);
+                } else {
+                    m_profiler->recordLatency(m_caller, now - m_start_us);
+                }
+            }
+    };
+
+} // namespace e5
@@ -0,0 +1,84 @@
+/**
+ * @file Log2Histogram.hpp
+ * @brief Fixed-size log2 microsecond histogram.
+ *
+ * This file contains the Log2Histogram template used wherever the
+ * application records latency distributions on the device: a handful of
+ * counters per power of two, constant-time recording and percentiles good to
+ * a factor of two.
+ *
+ * @author Goran
+ * @date 2025-09-19
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace e5 {
+
+    /**
+     * @brief Histogram of microsecond samples in power-of-two buckets.
+     *
+     * Bucket 0 holds samples under 1 us, bucket n samples in [2^(n-1), 2^n)
+     * us and the last bucket everything above. The maximum and the sum are
+     * exact.
+     *
+     * @tparam Buckets Number of buckets; the last one starts at
+     * 2^(Buckets-2) us
+     */
+    template <std::size_t Buckets> struct Log2Histogram {
+            static_assert(Buckets >= 2 && Buckets <= 33,
+                          "bucket bounds must fit in 32 bits");
+
+            std::array<uint32_t, Buckets> buckets{};
+            uint32_t count = 0;
+            uint32_t max_us = 0;
+            uint64_t total_us = 0;
+
+            void add(const uint32_t us) {
+                std::size_t bucket = 0;
+                for (uint32_t v = us; v > 0 && bucket < Buckets - 1; v >>= 1) {
+                    ++bucket;
+                }
+                ++buckets[bucket];
+                ++count;
+                total_us += us;
+                if (us > max_us) {
+                    max_us = us;
+                }
+            }
+
+            /**
+             * @brief Upper bound (us) of the bucket holding the given
+             * percentile; the exact maximum for the last bucket.
+             */
+            [[nodiscard]] uint32_t percentileUs(const uint8_t percent) const {
+                if (count == 0) {
+                    return 0;
+                }
+                const uint64_t target =
+                    (static_cast<uint64_t>(count) * percent + 99) / 100;
+                uint64_t seen = 0;
+                for (std::size_t bucket = 0; bucket < Buckets; ++bucket) {
+                    seen += buckets[bucket];
+                    if (seen >= target) {
+                        return bucket == Buckets - 1
+                                   ? max_us
+                                   : static_cast<uint32_t>(1ull << bucket);
+                    }
+                }
+                return max_us;
+            }
+
+            [[nodiscard]] uint32_t avgUs() const {
+                return count ? static_cast<uint32_t>(total_us / count) : 0;
+            }
+
+            void reset() { *this = {}; }
+    };
+
+} // namespace e5
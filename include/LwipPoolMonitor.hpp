@@ -0,0 +1,143 @@
+/**
+ * @file LwipPoolMonitor.hpp
+ * @brief lwIP memory pool sampling, leak detection and connect throttling.
+ *
+ * This file contains the LwipPoolMonitor class which samples lwIP's memp
+ * statistics for the pools the application depends on (the pbuf pool, pbuf
+ * headers, TCP PCBs and TCP segments), checks that each QOTD cycle gives its
+ * pbufs back, and optionally holds back new QOTD connects while the pbuf
+ * pool is nearly exhausted, so that data already queued in IoRxBuffer chains
+ * can be drained first.
+ *
+ * @author Goran
+ * @date 2025-09-23
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace e5 {
+
+    /**
+     * @brief lwIP pools watched by LwipPoolMonitor.
+     */
+    enum class LwipPool : uint8_t {
+        PBUF_POOL, ///< RX pbufs with payload, held by IoRxBuffer chains
+        PBUF,      ///< pbuf headers for referenced payloads
+        TCP_PCB,
+        TCP_SEG,
+        COUNT
+    };
+
+    /**
+     * @brief Short pool name for reports.
+     */
+    const char *poolName(LwipPool pool);
+
+    /**
+     * @class LwipPoolMonitor
+     * @brief Samples lwIP pool usage from the loop.
+     *
+     * The counters come from lwIP's stats facility (LWIP_STATS and
+     * MEMP_STATS); when the core is built without them, available() is false
+     * and the monitor never throttles.
+     *
+     * Leak detection compares pbuf pool usage at the end of each QOTD cycle,
+     * after the FIN handler has reset its IoRxBuffer, with the usage when the
+     * cycle started. Other connections can hold pbufs at either point, so a
+     * single positive difference is only counted as outstanding; a leak is
+     * reported when the idle level after a cycle has grown for LEAK_CYCLES
+     * cycles in a row.
+     *
+     * sample(), allowConnect(), cycleStarted() and cycleEnded() must be
+     * called from the loop on core 0; the accessors may be read from either
+     * core.
+     */
+    class LwipPoolMonitor {
+        public:
+            static constexpr uint8_t LEAK_CYCLES = 3;
+
+            struct PoolStats {
+                    uint32_t used = 0;
+                    uint32_t avail = 0;
+                    uint32_t max = 0;    ///< lwIP high-water mark
+                    uint32_t errors = 0; ///< Failed allocations
+            };
+
+        private:
+            PoolStats m_pools[static_cast<std::size_t>(LwipPool::COUNT)];
+            uint32_t m_min_free_pbufs = UINT32_MAX;
+            uint32_t m_samples = 0;
+
+            uint32_t m_throttle_below = 0; ///< 0 disables the throttle
+            uint32_t m_throttled = 0;
+
+            bool m_cycle_running = false;
+            uint32_t m_cycle_start_used = 0;
+            uint32_t m_last_end_used = 0;
+            uint8_t m_growth_run = 0;
+            uint32_t m_outstanding = 0;     ///< Cycles ending above start
+            uint32_t m_outstanding_max = 0; ///< Largest difference, pbufs
+            uint32_t m_leaks = 0;
+
+        public:
+            LwipPoolMonitor() = default;
+
+            /**
+             * @brief True when lwIP was built with memp statistics.
+             */
+            [[nodiscard]] static bool available();
+
+            /**
+             * @brief Copies the current pool counters from lwIP.
+             */
+            void sample();
+
+            /**
+             * @brief Holds back connects while fewer than @p min_free pbufs
+             * are free in the pool; 0 disables the throttle.
+             */
+            void setThrottle(const uint32_t min_free) {
+                m_throttle_below = min_free;
+            }
+
+            /**
+             * @brief Samples and decides whether a new connect may start.
+             *
+             * @return false while the throttle is holding connects back
+             */
+            bool allowConnect();
+
+            /**
+             * @brief Records pbuf usage when a QOTD cycle starts.
+             */
+            void cycleStarted();
+
+            /**
+             * @brief Compares pbuf usage with the start of the cycle.
+             */
+            void cycleEnded();
+
+            [[nodiscard]] const PoolStats &pool(const LwipPool pool) const {
+                return m_pools[static_cast<std::size_t>(pool)];
+            }
+            [[nodiscard]] uint32_t freePbufs() const {
+                const auto &pbufs = pool(LwipPool::PBUF_POOL);
+                return pbufs.avail - pbufs.used;
+            }
+            [[nodiscard]] uint32_t minFreePbufs() const {
+                return m_samples ? m_min_free_pbufs : 0;
+            }
+            [[nodiscard]] uint32_t samples() const { return m_samples; }
+            [[nodiscard]] uint32_t throttled() const { return m_throttled; }
+            [[nodiscard]] uint32_t outstanding() const { return m_outstanding; }
+            [[nodiscard]] uint32_t outstandingMax() const {
+                return m_outstanding_max;
+            }
+            [[nodiscard]] uint32_t leaks() const { return m_leaks; }
+    };
+
+} // namespace e5
@@ -0,0 +1,125 @@
+/**
+ * @file MicroBenchmark.hpp
+ * @brief Cycle-counter microbenchmarks of the application's hot paths.
+ *
+ * This file contains the MicroBenchmark timer and the suites that run on
+ * both the device and the host: QuoteBuffer operations from the owning core
+ * and from the other core, SerialPrinter::print() into a null sink,
+ * LoopScheduler::timeToRun() and MessageBuffer construction. The host
+ * driver in src/bench adds the connection handlers, fed from synthetic
+ * IoRxBuffer contents, and compares results against a stored baseline.
+ *
+ * Every case prints one `[MICRO]` line holding a JSON object, so results
+ * can be cut out of a serial capture as easily as out of host output.
+ *
+ * @author Goran
+ * @date 2025-09-28
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "QuoteBuffer.hpp"
+#include "SerialPrinter.hpp"
+#include <Arduino.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace e5 {
+
+    /**
+     * @brief Per-operation time of one benchmark case, in nanoseconds.
+     */
+    struct BenchStats {
+            uint32_t batch = 0;   ///< Operations per sample
+            uint32_t samples = 0;
+            uint32_t min_ns = 0;
+            uint32_t median_ns = 0;
+            uint32_t mean_ns = 0;
+            uint32_t max_ns = 0;
+    };
+
+    /**
+     * @class MicroBenchmark
+     * @brief Times an operation in batches with the cycle counter.
+     *
+     * Each sample runs the operation @c batch times between two reads of
+     * rp2040.getCycleCount(), which spreads the cost of reading the counter
+     * over the batch. Cycles are converted with rp2040.f_cpu(); on the host
+     * the counter already counts nanoseconds. The median is the figure to
+     * compare; the minimum shows the cost without interference.
+     */
+    class MicroBenchmark {
+        public:
+            static constexpr std::size_t SAMPLES = 64;
+
+        private:
+            uint32_t m_batch;
+
+            [[nodiscard]] BenchStats summarise(uint32_t (&cycles)[SAMPLES]) const;
+
+        public:
+            explicit MicroBenchmark(const uint32_t batch)
+                : m_batch(std::max<uint32_t>(batch, 1)) {}
+
+            [[nodiscard]] uint32_t batch() const { return m_batch; }
+
+            /**
+             * @brief Runs @p op SAMPLES times @c batch times.
+             *
+             * The first sample is a warm-up and is discarded.
+             */
+            template <typename Op> BenchStats measure(Op &&op) const {
+                uint32_t cycles[SAMPLES];
+                for (std::size_t sample = 0; sample <= SAMPLES; ++sample) {
+                    const uint32_t start = rp2040.getCycleCount();
+                    for (uint32_t i = 0; i < m_batch; ++i) {
+                        op();
+                    }
+                    const uint32_t elapsed = rp2040.getCycleCount() - start;
+                    if (sample > 0) {
+                        cycles[sample - 1] = elapsed;
+                    }
+                }
+                return summarise(cycles);
+            }
+
+            /**
+             * @brief Formats a result as a `[MICRO]` JSON line.
+             */
+            static std::string format(const char *name,
+                                      const BenchStats &stats);
+    };
+
+    /**
+     * @brief Runs the cases that call into a context from its own core.
+     *
+     * Must be called from thread-mode code on the core that owns the
+     * printer's and buffer's context (ctx1 in this application), while no
+     * other code uses the buffer, e.g. from setup1(). Console output is
+     * switched off while prints are measured; results are printed after.
+     *
+     * @param printer Printer bound to the calling core's context
+     * @param buffer Quote buffer bound to the calling core's context
+     * @param batch Operations per sample
+     */
+    void runSameCoreBenchmarks(const SerialPrinter &printer,
+                               QuoteBuffer &buffer, uint32_t batch);
+
+    /**
+     * @brief Runs the cases that call into a context from the other core.
+     *
+     * Must be called from thread-mode code on the core that does not own
+     * the printer's and buffer's context (core 0 in this application),
+     * while no other code uses the buffer.
+     *
+     * @param printer Printer bound to the other core's context
+     * @param buffer Quote buffer bound to the other core's context
+     * @param batch Operations per sample
+     */
+    void runCrossCoreBenchmarks(const SerialPrinter &printer,
+                                QuoteBuffer &buffer, uint32_t batch);
+
+} // namespace e5
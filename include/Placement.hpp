@@ -0,0 +1,77 @@
+/**
+ * @file Placement.hpp
+ * @brief Build-time assignment of components to async contexts.
+ *
+ * QuoteBuffer, SerialPrinter and the periodic statistics tasks each run on
+ * ctx0 (the TCP context, core 0), ctx1 (core 1) or ctx2, a third context
+ * that exists only when something is placed on it. The RP2040 has two
+ * cores, so ctx2 runs on core 1 next to ctx1, with a worker queue and lock
+ * of its own. Select a placement with build flags, e.g.
+ *
+ * ```
+ * -DE5_QUOTE_BUFFER_CTX=0 -DE5_PRINTER_CTX=2 -DE5_STATS_CTX=1
+ * ```
+ *
+ * The defaults are the arrangement the application has always used:
+ * QuoteBuffer and SerialPrinter on ctx1 and the statistics printed directly
+ * from loop1(). With E5_STATS_CTX set, loop1() still keeps the schedule but
+ * posts each task as BACKGROUND work to that context's PriorityDispatcher.
+ *
+ * @author Goran
+ * @date 2025-10-01
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#ifndef E5_QUOTE_BUFFER_CTX
+#define E5_QUOTE_BUFFER_CTX 1
+#endif
+#ifndef E5_PRINTER_CTX
+#define E5_PRINTER_CTX 1
+#endif
+
+#if E5_QUOTE_BUFFER_CTX < 0 || E5_QUOTE_BUFFER_CTX > 2
+#error E5_QUOTE_BUFFER_CTX must be 0, 1 or 2
+#endif
+#if E5_PRINTER_CTX < 0 || E5_PRINTER_CTX > 2
+#error E5_PRINTER_CTX must be 0, 1 or 2
+#endif
+#if defined(E5_STATS_CTX) && (E5_STATS_CTX < 0 || E5_STATS_CTX > 2)
+#error E5_STATS_CTX must be 0, 1 or 2
+#endif
+
+#if E5_QUOTE_BUFFER_CTX == 2 || E5_PRINTER_CTX == 2 ||                       \
+    (defined(E5_STATS_CTX) && E5_STATS_CTX == 2)
+#define E5_PLACEMENT_CTX2 1
+#else
+#define E5_PLACEMENT_CTX2 0
+#endif
+
+/**
+ * @brief Names the object of a placed context: E5_PLACED(ctx,
+ * E5_PRINTER_CTX) is ctx1 by default, E5_PLACED(dispatcher, ...) its
+ * dispatcher.
+ */
+#define E5_PLACED(prefix, n) E5_PLACED_NAME(prefix, n)
+#define E5_PLACED_NAME(prefix, n) prefix##n
+
+#define E5_PLACEMENT_STR(x) E5_PLACEMENT_STR_(x)
+#define E5_PLACEMENT_STR_(x) #x
+
+namespace e5 {
+
+    /**
+     * @brief Placement of this build, e.g. "buffer=ctx1 printer=ctx1
+     * stats=loop1", for result lines.
+     */
+    constexpr const char *PLACEMENT_LABEL =
+        "buffer=ctx" E5_PLACEMENT_STR(E5_QUOTE_BUFFER_CTX)
+        " printer=ctx" E5_PLACEMENT_STR(E5_PRINTER_CTX)
+#ifdef E5_STATS_CTX
+        " stats=ctx" E5_PLACEMENT_STR(E5_STATS_CTX);
+#else
+        " stats=loop1";
+#endif
+
+} // namespace e5
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "EphemeralBridge.hpp"
+#include <cstdint>
 #include <string>
 
 namespace e5 {
@@ -40,6 +41,12 @@ namespace e5 {
 
             std::unique_ptr<std::string> m_message =
                 nullptr; /**< Message buffer containing the text to print */
+
+            static volatile uint32_t s_printed; /**< Messages emitted so far */
+            static void (*s_observer)(const std::string &,
+                                      void *); /**< Optional emit observer */
+            static void *s_observer_arg; /**< Argument for s_observer */
+            static volatile bool s_output_enabled; /**< Write to Serial1 */
         protected:
             /**
              * @brief Handles the print operation.
@@ -65,6 +72,52 @@ namespace e5 {
             explicit PrintHandler(const AsyncCtx &ctx,
                                   std::unique_ptr<std::string> message);
 
+            /**
+             * @brief Writes a message to the serial output.
+             *
+             * Shared by the queued handler and SerialPrinter's inline path.
+             * Must be called on the printer's context core with the context
+             * lock held.
+             *
+             * @param message Text to print
+             */
+            static void emit(const std::string &message);
+
+            /**
+             * @brief Number of messages emitted since boot.
+             *
+             * Only written on the printer's context core; used to detect
+             * completion of queued prints.
+             */
+            static uint32_t printed() { return s_printed; }
+
+            /**
+             * @brief Sets a function called after every emitted message.
+             *
+             * The observer runs on the printer's context core with the
+             * context lock held and receives the message as printed. Set it
+             * before the printer is used.
+             *
+             * @param observer Function to call, or nullptr
+             * @param arg Passed to @p observer unchanged
+             */
+            static void setObserver(void (*observer)(const std::string &,
+                                                     void *),
+                                    void *arg) {
+                s_observer_arg = arg;
+                s_observer = observer;
+            }
+
+            /**
+             * @brief Turns the serial output off or back on.
+             *
+             * While off, messages are still counted and observed but not
+             * written, which makes the printer a null sink for benchmarks.
+             */
+            static void setOutputEnabled(const bool enabled) {
+                s_output_enabled = enabled;
+            }
+
             /**
              * @brief Static factory method that creates a PrintHandler with
              * self-ownership
@@ -0,0 +1,164 @@
+/**
+ * @file PriorityDispatcher.hpp
+ * @brief Priority-ordered execution of application work on an async context.
+ *
+ * This file contains the PriorityDispatcher class which collects work items
+ * posted for a context into per-class queues and drains them from a single
+ * PerpetualBridge, highest class first. Each pass is bounded, after which
+ * the dispatcher re-arms itself so that other workers on the context (e.g.
+ * SyncBridge executions) are not held up behind a long backlog.
+ *
+ * @author Goran
+ * @date 2025-09-08
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ContextManager.hpp"
+#include "PerpetualBridge.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace e5 {
+
+    using namespace async_tcp;
+
+    /**
+     * @brief Priority class of a work item, highest first.
+     */
+    enum class WorkPriority : uint8_t {
+        NETWORK_CRITICAL = 0, ///< Keeps TCP moving: ACK, RX, FIN, errors
+        NORMAL = 1,           ///< Connection setup and application logic
+        BACKGROUND = 2,       ///< Printing, statistics, housekeeping
+    };
+
+    constexpr std::size_t WORK_PRIORITY_CLASSES = 3;
+
+    /**
+     * @class PrioritizedWork
+     * @brief Unit of work that can be queued on a PriorityDispatcher.
+     *
+     * An item is queued at most once at a time; posting an item that is
+     * already queued is a no-op, so perpetual items (e.g. connection
+     * bridges) coalesce like pending workers do.
+     */
+    class PrioritizedWork {
+            friend class PriorityDispatcher;
+            bool m_queued = false; ///< Guarded by the dispatcher's context lock
+
+        public:
+            virtual ~PrioritizedWork() = default;
+
+            /**
+             * @brief Executes the work on the dispatcher's context.
+             */
+            virtual void runPrioritized() = 0;
+
+            /**
+             * @brief Called after runPrioritized(); one-shot items free
+             * themselves here.
+             */
+            virtual void release() {}
+    };
+
+    /**
+     * @class FunctionWork
+     * @brief Perpetual work item that calls a plain function, e.g. a
+     * periodic statistics task.
+     */
+    class FunctionWork final : public PrioritizedWork {
+            void (*const m_function)();
+
+        public:
+            explicit FunctionWork(void (*function)()) : m_function(function) {}
+
+            void runPrioritized() override { m_function(); }
+    };
+
+    /**
+     * @class PriorityDispatcher
+     * @brief Drains prioritised work for one context, higher classes first.
+     *
+     * Each pass runs up to a per-class budget of items, highest class first.
+     * Once the pass has used its time budget, lower classes are skipped.
+     * A class that has been skipped for the configured number of consecutive
+     * passes runs at least one item in the next pass regardless (starvation
+     * limit). If items remain, the dispatcher re-arms itself.
+     *
+     * post() may be called from any core; queues are guarded by the
+     * context lock. Enqueue lock times are recorded in the context's
+     * LockProfiler as ENQUEUE; each pass is recorded as WORKER_DISPATCH with
+     * the time from arming to the pass as wait and its duration as hold.
+     */
+    class PriorityDispatcher final : public PerpetualBridge {
+        public:
+            static constexpr std::size_t QUEUE_CAPACITY = 64;
+
+        private:
+            struct Queue {
+                    std::array<PrioritizedWork *, QUEUE_CAPACITY> items{};
+                    std::size_t head = 0;
+                    std::size_t count = 0;
+                    uint8_t skipped_passes = 0;
+                    uint32_t executed = 0;
+                    uint32_t rejected = 0;
+            };
+
+            std::array<Queue, WORK_PRIORITY_CLASSES> m_queues{};
+            std::array<uint8_t, WORK_PRIORITY_CLASSES> m_budget = {16, 8, 4};
+            uint32_t m_pass_budget_us = 500; ///< Time budget per pass
+            uint8_t m_starvation_limit = 4;  ///< Max consecutive skips
+            uint32_t m_passes = 0;
+            bool m_armed = false;     ///< A pass is pending
+            uint32_t m_armed_us = 0;  ///< When the pending pass was armed
+
+            void arm();
+
+            PrioritizedWork *pop(Queue &queue);
+
+        protected:
+            /**
+             * @brief Runs one bounded pass over the queues.
+             */
+            void onWork() override;
+
+        public:
+            /**
+             * @brief Constructs a PriorityDispatcher for @p ctx.
+             *
+             * initialiseBridge() must be called once the context is up.
+             *
+             * @param ctx Context the queued work runs on
+             */
+            explicit PriorityDispatcher(const AsyncCtx &ctx)
+                : PerpetualBridge(ctx) {}
+
+            /**
+             * @brief Queues @p work in @p priority and arms the dispatcher.
+             *
+             * @return true if the item is queued (or already was); false if
+             * the class queue is full and the caller must run the work
+             * another way
+             */
+            bool post(PrioritizedWork &work, WorkPriority priority);
+
+            /**
+             * @brief Sets the number of items a class may run per pass.
+             */
+            void setBudget(WorkPriority priority, uint8_t items);
+
+            /**
+             * @brief Sets the time budget per pass and the number of passes
+             * a class may be skipped before it is forced to run.
+             */
+            void setPassLimits(uint32_t pass_budget_us,
+                               uint8_t starvation_limit);
+
+            [[nodiscard]] uint32_t executed(WorkPriority priority) const;
+            [[nodiscard]] uint32_t rejected(WorkPriority priority) const;
+            [[nodiscard]] uint32_t passes() const { return m_passes; }
+    };
+
+} // namespace e5
@@ -0,0 +1,53 @@
+/**
+ * @file QotdBatchFinHandler.hpp
+ * @brief Defines the FIN handler of the batch QOTD mode.
+ *
+ * This file contains the QotdBatchFinHandler class which drains what is
+ * left of a batch QOTD connection through the QuoteRecordParser when the
+ * server closes it, ends the batch and closes the connection.
+ *
+ * @author Goran
+ * @date 2025-09-25
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+#include "QuoteRecordParser.hpp"
+#include "ResumableHandler.hpp"
+
+namespace e5 {
+    using namespace async_tcp;
+
+    /**
+     * @class QotdBatchFinHandler
+     * @brief Ends a batch QOTD connection.
+     *
+     * The remaining RX data is drained in budgeted slices, like
+     * QotdFinHandler; a batch can hold several kilobytes.
+     */
+    class QotdBatchFinHandler final : public ResumableHandler {
+            QuoteRecordParser &m_parser;
+
+        protected:
+            /**
+             * @brief Drains remaining records within @p budget, then ends
+             * the batch and closes the connection.
+             */
+            SliceResult onSlice(ConnectionTable::Slot slot,
+                                SliceBudget &budget) override;
+
+        public:
+            QotdBatchFinHandler(ConnectionTable &table,
+                                QuoteRecordParser &parser)
+                : ResumableHandler(table, WorkPriority::NETWORK_CRITICAL, 256,
+                                   1000),
+                  m_parser(parser) {}
+
+            // Override the virtual workload for RxBuffer
+            void workload(const ConnectionTable::Slot slot,
+                          void *data) override {
+                m_table.setRxBuffer(slot, static_cast<IoRxBuffer *>(data));
+            }
+    };
+
+} // namespace e5
@@ -0,0 +1,47 @@
+/**
+ * @file QotdBatchReceivedHandler.hpp
+ * @brief Defines the data received handler of the batch QOTD mode.
+ *
+ * This file contains the QotdBatchReceivedHandler class which feeds the data
+ * of a batch QOTD connection to a QuoteRecordParser as it arrives, so quotes
+ * reach the QuoteHistory before the server closes the connection.
+ *
+ * @author Goran
+ * @date 2025-09-25
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+#include "ConnectionHandler.hpp"
+#include "QuoteRecordParser.hpp"
+
+namespace e5 {
+    using namespace async_tcp;
+
+    /**
+     * @class QotdBatchReceivedHandler
+     * @brief Parses batch QOTD records as they are received.
+     *
+     * Unlike QotdReceivedHandler, every available byte is consumed: a
+     * record needs no more than its own bytes in the parser, and nothing
+     * crosses to the other core on the receive path.
+     */
+    class QotdBatchReceivedHandler final : public ConnectionHandler {
+            QuoteRecordParser &m_parser;
+
+        public:
+            void onWork(ConnectionTable::Slot slot) override;
+
+            QotdBatchReceivedHandler(ConnectionTable &table,
+                                     QuoteRecordParser &parser)
+                : ConnectionHandler(table), m_parser(parser) {}
+
+            // Override the virtual workload for RxBuffer
+            void workload(const ConnectionTable::Slot slot,
+                          void *data) override {
+                m_table.setRxBuffer(slot, static_cast<IoRxBuffer *>(data));
+                m_table.countRxEvent(slot);
+            }
+    };
+
+} // namespace e5
@@ -3,6 +3,7 @@
 #include <cstddef>
 
 // Global configuration for QOTD test app
-// Defined in src/main.cpp
-extern const std::size_t QOTD_PARTIAL_CONSUMPTION_THRESHOLD;
+// Defined in src/main.cpp. Read by the QOTD handlers on ctx0; the native
+// build's threshold sweep changes it between cycles. SIZE_MAX is unlimited.
+extern std::size_t QOTD_PARTIAL_CONSUMPTION_THRESHOLD;
 
@@ -17,11 +17,10 @@
  */
 
 #pragma once
-#include "ContextManager.hpp"
-#include "PerpetualBridge.hpp"
+#include "ConnectionHandler.hpp"
 #include "QuoteBuffer.hpp"
+#include "QuoteClaim.hpp"
 #include "SerialPrinter.hpp"
-#include "TcpClient.hpp"
 
 namespace e5 {
     using namespace async_tcp;
@@ -31,23 +30,24 @@ namespace e5 {
      * @brief Handles the connection established event for a QOTD client.
      *
      * This handler is triggered when a TCP connection is successfully
-     * established for a Quote of the Day (QOTD) client. It implements the
-     * EventBridge pattern to ensure that the handling occurs on the correct
-     * core with proper thread safety.
+     * established for a Quote of the Day (QOTD) client. It is bridged per
+     * connection through a ConnectionBridge to ensure that the handling occurs
+     * on the correct core with proper thread safety.
      *
      * The handler configures the connection for optimal QOTD protocol
      * performance by enabling keep-alive and disabling Nagle's algorithm for
      * lower latency.
      */
-    class QotdConnectedHandler final : public PerpetualBridge {
-            TcpClient &m_io; /**< Reference to the TCP client handling the
-                                     connection. */
+    class QotdConnectedHandler final : public ConnectionHandler {
             SerialPrinter &m_serial_printer; /**< Reference to the serial
                                                 printer for output. */
             QuoteBuffer
                 &m_quote_buffer; /**< Buffer for storing the quote data. */
+            bool m_notify = true; /**< Print a line per connection. */
+            QuoteClaim *m_claim; /**< Owner of the shared quote buffer, or
+                                    nullptr when the buffer is not shared. */
 
-        protected:
+        public:
             /**
              * @brief Handles the connection established event.
              *
@@ -60,26 +60,32 @@ namespace e5 {
              * initialized, ensuring proper core affinity for non-thread-safe
              * operations.
              */
-            void onWork() override;
+            void onWork(ConnectionTable::Slot slot) override;
 
-        public:
             /**
              * @brief Constructs a QotdConnectedHandler.
              *
-             * @param ctx Shared pointer to the context manager that will
-             * execute this handler
-             * @param io Reference to the TCP client that established the
-             * connection
+             * @param table Table holding the per-connection state
              * @param serial_printer Reference to the serial printer for output
              * messages
              * @param quote_buffer
+             * @param claim Claimed by the first racer to connect, if racers
+             * share @p quote_buffer
+             */
+            QotdConnectedHandler(ConnectionTable &table,
+                                 SerialPrinter &serial_printer,
+                                 QuoteBuffer &quote_buffer,
+                                 QuoteClaim *claim = nullptr)
+                : ConnectionHandler(table, WorkPriority::NORMAL),
+                  m_serial_printer(serial_printer),
+                  m_quote_buffer(quote_buffer), m_claim(claim) {}
+
+            /**
+             * @brief Enables or disables the per-connection message.
+             *
+             * Load-generating sessions connect too often to print each one.
              */
-            explicit QotdConnectedHandler(const AsyncCtx &ctx,
-                                          TcpClient &io,
-                                          SerialPrinter &serial_printer,
-                                          QuoteBuffer &quote_buffer)
-                : PerpetualBridge(ctx), m_io(io), m_serial_printer(serial_printer),
-                  m_quote_buffer(quote_buffer) {}
+            void setNotify(const bool notify) { m_notify = notify; }
     };
 
 } // namespace e5
\ No newline at end of file
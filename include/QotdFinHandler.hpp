@@ -15,10 +15,9 @@
  */
 
 #pragma once
-#include "ContextManager.hpp"
-#include "PerpetualBridge.hpp"
 #include "QuoteBuffer.hpp"
-#include "TcpClient.hpp"
+#include "QuoteClaim.hpp"
+#include "ResumableHandler.hpp"
 
 namespace e5 {
     using namespace async_tcp;
@@ -28,50 +27,53 @@ namespace e5 {
      * @brief Handles the FIN event for a QOTD client.
      *
      * This handler is triggered when a FIN packet is received, indicating
-     * the graceful termination of a connection by the server. It implements the
-     * EventBridge pattern to ensure that the handling occurs on the correct
-     * core with proper thread safety.
+     * the graceful termination of a connection by the server. It is bridged
+     * per connection through a ConnectionBridge to ensure that the handling
+     * occurs on the correct core with proper thread safety.
+     *
+     * The remaining RX data is drained in budgeted slices; a large backlog
+     * is spread over several invocations instead of monopolising the
+     * context with blocking cross-core QuoteBuffer calls.
      */
-    class QotdFinHandler final : public PerpetualBridge {
-            TcpClient &m_io; /**< Reference to the TCP client handling the
-                                     connection. */
-        IoRxBuffer *m_rx_buffer = nullptr; /**< Pointer to the IO receive buffer
-                                         associated with the TCP
-                                         client. */
+    class QotdFinHandler final : public ResumableHandler {
             QuoteBuffer
                 &m_quote_buffer; /**< Buffer for storing the quote data. */
+            QuoteClaim *m_claim; /**< Owner of the shared quote buffer, or
+                                    nullptr when the buffer is not shared. */
 
         protected:
             /**
-             * @brief Handles the FIN event.
+             * @brief Handles one slice of the FIN event.
              *
-             * This method is called when a FIN packet is received.
+             * Drains remaining data within @p budget. Once the RX buffer is
+             * empty, marks the quote complete and stops the connection.
              *
              * The method is executed on the core where the ContextManager was
              * initialized, ensuring proper core affinity for non-thread-safe
              * operations.
              */
-            void onWork() override;
+            SliceResult onSlice(ConnectionTable::Slot slot,
+                                SliceBudget &budget) override;
 
         public:
             /**
              * @brief Constructs a QotdFinHandler.
              *
-             * @param ctx A shared pointer to the context manager that will
-             * execute this handler.
-             * @param io A reference to the TCP client that established the
-             * connection.
+             * @param table Table holding the per-connection state.
              * @param quote_buffer
+             * @param claim Must be held to write @p quote_buffer, if racers
+             * share it
              */
-            explicit QotdFinHandler(const AsyncCtx &ctx,
-                                          TcpClient &io,
-                                          QuoteBuffer &quote_buffer)
-                : PerpetualBridge(ctx), m_io(io),
-                  m_quote_buffer(quote_buffer) {}
+            QotdFinHandler(ConnectionTable &table, QuoteBuffer &quote_buffer,
+                           QuoteClaim *claim = nullptr)
+                : ResumableHandler(table, WorkPriority::NETWORK_CRITICAL, 256,
+                                   1000),
+                  m_quote_buffer(quote_buffer), m_claim(claim) {}
 
             // Override the virtual workload for RxBuffer
-            void workload(void *data) override {
-                m_rx_buffer = static_cast<IoRxBuffer*>(data);
+            void workload(const ConnectionTable::Slot slot,
+                          void *data) override {
+                m_table.setRxBuffer(slot, static_cast<IoRxBuffer *>(data));
             }
 
     };
@@ -16,10 +16,9 @@
  */
 
 #pragma once
-#include "ContextManager.hpp"
-#include "PerpetualBridge.hpp"
+#include "ConnectionHandler.hpp"
 #include "QuoteBuffer.hpp"
-#include "TcpClient.hpp"
+#include "QuoteClaim.hpp"
 
 namespace e5 {
     using namespace async_tcp;
@@ -30,22 +29,22 @@ namespace e5 {
      * client.
      *
      * This handler is triggered when quote data is received on a TCP
-     * connection. It implements the EventBridge pattern to ensure that the
-     * handling occurs on the correct core with proper thread safety.
+     * connection. It is bridged per connection through a ConnectionBridge to
+     * ensure that the handling occurs on the correct core with proper thread
+     * safety.
      *
      * The handler reads the received data, stores it in a thread-safe
      * QuoteBuffer, and simulates data processing through the
      * simulateProcessData method.
      */
-    class QotdReceivedHandler final : public PerpetualBridge {
+    class QotdReceivedHandler final : public ConnectionHandler {
             QuoteBuffer
                 &m_quote_buffer; /**< Reference to the thread-safe buffer where
                                     the quote will be stored. */
-            IoRxBuffer *m_rx_buffer = nullptr; /**< Pointer to the IO receive b
-                                                  buffer associated with the TCP
-                                                     client. */
+            QuoteClaim *m_claim; /**< Owner of the shared quote buffer, or
+                                    nullptr when the buffer is not shared. */
 
-        protected:
+        public:
             /**
              * @brief Handles the data received event.
              *
@@ -62,23 +61,28 @@ namespace e5 {
              * initialized, ensuring proper core affinity for non-thread-safe
              * operations.
              */
-            void onWork() override;
+            void onWork(ConnectionTable::Slot slot) override;
 
-        public:
             /**
              * @brief Constructs a QotdReceivedHandler.
              *
-             * @param ctx Shared pointer to the context manager that will
-             * execute this handler
+             * @param table Table holding the per-connection state
              * @param quote_buffer Reference to the thread-safe buffer where the
              * quote will be stored
+             * @param claim Must be held to write @p quote_buffer, if racers
+             * share it
              */
-            QotdReceivedHandler(const AsyncCtx &ctx, QuoteBuffer &quote_buffer)
-                : PerpetualBridge(ctx), m_quote_buffer(quote_buffer) {}
+            QotdReceivedHandler(ConnectionTable &table,
+                                QuoteBuffer &quote_buffer,
+                                QuoteClaim *claim = nullptr)
+                : ConnectionHandler(table), m_quote_buffer(quote_buffer),
+                  m_claim(claim) {}
 
             // Override the virtual workload for RxBuffer
-            void workload(void *data) override {
-                m_rx_buffer = static_cast<IoRxBuffer *>(data);
+            void workload(const ConnectionTable::Slot slot,
+                          void *data) override {
+                m_table.setRxBuffer(slot, static_cast<IoRxBuffer *>(data));
+                m_table.countRxEvent(slot);
             }
     };
 
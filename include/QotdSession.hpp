@@ -0,0 +1,242 @@
+/**
+ * @file QotdSession.hpp
+ * @brief Self-contained QOTD client session and a rate-driven pool of them.
+ *
+ * This file contains the QotdSession class, which bundles everything one
+ * concurrent QOTD fetch needs: the TcpClient, its connected/received/FIN
+ * handlers, its own QuoteBuffer and its statistics, and the QotdSessionPool
+ * class which drives N sessions at a target aggregate rate. Together they
+ * turn the application into a load generator for the async-tcp stack.
+ *
+ * @author Goran
+ * @date 2025-09-19
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ConnectionManager.hpp"
+#include "ConnectionTable.hpp"
+#include "EndpointSelector.hpp"
+#include "Log2Histogram.hpp"
+#include "PriorityDispatcher.hpp"
+#include "QotdConnectedHandler.hpp"
+#include "QotdFinHandler.hpp"
+#include "QotdReceivedHandler.hpp"
+#include "QuoteBuffer.hpp"
+#include "SerialPrinter.hpp"
+#include "TcpClient.hpp"
+#include "TcpErrorHandler.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace e5 {
+
+    using namespace async_tcp;
+
+    /**
+     * @class QotdSession
+     * @brief One QOTD client with its own handlers, quote and statistics.
+     *
+     * The session's handlers are ConnectionHandlers like the application's
+     * shared ones, but bound to the session's QuoteBuffer, so quotes fetched
+     * concurrently never overwrite each other. Connection state lives in the
+     * shared ConnectionTable under the session's client ID, and the
+     * lifecycle is a PER_CYCLE ConnectionManager.
+     */
+    class QotdSession {
+        public:
+            /**
+             * @brief Result of a poll().
+             */
+            enum class Outcome : uint8_t {
+                NONE,      ///< Nothing finished
+                COMPLETED, ///< The cycle saw its FIN; latency is valid
+                FAILED,    ///< The cycle failed or missed its deadline
+            };
+
+        private:
+            TcpClient m_client;
+            QuoteBuffer m_quote;
+            QotdConnectedHandler m_connected_handler;
+            QotdReceivedHandler m_received_handler;
+            QotdFinHandler m_fin_handler;
+            ConnectionManager m_manager;
+
+            bool m_running = false;
+            uint32_t m_started_us = 0;
+            uint32_t m_seen_completed = 0;
+            uint32_t m_seen_failed = 0;
+
+            uint32_t m_cycles = 0;
+            uint32_t m_completed = 0;
+            uint32_t m_failed = 0;
+            uint32_t m_latency_max_us = 0;
+
+        public:
+            /**
+             * @brief Constructs a QotdSession.
+             *
+             * @param table Table shared with the application's connections
+             * @param quote_ctx Context the session's QuoteBuffer runs on
+             * @param printer Printer used by the connected handler
+             */
+            QotdSession(ConnectionTable &table, const AsyncCtx &quote_ctx,
+                        SerialPrinter &printer);
+
+            QotdSession(const QotdSession &) = delete;
+            QotdSession &operator=(const QotdSession &) = delete;
+
+            /**
+             * @brief Sets up the client on @p net_ctx and registers its
+             * bridges.
+             *
+             * @param net_ctx Context the client's events run on
+             * @param client_id Unique client ID (ConnectionTable key)
+             * @param error_handler Shared error handler
+             * @return false if the ConnectionTable is full
+             */
+            bool begin(const AsyncCtx &net_ctx, int client_id,
+                       TcpErrorHandler &error_handler);
+
+            /**
+             * @brief Attaches the session's handlers to a dispatcher.
+             */
+            void setDispatcher(PriorityDispatcher *dispatcher);
+
+            /**
+             * @brief Starts a cycle against @p address : @p port.
+             *
+             * @return false if the previous cycle is not finished or the
+             * connection attempt could not be started
+             */
+            bool start(const IPAddress &address, uint16_t port);
+
+            /**
+             * @brief Advances the session; call on every loop pass.
+             *
+             * @param latency_us Set to the connect-to-FIN time on COMPLETED
+             */
+            Outcome poll(uint32_t &latency_us);
+
+            /**
+             * @brief True when a cycle can be started right away.
+             */
+            [[nodiscard]] bool idle() const {
+                return !m_running &&
+                       m_manager.state() == ConnectionState::IDLE;
+            }
+            [[nodiscard]] QuoteBuffer &quote() { return m_quote; }
+            [[nodiscard]] uint32_t cycles() const { return m_cycles; }
+            [[nodiscard]] uint32_t completed() const { return m_completed; }
+            [[nodiscard]] uint32_t failed() const { return m_failed; }
+            [[nodiscard]] uint32_t latencyMaxUs() const {
+                return m_latency_max_us;
+            }
+    };
+
+    /**
+     * @class QotdSessionPool
+     * @brief Runs up to MAX_SESSIONS QotdSessions at a target rate.
+     *
+     * poll() starts a cycle on the next idle session every 1/rate seconds,
+     * round robin, against the best QOTD endpoint. A start that finds no
+     * idle session is counted as missed: the sessions cannot keep up with
+     * the rate. If the pool falls more than a few intervals behind, the
+     * schedule is reset instead of bursting to catch up.
+     *
+     * Phase statistics (completions, failures, misses and a connect-to-FIN
+     * latency histogram) accumulate until resetPhase().
+     */
+    class QotdSessionPool {
+        public:
+            static constexpr std::size_t MAX_SESSIONS = 8;
+            static constexpr std::size_t LATENCY_BUCKETS = 24;
+
+        private:
+            ConnectionTable &m_table;
+            const AsyncCtx &m_quote_ctx;
+            SerialPrinter &m_printer;
+            EndpointSelector &m_endpoints;
+
+            std::unique_ptr<QotdSession> m_sessions[MAX_SESSIONS];
+            std::size_t m_count = 0;
+            std::size_t m_next = 0; ///< Round-robin cursor
+
+            uint32_t m_interval_us = 0; ///< 0 when stopped
+            uint32_t m_next_us = 0;     ///< Time of the next start
+
+            Log2Histogram<LATENCY_BUCKETS> m_latency;
+            uint32_t m_phase_started_us = 0;
+            uint32_t m_started = 0;
+            uint32_t m_completed = 0;
+            uint32_t m_failed = 0;
+            uint32_t m_missed = 0;
+
+            QotdSession *nextIdle();
+
+        public:
+            /**
+             * @brief Constructs an empty pool.
+             *
+             * @param table Table shared with the application's connections
+             * @param quote_ctx Context the sessions' QuoteBuffers run on
+             * @param printer Printer used by the sessions' handlers
+             * @param endpoints QOTD endpoints; the best one is used per cycle
+             */
+            QotdSessionPool(ConnectionTable &table, const AsyncCtx &quote_ctx,
+                            SerialPrinter &printer,
+                            EndpointSelector &endpoints)
+                : m_table(table), m_quote_ctx(quote_ctx), m_printer(printer),
+                  m_endpoints(endpoints) {}
+
+            /**
+             * @brief Creates @p count sessions on @p net_ctx.
+             *
+             * Client IDs are assigned from @p first_client_id upwards.
+             *
+             * @return Number of sessions created
+             */
+            std::size_t begin(std::size_t count, const AsyncCtx &net_ctx,
+                              int first_client_id,
+                              TcpErrorHandler &error_handler);
+
+            /**
+             * @brief Attaches every session's handlers to a dispatcher.
+             */
+            void setDispatcher(PriorityDispatcher *dispatcher);
+
+            /**
+             * @brief Sets the aggregate target rate; 0 stops new cycles.
+             */
+            void setRate(uint32_t cycles_per_second);
+
+            /**
+             * @brief Polls the sessions and starts cycles on schedule.
+             */
+            void poll();
+
+            /**
+             * @brief Clears the phase statistics.
+             */
+            void resetPhase();
+
+            [[nodiscard]] std::size_t size() const { return m_count; }
+            [[nodiscard]] const QotdSession &session(std::size_t i) const {
+                return *m_sessions[i];
+            }
+            [[nodiscard]] const Log2Histogram<LATENCY_BUCKETS> &
+            latency() const {
+                return m_latency;
+            }
+            [[nodiscard]] uint32_t phaseUs() const {
+                return time_us_32() - m_phase_started_us;
+            }
+            [[nodiscard]] uint32_t started() const { return m_started; }
+            [[nodiscard]] uint32_t completed() const { return m_completed; }
+            [[nodiscard]] uint32_t failed() const { return m_failed; }
+            [[nodiscard]] uint32_t missed() const { return m_missed; }
+    };
+
+} // namespace e5
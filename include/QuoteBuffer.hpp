@@ -12,6 +12,7 @@
  */
 #pragma once
 #include "ContextManager.hpp"
+#include "InlineDispatch.hpp"
 #include "SyncBridge.hpp"
 #include <string>
 
@@ -39,6 +40,7 @@ namespace e5 {
 
             std::string m_buffer; ///< The internal string buffer
             bool m_quote_complete = false; ///< Flag indicating if current quote is complete
+            InlineDispatch m_dispatch; ///< Same-core fast path and counters
 
             /**
              * @struct BufferPayload
@@ -79,6 +81,27 @@ namespace e5 {
              */
             uint32_t onExecute(SyncPayloadPtr payload) override;
 
+            /**
+             * @brief Applies a buffer operation; the context lock is held
+             *
+             * @param payload Buffer operation instruction
+             * @return PICO_OK on success, or error code on failure
+             */
+            uint32_t apply(const SyncPayloadPtr &payload);
+
+            /**
+             * @brief Runs a buffer operation inline or through the bridge
+             *
+             * Operations issued on the buffer's context core run onExecute()
+             * directly under the context lock; all others go through
+             * SyncBridge::execute(). Bridged round trips are recorded in the
+             * context's LockProfiler as BRIDGE_EXECUTE latency.
+             *
+             * @param payload Buffer operation instruction
+             * @return PICO_OK on success, or error code on failure
+             */
+            uint32_t submit(SyncPayloadPtr payload);
+
         public:
             /**
              * @brief Constructs a QuoteBuffer with the specified context
@@ -153,6 +176,11 @@ namespace e5 {
              * when starting to receive a new quote.
              */
             void resetBuffer();
+
+            /**
+             * @brief Returns the dispatcher deciding inline vs queued access.
+             */
+            [[nodiscard]] InlineDispatch &dispatch() { return m_dispatch; }
     };
 
 } // namespace e5
@@ -0,0 +1,64 @@
+/**
+ * @file QuoteClaim.hpp
+ * @brief Ownership of the shared QuoteBuffer by one racing connection.
+ *
+ * This file contains the QuoteClaim class which decides which connection of
+ * an endpoint race may write the QuoteBuffer. Both racers' handlers run on
+ * ctx0 and share one buffer; without a claim the loser could reset or
+ * append to it before the loop has seen the winner and muted the loser.
+ *
+ * @author Goran
+ * @date 2025-09-30
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ConnectionTable.hpp"
+#include <atomic>
+
+namespace e5 {
+
+    /**
+     * @class QuoteClaim
+     * @brief The first connection to claim() it after reset() owns it.
+     *
+     * claim() runs in the QOTD handlers on ctx0; reset() is called by the
+     * loop on core 0 before a cycle starts, when no QOTD connection is open.
+     * owner() may be read from either core; EndpointRace uses it to make the
+     * owner the winner of the race.
+     */
+    class QuoteClaim {
+            std::atomic<ConnectionTable::Slot> m_owner{
+                ConnectionTable::NO_SLOT};
+
+        public:
+            /**
+             * @brief Takes ownership for @p slot if nobody holds it.
+             *
+             * @return true if @p slot owns the claim
+             */
+            bool claim(const ConnectionTable::Slot slot) {
+                // Only ctx0 claims, so a load and a store cannot race
+                const auto owner = m_owner.load(std::memory_order_relaxed);
+                if (owner == ConnectionTable::NO_SLOT) {
+                    m_owner.store(slot, std::memory_order_release);
+                    return true;
+                }
+                return owner == slot;
+            }
+
+            /**
+             * @brief Releases ownership for the next cycle.
+             */
+            void reset() {
+                m_owner.store(ConnectionTable::NO_SLOT,
+                              std::memory_order_release);
+            }
+
+            [[nodiscard]] ConnectionTable::Slot owner() const {
+                return m_owner.load(std::memory_order_acquire);
+            }
+    };
+
+} // namespace e5
@@ -0,0 +1,78 @@
+/**
+ * @file QuoteHistory.hpp
+ * @brief Fixed ring of quotes received but not yet used.
+ *
+ * This file contains the QuoteHistory class which holds the quotes parsed
+ * from a batch QOTD connection until the loop takes them, one per echo tick.
+ * Entries are preallocated at the RFC 865 maximum quote length, so no heap
+ * allocation happens on the receive path.
+ *
+ * @author Goran
+ * @date 2025-09-25
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace e5 {
+
+    /**
+     * @class QuoteHistory
+     * @brief Single-producer, single-consumer ring of quotes.
+     *
+     * push() is called by the batch QOTD handlers on ctx0 and pop() by the
+     * loop on the same core. Each index has one writer, so no lock is
+     * needed. A push into a full ring drops the new quote and counts it; the
+     * producer never moves the consumer's index.
+     */
+    class QuoteHistory {
+        public:
+            static constexpr std::size_t CAPACITY = 8;
+            static constexpr std::size_t MAX_QUOTE_BYTES = 512; ///< RFC 865
+
+        private:
+            struct Entry {
+                    uint16_t length = 0;
+                    char text[MAX_QUOTE_BYTES];
+            };
+
+            Entry m_ring[CAPACITY];
+            std::atomic<uint32_t> m_head{0}; ///< Quotes pushed
+            std::atomic<uint32_t> m_tail{0}; ///< Quotes popped
+            uint32_t m_dropped = 0;          ///< Pushes into a full ring
+
+        public:
+            QuoteHistory() = default;
+            QuoteHistory(const QuoteHistory &) = delete;
+            QuoteHistory &operator=(const QuoteHistory &) = delete;
+
+            /**
+             * @brief Appends a quote, truncated to MAX_QUOTE_BYTES.
+             *
+             * @return false if the ring was full and the quote was dropped
+             */
+            bool push(const char *text, std::size_t length);
+
+            /**
+             * @brief Takes the oldest quote.
+             *
+             * @return false if the ring is empty
+             */
+            bool pop(std::string &out);
+
+            [[nodiscard]] std::size_t pending() const {
+                return m_head.load(std::memory_order_acquire) -
+                       m_tail.load(std::memory_order_acquire);
+            }
+            [[nodiscard]] uint32_t pushed() const {
+                return m_head.load(std::memory_order_relaxed);
+            }
+            [[nodiscard]] uint32_t dropped() const { return m_dropped; }
+    };
+
+} // namespace e5
@@ -0,0 +1,100 @@
+/**
+ * @file QuoteRecordParser.hpp
+ * @brief Incremental parser for length-prefixed batch QOTD records.
+ *
+ * This file contains the QuoteRecordParser class. In the extended batch
+ * mode a QOTD server sends K quotes on one connection, each as a record of
+ * a 16-bit big-endian length followed by that many bytes of quote text,
+ * and then closes. The parser takes the stream in whatever pieces TCP
+ * delivers it, keeps partial headers and quotes between calls, and pushes
+ * each completed quote into a QuoteHistory.
+ *
+ * @author Goran
+ * @date 2025-09-25
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ConnectionTable.hpp"
+#include "QuoteHistory.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace e5 {
+
+    /**
+     * @class QuoteRecordParser
+     * @brief Splits a batch QOTD stream into quotes.
+     *
+     * One parser serves one batch connection at a time. The first
+     * connection to claim() it after reset() owns it, so data arriving on
+     * the other racer of an endpoint race before it is muted cannot corrupt
+     * the framing. Quotes longer than QuoteHistory::MAX_QUOTE_BYTES are
+     * truncated; the rest of the record is skipped.
+     *
+     * claim(), feed() and finish() run in the batch handlers on ctx0;
+     * reset() is called by the loop on core 0 before a cycle starts, when no
+     * batch connection is open. The counters have a single writer and may
+     * be read from either core.
+     */
+    class QuoteRecordParser {
+        public:
+            static constexpr std::size_t HEADER_BYTES = 2;
+
+        private:
+            QuoteHistory &m_history;
+            ConnectionTable::Slot m_owner = ConnectionTable::NO_SLOT;
+            uint8_t m_header_bytes = 0; ///< Header bytes of the current record
+            uint16_t m_length = 0;      ///< Length of the current record
+            uint16_t m_received = 0;    ///< Quote bytes of it received
+            char m_record[QuoteHistory::MAX_QUOTE_BYTES];
+
+            uint32_t m_records = 0;
+            uint32_t m_payload_bytes = 0;
+            uint32_t m_framing_bytes = 0;
+            uint32_t m_truncated = 0;  ///< Records cut to MAX_QUOTE_BYTES
+            uint32_t m_incomplete = 0; ///< Batches that ended mid-record
+
+            void complete();
+
+        public:
+            explicit QuoteRecordParser(QuoteHistory &history)
+                : m_history(history) {}
+
+            /**
+             * @brief Takes ownership for @p slot if the parser is free.
+             *
+             * @return true if @p slot owns the parser
+             */
+            bool claim(ConnectionTable::Slot slot);
+
+            /**
+             * @brief Parses @p size bytes; all of them are consumed.
+             */
+            void feed(const char *data, std::size_t size);
+
+            /**
+             * @brief Ends the batch of the owning connection at its FIN.
+             *
+             * A partial record is counted as incomplete and dropped.
+             */
+            void finish();
+
+            /**
+             * @brief Drops any partial record and releases ownership.
+             */
+            void reset();
+
+            [[nodiscard]] uint32_t records() const { return m_records; }
+            [[nodiscard]] uint32_t payloadBytes() const {
+                return m_payload_bytes;
+            }
+            [[nodiscard]] uint32_t framingBytes() const {
+                return m_framing_bytes;
+            }
+            [[nodiscard]] uint32_t truncated() const { return m_truncated; }
+            [[nodiscard]] uint32_t incomplete() const { return m_incomplete; }
+    };
+
+} // namespace e5
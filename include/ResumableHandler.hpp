@@ -0,0 +1,140 @@
+/**
+ * @file ResumableHandler.hpp
+ * @brief Connection handler that works in budgeted, resumable slices.
+ *
+ * This file contains the ResumableHandler class. Instead of draining all
+ * available work in one invocation, a resumable handler processes a slice
+ * bounded by a byte and a time budget and reports whether more work is
+ * pending. The connection's bridge then reschedules it behind other pending
+ * work on the context. Partial progress lives in the connection's state
+ * (e.g. data already consumed from the IoRxBuffer), so the next slice simply
+ * continues.
+ *
+ * @author Goran
+ * @date 2025-09-09
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ConnectionHandler.hpp"
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace e5 {
+
+    using namespace async_tcp;
+
+    /**
+     * @struct SliceBudget
+     * @brief Remaining byte and time budget of one handler slice.
+     */
+    struct SliceBudget {
+            std::size_t bytes;       ///< Bytes the slice may still process
+            uint32_t deadline_us;    ///< time_us_32() value the slice ends at
+            bool progressed = false; ///< A unit has been charged
+
+            /**
+             * @brief True once either the byte or the time budget is used up.
+             *
+             * Never true before the first unit has been charged, so every
+             * slice makes progress however small the budget.
+             */
+            [[nodiscard]] bool exhausted() const {
+                return progressed &&
+                       (bytes == 0 ||
+                        static_cast<int32_t>(time_us_32() - deadline_us) >= 0);
+            }
+
+            /**
+             * @brief Charges @p processed bytes against the budget.
+             */
+            void consume(const std::size_t processed) {
+                bytes = processed >= bytes ? 0 : bytes - processed;
+                progressed = true;
+            }
+    };
+
+    /**
+     * @brief Outcome of a handler slice.
+     */
+    enum class SliceResult : uint8_t {
+        DONE,         ///< No work left for this connection
+        MORE_PENDING, ///< Budget exhausted; reschedule to continue
+    };
+
+    /**
+     * @class ResumableHandler
+     * @brief ConnectionHandler whose work is split into budgeted slices.
+     *
+     * The upper bound of a single invocation is the time budget plus the
+     * cost of the last unit of work started before it ran out. Derived
+     * classes must check SliceBudget::exhausted() before each unit of work
+     * and return MORE_PENDING when it is set. The first unit of a slice
+     * always runs, so a handler cannot yield without progress.
+     */
+    class ResumableHandler : public ConnectionHandler {
+            static_assert(MAX_CONNECTIONS <= 32,
+                          "pending bitmap holds one bit per connection");
+
+            uint32_t m_more_pending = 0; ///< One bit per slot
+            std::size_t m_budget_bytes;  ///< Byte budget per slice
+            uint32_t m_budget_us;        ///< Time budget per slice
+
+            uint32_t m_slices = 0;       ///< Slices executed
+            uint32_t m_yields = 0;       ///< Slices that left work pending
+            uint32_t m_max_slice_us = 0; ///< Longest slice observed
+
+        protected:
+            /**
+             * @brief Processes one slice of work for @p slot.
+             *
+             * @param slot Connection slot in the table
+             * @param budget Remaining budget of this slice
+             * @return MORE_PENDING if the slice stopped on its budget
+             */
+            virtual SliceResult onSlice(ConnectionTable::Slot slot,
+                                        SliceBudget &budget) = 0;
+
+        public:
+            /**
+             * @brief Constructs a ResumableHandler.
+             *
+             * @param table Table holding the per-connection state
+             * @param priority Priority class used when a dispatcher is set
+             * @param budget_bytes Bytes a single slice may process
+             * @param budget_us Microseconds a single slice may run
+             */
+            ResumableHandler(ConnectionTable &table, WorkPriority priority,
+                             std::size_t budget_bytes, uint32_t budget_us)
+                : ConnectionHandler(table, priority),
+                  m_budget_bytes(budget_bytes ? budget_bytes : 1),
+                  m_budget_us(budget_us) {}
+
+            /**
+             * @brief Runs one slice and records whether work remains.
+             */
+            void onWork(ConnectionTable::Slot slot) final;
+
+            [[nodiscard]] bool
+            hasMoreWork(const ConnectionTable::Slot slot) const override {
+                return m_more_pending & (1u << slot);
+            }
+
+            /**
+             * @brief Sets the per-slice byte and time budget.
+             *
+             * A zero byte budget is raised to one byte; with a zero time
+             * budget every slice runs exactly one unit of work.
+             */
+            void setBudget(std::size_t bytes, uint32_t us);
+
+            [[nodiscard]] uint32_t slices() const { return m_slices; }
+            [[nodiscard]] uint32_t yields() const { return m_yields; }
+            [[nodiscard]] uint32_t maxSliceUs() const {
+                return m_max_slice_us;
+            }
+    };
+
+} // namespace e5
@@ -8,6 +8,9 @@
 
 #pragma once
 #include "ContextManager.hpp"
+#include "InlineDispatch.hpp"
+#include "PriorityDispatcher.hpp"
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -22,11 +25,20 @@ namespace e5 {
      * This class allows printing to the serial port from any core or interrupt
      * context by scheduling the actual printing operation on the appropriate
      * core through the async context.
+     *
+     * Calls made on the context's own core print inline under the context
+     * lock instead of queueing a PrintHandler. With a PriorityDispatcher
+     * attached, queued prints run in the BACKGROUND class so they cannot
+     * hold up more urgent work on the context.
      */
     class SerialPrinter {
 
             const AsyncCtx
                 &m_ctx; ///< Context manager for scheduling print operations
+            mutable InlineDispatch
+                m_dispatch; ///< Same-core fast path and dispatch counters
+            std::atomic<PriorityDispatcher *> m_priority_dispatcher{
+                nullptr}; ///< Optional dispatcher, set from either core
 
         public:
             /**
@@ -42,12 +54,28 @@ namespace e5 {
              *
              * This method schedules the printing operation to run on the core
              * where the context manager was initialized, ensuring thread
-             * safety.
+             * safety. When called on that core outside of a print already in
+             * progress, the message is printed inline.
              *
              * @param message std::string to print
              * @return PICO_OK on success, or error code on failure
              */
             uint32_t print(std::unique_ptr<std::string> message) const;
+
+            /**
+             * @brief Returns the dispatcher deciding inline vs queued prints.
+             */
+            [[nodiscard]] InlineDispatch &dispatch() const { return m_dispatch; }
+
+            /**
+             * @brief Queues prints on @p dispatcher as BACKGROUND work.
+             *
+             * The dispatcher must run on the printer's context. Pass nullptr
+             * to queue one PrintHandler per message again.
+             */
+            void setDispatcher(PriorityDispatcher *dispatcher) {
+                m_priority_dispatcher = dispatcher;
+            }
     };
 
 } // namespace e5
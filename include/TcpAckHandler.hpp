@@ -1,39 +1,51 @@
 // filepath: /home/goran/CLionProjects/pico-sdk-tests/include/TcpAckHandler.hpp
 /**
  * @file TcpAckHandler.hpp
- * @brief PerpetualBridge-based handler for ACK events carrying len payload.
+ * @brief Connection-generic handler for ACK events carrying len payload.
  */
 
 #pragma once
 
-#include "PerpetualBridge.hpp"
-#include "TcpClient.hpp"
+#include "ConnectionHandler.hpp"
+#include <Arduino.h>
 #include <cstdint>
 
 namespace e5 {
 
 using namespace async_tcp;
 
-class TcpAckHandler final : public PerpetualBridge {
-        TcpClient &m_io;           ///< TCP client reference
-        uint16_t m_len = 0;        ///< Last ACK length delivered via workload
-
-    protected:
-        void onWork() override;
+class TcpAckHandler final : public ConnectionHandler {
+        uint32_t m_latency_count = 0;    ///< ACK deliveries measured
+        uint64_t m_latency_total_us = 0; ///< Sum of ACK-to-writer latency
+        uint32_t m_latency_max_us = 0;   ///< Worst ACK-to-writer latency
 
     public:
-        TcpAckHandler(const AsyncCtx &ctx, TcpClient &io)
-            : PerpetualBridge(ctx), m_io(io) {}
+        explicit TcpAckHandler(ConnectionTable &table)
+            : ConnectionHandler(table) {}
+
+        void onWork(ConnectionTable::Slot slot) override;
 
         // Accept ACK length via EventBridge workload; takes ownership of payload
-        void workload(void *data) override {
+        void workload(const ConnectionTable::Slot slot, void *data) override {
             if (data) {
-                auto *len_ptr = static_cast<uint16_t *>(data);
-                m_len = *len_ptr;
+                const auto *len_ptr = static_cast<uint16_t *>(data);
+                m_table.addPendingAck(slot, *len_ptr, time_us_32());
                 delete len_ptr; // free payload after copying
             }
         }
+
+        // Time from the lwIP ACK callback until the writer was notified and
+        // free to send the next chunk
+        [[nodiscard]] uint32_t latencyCount() const { return m_latency_count; }
+        [[nodiscard]] uint32_t latencyAvgUs() const {
+            return m_latency_count ? m_latency_total_us / m_latency_count : 0;
+        }
+        [[nodiscard]] uint32_t latencyMaxUs() const { return m_latency_max_us; }
+        void resetLatency() {
+            m_latency_count = 0;
+            m_latency_total_us = 0;
+            m_latency_max_us = 0;
+        }
 };
 
 } // namespace e5
-
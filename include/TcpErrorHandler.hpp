@@ -13,9 +13,7 @@
 
 #pragma once
 
-#include "ContextManager.hpp"
-#include "PerpetualBridge.hpp"
-#include "TcpClient.hpp"
+#include "ConnectionHandler.hpp"
 #include <lwip/err.h>
 
 namespace e5 {
@@ -24,40 +22,37 @@ namespace e5 {
 
     /**
      * @class TcpErrorHandler
-     * @brief Handles TCP error events using EventBridge pattern
+     * @brief Handles TCP error events for any number of connections
      *
      * This handler processes error notifications from the TCP layer and
-     * performs appropriate cleanup. It follows the EventBridge pattern
-     * for proper core affinity and thread safety.
+     * performs appropriate cleanup. The error code is kept in the
+     * ConnectionTable, so a single instance serves every connection through
+     * per-connection ConnectionBridges.
      */
-    class TcpErrorHandler final : public PerpetualBridge {
-            TcpClient &m_io;                     ///< TCP client reference
-            err_t m_error = ERR_OK;             ///< Last error code delivered via workload
-
-        protected:
+    class TcpErrorHandler final : public ConnectionHandler {
+        public:
             /**
-             * @brief Processes the error event
+             * @brief Constructs a TcpErrorHandler
              *
-             * This method handles the error condition, performs cleanup,
-             * and optionally schedules retry logic.
+             * @param table Table holding the per-connection state
              */
-            void onWork() override;
+            explicit TcpErrorHandler(ConnectionTable &table)
+                : ConnectionHandler(table) {}
 
-        public:
             /**
-             * @brief Constructs a TcpErrorHandler
+             * @brief Processes the error event
              *
-             * @param ctx Context manager for execution
-             * @param io TCP client reference
+             * This method handles the error condition, performs cleanup,
+             * and optionally schedules retry logic.
              */
-            TcpErrorHandler(const AsyncCtx &ctx, TcpClient &io)
-                : PerpetualBridge(ctx), m_io(io) {}
+            void onWork(ConnectionTable::Slot slot) override;
 
             // Accept error code via EventBridge workload (mirrors EchoReceivedHandler pattern)
-            void workload(void *data) override {
+            void workload(const ConnectionTable::Slot slot,
+                          void *data) override {
                 if (data) {
                     const auto *err_ptr = static_cast<err_t*>(data);
-                    m_error = *err_ptr;
+                    m_table.setLastError(slot, *err_ptr);
                     delete err_ptr; // take ownership and free payload
                 }
             }
@@ -1,34 +1,36 @@
 #pragma once
 
-#include "PerpetualBridge.hpp"
-#include "TcpClient.hpp"
+#include "ConnectionHandler.hpp"
 #include "TcpWriter.hpp"
 
 namespace e5 {
 
     using namespace async_tcp;
 
-    class TcpPollHandler final : public PerpetualBridge {
-            TcpClient &m_io; ///< TCP client reference
+    class TcpPollHandler final : public ConnectionHandler {
+            uint32_t m_wakeups = 0; ///< Poll callbacks handled
+
+        public:
+            /**
+             * @brief Construct a TcpPollHandler with default behavior.
+             * @param table Table holding the per-connection state
+             */
+            explicit TcpPollHandler(ConnectionTable &table)
+                : ConnectionHandler(table, WorkPriority::BACKGROUND) {}
 
-        protected:
             /**
              * @brief Execute poll work under async-context guarantees.
              *
              * Default behavior mirrors TcpClient's existing poll lambda:
              * checks the writer for timeouts and triggers onWriteTimeout.
-             * If a custom action is provided, it takes precedence.
+             * Connections with a WriteDeadline in the table are skipped.
              */
-            void onWork() override;
+            void onWork(ConnectionTable::Slot slot) override;
 
-        public:
             /**
-             * @brief Construct a TcpPollHandler with default behavior.
-             * @param ctx Async context for execution
-             * @param io TcpClient reference
+             * @brief Number of poll callbacks handled, for all connections.
              */
-            TcpPollHandler(const AsyncCtx &ctx, TcpClient &io)
-                : PerpetualBridge(ctx), m_io(io) {}
+            [[nodiscard]] uint32_t wakeups() const { return m_wakeups; }
     };
 
 } // namespace e5
@@ -0,0 +1,125 @@
+/**
+ * @file WriteDeadline.hpp
+ * @brief Per-connection write timeout driven by a one-shot timed worker.
+ *
+ * This file contains the WriteDeadline class which detects stalled writes
+ * with its own timer on the connection's AsyncCtx instead of relying on the
+ * lwIP TCP poll callback. The timer is only armed while written data is
+ * waiting for an ACK, so the timer causes no wakeups on an idle connection.
+ * The lwIP poll callback keeps firing inside TcpClient; a connection with a
+ * deadline should simply not register a poll bridge.
+ *
+ * @author Goran
+ * @date 2025-09-15
+ * @ingroup AsyncTCPClient
+ */
+
+#pragma once
+
+#include "ContextManager.hpp"
+#include "TcpClient.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace e5 {
+
+    using namespace async_tcp;
+
+    /**
+     * @class WriteDeadline
+     * @brief Arms a timed worker while written data is unacknowledged.
+     *
+     * onWrite() arms the deadline, every ACK that makes progress pushes it
+     * forward, and the ACK that covers all outstanding bytes disarms it. The
+     * timed worker cannot be cancelled once queued, so the deadline is moved
+     * lazily: when the worker fires before the (moved) deadline it re-arms
+     * itself for the remainder, and when it fires after a disarm it does
+     * nothing. A generation counter lets reset() invalidate a worker that is
+     * already queued. A busy connection therefore costs at most one wakeup
+     * per timeout period, and an idle one none.
+     *
+     * When the deadline passes with data still outstanding, the writer's
+     * onWriteTimeout() is called, exactly as TcpPollHandler does when the
+     * writer reports a timeout.
+     *
+     * All state is guarded by the context lock; the methods may be called
+     * from the loop or from workers on the connection's context.
+     */
+    class WriteDeadline {
+        public:
+            /// Time a write may go without ACK progress unless configured
+            static constexpr uint32_t DEFAULT_TIMEOUT_US = 2000000;
+
+        private:
+            const AsyncCtx &m_ctx;
+            TcpClient &m_client;
+            uint32_t m_timeout_us; ///< Allowed time without progress
+
+            uint32_t m_outstanding = 0; ///< Written bytes not yet ACKed
+            uint32_t m_progress_us = 0; ///< Last write or ACK progress
+            uint32_t m_generation = 0;  ///< Invalidates queued workers
+            bool m_timer_pending = false;
+
+            uint32_t m_wakeups = 0;
+            uint32_t m_timeouts = 0;
+            uint32_t m_detect_total_us = 0; ///< Stall to detection, summed
+            uint32_t m_detect_max_us = 0;
+            uint32_t m_late_max_us = 0; ///< Detection after the deadline
+
+            void schedule(uint32_t now_us);
+
+        public:
+            /**
+             * @brief Constructs a WriteDeadline for @p client on @p ctx.
+             *
+             * @param ctx Context the client's handlers run on
+             * @param client Client whose writer is timed out
+             * @param timeout_us Time a write may go without ACK progress
+             */
+            WriteDeadline(const AsyncCtx &ctx, TcpClient &client,
+                          const uint32_t timeout_us = DEFAULT_TIMEOUT_US)
+                : m_ctx(ctx), m_client(client), m_timeout_us(timeout_us) {}
+
+            /**
+             * @brief Records @p bytes handed to the writer and arms the
+             * deadline if it is not armed yet.
+             */
+            void onWrite(std::size_t bytes);
+
+            /**
+             * @brief Records @p bytes acknowledged by the peer; pushes the
+             * deadline forward, or disarms it once nothing is outstanding.
+             */
+            void onAck(uint32_t bytes);
+
+            /**
+             * @brief Disarms the deadline and forgets outstanding bytes.
+             *
+             * Called when the connection closes or fails.
+             */
+            void reset();
+
+            /**
+             * @brief Called by the timed worker armed for @p generation.
+             */
+            void expire(uint32_t generation);
+
+            /**
+             * @brief Sets the time a write may go without ACK progress.
+             */
+            void setTimeout(const uint32_t timeout_us) {
+                m_timeout_us = timeout_us;
+            }
+
+            [[nodiscard]] uint32_t wakeups() const { return m_wakeups; }
+            [[nodiscard]] uint32_t timeouts() const { return m_timeouts; }
+            [[nodiscard]] uint32_t detectAvgUs() const {
+                return m_timeouts ? m_detect_total_us / m_timeouts : 0;
+            }
+            [[nodiscard]] uint32_t detectMaxUs() const {
+                return m_detect_max_us;
+            }
+            [[nodiscard]] uint32_t lateMaxUs() const { return m_late_max_us; }
+    };
+
+} // namespace e5
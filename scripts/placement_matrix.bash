@@ -0,0 +1,75 @@
+#!/usr/bin/env bash
+
+# placement_matrix.bash — builds the native application once per placement
+# of QuoteBuffer, SerialPrinter and the statistics tasks on ctx0, ctx1 and
+# ctx2 (include/Placement.hpp), 27 builds, runs each against the stand-in
+# servers and ranks the placements by cycle throughput.
+# Start the servers first: pio run -e servers, then .pio/build/servers/program
+# Run from the repository root: ./scripts/placement_matrix.bash
+# CYCLES=<n> cycles per run (2000), RUNS=<n> runs per placement, best kept (3)
+# STATS_MS=<ms> statistics period, passed as --stats_ms (10)
+# QOTD=<host:port> and ECHO=<host:port> (127.0.0.1:10017, 127.0.0.1:10007)
+# Raw output of every run is kept in $OUT (.pio/placement_matrix).
+# Columns: cycles/s, cycle p99 and p99.9 in us, then CPU time of core 0
+# (loop and ctx0) and core 1 (loop1 and the other contexts) in % of the run.
+# The default placement, statistics printed from loop1, is run last for
+# reference.
+
+set -euo pipefail
+
+cycles="${CYCLES:-2000}"
+runs="${RUNS:-3}"
+stats_ms="${STATS_MS:-10}"
+qotd="${QOTD:-127.0.0.1:10017}"
+echo="${ECHO:-127.0.0.1:10007}"
+out="${OUT:-.pio/placement_matrix}"
+mkdir -p "$out"
+
+results="$out/results.tsv"
+: > "$results"
+
+# measure <placement> <tag> <build flags>: builds, runs, appends the best row
+measure() {
+  local name="$1" tag="$2" flags="$3" best="" row status log
+  echo "[MATRIX] building $name" >&2
+  PLATFORMIO_BUILD_FLAGS="$flags" pio run -s -e native >&2
+  cp .pio/build/native/program "$out/$tag"
+
+  for run in $(seq "$runs"); do
+    log="$out/$tag.$run.log"
+    status=ok
+    "$out/$tag" "$qotd" "$echo" "$cycles" "--stats_ms=$stats_ms" > "$log" || status=failed
+    # cycles/s p99 p99.9 core0 core1 status
+    row="$(awk -v status="$status" '
+      /^\[HOST\] cycles / { for (i = 1; i <= NF; i++) if ($i == "cycles/s,") rate = $(i - 1) }
+      /^\[PIPELINE\] cycle n=/ { split($6, p, "/"); p99 = p[2]; p999 = p[3] }
+      /^\[HOST\] placement / { for (i = 1; i <= NF; i++) {
+          if ($i == "core0") core0 = $(i + 1)
+          if ($i == "core1") core1 = $(i + 1) }
+        sub(/,$/, "", core1) }
+      END { printf "%s\t%s\t%s\t%s\t%s\t%s", rate, p99, p999, core0, core1, status }
+    ' "$log")"
+    if [ -z "$best" ] || awk -v a="${row%%$'\t'*}" -v b="${best%%$'\t'*}" \
+         'BEGIN { exit !(a + 0 > b + 0) }'; then
+      best="$row"
+    fi
+  done
+  printf '%s\t%s\n' "$best" "$name" >> "$results"
+}
+
+for buffer in 0 1 2; do
+  for printer in 0 1 2; do
+    for stats in 0 1 2; do
+      measure "buffer=ctx$buffer printer=ctx$printer stats=ctx$stats" \
+        "b${buffer}p${printer}s${stats}" \
+        "-DE5_QUOTE_BUFFER_CTX=$buffer -DE5_PRINTER_CTX=$printer -DE5_STATS_CTX=$stats"
+    done
+  done
+done
+# The placement without flags, for reference
+measure "buffer=ctx1 printer=ctx1 stats=loop1 (default)" default ""
+
+printf '%10s %9s %9s %7s %7s  %-7s %s\n' \
+  "cycles/s" "p99_us" "p99.9_us" "core0%" "core1%" "status" "placement"
+sort -t $'\t' -k1,1 -g -r "$results" |
+  awk -F '\t' '{ printf "%10s %9s %9s %7s %7s  %-7s %s\n", $1, $2, $3, $4, $5, $6, $7 }'
@@ -7,9 +7,44 @@
 # https://github.com/lukePeavey/quotable
 # To emulate QOTD server run:
 # ncat -l 17 --keep-open --send-only --exec "./scripts/qotd_server.bash"
+# For load runs use the epoll servers in src/servers (pio run -e servers)
+# instead: this script forks a shell per connection.
+# QOTD_DELAY=<seconds> delays the response, to emulate a slow server.
+# QOTD_OFFLINE=1 serves a random quote from quotes.txt instead, for load
+# runs above the API rate limit.
+# QOTD_BATCH=<K> serves the extended batch mode instead: K quotes from
+# quotes.txt, each as a 16-bit big-endian length and the quote bytes, on a
+# port of its own (the client's QOTD_BATCH_PORT, 1717 by default):
+# QOTD_BATCH=8 ncat -l 1717 --keep-open --send-only --exec "./scripts/qotd_server.bash"
 
 set -euo pipefail
 
+sleep "${QOTD_DELAY:-0}"
+
+# quotes.txt is in fortune format: entries separated by "%" lines
+quotes="$(dirname "$0")/quotes.txt"
+random_quote() {
+  awk -v RS='%\n' -v seed="$RANDOM" \
+    'BEGIN { srand(seed) } { q[NR] = $0 } END { printf "%s", q[int(rand() * NR) + 1] }' \
+    "$quotes"
+}
+
+if [ -n "${QOTD_BATCH:-}" ]; then
+  export LC_ALL=C # ${#line} counts bytes
+  for _ in $(seq "$QOTD_BATCH"); do
+    line="$(random_quote | head -c 512)"
+    len=${#line}
+    printf "\\x$(printf %02x $((len >> 8)))\\x$(printf %02x $((len & 255)))"
+    printf '%s' "$line"
+  done
+  exit 0
+fi
+
+if [ "${QOTD_OFFLINE:-0}" = "1" ]; then
+  printf '%s\n' "$(random_quote)"
+  exit 0
+fi
+
 # Fetch JSON (uses --insecure only because your system CA bundle is out of date)
 json="$(curl -s --insecure --max-time 5 https://api.quotable.io/random || true)"
 
@@ -0,0 +1,114 @@
+#!/usr/bin/env bash
+
+# threshold_sweep.bash — sweeps QOTD_PARTIAL_CONSUMPTION_THRESHOLD in the
+# native build across quote sizes and segmentations, with the stand-in
+# servers (src/servers) and the impairment proxy (src/proxy) on loopback.
+# Run from the repository root: ./scripts/threshold_sweep.bash
+# SIZES: "quotes" serves scripts/quotes.txt, the quote size distribution
+# the application sees; a number serves quotes of that many bytes
+# ("quotes 32 96 256 512"). The servers cut quotes to 512 bytes.
+# SEGMENTS: bytes per segment from the proxy; 0 connects to the server
+# directly, which hands a quote over in one piece ("0 536 64 8").
+# GAP_US=<us> between segments, so they arrive as separate reads (100)
+# THRESHOLDS (1,8,16,32,64,88,128,256,512,unlimited), CYCLES=<n> per
+# threshold (500), OUT=<dir> for logs and generated quote files
+# (.pio/threshold_sweep), BASE_PORT=<port> first port used (20000)
+# Per cycle: QuoteBuffer calls that crossed to core 1, peekConsume() calls,
+# ctx0 CPU time, time core 0 spent blocked in QuoteBuffer, then the cycle
+# latency. The threshold with the lowest mean latency per size and
+# segmentation is marked with *; ties go to fewer cross-core calls. Rows
+# with failed cycles are never marked: a cycle whose echo differs in length
+# from the quote received counts as failed.
+
+set -euo pipefail
+
+sizes="${SIZES:-quotes 32 96 256 512}"
+segments="${SEGMENTS:-0 536 64 8}"
+gap_us="${GAP_US:-100}"
+thresholds="${THRESHOLDS:-1,8,16,32,64,88,128,256,512,unlimited}"
+cycles="${CYCLES:-500}"
+out="${OUT:-.pio/threshold_sweep}"
+port="${BASE_PORT:-20000}"
+mkdir -p "$out"
+
+pio run -s -e native -e servers -e proxy >&2
+native=.pio/build/native/program
+servers=.pio/build/servers/program
+proxy=.pio/build/proxy/program
+
+pids=()
+cleanup() {
+  for pid in "${pids[@]}"; do
+    kill "$pid" 2> /dev/null || true
+  done
+}
+trap cleanup EXIT
+
+# quote_file <bytes>: fortune file of quotes served as <bytes> bytes each,
+# newline included, cut from the words of scripts/quotes.txt
+quote_file() {
+  local file="$out/quotes-$1.txt"
+  tr -s '\n%' '  ' < "$(dirname "$0")/quotes.txt" |
+    awk -v len="$(($1 - 1))" '{
+      text = text $0
+      for (i = 0; i < 64; i++) {
+        start = (i * 37) % (length(text) - len) + 1
+        printf "%s\n%%\n", substr(text, start, len)
+      } }' > "$file"
+  echo "$file"
+}
+
+results="$out/results.tsv"
+: > "$results"
+
+for size in $sizes; do
+  if [ "$size" = quotes ]; then
+    file="$(dirname "$0")/quotes.txt"
+  else
+    file="$(quote_file "$size")"
+  fi
+  qotd_port=$port
+  echo_port=$((port + 1))
+  port=$((port + 2))
+  "$servers" --qotd="$qotd_port" --echo="$echo_port" --batch=0 --chargen=0 \
+    --discard=0 --bind=127.0.0.1 --quotes="$file" --quiet > "$out/servers-$size.log" &
+  pids+=($!)
+
+  for segment in $segments; do
+    target=$qotd_port
+    if [ "$segment" != 0 ]; then
+      target=$port
+      port=$((port + 1))
+      "$proxy" --listen="$target" --target="127.0.0.1:$qotd_port" \
+        --segment="$segment" --gap_us="$gap_us" > "$out/proxy-$size-$segment.log" &
+      pids+=($!)
+    fi
+    sleep 0.2
+    echo "[SWEEP] quotes $size, segments $segment" >&2
+    log="$out/native-$size-$segment.log"
+    "$native" "127.0.0.1:$target" "127.0.0.1:$echo_port" "$cycles" \
+      --thresholds="$thresholds" > "$log" || echo "[SWEEP] run failed: $log" >&2
+    # size segment threshold quote_bytes xcore peek ctx0_us blocked_us p50 p99 avg failed
+    awk -v size="$size" -v segment="$segment" '/^\[SWEEP\] threshold / {
+        split($21, p, "/"); sub(/:$/, "", $9)
+        printf "%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\n", size, segment,
+          $3, $5, $11, $13, $15, $17, p[1], p[2], p[3], $9
+      }' "$log" >> "$results"
+  done
+done
+
+printf '%-7s %5s %10s %7s %7s %7s %9s %11s %7s %7s %7s %6s\n' \
+  size segment threshold quote_B xcore peek ctx0_us blocked_us p50_us p99_us avg_us failed
+awk -F '\t' '
+  { row[NR] = $0; key = $1 SUBSEP $2
+    if ($12 + 0 > 0) next
+    if (!(key in best) || $11 + 0 < bavg[key] ||
+        ($11 + 0 == bavg[key] && $5 + 0 < bxcore[key])) {
+      best[key] = NR; bavg[key] = $11 + 0; bxcore[key] = $5 + 0 } }
+  END {
+    for (i = 1; i <= NR; i++) {
+      split(row[i], f, "\t")
+      mark = best[f[1] SUBSEP f[2]] == i ? "*" : " "
+      printf "%-7s %5s %9s%s %7s %7s %7s %9s %11s %7s %7s %7s %6s\n",
+        f[1], f[2], f[3], mark, f[4], f[5], f[6], f[7], f[8], f[9], f[10], f[11], f[12]
+    } }' "$results"
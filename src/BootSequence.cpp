@@ -0,0 +1,187 @@
+/**
+ * @file BootSequence.cpp
+ * @brief Implementation of the non-blocking boot sequence.
+ *
+ * @author Goran
+ * @date 2025-09-20
+ * @ingroup AsyncTCPClient
+ */
+
+#include "BootSequence.hpp"
+#include <WiFi.h>
+#include <lwip/dns.h>
+
+namespace e5 {
+
+    bool BootSequence::addService(EndpointSelector &selector) {
+        if (m_service_count == MAX_SERVICES) {
+            return false;
+        }
+        m_services[m_service_count++] = &selector;
+        for (std::size_t i = 0;
+             i < selector.size() && m_lookup_count < MAX_LOOKUPS; ++i) {
+            auto &lookup = m_lookups[m_lookup_count++];
+            lookup.selector = &selector;
+            lookup.index = static_cast<EndpointSelector::Index>(i);
+        }
+        return true;
+    }
+
+    void BootSequence::begin() {
+        m_started_us = time_us_32();
+        WiFi.beginNoBlock(m_ssid, m_password);
+
+        for (std::size_t i = 0; i < m_lookup_count; ++i) {
+            auto &lookup = m_lookups[i];
+            const auto &endpoint = lookup.selector->endpoint(lookup.index);
+            if (IPAddress address; m_cache.lookup(endpoint.host, address)) {
+                lookup.selector->setAddress(lookup.index, address);
+                ++m_cached;
+            }
+        }
+    }
+
+    void BootSequence::onFound(const char *, const ip_addr_t *address,
+                               void *arg) {
+        auto *lookup = static_cast<Lookup *>(arg);
+        if (address && IP_IS_V4(address)) {
+            lookup->address = ip4_addr_get_u32(ip_2_ip4(address));
+            lookup->state = LookupState::ANSWERED;
+        } else {
+            lookup->state = LookupState::FAILED;
+        }
+    }
+
+    void BootSequence::issueLookups() {
+        for (std::size_t i = 0; i < m_lookup_count; ++i) {
+            auto &lookup = m_lookups[i];
+            if (lookup.state != LookupState::QUEUED) {
+                continue;
+            }
+            // Set before the call: the callback may run before it returns
+            lookup.state = LookupState::IN_FLIGHT;
+            ip_addr_t address;
+            // The core wraps dns_gethostbyname() in the lwIP lock
+            switch (dns_gethostbyname(
+                lookup.selector->endpoint(lookup.index).host, &address,
+                &BootSequence::onFound, &lookup)) {
+            case ERR_OK: // Dotted address or already in lwIP's table
+                lookup.address = ip4_addr_get_u32(ip_2_ip4(&address));
+                lookup.state = LookupState::ANSWERED;
+                break;
+            case ERR_INPROGRESS:
+                break;
+            case ERR_MEM: // Resolver table full; retry on the next poll
+                lookup.state = LookupState::QUEUED;
+                return;
+            default:
+                lookup.state = LookupState::FAILED;
+                break;
+            }
+        }
+    }
+
+    void BootSequence::collectLookups() {
+        for (std::size_t i = 0; i < m_lookup_count; ++i) {
+            auto &lookup = m_lookups[i];
+            const LookupState state = lookup.state;
+            if (state == LookupState::FAILED) {
+                lookup.state = LookupState::DONE;
+                m_failed += reached(BootPhase::DNS) ? 0 : 1;
+                continue;
+            }
+            if (state != LookupState::ANSWERED) {
+                continue;
+            }
+            const IPAddress address(static_cast<uint32_t>(lookup.address));
+            const auto &endpoint = lookup.selector->endpoint(lookup.index);
+            if (!endpoint.resolved ||
+                static_cast<uint32_t>(endpoint.address) != lookup.address) {
+                m_changed += endpoint.resolved ? 1 : 0;
+                lookup.selector->setAddress(lookup.index, address);
+            }
+            m_cache.store(endpoint.host, address);
+            lookup.state = LookupState::DONE;
+            m_resolved += reached(BootPhase::DNS) ? 0 : 1;
+        }
+    }
+
+    bool BootSequence::servicesAddressed() const {
+        for (std::size_t s = 0; s < m_service_count; ++s) {
+            const auto &selector = *m_services[s];
+            bool addressed = false;
+            for (std::size_t i = 0; i < selector.size() && !addressed; ++i) {
+                addressed = selector.endpoint(i).resolved;
+            }
+            if (!addressed) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void BootSequence::poll() {
+        if (m_link_failed) {
+            return;
+        }
+        const uint32_t now = time_us_32();
+        if (!reached(BootPhase::LINK)) {
+            if (now - m_link_checked_us < LINK_CHECK_US) {
+                return;
+            }
+            m_link_checked_us = now;
+            if (WiFi.status() != WL_CONNECTED || !WiFi.localIP().isSet()) {
+                m_link_failed = now - m_started_us >= m_link_timeout_us;
+                return;
+            }
+            mark(BootPhase::LINK);
+        }
+
+        issueLookups();
+        collectLookups();
+
+        if (!reached(BootPhase::DNS)) {
+            std::size_t pending = 0;
+            for (std::size_t i = 0; i < m_lookup_count; ++i) {
+                const LookupState state = m_lookups[i].state;
+                pending += state == LookupState::QUEUED ||
+                                   state == LookupState::IN_FLIGHT
+                               ? 1
+                               : 0;
+            }
+            const bool timed_out =
+                now - m_phase_us[static_cast<std::size_t>(BootPhase::LINK)] >=
+                m_dns_timeout_us;
+            if (pending == 0 || timed_out) {
+                // Late answers are still applied, just not counted
+                m_failed += static_cast<uint8_t>(pending);
+                for (std::size_t i = 0; i < m_lookup_count; ++i) {
+                    if (m_lookups[i].state == LookupState::QUEUED) {
+                        m_lookups[i].state = LookupState::DONE;
+                    }
+                }
+                mark(BootPhase::DNS);
+            }
+        }
+
+        if (!reached(BootPhase::READY) &&
+            (servicesAddressed() || reached(BootPhase::DNS))) {
+            mark(BootPhase::READY);
+        }
+    }
+
+    void BootSequence::mark(const BootPhase phase) {
+        auto &phase_us = m_phase_us[static_cast<std::size_t>(phase)];
+        if (phase_us == 0) {
+            const uint32_t now = time_us_32();
+            phase_us = now ? now : 1;
+        }
+    }
+
+    void BootSequence::setTimeouts(const uint32_t link_timeout_us,
+                                   const uint32_t dns_timeout_us) {
+        m_link_timeout_us = link_timeout_us;
+        m_dns_timeout_us = dns_timeout_us;
+    }
+
+} // namespace e5
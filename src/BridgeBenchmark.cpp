@@ -0,0 +1,256 @@
+/**
+ * @file BridgeBenchmark.cpp
+ * @brief Implementation of the hand-off primitive benchmark.
+ *
+ * @author Goran
+ * @date 2025-09-30
+ * @ingroup AsyncTCPClient
+ */
+
+#include "BridgeBenchmark.hpp"
+#include "EphemeralBridge.hpp"
+#include <Arduino.h>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace e5 {
+
+    namespace {
+
+        /**
+         * @brief One self-owning bridge per message, created as PrintHandler
+         * is.
+         */
+        class EphemeralProbe final : public EphemeralBridge {
+                BridgeBenchmark::Probe &m_probe;
+
+            protected:
+                void onWork() override { m_probe.arrive(); }
+
+            public:
+                EphemeralProbe(const AsyncCtx &ctx, BridgeBenchmark::Probe &probe)
+                    : EphemeralBridge(ctx), m_probe(probe) {}
+
+                static void post(const AsyncCtx &ctx,
+                                 BridgeBenchmark::Probe &probe) {
+                    auto bridge = std::make_unique<EphemeralProbe>(ctx, probe);
+                    EphemeralProbe *raw_ptr = bridge.get();
+                    raw_ptr->takeOwnership(std::move(bridge));
+                    raw_ptr->initialiseBridge();
+                    raw_ptr->run(0);
+                }
+        };
+
+        const char *loadName(const TargetLoad load) {
+            switch (load) {
+            case TargetLoad::IDLE:
+                return "idle";
+            case TargetLoad::BUSY_LOOP:
+                return "busy_loop";
+            case TargetLoad::LONG_HANDLER:
+                return "long_handler";
+            }
+            return "?";
+        }
+
+        uint32_t cyclesToNs(const uint64_t cycles) {
+            return static_cast<uint32_t>(cycles * 1000000000ull /
+                                         static_cast<uint64_t>(rp2040.f_cpu()));
+        }
+
+        void spinUs(const uint32_t us) {
+            const uint32_t start = time_us_32();
+            while (time_us_32() - start < us) {
+                tight_loop_contents();
+            }
+        }
+
+    } // namespace
+
+    void BridgeBenchmark::Probe::arrive() {
+        arrived_us.store(time_us_32(), std::memory_order_relaxed);
+        // Single writer; the M0+ has no atomic increment
+        delivered.store(delivered.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+    }
+
+    void BridgeBenchmark::LongHandler::onWork() {
+        if (m_load.load(std::memory_order_relaxed) == TargetLoad::LONG_HANDLER) {
+            spinUs(LONG_HANDLER_US);
+        }
+    }
+
+    BridgeBenchmark::BridgeBenchmark(const AsyncCtx &ctx)
+        : m_ctx(ctx), m_sync(ctx, m_probe), m_perpetual(ctx, m_probe),
+          m_long_handler(ctx, m_load) {}
+
+    void BridgeBenchmark::begin() {
+        m_perpetual.initialiseBridge();
+        m_long_handler.initialiseBridge();
+    }
+
+    void BridgeBenchmark::serve() {
+        const uint32_t sent = m_mail_sent.load(std::memory_order_acquire);
+        if (sent != m_mail_seen.load(std::memory_order_relaxed)) {
+            m_probe.arrive();
+            m_mail_seen.store(sent, std::memory_order_release);
+        }
+        switch (m_load.load(std::memory_order_relaxed)) {
+        case TargetLoad::IDLE:
+            break;
+        case TargetLoad::BUSY_LOOP:
+            spinUs(BUSY_SPIN_US);
+            break;
+        case TargetLoad::LONG_HANDLER:
+            // Queued again as soon as it has run; a no-op while queued
+            m_long_handler.run();
+            break;
+        }
+    }
+
+    bool BridgeBenchmark::await(const uint32_t delivered) const {
+        const uint32_t start = time_us_32();
+        while (static_cast<int32_t>(
+                   m_probe.delivered.load(std::memory_order_acquire) -
+                   delivered) < 0) {
+            if (time_us_32() - start >= TIMEOUT_US) {
+                return false;
+            }
+            tight_loop_contents();
+        }
+        return true;
+    }
+
+    void BridgeBenchmark::send(const Primitive primitive) {
+        switch (primitive) {
+        case Primitive::SYNC:
+            m_sync.send();
+            break;
+        case Primitive::EPHEMERAL:
+            EphemeralProbe::post(m_ctx, m_probe);
+            break;
+        case Primitive::PERPETUAL:
+            m_perpetual.run();
+            break;
+        case Primitive::MAILBOX: {
+            // One slot: wait until the last message has been taken
+            const uint32_t sent = m_mail_sent.load(std::memory_order_relaxed);
+            const uint32_t start = time_us_32();
+            while (m_mail_seen.load(std::memory_order_acquire) != sent &&
+                   time_us_32() - start < TIMEOUT_US) {
+                tight_loop_contents();
+            }
+            m_mail_sent.store(sent + 1, std::memory_order_release);
+            break;
+        }
+        }
+    }
+
+    BridgeStats BridgeBenchmark::measure(const Primitive primitive,
+                                         const uint32_t messages) {
+        BridgeStats stats;
+        stats.messages = messages;
+
+        uint64_t round_trip_cycles = 0;
+        uint32_t max_cycles = 0;
+        uint64_t one_way_us = 0;
+        uint32_t completed = 0;
+        for (uint32_t i = 0; i < messages; ++i) {
+            const uint32_t target =
+                m_probe.delivered.load(std::memory_order_acquire) + 1;
+            const uint32_t sent_us = time_us_32();
+            const uint32_t start = rp2040.getCycleCount();
+            send(primitive);
+            if (!await(target)) {
+                ++stats.timeouts;
+                continue;
+            }
+            const uint32_t cycles = rp2040.getCycleCount() - start;
+            round_trip_cycles += cycles;
+            max_cycles = std::max(max_cycles, cycles);
+            one_way_us += m_probe.arrived_us.load(std::memory_order_relaxed) -
+                          sent_us;
+            ++completed;
+        }
+        if (completed > 0) {
+            stats.round_trip_ns = cyclesToNs(round_trip_cycles / completed);
+            stats.round_trip_max_ns = cyclesToNs(max_cycles);
+            stats.one_way_ns =
+                static_cast<uint32_t>(one_way_us * 1000 / completed);
+        }
+
+        // Back to back; a perpetual bridge's last run() is followed by one
+        // more run whether it was queued anew or merged into a pending one
+        const uint32_t first = m_probe.delivered.load(std::memory_order_acquire);
+        uint32_t before_last = first;
+        const uint32_t start = rp2040.getCycleCount();
+        for (uint32_t i = 0; i < RATE_MESSAGES; ++i) {
+            before_last = m_probe.delivered.load(std::memory_order_acquire);
+            send(primitive);
+        }
+        const bool drained = await(primitive == Primitive::PERPETUAL
+                                       ? before_last + 1
+                                       : first + RATE_MESSAGES);
+        const uint32_t elapsed_ns = cyclesToNs(rp2040.getCycleCount() - start);
+        stats.timeouts += drained ? 0 : 1;
+        stats.delivered =
+            m_probe.delivered.load(std::memory_order_acquire) - first;
+        stats.rate_per_s = elapsed_ns ? static_cast<uint32_t>(
+                                            stats.delivered * 1000000000ull /
+                                            elapsed_ns)
+                                      : 0;
+        return stats;
+    }
+
+    void BridgeBenchmark::run(const SerialPrinter &printer,
+                              const bool cross_core, const uint32_t messages) {
+#ifdef ARDUINO_ARCH_RP2040
+        constexpr char platform[] = "rp2040";
+#else
+        constexpr char platform[] = "host";
+#endif
+        static constexpr const char *primitive_names[] = {
+            "sync", "ephemeral", "perpetual", "mailbox"};
+        const TargetLoad loads[] = {TargetLoad::IDLE, TargetLoad::BUSY_LOOP,
+                                    TargetLoad::LONG_HANDLER};
+
+        // Printed at the end: prints run on the target context too
+        std::vector<std::string> lines;
+        for (const TargetLoad load : loads) {
+            if (!cross_core && load != TargetLoad::IDLE) {
+                break;
+            }
+            m_load.store(load, std::memory_order_relaxed);
+            delay(10); // Let the target core pick the load up
+            for (uint8_t p = 0; p < std::size(primitive_names); ++p) {
+                const auto primitive = static_cast<Primitive>(p);
+                if (!cross_core && primitive == Primitive::MAILBOX) {
+                    continue;
+                }
+                const BridgeStats stats = measure(primitive, messages);
+                lines.push_back(
+                    std::string("[BRIDGE] {\"primitive\":\"") +
+                    primitive_names[p] + "\",\"placement\":\"" +
+                    (cross_core ? "cross_core" : "same_core") +
+                    "\",\"target\":\"" + loadName(load) +
+                    "\",\"platform\":\"" + platform +
+                    "\",\"messages\":" + std::to_string(stats.messages) +
+                    ",\"round_trip_ns\":" + std::to_string(stats.round_trip_ns) +
+                    ",\"round_trip_max_ns\":" +
+                    std::to_string(stats.round_trip_max_ns) +
+                    ",\"one_way_ns\":" + std::to_string(stats.one_way_ns) +
+                    ",\"rate_per_s\":" + std::to_string(stats.rate_per_s) +
+                    ",\"rate_sent\":" + std::to_string(RATE_MESSAGES) +
+                    ",\"rate_delivered\":" + std::to_string(stats.delivered) +
+                    ",\"timeouts\":" + std::to_string(stats.timeouts) + "}\n");
+            }
+        }
+        m_load.store(TargetLoad::IDLE, std::memory_order_relaxed);
+        for (auto &line : lines) {
+            printer.print(std::make_unique<std::string>(std::move(line)));
+        }
+    }
+
+} // namespace e5
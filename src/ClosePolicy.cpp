@@ -0,0 +1,68 @@
+/**
+ * @file ClosePolicy.cpp
+ * @brief Implementation of the close strategies and the PCB census.
+ *
+ * @author Goran
+ * @date 2025-09-24
+ * @ingroup AsyncTCPClient
+ */
+
+#include "ClosePolicy.hpp"
+#include <Arduino.h>
+#include <lwip/priv/tcp_priv.h>
+#include <lwip/tcp.h>
+
+namespace e5 {
+
+    namespace {
+
+        uint16_t countPcbs(const tcp_pcb *pcb, uint16_t *closing) {
+            uint16_t count = 0;
+            for (; pcb && count < MEMP_NUM_TCP_PCB; pcb = pcb->next) {
+                ++count;
+                if (closing && pcb->state >= FIN_WAIT_1 &&
+                    pcb->state <= LAST_ACK) {
+                    ++*closing;
+                }
+            }
+            return count;
+        }
+
+    } // namespace
+
+    const char *closeStrategyName(const CloseStrategy strategy) {
+        switch (strategy) {
+        case CloseStrategy::GRACEFUL:
+            return "graceful";
+        case CloseStrategy::ABORT_AFTER_DRAIN:
+            return "abort";
+        case CloseStrategy::REUSE_AWARE:
+            return "reuse";
+        }
+        return "?";
+    }
+
+    PcbCensus takePcbCensus() {
+        PcbCensus census;
+        census.capacity = MEMP_NUM_TCP_PCB;
+        census.active = countPcbs(tcp_active_pcbs, &census.closing);
+        census.time_wait = countPcbs(tcp_tw_pcbs, nullptr);
+        return census;
+    }
+
+    bool closeClient(TcpClient &client, const CloseStrategy strategy) {
+        bool abort = strategy == CloseStrategy::ABORT_AFTER_DRAIN;
+        if (strategy == CloseStrategy::REUSE_AWARE) {
+            // The PCB being closed is still counted as active
+            abort = takePcbCensus().spare() < REUSE_SPARE_PCBS;
+        }
+        if (abort) {
+            client.abort();
+            DEBUGWIRE("[ClosePolicy][:i%d] aborted\n", client.getClientId());
+        } else {
+            client.shutdown();
+        }
+        return abort;
+    }
+
+} // namespace e5
@@ -0,0 +1,26 @@
+/**
+ * @file ConnectionHandler.cpp
+ * @brief Implementation of the connection-generic handler base.
+ *
+ * @author Goran
+ * @date 2025-09-04
+ * @ingroup AsyncTCPClient
+ */
+
+#include "ConnectionHandler.hpp"
+
+namespace e5 {
+
+    std::unique_ptr<PerpetualBridge>
+    ConnectionHandler::bridge(const AsyncCtx &ctx, TcpClient &io) {
+        const auto slot = m_table.attach(io);
+        if (slot == ConnectionTable::NO_SLOT) {
+            return nullptr;
+        }
+        auto connection_bridge =
+            std::make_unique<ConnectionBridge>(ctx, *this, slot);
+        connection_bridge->initialiseBridge();
+        return connection_bridge;
+    }
+
+} // namespace e5
@@ -0,0 +1,270 @@
+/**
+ * @file ConnectionManager.cpp
+ * @brief Implementation of the per-client connection state machine.
+ *
+ * @author Goran
+ * @date 2025-09-12
+ * @ingroup AsyncTCPClient
+ */
+
+#include "ConnectionManager.hpp"
+#include "WriteDeadline.hpp"
+#include <algorithm>
+
+namespace e5 {
+
+    ConnectionManager::ConnectionManager(ConnectionTable &table,
+                                         TcpClient &client,
+                                         const IPAddress &address,
+                                         const uint16_t port,
+                                         const ConnectionMode mode)
+        : m_table(table), m_client(client), m_address(address), m_port(port),
+          m_mode(mode) {}
+
+    void ConnectionManager::start() {
+        m_slot = m_table.find(m_client.getClientId());
+        if (m_slot == ConnectionTable::NO_SLOT) {
+            DEBUGWIRE("[ConnectionManager][:i%d] client not attached\n",
+                      m_client.getClientId());
+            return;
+        }
+        m_seen_connects = m_table.connects(m_slot);
+        m_seen_closes = m_table.closes(m_slot);
+        m_seen_errors = m_table.errors(m_slot);
+    }
+
+    void ConnectionManager::enter(const ConnectionState state,
+                                  const uint32_t now_us) {
+        m_state = state;
+        m_state_since_us = now_us;
+    }
+
+    bool ConnectionManager::connect(const uint32_t now_us) {
+        if (m_client.status() != CLOSED) {
+            // Previous connection still closing (e.g. TIME_WAIT); retry
+            // after the base delay without counting a failure.
+            m_backoff_us = m_backoff_base_us;
+            enter(ConnectionState::BACKOFF, now_us);
+            return false;
+        }
+        if (m_mode == ConnectionMode::PER_CYCLE) {
+            ++m_cycles; // Completed or failed from here on
+        }
+        m_attempt_us = now_us;
+        m_table.setMuted(m_slot, false);
+        m_table.setRxStarted(m_slot, false);
+        if (const auto err = m_client.connect(m_address, m_port);
+            err != PICO_OK) {
+            fail("connect", now_us);
+            return true;
+        }
+        DEBUGWIRE("[ConnectionManager][:i%d] connecting\n",
+                  m_client.getClientId());
+        enter(ConnectionState::CONNECTING, now_us);
+        return true;
+    }
+
+    void ConnectionManager::backoff(const uint32_t now_us) {
+        if (auto *deadline = m_table.writeDeadline(m_slot)) {
+            deadline->reset();
+        }
+        const uint8_t shift = std::min<uint8_t>(m_failures, 16);
+        const uint32_t ceiling = static_cast<uint32_t>(std::min<uint64_t>(
+            static_cast<uint64_t>(m_backoff_base_us) << shift,
+            m_backoff_max_us));
+        // Equal jitter: at least half the ceiling, so retries stay spaced
+        // out, with the other half random to spread simultaneous clients.
+        m_backoff_us = ceiling / 2 + static_cast<uint32_t>(random(
+                                         static_cast<long>(ceiling / 2) + 1));
+        if (m_failures < UINT8_MAX) {
+            ++m_failures;
+        }
+        enter(ConnectionState::BACKOFF, now_us);
+    }
+
+    void ConnectionManager::fail([[maybe_unused]] const char *reason,
+                                 const uint32_t now_us) {
+        ++m_failed_attempts;
+        if (m_mode == ConnectionMode::PER_CYCLE) {
+            ++m_failed_cycles;
+        }
+        backoff(now_us);
+        DEBUGWIRE("[ConnectionManager][:i%d] %s failed, retry in %lu us\n",
+                  m_client.getClientId(), reason,
+                  static_cast<unsigned long>(m_backoff_us));
+    }
+
+    void ConnectionManager::onClosed(const uint32_t now_us) {
+        if (m_mode == ConnectionMode::PER_CYCLE) {
+            ++m_completed_cycles;
+            enter(ConnectionState::IDLE, now_us);
+        } else {
+            backoff(now_us);
+        }
+    }
+
+    void ConnectionManager::flush() {
+        while (!m_write_queue.empty()) {
+            const std::string &data = m_write_queue.front();
+            if (const size_t error = m_client.write(
+                    reinterpret_cast<const uint8_t *>(data.c_str()),
+                    data.size());
+                error != PICO_OK) {
+                DEBUGWIRE("[ConnectionManager][:i%d] write returned %d\n",
+                          m_client.getClientId(), static_cast<int>(error));
+                ++m_dropped_writes;
+            } else {
+                m_table.addWrite(m_slot, data.size(), time_us_32());
+                if (auto *deadline = m_table.writeDeadline(m_slot)) {
+                    deadline->onWrite(data.size());
+                }
+            }
+            m_write_queue.pop_front();
+        }
+    }
+
+    bool ConnectionManager::syncEvents(bool &connected, bool &closed,
+                                       bool &errored) {
+        if (m_slot == ConnectionTable::NO_SLOT) {
+            return false;
+        }
+        const uint16_t connects = m_table.connects(m_slot);
+        const uint16_t closes = m_table.closes(m_slot);
+        const uint16_t errors = m_table.errors(m_slot);
+        connected = connects != m_seen_connects;
+        closed = closes != m_seen_closes;
+        errored = errors != m_seen_errors;
+        m_seen_connects = connects;
+        m_seen_closes = closes;
+        m_seen_errors = errors;
+        return true;
+    }
+
+    void ConnectionManager::poll() {
+        bool connected = false;
+        bool closed = false;
+        bool errored = false;
+        if (!syncEvents(connected, closed, errored)) {
+            return;
+        }
+        const uint32_t now = time_us_32();
+
+        switch (m_state) {
+        case ConnectionState::IDLE:
+            if (m_mode == ConnectionMode::PERSISTENT) {
+                connect(now);
+            }
+            break;
+
+        case ConnectionState::CONNECTING:
+            if (connected) {
+                const uint32_t latency = now - m_attempt_us;
+                m_last_connect_us = latency;
+                ++m_connects;
+                m_connect_latency_total_us += latency;
+                m_connect_latency_max_us =
+                    std::max(m_connect_latency_max_us, latency);
+                m_failures = 0;
+                enter(ConnectionState::ESTABLISHED, now);
+                flush();
+                // A short-lived connection may already be gone
+                if (errored) {
+                    fail("connection", now);
+                } else if (closed) {
+                    onClosed(now);
+                }
+            } else if (errored) {
+                fail("connect", now);
+            } else if (now - m_attempt_us >=
+                       (m_mode == ConnectionMode::PER_CYCLE
+                            ? std::min(m_connect_timeout_us,
+                                       m_cycle_deadline_us)
+                            : m_connect_timeout_us)) {
+                m_table.close(m_slot);
+                fail("connect timeout", now);
+            }
+            break;
+
+        case ConnectionState::ESTABLISHED:
+            if (errored) {
+                // lwIP has already freed the connection
+                fail("connection", now);
+            } else if (closed) {
+                onClosed(now);
+            } else if (m_mode == ConnectionMode::PERSISTENT &&
+                       m_client.status() != ESTABLISHED) {
+                // Peer closed and no FIN handler is registered
+                m_table.close(m_slot);
+                backoff(now);
+            } else if (m_mode == ConnectionMode::PER_CYCLE &&
+                       now - m_attempt_us >= m_cycle_deadline_us) {
+                m_table.close(m_slot);
+                fail("cycle deadline", now);
+            }
+            break;
+
+        case ConnectionState::BACKOFF:
+            if (now - m_state_since_us >= m_backoff_us) {
+                enter(ConnectionState::IDLE, now);
+                if (m_mode == ConnectionMode::PERSISTENT) {
+                    connect(now);
+                }
+            }
+            break;
+        }
+    }
+
+    bool ConnectionManager::requestCycle() {
+        if (m_slot == ConnectionTable::NO_SLOT ||
+            m_state != ConnectionState::IDLE ||
+            m_client.status() != CLOSED) {
+            ++m_wasted_cycles;
+            return false;
+        }
+        if (!connect(time_us_32())) {
+            ++m_wasted_cycles;
+            return false;
+        }
+        return m_state == ConnectionState::CONNECTING;
+    }
+
+    void ConnectionManager::abandon() {
+        if (m_state != ConnectionState::CONNECTING &&
+            m_state != ConnectionState::ESTABLISHED) {
+            return;
+        }
+        if (m_mode == ConnectionMode::PER_CYCLE) {
+            ++m_abandoned_cycles;
+        }
+        m_table.setMuted(m_slot, true);
+        m_table.close(m_slot);
+        if (auto *deadline = m_table.writeDeadline(m_slot)) {
+            deadline->reset();
+        }
+        enter(ConnectionState::IDLE, time_us_32());
+    }
+
+    void ConnectionManager::write(std::string data) {
+        if (m_write_queue.size() == WRITE_QUEUE_CAPACITY) {
+            m_write_queue.pop_front();
+            ++m_dropped_writes;
+        }
+        m_write_queue.push_back(std::move(data));
+        if (ready()) {
+            flush();
+        }
+    }
+
+    void ConnectionManager::setBackoff(const uint32_t base_us,
+                                       const uint32_t max_us) {
+        m_backoff_base_us = base_us ? base_us : 1;
+        m_backoff_max_us = std::max(max_us, m_backoff_base_us);
+    }
+
+    void ConnectionManager::setDeadlines(const uint32_t connect_timeout_us,
+                                         const uint32_t cycle_deadline_us) {
+        m_connect_timeout_us = connect_timeout_us;
+        m_cycle_deadline_us = cycle_deadline_us;
+    }
+
+} // namespace e5
@@ -0,0 +1,63 @@
+/**
+ * @file ConnectionTable.cpp
+ * @brief Implementation of the per-connection state table.
+ *
+ * @author Goran
+ * @date 2025-09-04
+ * @ingroup AsyncTCPClient
+ */
+
+#include "ConnectionTable.hpp"
+#include "WriteDeadline.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace e5 {
+
+    ConnectionTable::Slot ConnectionTable::attach(TcpClient &io) {
+        const int client_id = io.getClientId();
+        if (const Slot existing = find(client_id); existing != NO_SLOT) {
+            return existing;
+        }
+        if (m_size >= MAX_CONNECTIONS) {
+            return NO_SLOT;
+        }
+        const auto slot = static_cast<Slot>(m_size++);
+        m_client_id[slot] = client_id;
+        m_client[slot] = &io;
+        return slot;
+    }
+
+    ConnectionTable::Slot ConnectionTable::find(const int client_id) const {
+        for (std::size_t i = 0; i < m_size; ++i) {
+            if (m_client_id[i] == client_id) {
+                return static_cast<Slot>(i);
+            }
+        }
+        return NO_SLOT;
+    }
+
+    ConnectionStats ConnectionTable::snapshot(const Slot slot) const {
+        ConnectionStats stats;
+        stats.client_id = m_client_id[slot];
+        stats.rx_bytes = m_rx_bytes[slot];
+        stats.rx_events = m_rx_events[slot];
+        stats.tx_bytes = m_tx_bytes[slot];
+        stats.writes = m_writes[slot];
+        stats.acks = m_acks[slot];
+        stats.acked_bytes = m_acked_bytes[slot];
+        stats.rtt_avg_us = m_rtt_us[slot];
+        stats.errors = m_errors[slot];
+        stats.timeouts = m_timeouts[slot];
+        if (const auto *deadline = m_write_deadline[slot]) {
+            stats.timeouts += static_cast<uint16_t>(deadline->timeouts());
+        }
+        stats.connects = m_connects[slot];
+        stats.closes = m_closes[slot];
+        stats.aborts = m_aborts[slot];
+        std::copy(std::begin(m_error_codes[slot]), std::end(m_error_codes[slot]),
+                  std::begin(stats.errors_by_code));
+        return stats;
+    }
+
+} // namespace e5
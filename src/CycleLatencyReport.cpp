@@ -0,0 +1,265 @@
+/**
+ * @file CycleLatencyReport.cpp
+ * @brief Implementation of the end-to-end cycle latency report.
+ *
+ * @author Goran
+ * @date 2025-09-29
+ * @ingroup AsyncTCPClient
+ */
+
+#include "CycleLatencyReport.hpp"
+#include <Arduino.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace e5 {
+
+    namespace {
+
+        /**
+         * @brief "p50", "p99" or "p99.9" for a per-mille value.
+         */
+        std::string percentileName(const uint16_t per_mille) {
+            std::string name = "p" + std::to_string(per_mille / 10);
+            if (per_mille % 10 != 0) {
+                name += "." + std::to_string(per_mille % 10);
+            }
+            return name;
+        }
+
+        /**
+         * @brief Parses "NN" or "NN.N" after the 'p' of a budget.
+         *
+         * @return Per-mille value, or 0 if the text is not a percentile
+         */
+        uint16_t parsePerMille(const char *text, const char **end) {
+            char *tail = nullptr;
+            const unsigned long whole = std::strtoul(text, &tail, 10);
+            unsigned long tenths = 0;
+            if (*tail == '.' && tail[1] >= '0' && tail[1] <= '9') {
+                tenths = static_cast<unsigned long>(tail[1] - '0');
+                tail += 2;
+            }
+            *end = tail;
+            const unsigned long per_mille = whole * 10 + tenths;
+            return tail != text && per_mille > 0 && per_mille < 1000
+                       ? static_cast<uint16_t>(per_mille)
+                       : 0;
+        }
+
+    } // namespace
+
+    const char *CycleLatencyReport::spanName(const std::size_t span) {
+        return span == 0 ? "cycle" : stageName(static_cast<CycleStage>(span));
+    }
+
+    std::size_t CycleLatencyReport::bucketOf(const uint32_t us) {
+        if (us < SUB_BUCKETS) {
+            return us;
+        }
+        uint32_t msb = SUB_BITS;
+        while (msb < 23 && (us >> (msb + 1)) != 0) {
+            ++msb;
+        }
+        const uint32_t shift = msb - SUB_BITS;
+        return SUB_BUCKETS + shift * SUB_BUCKETS +
+               ((us >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    uint32_t CycleLatencyReport::bucketUpperUs(const std::size_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return static_cast<uint32_t>(bucket);
+        }
+        const auto shift = static_cast<uint32_t>((bucket - SUB_BUCKETS) /
+                                                 SUB_BUCKETS);
+        const auto sub =
+            static_cast<uint32_t>((bucket - SUB_BUCKETS) % SUB_BUCKETS);
+        return ((SUB_BUCKETS + sub) << shift) + (1u << shift) - 1;
+    }
+
+    void CycleLatencyReport::add(Histogram &histogram, uint32_t us) {
+        us = std::min(us, MAX_US);
+        ++histogram.buckets[bucketOf(us)];
+        ++histogram.count;
+        histogram.total_us += us;
+        histogram.max_us = std::max(histogram.max_us, us);
+    }
+
+    void CycleLatencyReport::add(const CycleRecord &record) {
+        if (record.id == 0) {
+            return;
+        }
+        ++m_cycles;
+        m_quotes += record.at(CycleStage::COMPLETE) != 0 ? 1 : 0;
+        m_mismatched += mismatched(record) ? 1 : 0;
+
+        const auto span = [&record](Histogram &histogram,
+                                    const CycleStage from,
+                                    const CycleStage to) {
+            const uint32_t start = record.at(from);
+            const uint32_t end = record.at(to);
+            if (start == 0 || end == 0) {
+                return;
+            }
+            // Echo stages of different handlers may be stamped out of order
+            if (static_cast<int32_t>(end - start) < 0) {
+                ++histogram.reversed;
+                return;
+            }
+            add(histogram, end - start);
+        };
+        span(m_spans[0], CycleStage::CONNECT, CycleStage::PRINTED);
+        for (std::size_t i = 1; i < SPANS; ++i) {
+            span(m_spans[i], static_cast<CycleStage>(i - 1),
+                 static_cast<CycleStage>(i));
+        }
+    }
+
+    bool CycleLatencyReport::mismatched(const CycleRecord &record) {
+        return record.at(CycleStage::COMPLETE) != 0 &&
+               record.at(CycleStage::ECHO_WRITE) != 0 &&
+               record.echo_bytes != record.rx_bytes;
+    }
+
+    bool CycleLatencyReport::settled(const CycleRecord &record,
+                                     const bool cycle_ended,
+                                     const uint32_t timeout_us) {
+        if (record.id == 0) {
+            return true;
+        }
+        if (cycle_ended && (record.at(CycleStage::PRINTED) != 0 ||
+                            record.at(CycleStage::COMPLETE) == 0)) {
+            return true;
+        }
+        return time_us_32() - record.at(CycleStage::CONNECT) >= timeout_us;
+    }
+
+    bool CycleLatencyReport::setBudgets(const char *spec) {
+        m_budget_count = 0;
+        const char *at = spec;
+        while (at && *at != '\0') {
+            const char *colon = std::strchr(at, ':');
+            if (!colon || m_budget_count == MAX_BUDGETS) {
+                m_budget_count = 0;
+                return false;
+            }
+            Budget budget;
+            bool named = false;
+            for (std::size_t span = 0; span < SPANS && !named; ++span) {
+                const char *name = spanName(span);
+                if (std::strlen(name) == static_cast<std::size_t>(colon - at) &&
+                    std::strncmp(name, at, colon - at) == 0) {
+                    budget.span = static_cast<uint8_t>(span);
+                    named = true;
+                }
+            }
+            const char *tail = colon + 1;
+            if (named && *tail == 'p') {
+                budget.per_mille = parsePerMille(tail + 1, &tail);
+            }
+            char *end = nullptr;
+            if (budget.per_mille != 0 && *tail == '=') {
+                budget.limit_us = std::strtoul(tail + 1, &end, 10);
+            }
+            if (!end || end == tail + 1 || (*end != ',' && *end != '\0')) {
+                m_budget_count = 0;
+                return false;
+            }
+            m_budgets[m_budget_count++] = budget;
+            at = *end == ',' ? end + 1 : end;
+        }
+        return true;
+    }
+
+    uint32_t CycleLatencyReport::percentileUs(const std::size_t span,
+                                              const uint16_t per_mille) const {
+        const auto &histogram = m_spans[span];
+        if (histogram.count == 0) {
+            return 0;
+        }
+        const uint64_t target = std::max<uint64_t>(
+            (static_cast<uint64_t>(histogram.count) * per_mille + 999) / 1000,
+            1);
+        uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+            seen += histogram.buckets[bucket];
+            if (seen >= target) {
+                return std::min(bucketUpperUs(bucket), histogram.max_us);
+            }
+        }
+        return histogram.max_us;
+    }
+
+    uint32_t CycleLatencyReport::meanUs(const std::size_t span) const {
+        const auto &histogram = m_spans[span];
+        return histogram.count
+                   ? static_cast<uint32_t>(histogram.total_us / histogram.count)
+                   : 0;
+    }
+
+    std::size_t CycleLatencyReport::exceeded() const {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < m_budget_count; ++i) {
+            const auto &budget = m_budgets[i];
+            // A budget over cycles that never got that far is not met either
+            if (m_spans[budget.span].count == 0 ||
+                percentileUs(budget.span, budget.per_mille) > budget.limit_us) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    bool CycleLatencyReport::passed(const uint32_t failed_cycles) const {
+        return m_quotes > 0 && failed_cycles == 0 && m_mismatched == 0 &&
+               exceeded() == 0;
+    }
+
+    std::string CycleLatencyReport::report(const uint32_t failed_cycles) const {
+        std::string lines = "[PIPELINE] cycles " + std::to_string(m_cycles) +
+                            ", quotes " + std::to_string(m_quotes) +
+                            ", printed " + std::to_string(printed()) + "\n";
+        for (std::size_t offset = 1; offset <= SPANS; ++offset) {
+            // Stages in order, the whole cycle last
+            const std::size_t span = offset % SPANS;
+            const auto &histogram = m_spans[span];
+            if (histogram.count == 0 && histogram.reversed == 0) {
+                continue;
+            }
+            lines += std::string("[PIPELINE] ") + spanName(span) +
+                     " n=" + std::to_string(histogram.count) +
+                     " p50/p99/p99.9/max us " +
+                     std::to_string(percentileUs(span, 500)) + "/" +
+                     std::to_string(percentileUs(span, 990)) + "/" +
+                     std::to_string(percentileUs(span, 999)) + "/" +
+                     std::to_string(histogram.max_us) + " avg " +
+                     std::to_string(meanUs(span)) +
+                     (histogram.reversed != 0
+                          ? " reversed " + std::to_string(histogram.reversed)
+                          : "") +
+                     "\n";
+        }
+        for (std::size_t i = 0; i < m_budget_count; ++i) {
+            const auto &budget = m_budgets[i];
+            const uint32_t actual = percentileUs(budget.span, budget.per_mille);
+            const bool met = m_spans[budget.span].count != 0 &&
+                             actual <= budget.limit_us;
+            lines += std::string("[PIPELINE] budget ") +
+                     spanName(budget.span) + " " +
+                     percentileName(budget.per_mille) + " <= " +
+                     std::to_string(budget.limit_us) + " us: " +
+                     std::to_string(actual) + " us, " +
+                     (met ? "met" : "EXCEEDED") + "\n";
+        }
+        lines += std::string("[PIPELINE] ") +
+                 (passed(failed_cycles) ? "PASS" : "FAIL") + ", " +
+                 std::to_string(failed_cycles) + " failed cycles, " +
+                 std::to_string(m_mismatched) + " echo mismatches, " +
+                 std::to_string(exceeded()) + " of " +
+                 std::to_string(m_budget_count) + " budgets exceeded" +
+                 (m_quotes == 0 ? ", no quotes" : "") + "\n";
+        return lines;
+    }
+
+} // namespace e5
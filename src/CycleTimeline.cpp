@@ -0,0 +1,213 @@
+/**
+ * @file CycleTimeline.cpp
+ * @brief Implementation of the QOTD cycle timeline ring.
+ *
+ * @author Goran
+ * @date 2025-09-22
+ * @ingroup AsyncTCPClient
+ */
+
+#include "CycleTimeline.hpp"
+#include <Arduino.h>
+#include <algorithm>
+
+namespace e5 {
+
+    const char *stageName(const CycleStage stage) {
+        switch (stage) {
+        case CycleStage::CONNECT:
+            return "connect";
+        case CycleStage::CONNECTED:
+            return "connected";
+        case CycleStage::FIRST_RX:
+            return "first_rx";
+        case CycleStage::LAST_CHUNK:
+            return "last_chunk";
+        case CycleStage::FIN:
+            return "fin";
+        case CycleStage::COMPLETE:
+            return "complete";
+        case CycleStage::ECHO_WRITE:
+            return "echo_write";
+        case CycleStage::ECHO_ACK:
+            return "echo_ack";
+        case CycleStage::ECHO_LAST_BYTE:
+            return "echo_last";
+        case CycleStage::PRINTED:
+            return "printed";
+        case CycleStage::COUNT:
+            break;
+        }
+        return "?";
+    }
+
+    void CycleTimeline::stamp(CycleRecord &record, const CycleStage stage) {
+        auto &at = record.stage_us[static_cast<std::size_t>(stage)];
+        if (at == 0) {
+            const uint32_t now = time_us_32();
+            at = now ? now : 1;
+        }
+    }
+
+    CycleRecord *CycleTimeline::current() {
+        const uint32_t cycles = m_cycles.load(std::memory_order_acquire);
+        return cycles ? &m_ring[(cycles - 1) % CAPACITY] : nullptr;
+    }
+
+    CycleRecord *CycleTimeline::echo() {
+        const int16_t index = m_echo.load(std::memory_order_acquire);
+        return index >= 0 ? &m_ring[index] : nullptr;
+    }
+
+    uint32_t CycleTimeline::begin() {
+        const uint32_t id = m_cycles.load(std::memory_order_relaxed) + 1;
+        const auto index = static_cast<int16_t>((id - 1) % CAPACITY);
+        // The echo stages may still point at the record being reused;
+        // echoWrite() runs on the loop too, so this cannot race it
+        if (m_echo.load(std::memory_order_relaxed) == index) {
+            m_echo.store(-1, std::memory_order_relaxed);
+        }
+
+        auto &record = m_ring[index];
+        record = CycleRecord();
+        record.id = id;
+        stamp(record, CycleStage::CONNECT);
+        // Publish only once the record is clean; handlers stamp the
+        // previous record until then
+        m_cycles.store(id, std::memory_order_release);
+        return id;
+    }
+
+    void CycleTimeline::discard() {
+        const uint32_t cycles = m_cycles.load(std::memory_order_relaxed);
+        if (cycles != 0) {
+            m_cycles.store(cycles - 1, std::memory_order_release);
+        }
+    }
+
+    void CycleTimeline::mark(const CycleStage stage) {
+        if (auto *record = current()) {
+            stamp(*record, stage);
+        }
+    }
+
+    void CycleTimeline::addChunk(const std::size_t bytes) {
+        auto *record = current();
+        if (!record || bytes == 0) {
+            return;
+        }
+        stamp(*record, CycleStage::FIRST_RX);
+        uint32_t now = time_us_32();
+        now = now ? now : 1;
+        record->stage_us[static_cast<std::size_t>(CycleStage::LAST_CHUNK)] =
+            now;
+        if (record->rx_chunks < CycleRecord::CHUNK_STAMPS) {
+            record->chunk_us[record->rx_chunks] = now;
+        }
+        record->rx_chunks = static_cast<uint16_t>(
+            std::min<uint32_t>(record->rx_chunks + 1u, UINT16_MAX));
+        record->rx_bytes = static_cast<uint16_t>(std::min<std::size_t>(
+            record->rx_bytes + bytes, UINT16_MAX));
+        ++record->chunks;
+    }
+
+    void CycleTimeline::addDrained(const std::size_t bytes) {
+        auto *record = current();
+        if (!record || bytes == 0) {
+            return;
+        }
+        record->rx_bytes = static_cast<uint16_t>(std::min<std::size_t>(
+            record->rx_bytes + bytes, UINT16_MAX));
+        ++record->chunks;
+    }
+
+    void CycleTimeline::echoWrite(const std::size_t bytes) {
+        auto *record = current();
+        if (!record || record->at(CycleStage::COMPLETE) == 0 ||
+            record->at(CycleStage::ECHO_WRITE) != 0) {
+            return;
+        }
+        record->echo_bytes =
+            static_cast<uint16_t>(std::min<std::size_t>(bytes, UINT16_MAX));
+        stamp(*record, CycleStage::ECHO_WRITE);
+        m_echo.store(static_cast<int16_t>(record - m_ring),
+                     std::memory_order_release);
+    }
+
+    void CycleTimeline::echoAcked(const std::size_t bytes) {
+        auto *record = echo();
+        if (!record || record->at(CycleStage::ECHO_ACK) != 0) {
+            return;
+        }
+        record->echo_acked = static_cast<uint16_t>(std::min<std::size_t>(
+            record->echo_acked + bytes, UINT16_MAX));
+        if (record->echo_acked >= record->echo_bytes) {
+            stamp(*record, CycleStage::ECHO_ACK);
+        }
+    }
+
+    void CycleTimeline::echoReceived(const std::size_t bytes,
+                                     const std::string *message) {
+        auto *record = echo();
+        if (!record || record->at(CycleStage::ECHO_LAST_BYTE) != 0) {
+            return;
+        }
+        record->echo_rx_bytes = static_cast<uint16_t>(std::min<std::size_t>(
+            record->echo_rx_bytes + bytes, UINT16_MAX));
+        if (record->echo_rx_bytes >= record->echo_bytes) {
+            m_watched_print.store(message, std::memory_order_release);
+            stamp(*record, CycleStage::ECHO_LAST_BYTE);
+        }
+    }
+
+    void CycleTimeline::onEmit(const std::string &message, void *arg) {
+        auto &timeline = *static_cast<CycleTimeline *>(arg);
+        // No compare-and-swap on the M0+; a watch set between the load and
+        // the store would be lost, costing one PRINTED stamp at most
+        if (timeline.m_watched_print.load(std::memory_order_acquire) !=
+            &message) {
+            return;
+        }
+        timeline.m_watched_print.store(nullptr, std::memory_order_relaxed);
+        if (auto *record = timeline.echo()) {
+            stamp(*record, CycleStage::PRINTED);
+        }
+    }
+
+    bool CycleTimeline::record(const std::size_t age, CycleRecord &out) const {
+        const uint32_t cycles = m_cycles.load(std::memory_order_acquire);
+        if (age >= CAPACITY || age >= cycles) {
+            return false;
+        }
+        out = m_ring[(cycles - 1 - age) % CAPACITY];
+        return true;
+    }
+
+    CycleTimeline::Latency CycleTimeline::latency(const CycleStage from,
+                                                  const CycleStage to) const {
+        uint32_t samples[CAPACITY];
+        uint16_t count = 0;
+        for (const auto &record : m_ring) {
+            const uint32_t start = record.at(from);
+            const uint32_t end = record.at(to);
+            if (record.id != 0 && start != 0 && end != 0) {
+                samples[count++] = end - start;
+            }
+        }
+        Latency result;
+        result.count = count;
+        if (count == 0) {
+            return result;
+        }
+        std::sort(samples, samples + count);
+        const auto pick = [&](const uint32_t percent) {
+            return samples[(count - 1) * percent / 100];
+        };
+        result.p50_us = pick(50);
+        result.p90_us = pick(90);
+        result.p99_us = pick(99);
+        result.max_us = samples[count - 1];
+        return result;
+    }
+
+} // namespace e5
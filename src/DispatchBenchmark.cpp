@@ -0,0 +1,98 @@
+/**
+ * @file DispatchBenchmark.cpp
+ * @brief On-device benchmark of inline vs queued context dispatch.
+ *
+ * @author Goran
+ * @date 2025-09-05
+ * @ingroup AsyncTCPClient
+ */
+
+#include "DispatchBenchmark.hpp"
+#include "PrintHandler.hpp"
+#include <Arduino.h>
+#include <algorithm>
+
+namespace e5 {
+
+    namespace {
+
+        struct Latency {
+                uint64_t total_us = 0;
+                uint32_t max_us = 0;
+
+                void add(const uint32_t us) {
+                    total_us += us;
+                    max_us = std::max(max_us, us);
+                }
+        };
+
+        void report(const SerialPrinter &printer, const char *operation,
+                    const bool inline_path, const std::size_t iterations,
+                    const Latency &latency) {
+            auto line = std::make_unique<std::string>(
+                std::string("[BENCH] dispatch,") + operation + "," +
+                (inline_path ? "inline" : "queued") +
+                ",n=" + std::to_string(iterations) +
+                ",avg_us=" + std::to_string(latency.total_us / iterations) +
+                ",max_us=" + std::to_string(latency.max_us) + "\n");
+            printer.print(std::move(line));
+        }
+
+        // Time from print() to the message being emitted, queued or inline.
+        Latency measurePrint(const SerialPrinter &printer,
+                             const std::size_t iterations) {
+            Latency latency;
+            for (std::size_t i = 0; i < iterations; ++i) {
+                const uint32_t target = PrintHandler::printed() + 1;
+                const uint32_t start = time_us_32();
+                printer.print(std::make_unique<std::string>());
+                while (PrintHandler::printed() < target) {
+                    tight_loop_contents();
+                }
+                latency.add(time_us_32() - start);
+            }
+            return latency;
+        }
+
+        // Time for one set() followed by one get().
+        Latency measureQuoteBuffer(QuoteBuffer &buffer,
+                                   const std::size_t iterations) {
+            Latency latency;
+            const std::string quote = "Keep it simple. - Unknown";
+            for (std::size_t i = 0; i < iterations; ++i) {
+                const uint32_t start = time_us_32();
+                buffer.set(quote);
+                (void)buffer.get();
+                latency.add(time_us_32() - start);
+            }
+            return latency;
+        }
+
+    } // namespace
+
+    void runDispatchBenchmark(const SerialPrinter &printer,
+                              QuoteBuffer &buffer,
+                              const std::size_t iterations) {
+        if (iterations == 0) {
+            return;
+        }
+        Latency results[2][2];
+        for (const bool inline_path : {false, true}) {
+            printer.dispatch().setEnabled(inline_path);
+            buffer.dispatch().setEnabled(inline_path);
+            results[inline_path][0] = measurePrint(printer, iterations);
+            results[inline_path][1] = measureQuoteBuffer(buffer, iterations);
+        }
+        printer.dispatch().setEnabled(true);
+        buffer.dispatch().setEnabled(true);
+        buffer.clear();
+
+        for (const bool inline_path : {false, true}) {
+            report(printer, "print", inline_path, iterations,
+                   results[inline_path][0]);
+            report(printer, "quote_buffer", inline_path, iterations,
+                   results[inline_path][1]);
+        }
+    }
+
+} // namespace e5
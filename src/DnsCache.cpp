@@ -0,0 +1,102 @@
+/**
+ * @file DnsCache.cpp
+ * @brief Implementation of the flash-backed DNS cache.
+ *
+ * @author Goran
+ * @date 2025-09-20
+ * @ingroup AsyncTCPClient
+ */
+
+#include "DnsCache.hpp"
+#include <EEPROM.h>
+
+namespace e5 {
+
+    uint32_t DnsCache::hash(const char *host) {
+        uint32_t h = 2166136261u;
+        for (; *host; ++host) {
+            h = (h ^ static_cast<uint8_t>(*host)) * 16777619u;
+        }
+        return h ? h : 1; // 0 marks a free entry
+    }
+
+    uint32_t DnsCache::checksum(const Image &image) {
+        const auto *bytes = reinterpret_cast<const uint8_t *>(&image);
+        uint32_t sum = 2166136261u;
+        for (std::size_t i = 0; i < offsetof(Image, checksum); ++i) {
+            sum = (sum ^ bytes[i]) * 16777619u;
+        }
+        return sum;
+    }
+
+    DnsCache::Entry *DnsCache::find(const uint32_t host_hash) {
+        for (auto &entry : m_image.entries) {
+            if (entry.host_hash == host_hash) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    void DnsCache::load() {
+        EEPROM.begin(EEPROM_SIZE);
+        EEPROM.get(0, m_image);
+        if (m_image.magic != MAGIC || m_image.checksum != checksum(m_image)) {
+            DEBUGWIRE("[DnsCache] no valid image, starting empty\n");
+            m_image = Image();
+            m_image.magic = MAGIC;
+        }
+        m_boot = static_cast<uint16_t>(m_image.boots + 1);
+    }
+
+    bool DnsCache::lookup(const char *host, IPAddress &address) const {
+        const uint32_t host_hash = hash(host);
+        for (const auto &entry : m_image.entries) {
+            if (entry.host_hash != host_hash) {
+                continue;
+            }
+            if (static_cast<uint16_t>(m_boot - entry.refreshed_boot) >
+                m_ttl_boots) {
+                return false;
+            }
+            address = IPAddress(entry.address);
+            return true;
+        }
+        return false;
+    }
+
+    void DnsCache::store(const char *host, const IPAddress &address) {
+        const uint32_t host_hash = hash(host);
+        Entry *entry = find(host_hash);
+        if (!entry) {
+            entry = find(0);
+        }
+        if (!entry) {
+            // Full: replace the entry refreshed longest ago
+            entry = &m_image.entries[0];
+            for (auto &candidate : m_image.entries) {
+                if (static_cast<uint16_t>(m_boot - candidate.refreshed_boot) >
+                    static_cast<uint16_t>(m_boot - entry->refreshed_boot)) {
+                    entry = &candidate;
+                }
+            }
+        }
+        entry->host_hash = host_hash;
+        entry->address = static_cast<uint32_t>(address);
+        entry->refreshed_boot = m_boot;
+    }
+
+    bool DnsCache::commit() {
+        if (m_committed) {
+            return false;
+        }
+        // The counter goes to flash every boot, even with every address
+        // unchanged; otherwise those boots would not age the entries
+        m_image.boots = m_boot;
+        m_image.checksum = checksum(m_image);
+        EEPROM.put(0, m_image);
+        m_committed = true;
+        return EEPROM.commit();
+    }
+
+} // namespace e5
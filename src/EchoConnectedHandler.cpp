@@ -33,14 +33,16 @@ namespace e5 {
      * initialized, ensuring proper core affinity for non-thread-safe operations
      * like printing.
      */
-    void EchoConnectedHandler::onWork() {
+    void EchoConnectedHandler::onWork(const ConnectionTable::Slot slot) {
+        auto &io = m_table.client(slot);
+        m_table.markConnected(slot);
         // Configure connection parameters
-        m_io.keepAlive();
-        m_io.setNoDelay(true); // Disable Nagle's algorithm for immediate packet
-                               // transmission
+        io.keepAlive();
+        io.setNoDelay(true); // Disable Nagle's algorithm for immediate packet
+                             // transmission
 
         // Get the local IP address
-        const std::string remote_ip(m_io.remoteIP().toString().c_str());
+        const std::string remote_ip(io.remoteIP().toString().c_str());
         auto notify_connect = std::make_unique<std::string>(
             "[INFO] Echo client connected. Remote IP: " + remote_ip + "\n");
 
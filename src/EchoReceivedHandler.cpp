@@ -12,39 +12,56 @@
  */
 
 #include "EchoReceivedHandler.hpp"
+#include "CycleTimeline.hpp"
+#include <algorithm>
 #include <string>
 
 namespace e5 {
 
     /**
-     * @brief Handles the data received event.
+     * @brief Handles one slice of the data received event.
      *
      * This method is called when data is received on the TCP connection. It:
      * 1. Peeks at available data in the TCP buffer without consuming it
-     * 2. Creates a string from the peeked data
+     * 2. Creates a string from at most the slice budget of peeked data
      * 3. Outputs the data through the SerialPrinter with chunk information
-     * 4. Consumes the data from the TCP buffer
+     * 4. Consumes exactly the printed bytes from the TCP buffer
      *
      * With Nagle's algorithm disabled, data arrives in multiple TCP
-     * segments based on network conditions.
+     * segments based on network conditions. Anything beyond the budget is
+     * printed by the next slice.
      */
-    void EchoReceivedHandler::onWork() {
+    SliceResult EchoReceivedHandler::onSlice(const ConnectionTable::Slot slot,
+                                             SliceBudget &budget) {
+        IoRxBuffer *rx_buffer = m_table.rxBuffer(slot);
         // ReSharper disable once CppDFANullDereference
-        const size_t available = m_rx_buffer->peekAvailable();
+        const size_t available = rx_buffer->peekAvailable();
         if (available == 0)
-            return;
+            return SliceResult::DONE;
+        const size_t chunk = std::min(available, budget.bytes);
+        m_table.addRxBytes(slot, chunk);
 
         // ReSharper disable once CppDFANullDereference
-        const char *data = m_rx_buffer->peekBuffer();
-        // Print any incoming echo data (append newline only for SerialPrinter)
+        const char *data = rx_buffer->peekBuffer();
+        // Print incoming echo data; the newline for SerialPrinter is only
+        // appended once the received data has been printed in full
         auto quote = std::make_unique<std::string>();
-        quote->reserve(available + 1);
-        quote->assign(data, available);
-        quote->append("\n");
+        quote->reserve(chunk + 1);
+        quote->assign(data, chunk);
+        if (chunk == available) {
+            quote->append("\n");
+        }
+        if (auto *timeline = m_table.timeline(slot)) {
+            // Watched before printing: the print may run at once on core 1
+            timeline->echoReceived(chunk, quote.get());
+        }
         m_serial_printer.print(std::move(quote));
-        // Consume exactly the bytes we received; IoRxBuffer frees head on exact consumption
+        // Consume exactly the bytes we printed; IoRxBuffer frees head on exact consumption
         // ReSharper disable once CppDFANullDereference
-        m_rx_buffer->peekConsume(available);
+        rx_buffer->peekConsume(chunk);
+        budget.consume(chunk);
+        return chunk < available ? SliceResult::MORE_PENDING
+                                 : SliceResult::DONE;
     }
 
 } // namespace e5
@@ -0,0 +1,144 @@
+/**
+ * @file EndpointRace.cpp
+ * @brief Implementation of the per-cycle endpoint race.
+ *
+ * @author Goran
+ * @date 2025-09-17
+ * @ingroup AsyncTCPClient
+ */
+
+#include "EndpointRace.hpp"
+
+namespace e5 {
+
+    bool EndpointRace::addRacer(ConnectionManager &manager) {
+        if (m_count == MAX_RACERS) {
+            return false;
+        }
+        auto &racer = m_racers[m_count++];
+        racer.manager = &manager;
+        racer.seen_connects = manager.connects();
+        racer.seen_completed = manager.completedCycles();
+        racer.seen_failed = manager.failedCycles();
+        return true;
+    }
+
+    bool EndpointRace::requestCycle() {
+        if (m_active) {
+            ++m_wasted;
+            return false;
+        }
+        EndpointSelector::Index best[MAX_RACERS];
+        const std::size_t candidates = m_selector.best(best, m_count);
+        if (m_claim) {
+            // No QOTD connection is open between cycles
+            m_claim->reset();
+        }
+
+        std::size_t started = 0;
+        for (std::size_t i = 0; i < candidates; ++i) {
+            auto &racer = m_racers[i];
+            const auto &endpoint = m_selector.endpoint(best[i]);
+            racer.manager->setEndpoint(endpoint.address, endpoint.port);
+            racer.endpoint = best[i];
+            racer.running = racer.manager->requestCycle();
+            started += racer.running ? 1 : 0;
+        }
+        if (started == 0) {
+            ++m_wasted;
+            return false;
+        }
+        ++m_cycles;
+        m_raced += started > 1 ? 1 : 0;
+        m_active = true;
+        m_winner = -1;
+        m_completed = false;
+        m_started_us = time_us_32();
+        return true;
+    }
+
+    void EndpointRace::win(const std::size_t index) {
+        m_winner = static_cast<int8_t>(index);
+        m_selector.recordWin(m_racers[index].endpoint);
+        for (std::size_t j = 0; j < m_count; ++j) {
+            if (j != index && m_racers[j].running) {
+                m_racers[j].manager->abandon();
+                m_racers[j].running = false;
+            }
+        }
+    }
+
+    void EndpointRace::poll() {
+        for (std::size_t i = 0; i < m_count; ++i) {
+            m_racers[i].manager->poll();
+        }
+
+        // The racer writing the shared buffer wins, even if the other
+        // connect was seen first
+        if (const auto owner =
+                m_claim ? m_claim->owner() : ConnectionTable::NO_SLOT;
+            owner != ConnectionTable::NO_SLOT && m_active && m_winner < 0) {
+            for (std::size_t i = 0; i < m_count; ++i) {
+                if (m_racers[i].running &&
+                    m_racers[i].manager->slot() == owner) {
+                    win(i);
+                    break;
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < m_count; ++i) {
+            auto &racer = m_racers[i];
+            const auto &manager = *racer.manager;
+            const bool connected = manager.connects() != racer.seen_connects;
+            const bool completed =
+                manager.completedCycles() != racer.seen_completed;
+            const bool failed = manager.failedCycles() != racer.seen_failed;
+            racer.seen_connects = manager.connects();
+            racer.seen_completed = manager.completedCycles();
+            racer.seen_failed = manager.failedCycles();
+            if (racer.endpoint == EndpointSelector::NO_ENDPOINT) {
+                continue;
+            }
+
+            if (connected) {
+                // Losers still contribute a connect-time sample
+                m_selector.recordConnect(racer.endpoint,
+                                         manager.lastConnectUs());
+                if (!m_claim && racer.running && m_winner < 0) {
+                    win(i);
+                }
+            }
+            if (!racer.running) {
+                continue;
+            }
+            if (failed) {
+                m_selector.recordFailure(racer.endpoint);
+                racer.running = false;
+                if (m_winner == static_cast<int8_t>(i)) {
+                    m_winner = -1;
+                }
+            } else if (completed && m_winner == static_cast<int8_t>(i)) {
+                m_last_cycle_us = time_us_32() - m_started_us;
+                m_selector.recordCycle(racer.endpoint, m_last_cycle_us);
+                m_completed = true;
+                racer.running = false;
+            }
+        }
+
+        if (!m_active) {
+            return;
+        }
+        for (std::size_t i = 0; i < m_count; ++i) {
+            if (m_racers[i].running) {
+                return;
+            }
+        }
+        // Every racer has finished, failed or been abandoned
+        m_active = false;
+        if (!m_completed) {
+            ++m_failed;
+        }
+    }
+
+} // namespace e5
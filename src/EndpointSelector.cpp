@@ -0,0 +1,159 @@
+/**
+ * @file EndpointSelector.cpp
+ * @brief Implementation of the latency-ranked endpoint set.
+ *
+ * @author Goran
+ * @date 2025-09-17
+ * @ingroup AsyncTCPClient
+ */
+
+#include "EndpointSelector.hpp"
+#include <algorithm>
+
+namespace e5 {
+
+    namespace {
+
+        uint32_t ewma(const uint32_t average, const uint32_t sample,
+                      const uint16_t samples) {
+            if (samples == 0) {
+                return sample;
+            }
+            return average - average / 4 + sample / 4;
+        }
+
+    } // namespace
+
+    EndpointSelector::Index EndpointSelector::add(const char *host,
+                                                  const uint16_t port) {
+        if (m_size == MAX_ENDPOINTS) {
+            return NO_ENDPOINT;
+        }
+        auto &endpoint = m_endpoints[m_size];
+        endpoint.host = host;
+        endpoint.port = port;
+        return static_cast<Index>(m_size++);
+    }
+
+    void EndpointSelector::setAddress(const Index index,
+                                      const IPAddress &address) {
+        auto &endpoint = m_endpoints[index];
+        endpoint.address = address;
+        endpoint.resolved = true;
+    }
+
+    bool EndpointSelector::live(const Endpoint &endpoint,
+                                const uint32_t now_us) const {
+        return endpoint.resolved &&
+               (endpoint.quarantine_us == 0 ||
+                now_us - endpoint.quarantined_at_us >= endpoint.quarantine_us);
+    }
+
+    uint32_t EndpointSelector::score(const Endpoint &endpoint) {
+        if (endpoint.cycle_samples > 0) {
+            return endpoint.cycle_ewma_us;
+        }
+        // Connect time alone says less about the service; rank it behind
+        // a measured cycle of the same length.
+        return endpoint.connect_samples > 0 ? endpoint.connect_ewma_us * 2
+                                            : 0;
+    }
+
+    std::size_t EndpointSelector::best(Index *out, const std::size_t count) {
+        const uint32_t now = time_us_32();
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < m_size; ++i) {
+            if (!live(m_endpoints[i], now)) {
+                continue;
+            }
+            // Insertion sort into the short result list
+            std::size_t pos = std::min(found, count);
+            while (pos > 0 && score(m_endpoints[i]) <
+                                  score(m_endpoints[out[pos - 1]])) {
+                if (pos < count) {
+                    out[pos] = out[pos - 1];
+                }
+                --pos;
+            }
+            if (pos < count) {
+                out[pos] = static_cast<Index>(i);
+                found = std::min(found + 1, count);
+            }
+        }
+        if (found > 0 || count == 0) {
+            return found;
+        }
+
+        // Nothing live: fall back to the quarantine that ends first
+        uint32_t soonest = UINT32_MAX;
+        for (std::size_t i = 0; i < m_size; ++i) {
+            const auto &endpoint = m_endpoints[i];
+            if (!endpoint.resolved) {
+                continue;
+            }
+            const uint32_t left = endpoint.quarantine_us -
+                                  (now - endpoint.quarantined_at_us);
+            if (left < soonest) {
+                soonest = left;
+                out[0] = static_cast<Index>(i);
+                found = 1;
+            }
+        }
+        return found;
+    }
+
+    void EndpointSelector::recordConnect(const Index index,
+                                         const uint32_t connect_us) {
+        auto &endpoint = m_endpoints[index];
+        endpoint.connect_ewma_us =
+            ewma(endpoint.connect_ewma_us, connect_us, endpoint.connect_samples);
+        if (endpoint.connect_samples < UINT16_MAX) {
+            ++endpoint.connect_samples;
+        }
+        endpoint.consecutive_failures = 0;
+        endpoint.quarantines = 0;
+        endpoint.quarantine_us = 0;
+    }
+
+    void EndpointSelector::recordCycle(const Index index,
+                                       const uint32_t cycle_us) {
+        auto &endpoint = m_endpoints[index];
+        endpoint.cycle_ewma_us =
+            ewma(endpoint.cycle_ewma_us, cycle_us, endpoint.cycle_samples);
+        if (endpoint.cycle_samples < UINT16_MAX) {
+            ++endpoint.cycle_samples;
+        }
+    }
+
+    void EndpointSelector::recordFailure(const Index index) {
+        auto &endpoint = m_endpoints[index];
+        ++endpoint.failures;
+        if (++endpoint.consecutive_failures < FAILURE_LIMIT) {
+            return;
+        }
+        endpoint.consecutive_failures = 0;
+        const uint8_t shift = std::min<uint8_t>(endpoint.quarantines, 16);
+        endpoint.quarantine_us = static_cast<uint32_t>(std::min<uint64_t>(
+            static_cast<uint64_t>(m_quarantine_base_us) << shift,
+            m_quarantine_max_us));
+        endpoint.quarantined_at_us = time_us_32();
+        if (endpoint.quarantines < UINT8_MAX) {
+            ++endpoint.quarantines;
+        }
+        DEBUGWIRE("[EndpointSelector] %s:%u quarantined for %lu us\n",
+                  endpoint.host, endpoint.port,
+                  static_cast<unsigned long>(endpoint.quarantine_us));
+    }
+
+    void EndpointSelector::setQuarantine(const uint32_t base_us,
+                                         const uint32_t max_us) {
+        m_quarantine_base_us = base_us;
+        m_quarantine_max_us = std::max(max_us, base_us);
+    }
+
+    bool EndpointSelector::quarantined(const Index index) const {
+        return !live(m_endpoints[index], time_us_32()) &&
+               m_endpoints[index].resolved;
+    }
+
+} // namespace e5
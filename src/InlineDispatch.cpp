@@ -0,0 +1,48 @@
+/**
+ * @file InlineDispatch.cpp
+ * @brief Implementation of the same-core dispatch fast path.
+ *
+ * @author Goran
+ * @date 2025-09-05
+ * @ingroup AsyncTCPClient
+ */
+
+#include "InlineDispatch.hpp"
+#include "LockProfiler.hpp"
+#include <Arduino.h>
+
+namespace e5 {
+
+    bool InlineDispatch::tryEnter() {
+        if (!m_enabled || get_core_num() != m_ctx.getCore() || m_active) {
+            return false;
+        }
+        const uint32_t start = time_us_32();
+        m_ctx.acquireLock();
+        // A worker may have started inline work between the check and the
+        // lock; re-check now that the context is held.
+        if (m_active) {
+            m_ctx.releaseLock();
+            return false;
+        }
+        m_active = true;
+        m_acquired_us = time_us_32();
+        if (auto *profiler = LockProfiler::of(m_ctx)) {
+            profiler->recordWait(LockCaller::LOOP_CODE, m_acquired_us - start);
+        }
+        ++m_inline[get_core_num()];
+        return true;
+    }
+
+    void InlineDispatch::leave() {
+        const uint32_t held_us = time_us_32() - m_acquired_us;
+        m_active = false;
+        m_ctx.releaseLock();
+        if (auto *profiler = LockProfiler::of(m_ctx)) {
+            profiler->recordHold(LockCaller::LOOP_CODE, held_us);
+        }
+    }
+
+    void InlineDispatch::countQueued() { ++m_queued[get_core_num()]; }
+
+} // namespace e5
@@ -0,0 +1,54 @@
+/**
+ * @file Latch.cpp
+ * @brief Implementation of the cross-core latch.
+ *
+ * @author Goran
+ * @date 2025-09-21
+ * @ingroup AsyncTCPClient
+ */
+
+#include "Latch.hpp"
+#include <Arduino.h>
+
+#ifdef ARDUINO
+#include <hardware/sync.h>
+#endif
+
+namespace e5 {
+
+#ifdef ARDUINO
+    void Latch::open() {
+        const uint32_t now = time_us_32();
+        m_opened_us.store(now ? now : 1, std::memory_order_relaxed);
+        m_open.store(true, std::memory_order_release);
+        __sev();
+    }
+
+    void Latch::wait() const {
+        while (!isOpen()) {
+            __wfe();
+        }
+    }
+#else
+    void Latch::open() {
+        const uint32_t now = time_us_32();
+        m_opened_us.store(now ? now : 1, std::memory_order_relaxed);
+        {
+            // Under the mutex, so a waiter between its check and its sleep
+            // cannot miss the notification
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_open.store(true, std::memory_order_release);
+        }
+        m_opened.notify_all();
+    }
+
+    void Latch::wait() const {
+        if (isOpen()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_opened.wait(lock, [this] { return isOpen(); });
+    }
+#endif
+
+} // namespace e5
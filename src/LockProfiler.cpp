@@ -0,0 +1,120 @@
+/**
+ * @file LockProfiler.cpp
+ * @brief Implementation of the async-context lock contention metrics.
+ *
+ * @author Goran
+ * @date 2025-09-10
+ * @ingroup AsyncTCPClient
+ */
+
+#include "LockProfiler.hpp"
+#include <algorithm>
+
+namespace e5 {
+
+    namespace {
+
+        const char *callerName(const std::size_t caller) {
+            switch (static_cast<LockCaller>(caller)) {
+            case LockCaller::BRIDGE_EXECUTE:
+                return "bridge_execute";
+            case LockCaller::WORKER_DISPATCH:
+                return "worker_dispatch";
+            case LockCaller::LOOP_CODE:
+                return "loop_code";
+            case LockCaller::ENQUEUE:
+                return "enqueue";
+            default:
+                return "unknown";
+            }
+        }
+
+        std::string formatHistogram(const LockProfiler::Histogram &histogram) {
+            return std::to_string(histogram.percentileUs(50)) + "/" +
+                   std::to_string(histogram.percentileUs(99)) + "/" +
+                   std::to_string(histogram.max_us);
+        }
+
+    } // namespace
+
+    const AsyncCtx *LockProfiler::s_contexts[MAX_PROFILED_CONTEXTS] = {};
+    LockProfiler *LockProfiler::s_profilers[MAX_PROFILED_CONTEXTS] = {};
+
+    bool LockProfiler::attach(const AsyncCtx &ctx, LockProfiler &profiler) {
+        for (std::size_t i = 0; i < MAX_PROFILED_CONTEXTS; ++i) {
+            if (s_contexts[i] == nullptr || s_contexts[i] == &ctx) {
+                s_profilers[i] = &profiler;
+                s_contexts[i] = &ctx;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    LockProfiler *LockProfiler::of(const AsyncCtx &ctx) {
+        for (std::size_t i = 0; i < MAX_PROFILED_CONTEXTS; ++i) {
+            if (s_contexts[i] == &ctx) {
+                return s_profilers[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void LockProfiler::recordWait(const LockCaller caller,
+                                  const uint32_t wait_us) {
+        auto &series = m_series[static_cast<std::size_t>(caller)][currentLane()];
+        series.wait.add(wait_us);
+        if (wait_us >= m_contention_threshold_us) {
+            ++series.contended;
+        }
+    }
+
+    void LockProfiler::recordHold(const LockCaller caller,
+                                  const uint32_t hold_us) {
+        m_series[static_cast<std::size_t>(caller)][currentLane()].hold.add(
+            hold_us);
+    }
+
+    void LockProfiler::recordLatency(const LockCaller caller,
+                                     const uint32_t latency_us) {
+        m_series[static_cast<std::size_t>(caller)][currentLane()].latency.add(
+            latency_us);
+    }
+
+    std::string LockProfiler::report() const {
+        std::string lines;
+        for (std::size_t caller = 0; caller < LOCK_CALLER_CLASSES; ++caller) {
+            for (std::size_t lane = 0; lane < LOCK_LANES; ++lane) {
+                const auto &series = m_series[caller][lane];
+                if (series.wait.count == 0 && series.hold.count == 0 &&
+                    series.latency.count == 0) {
+                    continue;
+                }
+                lines += std::string("[LOCK] ") + m_name + " " +
+                         callerName(caller) + " c" + std::to_string(lane / 2) +
+                         (lane % 2 ? "/worker" : "/loop") + " n=" +
+                         std::to_string(std::max(series.wait.count +
+                                                     series.latency.count,
+                                                 series.hold.count));
+                if (series.wait.count != 0) {
+                    lines += " contended=" + std::to_string(series.contended) +
+                             " wait p50/p99/max=" +
+                             formatHistogram(series.wait);
+                }
+                if (series.latency.count != 0) {
+                    lines += " latency p50/p99/max=" +
+                             formatHistogram(series.latency);
+                }
+                if (series.hold.count != 0) {
+                    lines += " hold p50/p99/max=" +
+                             formatHistogram(series.hold);
+                }
+                lines += "\n";
+            }
+        }
+        return lines;
+    }
+
+    void LockProfiler::reset() { m_series = {}; }
+
+} // namespace e5
@@ -0,0 +1,125 @@
+/**
+ * @file LwipPoolMonitor.cpp
+ * @brief Implementation of the lwIP pool monitor.
+ *
+ * @author Goran
+ * @date 2025-09-23
+ * @ingroup AsyncTCPClient
+ */
+
+#include "LwipPoolMonitor.hpp"
+#include <Arduino.h>
+#include <algorithm>
+#include <lwip/memp.h>
+#include <lwip/stats.h>
+
+#if defined(E5_LWIP_STATS) && !(LWIP_STATS && MEMP_STATS)
+#error E5_LWIP_STATS needs a core built with LWIP_STATS and MEMP_STATS
+#endif
+
+namespace e5 {
+
+    namespace {
+
+#if LWIP_STATS && MEMP_STATS
+        constexpr memp_t MEMP_INDEX[] = {MEMP_PBUF_POOL, MEMP_PBUF,
+                                         MEMP_TCP_PCB, MEMP_TCP_SEG};
+        static_assert(std::size(MEMP_INDEX) ==
+                          static_cast<std::size_t>(LwipPool::COUNT),
+                      "one memp index per LwipPool");
+#endif
+
+    } // namespace
+
+    const char *poolName(const LwipPool pool) {
+        switch (pool) {
+        case LwipPool::PBUF_POOL:
+            return "pbuf_pool";
+        case LwipPool::PBUF:
+            return "pbuf";
+        case LwipPool::TCP_PCB:
+            return "tcp_pcb";
+        case LwipPool::TCP_SEG:
+            return "tcp_seg";
+        case LwipPool::COUNT:
+            break;
+        }
+        return "?";
+    }
+
+    bool LwipPoolMonitor::available() {
+#if LWIP_STATS && MEMP_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void LwipPoolMonitor::sample() {
+#if LWIP_STATS && MEMP_STATS
+        // Plain reads of counters lwIP updates under its own lock; a sample
+        // may be one allocation stale, which is fine for monitoring
+        for (std::size_t i = 0; i < std::size(MEMP_INDEX); ++i) {
+            const auto *stats = lwip_stats.memp[MEMP_INDEX[i]];
+            if (!stats) {
+                continue;
+            }
+            auto &pool = m_pools[i];
+            pool.used = stats->used;
+            pool.avail = stats->avail;
+            pool.max = stats->max;
+            pool.errors = stats->err;
+        }
+        m_min_free_pbufs = std::min(m_min_free_pbufs, freePbufs());
+        ++m_samples;
+#endif
+    }
+
+    bool LwipPoolMonitor::allowConnect() {
+        if (m_throttle_below == 0 || !available()) {
+            return true;
+        }
+        sample();
+        if (freePbufs() >= m_throttle_below) {
+            return true;
+        }
+        ++m_throttled;
+        DEBUGWIRE("[LwipPoolMonitor] %lu pbufs free, connect held back\n",
+                  static_cast<unsigned long>(freePbufs()));
+        return false;
+    }
+
+    void LwipPoolMonitor::cycleStarted() {
+        if (!available()) {
+            return;
+        }
+        sample();
+        m_cycle_start_used = pool(LwipPool::PBUF_POOL).used;
+        m_cycle_running = true;
+    }
+
+    void LwipPoolMonitor::cycleEnded() {
+        if (!available() || !m_cycle_running) {
+            return;
+        }
+        m_cycle_running = false;
+        sample();
+        const uint32_t used = pool(LwipPool::PBUF_POOL).used;
+        if (used > m_cycle_start_used) {
+            ++m_outstanding;
+            m_outstanding_max =
+                std::max(m_outstanding_max, used - m_cycle_start_used);
+        }
+        // A leak shows as an idle level that keeps creeping up
+        m_growth_run = used > m_last_end_used ? m_growth_run + 1 : 0;
+        m_last_end_used = used;
+        if (m_growth_run >= LEAK_CYCLES) {
+            ++m_leaks;
+            m_growth_run = 0;
+            DEBUGWIRE("[LwipPoolMonitor] pbuf pool grew for %u cycles, %lu "
+                      "in use\n",
+                      LEAK_CYCLES, static_cast<unsigned long>(used));
+        }
+    }
+
+} // namespace e5
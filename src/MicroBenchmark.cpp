@@ -0,0 +1,162 @@
+/**
+ * @file MicroBenchmark.cpp
+ * @brief Cycle-counter microbenchmarks of the application's hot paths.
+ *
+ * @author Goran
+ * @date 2025-09-28
+ * @ingroup AsyncTCPClient
+ */
+
+#include "MicroBenchmark.hpp"
+#include "LoopScheduler.hpp"
+#include "MessageBuffer.hpp"
+#include "PrintHandler.hpp"
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace e5 {
+
+    namespace {
+
+        // Typical quote: a little over QOTD_PARTIAL_CONSUMPTION_THRESHOLD
+        constexpr char QUOTE[] =
+            "Simplicity is prerequisite for reliability. "
+            "- Edsger Dijkstra, How do we tell truths that might hurt?";
+        constexpr char LINE_64[] =
+            "[INFO] 0123456789abcdef0123456789abcdef0123456789abcdef0123456\n";
+
+        // Keeps results the compiler could otherwise drop
+        volatile std::size_t sink = 0;
+
+        /**
+         * @brief Time from print() until the message has been emitted,
+         * inline or by the context's worker.
+         */
+        void printAndWait(const SerialPrinter &printer, const char *text) {
+            const uint32_t target = PrintHandler::printed() + 1;
+            printer.print(std::make_unique<std::string>(text));
+            while (static_cast<int32_t>(PrintHandler::printed() - target) < 0) {
+                tight_loop_contents();
+            }
+        }
+
+        void report(const SerialPrinter &printer,
+                    const std::vector<std::pair<const char *, BenchStats>> &results) {
+            for (const auto &[name, stats] : results) {
+                printer.print(std::make_unique<std::string>(
+                    MicroBenchmark::format(name, stats)));
+            }
+        }
+
+        void measureQuoteBuffer(const MicroBenchmark &bench,
+                                QuoteBuffer &buffer, const char *set_get,
+                                const char *is_complete,
+                                std::vector<std::pair<const char *, BenchStats>> &results) {
+            const std::string quote = QUOTE;
+            results.emplace_back(set_get, bench.measure([&] {
+                buffer.set(quote);
+                sink = buffer.get().size();
+            }));
+            results.emplace_back(is_complete, bench.measure([&] {
+                sink = buffer.isComplete();
+            }));
+            buffer.clear();
+        }
+
+        void measurePrints(const MicroBenchmark &bench,
+                           const SerialPrinter &printer, const char *empty,
+                           const char *line,
+                           std::vector<std::pair<const char *, BenchStats>> &results) {
+            PrintHandler::setOutputEnabled(false);
+            results.emplace_back(empty, bench.measure([&] {
+                printAndWait(printer, "");
+            }));
+            results.emplace_back(line, bench.measure([&] {
+                printAndWait(printer, LINE_64);
+            }));
+            PrintHandler::setOutputEnabled(true);
+        }
+
+    } // namespace
+
+    BenchStats MicroBenchmark::summarise(uint32_t (&cycles)[SAMPLES]) const {
+        const uint64_t hz = static_cast<uint64_t>(rp2040.f_cpu());
+        const auto to_ns = [&](const uint64_t count) {
+            return static_cast<uint32_t>(count * 1000000000ull / hz / m_batch);
+        };
+        std::sort(std::begin(cycles), std::end(cycles));
+        uint64_t total = 0;
+        for (const uint32_t sample : cycles) {
+            total += sample;
+        }
+        BenchStats stats;
+        stats.batch = m_batch;
+        stats.samples = SAMPLES;
+        stats.min_ns = to_ns(cycles[0]);
+        stats.median_ns = to_ns(cycles[SAMPLES / 2]);
+        stats.mean_ns = to_ns(total / SAMPLES);
+        stats.max_ns = to_ns(cycles[SAMPLES - 1]);
+        return stats;
+    }
+
+    std::string MicroBenchmark::format(const char *name,
+                                       const BenchStats &stats) {
+#ifdef ARDUINO_ARCH_RP2040
+        constexpr char platform[] = "rp2040";
+#else
+        constexpr char platform[] = "host";
+#endif
+        return std::string("[MICRO] {\"bench\":\"") + name +
+               "\",\"platform\":\"" + platform +
+               "\",\"batch\":" + std::to_string(stats.batch) +
+               ",\"samples\":" + std::to_string(stats.samples) +
+               ",\"min_ns\":" + std::to_string(stats.min_ns) +
+               ",\"median_ns\":" + std::to_string(stats.median_ns) +
+               ",\"mean_ns\":" + std::to_string(stats.mean_ns) +
+               ",\"max_ns\":" + std::to_string(stats.max_ns) + "}\n";
+    }
+
+    void runSameCoreBenchmarks(const SerialPrinter &printer,
+                               QuoteBuffer &buffer, const uint32_t batch) {
+        const MicroBenchmark bench(batch);
+        std::vector<std::pair<const char *, BenchStats>> results;
+
+        measureQuoteBuffer(bench, buffer, "quote_buffer.set_get.same_core",
+                           "quote_buffer.is_complete.same_core", results);
+        measurePrints(bench, printer, "serial_printer.print_empty.same_core",
+                      "serial_printer.print_64B.same_core", results);
+
+        // As many entries as the application's busiest scheduler
+        LoopScheduler scheduler;
+        for (uint8_t key = 0; key < 10; ++key) {
+            scheduler.setEntry(key, 1000 + key);
+        }
+        uint8_t key = 0;
+        results.emplace_back("loop_scheduler.time_to_run", bench.measure([&] {
+            sink = scheduler.timeToRun(key);
+            key = key == 9 ? 0 : key + 1;
+        }));
+
+        results.emplace_back("message_buffer.construct_64B", bench.measure([] {
+            const MessageBuffer message(LINE_64);
+            sink = message.size();
+        }));
+
+        report(printer, results);
+    }
+
+    void runCrossCoreBenchmarks(const SerialPrinter &printer,
+                                QuoteBuffer &buffer, const uint32_t batch) {
+        const MicroBenchmark bench(batch);
+        std::vector<std::pair<const char *, BenchStats>> results;
+
+        measureQuoteBuffer(bench, buffer, "quote_buffer.set_get.cross_core",
+                           "quote_buffer.is_complete.cross_core", results);
+        measurePrints(bench, printer, "serial_printer.print_empty.cross_core",
+                      "serial_printer.print_64B.cross_core", results);
+
+        report(printer, results);
+    }
+
+} // namespace e5
@@ -29,11 +29,22 @@ namespace e5 {
      * stored message to the serial output. The message and handler cleanup is
      * handled automatically by the EphemeralBridge's self-ownership mechanism.
      */
-    void  PrintHandler::onWork() {
-        if (!m_message->empty()) {
-            Serial1.print(m_message->c_str());
+    void  PrintHandler::onWork() { emit(*m_message); }
+
+    volatile uint32_t PrintHandler::s_printed = 0;
+    void (*PrintHandler::s_observer)(const std::string &, void *) = nullptr;
+    void *PrintHandler::s_observer_arg = nullptr;
+    volatile bool PrintHandler::s_output_enabled = true;
+
+    void PrintHandler::emit(const std::string &message) {
+        if (!message.empty() && s_output_enabled) {
+            Serial1.print(message.c_str());
             digitalWrite(LED_BUILTIN, LOW);
         }
+        ++s_printed;
+        if (s_observer) {
+            s_observer(message, s_observer_arg);
+        }
     }
 
     /**
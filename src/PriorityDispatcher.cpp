@@ -0,0 +1,131 @@
+/**
+ * @file PriorityDispatcher.cpp
+ * @brief Implementation of the priority-ordered work dispatcher.
+ *
+ * @author Goran
+ * @date 2025-09-08
+ * @ingroup AsyncTCPClient
+ */
+
+#include "PriorityDispatcher.hpp"
+#include "LockProfiler.hpp"
+#include <Arduino.h>
+
+namespace e5 {
+
+    bool PriorityDispatcher::post(PrioritizedWork &work,
+                                  const WorkPriority priority) {
+        auto &queue = m_queues[static_cast<std::size_t>(priority)];
+        bool queued = true;
+        {
+            LockTimer timer(m_ctx, LockCaller::ENQUEUE);
+            m_ctx.acquireLock();
+            timer.acquired();
+            if (work.m_queued) {
+                m_ctx.releaseLock();
+                return true;
+            }
+            if (queue.count == QUEUE_CAPACITY) {
+                ++queue.rejected;
+                queued = false;
+            } else {
+                queue.items[(queue.head + queue.count) % QUEUE_CAPACITY] =
+                    &work;
+                ++queue.count;
+                work.m_queued = true;
+                arm();
+            }
+            m_ctx.releaseLock();
+        }
+        if (queued) {
+            run();
+        }
+        return queued;
+    }
+
+    void PriorityDispatcher::arm() {
+        if (!m_armed) {
+            m_armed = true;
+            m_armed_us = time_us_32();
+        }
+    }
+
+    PrioritizedWork *PriorityDispatcher::pop(Queue &queue) {
+        PrioritizedWork *work = queue.items[queue.head];
+        queue.head = (queue.head + 1) % QUEUE_CAPACITY;
+        --queue.count;
+        work->m_queued = false;
+        return work;
+    }
+
+    void PriorityDispatcher::onWork() {
+        ++m_passes;
+        const uint32_t start = time_us_32();
+        auto *profiler = LockProfiler::of(m_ctx);
+        if (profiler && m_armed) {
+            // Waiting for the pass, not for the lock
+            profiler->recordLatency(LockCaller::WORKER_DISPATCH,
+                                    start - m_armed_us);
+        }
+        m_armed = false;
+        bool remaining = false;
+
+        for (std::size_t cls = 0; cls < WORK_PRIORITY_CLASSES; ++cls) {
+            auto &queue = m_queues[cls];
+            if (queue.count == 0) {
+                queue.skipped_passes = 0;
+                continue;
+            }
+
+            std::size_t budget = m_budget[cls];
+            if (cls > 0 && time_us_32() - start >= m_pass_budget_us) {
+                // Out of time: lower classes wait unless they are starving
+                if (queue.skipped_passes < m_starvation_limit) {
+                    ++queue.skipped_passes;
+                    remaining = true;
+                    continue;
+                }
+                budget = 1;
+            }
+            queue.skipped_passes = 0;
+
+            for (; budget > 0 && queue.count > 0; --budget) {
+                PrioritizedWork *work = pop(queue);
+                work->runPrioritized();
+                work->release();
+                ++queue.executed;
+            }
+            remaining = remaining || queue.count > 0;
+        }
+
+        if (profiler) {
+            profiler->recordHold(LockCaller::WORKER_DISPATCH,
+                                 time_us_32() - start);
+        }
+        if (remaining) {
+            // Yield to other workers on the context, then continue
+            arm();
+            run();
+        }
+    }
+
+    void PriorityDispatcher::setBudget(const WorkPriority priority,
+                                       const uint8_t items) {
+        m_budget[static_cast<std::size_t>(priority)] = items ? items : 1;
+    }
+
+    void PriorityDispatcher::setPassLimits(const uint32_t pass_budget_us,
+                                           const uint8_t starvation_limit) {
+        m_pass_budget_us = pass_budget_us;
+        m_starvation_limit = starvation_limit;
+    }
+
+    uint32_t PriorityDispatcher::executed(const WorkPriority priority) const {
+        return m_queues[static_cast<std::size_t>(priority)].executed;
+    }
+
+    uint32_t PriorityDispatcher::rejected(const WorkPriority priority) const {
+        return m_queues[static_cast<std::size_t>(priority)].rejected;
+    }
+
+} // namespace e5
@@ -0,0 +1,59 @@
+/**
+ * @file QotdBatchFinHandler.cpp
+ * @brief Implementation of the batch QOTD FIN handler.
+ *
+ * @author Goran
+ * @date 2025-09-25
+ * @ingroup AsyncTCPClient
+ */
+
+#include "QotdBatchFinHandler.hpp"
+#include "CycleTimeline.hpp"
+#include <Arduino.h>
+
+namespace e5 {
+
+    SliceResult QotdBatchFinHandler::onSlice(const ConnectionTable::Slot slot,
+                                             SliceBudget &budget) {
+        IoRxBuffer *rx_buffer = m_table.rxBuffer(slot);
+        if (m_table.muted(slot) || !m_parser.claim(slot)) {
+            // Lost an endpoint race: nothing to deliver
+            rx_buffer->reset();
+            m_table.close(slot);
+            m_table.markClosed(slot);
+            return SliceResult::DONE;
+        }
+        auto *timeline = m_table.timeline(slot);
+        if (timeline) {
+            timeline->mark(CycleStage::FIN); // First slice only
+        }
+
+        // ReSharper disable once CppDFANullDereference
+        while (const size_t available = rx_buffer->peekAvailable()) {
+            if (budget.exhausted()) {
+                DEBUGWIRE("[QOTD][BATCH][FIN] yielding, %zu bytes pending\n",
+                          available);
+                return SliceResult::MORE_PENDING;
+            }
+            m_parser.feed(rx_buffer->peekBuffer(), available);
+            rx_buffer->peekConsume(available);
+            m_table.addRxBytes(slot, available);
+            if (timeline) {
+                timeline->addDrained(available);
+            }
+            budget.consume(available);
+        }
+
+        m_parser.finish();
+        if (timeline) {
+            timeline->mark(CycleStage::COMPLETE);
+        }
+        rx_buffer->reset();
+        m_table.close(slot);
+        m_table.markClosed(slot);
+        DEBUGWIRE("[QOTD][BATCH] batch complete, %lu records\n",
+                  static_cast<unsigned long>(m_parser.records()));
+        return SliceResult::DONE;
+    }
+
+} // namespace e5
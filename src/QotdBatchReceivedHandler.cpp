@@ -0,0 +1,41 @@
+/**
+ * @file QotdBatchReceivedHandler.cpp
+ * @brief Implementation of the batch QOTD data received handler.
+ *
+ * @author Goran
+ * @date 2025-09-25
+ * @ingroup AsyncTCPClient
+ */
+
+#include "QotdBatchReceivedHandler.hpp"
+#include "CycleTimeline.hpp"
+#include <Arduino.h>
+
+namespace e5 {
+
+    /**
+     * @brief Feeds all received data to the record parser.
+     *
+     * Data on a muted connection, or on one that does not own the parser,
+     * is consumed and dropped.
+     */
+    void QotdBatchReceivedHandler::onWork(const ConnectionTable::Slot slot) {
+        IoRxBuffer *rx_buffer = m_table.rxBuffer(slot);
+        const bool deliver = !m_table.muted(slot) && m_parser.claim(slot);
+        auto *timeline = m_table.timeline(slot);
+        // ReSharper disable once CppDFANullDereference
+        while (const size_t available = rx_buffer->peekAvailable()) {
+            m_table.addRxBytes(slot, available);
+            if (deliver) {
+                m_parser.feed(rx_buffer->peekBuffer(), available);
+                if (timeline) {
+                    timeline->addChunk(available);
+                }
+            }
+            rx_buffer->peekConsume(available);
+        }
+        DEBUGWIRE("[QOTD][BATCH] %lu records so far\n",
+                  static_cast<unsigned long>(m_parser.records()));
+    }
+
+} // namespace e5
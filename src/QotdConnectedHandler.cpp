@@ -17,6 +17,7 @@
  */
 
 #include "QotdConnectedHandler.hpp"
+#include "CycleTimeline.hpp"
 #include <Arduino.h>
 
 namespace e5 {
@@ -33,11 +34,22 @@ namespace e5 {
      * initialized, ensuring proper core affinity for non-thread-safe operations
      * like printing.
      */
-    void QotdConnectedHandler::onWork() {
+    void QotdConnectedHandler::onWork(const ConnectionTable::Slot slot) {
+        // Before markConnected(), so the loop sees the owner with the connect
+        if (m_claim && !m_table.muted(slot)) {
+            m_claim->claim(slot);
+        }
+        m_table.markConnected(slot);
+        if (auto *timeline = m_table.timeline(slot)) {
+            timeline->mark(CycleStage::CONNECTED);
+        }
+        if (!m_notify) {
+            return;
+        }
 
         auto notify_connect = std::make_unique<std::string>(
             std::string("[INFO] Getting a quote from: ")
-            + m_io.remoteIP().toString().c_str()
+            + m_table.client(slot).remoteIP().toString().c_str()
             + "\n");
 
         m_serial_printer.print(std::move(notify_connect));
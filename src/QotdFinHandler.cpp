@@ -15,56 +15,95 @@
  */
 
 #include "QotdFinHandler.hpp"
+#include "CycleTimeline.hpp"
 #include <Arduino.h>
 #include "QotdConfig.hpp"
 
 namespace e5 {
 
     /**
-     * @brief Handles the FIN event.
+     * @brief Handles one slice of the FIN event.
      *
-     * This method is called when a FIN packet is received.
+     * This method is called when a FIN packet is received, and again for
+     * every slice while data remains. Each slice drains up to the budget in
+     * QOTD_PARTIAL_CONSUMPTION_THRESHOLD sized chunks; data already appended
+     * to the QuoteBuffer has been consumed from the IoRxBuffer, so the next
+     * slice continues where this one stopped.
      *
      * The method is executed on the core where the ContextManager was
      * initialized, ensuring proper core affinity for non-thread-safe
      * operations.
      */
-    void QotdFinHandler::onWork() {
-        auto available = m_rx_buffer->peekAvailable();
+    SliceResult QotdFinHandler::onSlice(const ConnectionTable::Slot slot,
+                                        SliceBudget &budget) {
+        IoRxBuffer *rx_buffer = m_table.rxBuffer(slot);
+        auto available = rx_buffer->peekAvailable();
+        if (m_table.muted(slot) || (m_claim && !m_claim->claim(slot))) {
+            // Lost an endpoint race: nothing to deliver
+            rx_buffer->reset();
+            m_table.close(slot);
+            m_table.markClosed(slot);
+            return SliceResult::DONE;
+        }
+        auto *timeline = m_table.timeline(slot);
+        if (timeline) {
+            timeline->mark(CycleStage::FIN); // First slice only
+        }
         if (available == 0) {
             // FIN with no data means all data was consumed by receive callback
             // Quote is complete, just mark it and stop connection.
             m_quote_buffer.setComplete();
+            if (timeline) {
+                timeline->mark(CycleStage::COMPLETE);
+            }
             // Reset the buffer to free any pbuf resources
-            m_rx_buffer->reset();
-            m_io.shutdown();
+            rx_buffer->reset();
+            m_table.close(slot);
+            m_table.markClosed(slot);
             DEBUGWIRE(
                 "[QOTD][FIN] no data, quote complete, connection stopped.");
-            return;
+            return SliceResult::DONE;
         }
 
-        // drain any remaining data
+        // drain remaining data within the slice budget
         DEBUGWIRE("[QOTD][FIN] draining %zu bytes\n", available);
         while (available > 0) {
+            if (budget.exhausted()) {
+                DEBUGWIRE("[QOTD][FIN] yielding, %zu bytes pending\n",
+                          available);
+                return SliceResult::MORE_PENDING;
+            }
             const size_t consume_size =
                 std::min(available, QOTD_PARTIAL_CONSUMPTION_THRESHOLD);
-            const char *peek_buffer = m_rx_buffer->peekBuffer();
+            const char *peek_buffer = rx_buffer->peekBuffer();
             // Create string from the chunk to be consumed
             std::string quote_chunk(peek_buffer, consume_size);
 
             m_quote_buffer.append(quote_chunk);
             // ReSharper disable once CppDFANullDereference
-            m_rx_buffer->peekConsume(consume_size);
-            available = available - consume_size;
+            rx_buffer->peekConsume(consume_size);
+            m_table.addRxBytes(slot, consume_size);
+            if (timeline) {
+                timeline->addDrained(consume_size);
+            }
+            budget.consume(consume_size);
+            // Segments are separate pbufs; move on to the next one
+            available = rx_buffer->peekAvailable();
         }
 
         // Quote is complete after draining all remaining data
         m_quote_buffer.setComplete();
+        if (timeline) {
+            timeline->mark(CycleStage::COMPLETE);
+        }
         // Reset the buffer. Data drained.
         // ReSharper disable once CppDFANullDereference
-        m_rx_buffer->reset();
-        m_io.shutdown();
-        DEBUGWIRE("[QOTD] drained, quote complete, connection stopped: %d\n", m_io.status());
+        rx_buffer->reset();
+        m_table.close(slot);
+        m_table.markClosed(slot);
+        DEBUGWIRE("[QOTD] drained, quote complete, connection stopped: %d\n",
+                  m_table.client(slot).status());
+        return SliceResult::DONE;
     }
 
 } // namespace e5
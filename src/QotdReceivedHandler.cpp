@@ -16,6 +16,7 @@
  */
 
 #include "QotdReceivedHandler.hpp"
+#include "CycleTimeline.hpp"
 #include <Arduino.h>
 #include "QotdConfig.hpp"
 
@@ -29,46 +30,70 @@ namespace e5 {
      * processing; the remainder is drained on FIN.
      *
      * Specifically, this handler:
-     * 1. Resets the quote buffer and completion flag to start a new quote
-     * 2. Peeks up to QOTD_PARTIAL_CONSUMPTION_THRESHOLD bytes, copies them
-     *    into the buffer via QuoteBuffer::set(), and
+     * 1. On the first chunk of a cycle, resets the quote buffer and
+     *    completion flag to start a new quote
+     * 2. Peeks up to QOTD_PARTIAL_CONSUMPTION_THRESHOLD bytes and copies
+     *    them into the buffer via QuoteBuffer::set() on the first chunk, or
+     *    QuoteBuffer::append() on later segments that arrive before FIN
      * 3. Consumes exactly the processed bytes via IoRxBuffer::peekConsume()
      * 4. Defers draining of any remaining bytes to QotdFinHandler::onWork()
      *
      * Notes:
      * - The partial consumption threshold is configured by
      *   QOTD_PARTIAL_CONSUMPTION_THRESHOLD (see QotdConfig.hpp / main.cpp)
-     * - This handler overwrites any previous content; no append/looping occurs
-     *   here. Continuation is handled exclusively by the FIN handler.
+     * - The first chunk is tracked per connection in the ConnectionTable
+     *   (rxStarted()), cleared by ConnectionManager before each connect, so
+     *   a segmented quote is never overwritten by its own later segments.
      * - Executed on the context/core associated with this handler to maintain
      *   proper affinity.
      */
-    void QotdReceivedHandler::onWork() {
+    void QotdReceivedHandler::onWork(const ConnectionTable::Slot slot) {
+        IoRxBuffer *rx_buffer = m_table.rxBuffer(slot);
         // ReSharper disable once CppDFANullDereference
-        const size_t available = m_rx_buffer->peekAvailable();
+        const size_t available = rx_buffer->peekAvailable();
         if (available == 0) {
             return;
         }
+        // Data may arrive before the connected handler has run
+        if (m_table.muted(slot) || (m_claim && !m_claim->claim(slot))) {
+            // Lost an endpoint race: drop the data, the connection is closing
+            rx_buffer->peekConsume(available);
+            m_table.addRxBytes(slot, available);
+            return;
+        }
 
-        // A new quote arriving: reset buffer and completion flag.
-        m_quote_buffer.resetBuffer();
+        // The first chunk of a cycle starts a new quote: reset buffer and
+        // completion flag. Later segments before FIN are appended.
+        const bool first_chunk = !m_table.rxStarted(slot);
+        if (first_chunk) {
+            m_quote_buffer.resetBuffer();
+            m_table.setRxStarted(slot, true);
+        }
 
         // Consume up to threshold, or all available data if less
         const size_t consume_size = std::min(available, QOTD_PARTIAL_CONSUMPTION_THRESHOLD);
 
 
         // ReSharper disable once CppDFANullDereference
-        const char *peek_buffer = m_rx_buffer->peekBuffer();
+        const char *peek_buffer = rx_buffer->peekBuffer();
         // Create string from the chunk to be consumed
         const std::string quote_chunk(peek_buffer, consume_size);
 
-        // Always set the first chunk; remaining data will be drained on FIN
-        m_quote_buffer.set(quote_chunk);
+        // Set the first chunk, append later ones; the rest is drained on FIN
+        if (first_chunk) {
+            m_quote_buffer.set(quote_chunk);
+        } else {
+            m_quote_buffer.append(quote_chunk);
+        }
         DEBUGWIRE("[QOTD] Consumed %zu/%zu bytes\n", consume_size, available);
         // ReSharper disable once CppDFANullDereference
-        m_rx_buffer->peekConsume(consume_size);
+        rx_buffer->peekConsume(consume_size);
+        m_table.addRxBytes(slot, consume_size);
+        if (auto *timeline = m_table.timeline(slot)) {
+            timeline->addChunk(consume_size);
+        }
 
-        DEBUGWIRE("[QOTD] First chunk (%zu bytes): '%.*s...'\n",
+        DEBUGWIRE("[QOTD] Chunk (%zu bytes): '%.*s...'\n",
                  consume_size,
                  static_cast<int>(std::min(quote_chunk.size(), static_cast<size_t>(20))),
                  quote_chunk.c_str());
@@ -0,0 +1,181 @@
+/**
+ * @file QotdSession.cpp
+ * @brief Implementation of QOTD sessions and the session pool.
+ *
+ * @author Goran
+ * @date 2025-09-19
+ * @ingroup AsyncTCPClient
+ */
+
+#include "QotdSession.hpp"
+#include <algorithm>
+
+namespace e5 {
+
+    QotdSession::QotdSession(ConnectionTable &table,
+                             const AsyncCtx &quote_ctx,
+                             SerialPrinter &printer)
+        : m_quote(quote_ctx),
+          m_connected_handler(table, printer, m_quote),
+          m_received_handler(table, m_quote), m_fin_handler(table, m_quote),
+          m_manager(table, m_client, IPAddress(), 0,
+                    ConnectionMode::PER_CYCLE) {
+        m_connected_handler.setNotify(false);
+    }
+
+    bool QotdSession::begin(const AsyncCtx &net_ctx, const int client_id,
+                            TcpErrorHandler &error_handler) {
+        m_client.setSyncAccessor(
+            std::make_unique<TcpClientSyncAccessor>(net_ctx, m_client));
+        m_client.setClientId(client_id);
+
+        auto error = error_handler.bridge(net_ctx, m_client);
+        if (!error) {
+            return false;
+        }
+        m_client.setOnErrorCallback(std::move(error));
+        m_client.setOnConnectedCallback(
+            m_connected_handler.bridge(net_ctx, m_client));
+        m_client.setOnReceivedCallback(
+            m_received_handler.bridge(net_ctx, m_client));
+        m_client.setOnFinCallback(m_fin_handler.bridge(net_ctx, m_client));
+        m_manager.start();
+        return true;
+    }
+
+    void QotdSession::setDispatcher(PriorityDispatcher *dispatcher) {
+        m_connected_handler.setDispatcher(dispatcher);
+        m_received_handler.setDispatcher(dispatcher);
+        m_fin_handler.setDispatcher(dispatcher);
+    }
+
+    bool QotdSession::start(const IPAddress &address, const uint16_t port) {
+        if (m_running) {
+            return false;
+        }
+        m_manager.setEndpoint(address, port);
+        if (!m_manager.requestCycle()) {
+            return false;
+        }
+        m_running = true;
+        m_started_us = time_us_32();
+        ++m_cycles;
+        return true;
+    }
+
+    QotdSession::Outcome QotdSession::poll(uint32_t &latency_us) {
+        m_manager.poll();
+        const bool completed =
+            m_manager.completedCycles() != m_seen_completed;
+        const bool failed = m_manager.failedCycles() != m_seen_failed;
+        m_seen_completed = m_manager.completedCycles();
+        m_seen_failed = m_manager.failedCycles();
+        if (!m_running) {
+            return Outcome::NONE;
+        }
+        if (completed) {
+            m_running = false;
+            ++m_completed;
+            latency_us = time_us_32() - m_started_us;
+            m_latency_max_us = std::max(m_latency_max_us, latency_us);
+            return Outcome::COMPLETED;
+        }
+        if (failed) {
+            m_running = false;
+            ++m_failed;
+            return Outcome::FAILED;
+        }
+        return Outcome::NONE;
+    }
+
+    std::size_t QotdSessionPool::begin(const std::size_t count,
+                                       const AsyncCtx &net_ctx,
+                                       const int first_client_id,
+                                       TcpErrorHandler &error_handler) {
+        while (m_count < std::min(count, MAX_SESSIONS)) {
+            auto session = std::make_unique<QotdSession>(m_table, m_quote_ctx,
+                                                         m_printer);
+            if (!session->begin(net_ctx,
+                                first_client_id + static_cast<int>(m_count),
+                                error_handler)) {
+                break;
+            }
+            m_sessions[m_count++] = std::move(session);
+        }
+        resetPhase();
+        return m_count;
+    }
+
+    void QotdSessionPool::setDispatcher(PriorityDispatcher *dispatcher) {
+        for (std::size_t i = 0; i < m_count; ++i) {
+            m_sessions[i]->setDispatcher(dispatcher);
+        }
+    }
+
+    void QotdSessionPool::setRate(const uint32_t cycles_per_second) {
+        m_interval_us = cycles_per_second ? 1000000 / cycles_per_second : 0;
+        m_next_us = time_us_32();
+    }
+
+    QotdSession *QotdSessionPool::nextIdle() {
+        for (std::size_t n = 0; n < m_count; ++n) {
+            auto &session = *m_sessions[(m_next + n) % m_count];
+            if (session.idle()) {
+                m_next = (m_next + n + 1) % m_count;
+                return &session;
+            }
+        }
+        return nullptr;
+    }
+
+    void QotdSessionPool::poll() {
+        for (std::size_t i = 0; i < m_count; ++i) {
+            uint32_t latency_us = 0;
+            switch (m_sessions[i]->poll(latency_us)) {
+            case QotdSession::Outcome::COMPLETED:
+                ++m_completed;
+                m_latency.add(latency_us);
+                break;
+            case QotdSession::Outcome::FAILED:
+                ++m_failed;
+                break;
+            case QotdSession::Outcome::NONE:
+                break;
+            }
+        }
+
+        const uint32_t now = time_us_32();
+        if (m_interval_us == 0 || m_count == 0 ||
+            static_cast<int32_t>(now - m_next_us) < 0) {
+            return;
+        }
+        if (now - m_next_us > 4 * m_interval_us) {
+            // Too far behind; restart the schedule rather than burst
+            m_next_us = now;
+        }
+        m_next_us += m_interval_us;
+
+        EndpointSelector::Index best;
+        QotdSession *session = nextIdle();
+        if (!session || m_endpoints.best(&best, 1) == 0) {
+            ++m_missed;
+            return;
+        }
+        const auto &endpoint = m_endpoints.endpoint(best);
+        if (session->start(endpoint.address, endpoint.port)) {
+            ++m_started;
+        } else {
+            ++m_missed;
+        }
+    }
+
+    void QotdSessionPool::resetPhase() {
+        m_latency.reset();
+        m_phase_started_us = time_us_32();
+        m_started = 0;
+        m_completed = 0;
+        m_failed = 0;
+        m_missed = 0;
+    }
+
+} // namespace e5
@@ -12,6 +12,7 @@
  */
 
 #include "QuoteBuffer.hpp"
+#include "LockProfiler.hpp"
 #include <Arduino.h>
 
 namespace e5 {
@@ -21,19 +22,52 @@ namespace e5 {
      *
      * @param ctx Shared context manager for synchronized execution
      */
-    QuoteBuffer::QuoteBuffer(const AsyncCtx &ctx) : SyncBridge(ctx) {}
+    QuoteBuffer::QuoteBuffer(const AsyncCtx &ctx)
+        : SyncBridge(ctx), m_dispatch(ctx) {}
+
+    /**
+     * @brief Runs a buffer operation inline or through the bridge
+     *
+     * On the context core there is nothing to marshal, so the operation is
+     * executed directly under the context lock. The reentrancy guard in
+     * InlineDispatch sends nested calls through the bridge.
+     *
+     * @param payload Buffer operation instruction
+     * @return PICO_OK on success, or error code on failure
+     */
+    uint32_t QuoteBuffer::submit(SyncPayloadPtr payload) {
+        if (m_dispatch.tryEnter()) {
+            const auto result = apply(payload);
+            m_dispatch.leave();
+            return result;
+        }
+        m_dispatch.countQueued();
+        LockTimer timer(m_dispatch.context(), LockCaller::BRIDGE_EXECUTE);
+        return execute(std::move(payload));
+    }
 
     /**
      * @brief Executes buffer operations in a thread-safe manner
      *
      * This method is called by the SyncBridge to perform modifications to the
      * buffer. It ensures that all modifications happen on the core where
-     * the ContextManager was initialized, providing thread safety.
+     * the ContextManager was initialized, providing thread safety. The time
+     * spent applying the operation is recorded as BRIDGE_EXECUTE hold.
      *
      * @param payload Buffer operation instruction
      * @return PICO_OK on success, or error code on failure
      */
     uint32_t QuoteBuffer::onExecute(const SyncPayloadPtr payload) {
+        const uint32_t start = time_us_32();
+        const auto result = apply(payload);
+        if (auto *profiler = LockProfiler::of(m_dispatch.context())) {
+            profiler->recordHold(LockCaller::BRIDGE_EXECUTE,
+                                 time_us_32() - start);
+        }
+        return result;
+    }
+
+    uint32_t QuoteBuffer::apply(const SyncPayloadPtr &payload) {
 
         switch (const auto *buffer_payload =
                     static_cast<BufferPayload *>(payload.get()); // NOLINT
@@ -84,7 +118,7 @@ namespace e5 {
         auto payload = std::make_unique<BufferPayload>();
         payload->op = BufferPayload::SET;
         payload->data = data;
-        if (const auto result = execute(std::move(payload));
+        if (const auto result = submit(std::move(payload));
             result != PICO_OK) {
             DEBUGV("[c%d][%llu][ERROR] QuoteBuffer::set() returned error "
                    "%d.\n",
@@ -107,7 +141,7 @@ namespace e5 {
         payload->op = BufferPayload::GET;
         payload->result_ptr = &result_string;
 
-        if (const auto result = execute(std::move(payload));
+        if (const auto result = submit(std::move(payload));
             result != PICO_OK) {
             DEBUGV("[c%d][%llu][ERROR] QuoteBuffer::get() returned error "
                    "%d.\n",
@@ -130,7 +164,7 @@ namespace e5 {
         auto payload = std::make_unique<BufferPayload>();
         payload->op = BufferPayload::APPEND;
         payload->data = data;
-        if (const auto result = execute(std::move(payload));
+        if (const auto result = submit(std::move(payload));
             result != PICO_OK) {
             DEBUGV("[c%d][%llu][ERROR] QuoteBuffer::append() returned "
                    "error %d.\n",
@@ -152,7 +186,7 @@ namespace e5 {
         auto payload = std::make_unique<BufferPayload>();
         payload->op = BufferPayload::GET;
         payload->result_ptr = &result_string;
-        if (const auto result = execute(std::move(payload));
+        if (const auto result = submit(std::move(payload));
             result != PICO_OK) {
             DEBUGV(
                 "[c%d][%llu][ERROR] QuoteBuffer::empty() returned error %d.\n",
@@ -172,7 +206,7 @@ namespace e5 {
         auto payload = std::make_unique<BufferPayload>();
         payload->op = BufferPayload::SET;
         payload->data = "";
-        if (const auto result = execute(std::move(payload));
+        if (const auto result = submit(std::move(payload));
             result != PICO_OK) {
             DEBUGV(
                 "[c%d][%llu][ERROR] QuoteBuffer::clear() returned error %d.\n",
@@ -189,7 +223,7 @@ namespace e5 {
     void QuoteBuffer::setComplete() {
         auto payload = std::make_unique<BufferPayload>();
         payload->op = BufferPayload::SET_COMPLETE;
-        if (const auto result = execute(std::move(payload));
+        if (const auto result = submit(std::move(payload));
             result != PICO_OK) {
             DEBUGV("[c%d][%llu][ERROR] QuoteBuffer::setComplete() returned "
                    "error %d.\n",
@@ -208,7 +242,7 @@ namespace e5 {
         auto payload = std::make_unique<BufferPayload>();
         payload->op = BufferPayload::IS_COMPLETE;
         payload->result_ptr = &result_string;
-        if (const auto result = execute(std::move(payload));
+        if (const auto result = submit(std::move(payload));
             result != PICO_OK) {
             DEBUGV("[c%d][%llu][ERROR] QuoteBuffer::isComplete() returned "
                    "error %d.\n",
@@ -227,7 +261,7 @@ namespace e5 {
     void QuoteBuffer::resetBuffer() {
         auto payload = std::make_unique<BufferPayload>();
         payload->op = BufferPayload::RESET_COMPLETE;
-        if (const auto result = execute(std::move(payload));
+        if (const auto result = submit(std::move(payload));
             result != PICO_OK) {
             DEBUGV("[c%d][%llu][ERROR] QuoteBuffer::resetBuffer() returned "
                    "error %d.\n",
@@ -0,0 +1,41 @@
+/**
+ * @file QuoteHistory.cpp
+ * @brief Implementation of the quote history ring.
+ *
+ * @author Goran
+ * @date 2025-09-25
+ * @ingroup AsyncTCPClient
+ */
+
+#include "QuoteHistory.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace e5 {
+
+    bool QuoteHistory::push(const char *text, const std::size_t length) {
+        const uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == CAPACITY) {
+            ++m_dropped;
+            return false;
+        }
+        auto &entry = m_ring[head % CAPACITY];
+        entry.length =
+            static_cast<uint16_t>(std::min(length, MAX_QUOTE_BYTES));
+        std::memcpy(entry.text, text, entry.length);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool QuoteHistory::pop(std::string &out) {
+        const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        const auto &entry = m_ring[tail % CAPACITY];
+        out.assign(entry.text, entry.length);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+} // namespace e5
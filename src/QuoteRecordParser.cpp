@@ -0,0 +1,83 @@
+/**
+ * @file QuoteRecordParser.cpp
+ * @brief Implementation of the batch QOTD record parser.
+ *
+ * @author Goran
+ * @date 2025-09-25
+ * @ingroup AsyncTCPClient
+ */
+
+#include "QuoteRecordParser.hpp"
+#include <Arduino.h>
+#include <algorithm>
+#include <cstring>
+
+namespace e5 {
+
+    bool QuoteRecordParser::claim(const ConnectionTable::Slot slot) {
+        if (m_owner == ConnectionTable::NO_SLOT) {
+            m_owner = slot;
+        }
+        return m_owner == slot;
+    }
+
+    void QuoteRecordParser::complete() {
+        // A zero-length record carries no quote
+        if (m_length > 0) {
+            m_history.push(m_record, std::min<std::size_t>(
+                                         m_received,
+                                         QuoteHistory::MAX_QUOTE_BYTES));
+            ++m_records;
+            m_truncated += m_length > QuoteHistory::MAX_QUOTE_BYTES ? 1 : 0;
+        }
+        m_header_bytes = 0;
+        m_length = 0;
+        m_received = 0;
+    }
+
+    void QuoteRecordParser::feed(const char *data, const std::size_t size) {
+        std::size_t offset = 0;
+        while (offset < size) {
+            if (m_header_bytes < HEADER_BYTES) {
+                m_length = static_cast<uint16_t>(
+                    m_length << 8 | static_cast<uint8_t>(data[offset++]));
+                ++m_header_bytes;
+                ++m_framing_bytes;
+                if (m_header_bytes == HEADER_BYTES && m_length == 0) {
+                    complete();
+                }
+                continue;
+            }
+            const std::size_t take =
+                std::min<std::size_t>(size - offset, m_length - m_received);
+            if (m_received < QuoteHistory::MAX_QUOTE_BYTES) {
+                std::memcpy(m_record + m_received, data + offset,
+                            std::min(take, QuoteHistory::MAX_QUOTE_BYTES -
+                                               m_received));
+            }
+            m_received = static_cast<uint16_t>(m_received + take);
+            m_payload_bytes += take;
+            offset += take;
+            if (m_received == m_length) {
+                complete();
+            }
+        }
+    }
+
+    void QuoteRecordParser::finish() {
+        if (m_header_bytes > 0) {
+            ++m_incomplete;
+            DEBUGWIRE("[QuoteRecordParser] batch ended mid-record (%u/%u)\n",
+                      m_received, m_length);
+        }
+        reset();
+    }
+
+    void QuoteRecordParser::reset() {
+        m_header_bytes = 0;
+        m_length = 0;
+        m_received = 0;
+        m_owner = ConnectionTable::NO_SLOT;
+    }
+
+} // namespace e5
@@ -0,0 +1,37 @@
+/**
+ * @file ResumableHandler.cpp
+ * @brief Implementation of the budgeted, resumable connection handler.
+ *
+ * @author Goran
+ * @date 2025-09-09
+ * @ingroup AsyncTCPClient
+ */
+
+#include "ResumableHandler.hpp"
+#include <algorithm>
+
+namespace e5 {
+
+    void ResumableHandler::onWork(const ConnectionTable::Slot slot) {
+        const uint32_t start = time_us_32();
+        SliceBudget budget{m_budget_bytes, start + m_budget_us};
+
+        const auto result = onSlice(slot, budget);
+        if (result == SliceResult::MORE_PENDING) {
+            m_more_pending |= 1u << slot;
+            ++m_yields;
+        } else {
+            m_more_pending &= ~(1u << slot);
+        }
+
+        ++m_slices;
+        m_max_slice_us = std::max(m_max_slice_us, time_us_32() - start);
+    }
+
+    void ResumableHandler::setBudget(const std::size_t bytes,
+                                     const uint32_t us) {
+        m_budget_bytes = bytes ? bytes : 1;
+        m_budget_us = us;
+    }
+
+} // namespace e5
@@ -8,17 +8,58 @@
 
 #include "SerialPrinter.hpp"
 #include "ContextManager.hpp"
+#include "LockProfiler.hpp"
 #include "MessageBuffer.hpp"
 #include "PrintHandler.hpp"
 #include "pins_arduino.h"
 namespace e5 {
 
+    namespace {
+
+        // One-shot print queued on a PriorityDispatcher; frees itself once
+        // the dispatcher has run it.
+        class PrintTask final : public PrioritizedWork {
+                std::unique_ptr<std::string> m_message;
+
+            public:
+                explicit PrintTask(std::unique_ptr<std::string> message)
+                    : m_message(std::move(message)) {}
+
+                void runPrioritized() override {
+                    PrintHandler::emit(*m_message);
+                }
+
+                void release() override { delete this; }
+
+                std::unique_ptr<std::string> takeMessage() {
+                    return std::move(m_message);
+                }
+        };
+
+    } // namespace
+
     // Constructor implementation
-    SerialPrinter::SerialPrinter(const AsyncCtx &ctx) : m_ctx(ctx) {}
+    SerialPrinter::SerialPrinter(const AsyncCtx &ctx)
+        : m_ctx(ctx), m_dispatch(ctx) {}
 
     // Print method implementation for std::string
     uint32_t SerialPrinter::print(std::unique_ptr<std::string> message) const {
         digitalWrite(LED_BUILTIN, HIGH);
+        if (m_dispatch.tryEnter()) {
+            PrintHandler::emit(*message);
+            m_dispatch.leave();
+            return PICO_OK;
+        }
+        m_dispatch.countQueued();
+        if (auto *dispatcher = m_priority_dispatcher.load()) {
+            auto task = std::make_unique<PrintTask>(std::move(message));
+            if (dispatcher->post(*task, WorkPriority::BACKGROUND)) {
+                task.release(); // NOLINT: owned by the dispatcher until run
+                return PICO_OK;
+            }
+            message = task->takeMessage();
+        }
+        LockTimer timer(m_ctx, LockCaller::ENQUEUE);
         PrintHandler::create(m_ctx, std::move(message));
         return PICO_OK; // Return success code
     }
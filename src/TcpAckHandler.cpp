@@ -1,15 +1,39 @@
 // filepath: /home/goran/CLionProjects/pico-sdk-tests/src/TcpAckHandler.cpp
 #include "TcpAckHandler.hpp"
+#include "CycleTimeline.hpp"
+#include "WriteDeadline.hpp"
 #include <Arduino.h>
+#include <algorithm>
 
 namespace e5 {
 
-void TcpAckHandler::onWork() {
-    // Notify writer about ACK if configured
-    if (auto *writer = m_io.getWriter()) {
-        writer->onAckReceived(m_len);
+void TcpAckHandler::onWork(const ConnectionTable::Slot slot) {
+    const uint32_t arrived_us = m_table.pendingAckSince(slot);
+    const uint32_t acked = m_table.takePendingAck(slot);
+    auto &io = m_table.client(slot);
+    // Notify writer about ACK if configured. ACKs coalesced while the bridge
+    // was pending are delivered in uint16_t sized steps.
+    if (auto *writer = io.getWriter()) {
+        for (uint32_t remaining = acked; remaining > 0;) {
+            const auto step =
+                static_cast<uint16_t>(std::min<uint32_t>(remaining, UINT16_MAX));
+            writer->onAckReceived(step);
+            remaining -= step;
+        }
     }
-    DEBUGWIRE("[TcpAckHandler][:i%d] ACK len=%u handled\n", m_io.getClientId(), static_cast<unsigned>(m_len));
+    if (auto *deadline = m_table.writeDeadline(slot); deadline && acked > 0) {
+        deadline->onAck(acked);
+    }
+    if (auto *timeline = m_table.timeline(slot); timeline && acked > 0) {
+        timeline->echoAcked(acked);
+    }
+    if (acked > 0) {
+        const uint32_t latency_us = time_us_32() - arrived_us;
+        ++m_latency_count;
+        m_latency_total_us += latency_us;
+        m_latency_max_us = std::max(m_latency_max_us, latency_us);
+    }
+    DEBUGWIRE("[TcpAckHandler][:i%d] ACK len=%u handled\n", io.getClientId(), static_cast<unsigned>(acked));
 }
 
 } // namespace e5
@@ -7,17 +7,23 @@
  */
 
 #include "TcpErrorHandler.hpp"
+#include "WriteDeadline.hpp"
 #include <Arduino.h>
 
 namespace e5 {
 
-    void TcpErrorHandler::onWork() {
+    void TcpErrorHandler::onWork(const ConnectionTable::Slot slot) {
+        auto &io = m_table.client(slot);
+        const err_t error = m_table.lastError(slot);
         // Notify writer about the error if configured
-        if (auto *writer = m_io.getWriter()) {
-            writer->onError(m_error);
+        if (auto *writer = io.getWriter()) {
+            writer->onError(error);
+        }
+        if (auto *deadline = m_table.writeDeadline(slot)) {
+            deadline->reset();
         }
         DEBUGWIRE("[TcpErrorHandler][:i%d] Error %d handled\n",
-                  m_io.getClientId(), static_cast<int>(m_error));
+                  io.getClientId(), static_cast<int>(error));
     }
 
 } // namespace e5
@@ -2,9 +2,15 @@
 
 namespace e5 {
 
-void TcpPollHandler::onWork() {
-    if (auto *writer = m_io.getWriter()) {
+void TcpPollHandler::onWork(const ConnectionTable::Slot slot) {
+    ++m_wakeups;
+    if (m_table.writeDeadline(slot)) {
+        // Timeouts are detected by the connection's own deadline timer
+        return;
+    }
+    if (auto *writer = m_table.client(slot).getWriter()) {
         if (writer->hasTimedOut()) {
+            m_table.countTimeout(slot);
             writer->onWriteTimeout();
         }
     }
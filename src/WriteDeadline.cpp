@@ -0,0 +1,117 @@
+/**
+ * @file WriteDeadline.cpp
+ * @brief Implementation of the per-connection write timeout.
+ *
+ * @author Goran
+ * @date 2025-09-15
+ * @ingroup AsyncTCPClient
+ */
+
+#include "WriteDeadline.hpp"
+#include "EphemeralBridge.hpp"
+#include <Arduino.h>
+#include <algorithm>
+#include <memory>
+
+namespace e5 {
+
+    namespace {
+
+        // One-shot timed worker; frees itself after running like PrintHandler
+        class DeadlineTimer final : public EphemeralBridge {
+                WriteDeadline &m_deadline;
+                uint32_t m_generation;
+
+            protected:
+                void onWork() override { m_deadline.expire(m_generation); }
+
+            public:
+                DeadlineTimer(const AsyncCtx &ctx, WriteDeadline &deadline,
+                              const uint32_t generation)
+                    : EphemeralBridge(ctx), m_deadline(deadline),
+                      m_generation(generation) {}
+        };
+
+    } // namespace
+
+    void WriteDeadline::schedule(const uint32_t now_us) {
+        if (m_timer_pending) {
+            return;
+        }
+        const uint32_t remaining_us = m_progress_us + m_timeout_us - now_us;
+        // Round up so the worker never fires before the deadline
+        const uint32_t run_in_ms = (remaining_us + 999) / 1000;
+        auto timer =
+            std::make_unique<DeadlineTimer>(m_ctx, *this, m_generation);
+        DeadlineTimer *raw_ptr = timer.get();
+        raw_ptr->takeOwnership(std::move(timer));
+        raw_ptr->initialiseBridge();
+        raw_ptr->run(run_in_ms);
+        m_timer_pending = true;
+    }
+
+    void WriteDeadline::onWrite(const std::size_t bytes) {
+        m_ctx.acquireLock();
+        const uint32_t now = time_us_32();
+        if (m_outstanding == 0) {
+            m_progress_us = now;
+        }
+        m_outstanding += bytes;
+        schedule(now);
+        m_ctx.releaseLock();
+    }
+
+    void WriteDeadline::onAck(const uint32_t bytes) {
+        m_ctx.acquireLock();
+        m_outstanding -= std::min(bytes, m_outstanding);
+        // Moving the deadline is just a timestamp; a queued worker re-arms
+        // for the remainder when it fires.
+        m_progress_us = time_us_32();
+        m_ctx.releaseLock();
+    }
+
+    void WriteDeadline::reset() {
+        m_ctx.acquireLock();
+        m_outstanding = 0;
+        ++m_generation;
+        m_timer_pending = false;
+        m_ctx.releaseLock();
+    }
+
+    void WriteDeadline::expire(const uint32_t generation) {
+        m_ctx.acquireLock();
+        ++m_wakeups;
+        if (generation != m_generation) {
+            // Invalidated by reset(); a newer worker may be pending
+            m_ctx.releaseLock();
+            return;
+        }
+        m_timer_pending = false;
+        const uint32_t now = time_us_32();
+        const uint32_t stalled_us = now - m_progress_us;
+        if (m_outstanding == 0) {
+            m_ctx.releaseLock();
+            return;
+        }
+        if (stalled_us < m_timeout_us) {
+            schedule(now);
+            m_ctx.releaseLock();
+            return;
+        }
+
+        ++m_timeouts;
+        m_detect_total_us += stalled_us;
+        m_detect_max_us = std::max(m_detect_max_us, stalled_us);
+        m_late_max_us = std::max(m_late_max_us, stalled_us - m_timeout_us);
+        m_outstanding = 0;
+        m_ctx.releaseLock();
+
+        DEBUGWIRE("[WriteDeadline][:i%d] write stalled for %lu us\n",
+                  m_client.getClientId(),
+                  static_cast<unsigned long>(stalled_us));
+        if (auto *writer = m_client.getWriter()) {
+            writer->onWriteTimeout();
+        }
+    }
+
+} // namespace e5
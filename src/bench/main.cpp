@@ -0,0 +1,525 @@
+/*
+ * AsyncTCPClient Microbenchmark Driver
+ *
+ * Runs the microbenchmark suites of MicroBenchmark.hpp on the host, with
+ * the two contexts of src/native, and adds the connection handlers: each
+ * handler's onWork() is timed on core 0 with a synthetic IoRxBuffer refilled
+ * before every call, as its lwIP callback would leave it. The refill is part
+ * of the figure.
+ *
+ * The suites run --repeat times and each case keeps its best median. Results
+ * go to stdout as [MICRO] JSON lines. With --baseline they are
+ * compared with a stored run by median; against a device baseline, a case
+ * slower by more than the tolerance is a regression and makes the exit
+ * status non-zero. --compare checks a saved run instead of measuring, e.g.
+ * a serial capture of the device's microbench build.
+ *
+ * --suite=bridge runs the BridgeBenchmark cases instead: SyncBridge,
+ * EphemeralBridge, PerpetualBridge and an atomic mailbox, each --messages
+ * times, from core 1 and from core 0 while a core 1 loop thread serves the
+ * target side. They print [BRIDGE] JSON lines and are not compared.
+ *
+ * Usage: e5_bench [--batch=N] [--repeat=N] [--baseline=file] [--compare=file]
+ *                 [--write_baseline=file] [--tolerance_pct=N] [--floor_ns=N]
+ *        e5_bench --suite=bridge [--messages=N]
+ *
+ * Defaults: batch 32, repeat 5, floor 50 ns (differences below the floor
+ * never count, so the cheapest cases do not flap). The tolerance defaults to
+ * 10% against a device baseline. A host baseline is compared but not gated
+ * unless --tolerance_pct is given: on a PC, the lock and thread hand-off
+ * cases move by 40% between runs, in their minimum as much as in their
+ * median, and a tolerance that wide lets real regressions through.
+ */
+#include "BridgeBenchmark.hpp"
+#include "ConnectionTable.hpp"
+#include "ContextManager.hpp"
+#include "EchoReceivedHandler.hpp"
+#include "MicroBenchmark.hpp"
+#include "PrintHandler.hpp"
+#include "QotdBatchReceivedHandler.hpp"
+#include "QotdConfig.hpp"
+#include "QotdFinHandler.hpp"
+#include "QotdReceivedHandler.hpp"
+#include "QuoteBuffer.hpp"
+#include "QuoteHistory.hpp"
+#include "QuoteRecordParser.hpp"
+#include "SerialPrinter.hpp"
+#include "TcpAckHandler.hpp"
+#include "TcpClient.hpp"
+#include <Arduino.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace async_tcp;
+
+// Global configuration values for QOTD test app
+std::size_t QOTD_PARTIAL_CONSUMPTION_THRESHOLD = 88;
+
+namespace {
+
+    AsyncCtx ctx0 = {};
+    AsyncCtx ctx1 = {};
+
+    constexpr uint32_t DEVICE_TOLERANCE_PCT = 10;
+
+    struct Options {
+            uint32_t batch = 32;
+            uint32_t repeat = 5;
+            uint32_t tolerance_pct = 0; ///< 0 picks by platform
+            bool gate = true; ///< Regressions fail the run
+            uint32_t floor_ns = 50;
+            uint32_t messages = 1000; ///< Per bridge case
+            bool bridges = false;     ///< --suite=bridge
+            std::string baseline;
+            std::string compare;
+            std::string write_baseline;
+    };
+
+    constexpr char QUOTE[] =
+        "Few people are capable of expressing with equanimity opinions which "
+        "differ from the prejudices of their social environment. - Einstein\n";
+
+    /**
+     * @brief Collects the [MICRO] lines printed to Serial1.
+     */
+    void capture(const char *data, const std::size_t size, void *arg) {
+        static_cast<std::string *>(arg)->append(data, size);
+    }
+
+    std::string handler_result(const char *name, const e5::BenchStats &stats) {
+        return e5::MicroBenchmark::format(name, stats);
+    }
+
+    /**
+     * @brief Times the handlers' onWork() on core 0, where they run.
+     */
+    std::string run_handler_benchmarks(e5::SerialPrinter &printer,
+                                       e5::QuoteBuffer &buffer,
+                                       const uint32_t batch) {
+        const e5::MicroBenchmark bench(batch);
+        e5::ConnectionTable table;
+        TcpClient qotd;
+        TcpClient echo;
+        qotd.setClientId(1);
+        echo.setClientId(2);
+        const auto qotd_slot = table.attach(qotd);
+        const auto echo_slot = table.attach(echo);
+        IoRxBuffer rx;
+        std::string out;
+
+        e5::QotdReceivedHandler received(table, buffer);
+        out += handler_result("handler.qotd_received.first_chunk",
+                              bench.measure([&] {
+                                  // Every call starts a new quote
+                                  table.setRxStarted(qotd_slot, false);
+                                  rx.reset();
+                                  rx.append(QUOTE, sizeof(QUOTE) - 1);
+                                  received.workload(qotd_slot, &rx);
+                                  received.onWork(qotd_slot);
+                              }));
+
+        e5::QotdFinHandler fin(table, buffer);
+        out += handler_result("handler.qotd_fin.drain", bench.measure([&] {
+                                  rx.reset();
+                                  rx.append(QUOTE + QOTD_PARTIAL_CONSUMPTION_THRESHOLD,
+                                            sizeof(QUOTE) - 1 -
+                                                QOTD_PARTIAL_CONSUMPTION_THRESHOLD);
+                                  fin.workload(qotd_slot, &rx);
+                                  fin.onWork(qotd_slot);
+                              }));
+
+        // A 4 KiB backlog drained in one invocation and in default slices;
+        // the rescheduling between slices is in the bridge cases
+        std::string backlog;
+        while (backlog.size() < 4096) {
+            backlog.append(QUOTE, sizeof(QUOTE) - 1);
+        }
+        backlog.resize(4096);
+        const auto drain = [&](e5::QotdFinHandler &handler) {
+            buffer.clear();
+            rx.reset();
+            rx.append(backlog.data(), backlog.size());
+            handler.workload(qotd_slot, &rx);
+            do {
+                handler.onWork(qotd_slot);
+            } while (handler.hasMoreWork(qotd_slot));
+        };
+        e5::QotdFinHandler monolithic(table, buffer);
+        monolithic.setBudget(SIZE_MAX, 1u << 30);
+        out += handler_result("handler.qotd_fin.drain_4KiB.monolithic",
+                              bench.measure([&] { drain(monolithic); }));
+        e5::QotdFinHandler sliced(table, buffer);
+        out += handler_result("handler.qotd_fin.drain_4KiB.sliced",
+                              bench.measure([&] { drain(sliced); }));
+
+        // Eight records, popped again so the history never fills
+        std::string records;
+        for (int i = 0; i < 8; ++i) {
+            const std::size_t length = sizeof(QUOTE) - 1;
+            records += static_cast<char>(length >> 8);
+            records += static_cast<char>(length & 0xFF);
+            records.append(QUOTE, length);
+        }
+        e5::QuoteHistory history;
+        e5::QuoteRecordParser parser(history);
+        e5::QotdBatchReceivedHandler batch_received(table, parser);
+        std::string popped;
+        out += handler_result("handler.batch_received.8_records",
+                              bench.measure([&] {
+                                  parser.reset();
+                                  rx.reset();
+                                  rx.append(records.data(), records.size());
+                                  batch_received.workload(qotd_slot, &rx);
+                                  batch_received.onWork(qotd_slot);
+                                  while (history.pop(popped)) {
+                                  }
+                              }));
+
+        e5::EchoReceivedHandler echo_received(table, printer, buffer);
+        e5::PrintHandler::setOutputEnabled(false);
+        out += handler_result("handler.echo_received", bench.measure([&] {
+                                  rx.reset();
+                                  rx.append(QUOTE, sizeof(QUOTE) - 1);
+                                  echo_received.workload(echo_slot, &rx);
+                                  echo_received.onWork(echo_slot);
+                              }));
+        // Let the queued prints drain before output is switched back on
+        delay(50);
+        e5::PrintHandler::setOutputEnabled(true);
+
+        e5::TcpAckHandler ack(table);
+        out += handler_result("handler.tcp_ack", bench.measure([&] {
+                                  ack.workload(echo_slot, new uint16_t(64));
+                                  ack.onWork(echo_slot);
+                              }));
+        buffer.clear();
+        return out;
+    }
+
+    /**
+     * @brief Median of every "bench" in JSON lines such as [MICRO] output.
+     */
+    std::map<std::string, uint32_t> parse_results(std::istream &in) {
+        std::map<std::string, uint32_t> medians;
+        std::string line;
+        while (std::getline(in, line)) {
+            const auto name_at = line.find("\"bench\":\"");
+            const auto median_at = line.find("\"median_ns\":");
+            if (name_at == std::string::npos || median_at == std::string::npos) {
+                continue;
+            }
+            const auto name_start = name_at + 9;
+            const auto name_end = line.find('"', name_start);
+            medians[line.substr(name_start, name_end - name_start)] =
+                static_cast<uint32_t>(
+                    std::strtoul(line.c_str() + median_at + 12, nullptr, 10));
+        }
+        return medians;
+    }
+
+    /**
+     * @brief Keeps, for each case, the line with the lowest median.
+     *
+     * Other processes and frequency scaling only ever make a run slower,
+     * so the best of several runs is the most repeatable figure on a PC.
+     */
+    std::string best_of(const std::string &runs) {
+        std::vector<std::string> order;
+        std::map<std::string, std::pair<uint32_t, std::string>> best;
+        std::istringstream lines(runs);
+        std::string line;
+        while (std::getline(lines, line)) {
+            std::istringstream one(line);
+            const auto parsed = parse_results(one);
+            if (parsed.empty()) {
+                continue;
+            }
+            const auto &[name, median] = *parsed.begin();
+            const auto it = best.find(name);
+            if (it == best.end()) {
+                order.push_back(name);
+                best.emplace(name, std::make_pair(median, line));
+            } else if (median < it->second.first) {
+                it->second = {median, line};
+            }
+        }
+        std::string out;
+        for (const auto &name : order) {
+            out += best[name].second + "\n";
+        }
+        return out;
+    }
+
+    /**
+     * @brief Prints a [MICRO] compare line per case of the baseline.
+     *
+     * Without options.gate, slower cases are listed but only missing ones
+     * count.
+     *
+     * @return Number of regressions
+     */
+    int compare(const std::map<std::string, uint32_t> &baseline,
+                const std::map<std::string, uint32_t> &current,
+                const Options &options) {
+        int regressions = 0;
+        for (const auto &[name, base_ns] : baseline) {
+            const auto it = current.find(name);
+            if (it == current.end()) {
+                std::printf("[MICRO] compare %s: missing\n", name.c_str());
+                ++regressions;
+                continue;
+            }
+            const uint32_t now_ns = it->second;
+            const double delta_pct =
+                base_ns ? (static_cast<double>(now_ns) - base_ns) * 100.0 / base_ns
+                        : 0.0;
+            const bool regressed =
+                options.gate && now_ns > base_ns + options.floor_ns &&
+                delta_pct > static_cast<double>(options.tolerance_pct);
+            regressions += regressed ? 1 : 0;
+            std::printf("[MICRO] compare %s: baseline %lu ns, now %lu ns, "
+                        "%+.1f%%%s\n",
+                        name.c_str(), static_cast<unsigned long>(base_ns),
+                        static_cast<unsigned long>(now_ns), delta_pct,
+                        regressed ? ", REGRESSION" : "");
+        }
+        for (const auto &[name, now_ns] : current) {
+            if (baseline.find(name) == baseline.end()) {
+                std::printf("[MICRO] compare %s: new, %lu ns\n", name.c_str(),
+                            static_cast<unsigned long>(now_ns));
+            }
+        }
+        if (options.gate) {
+            std::printf("[MICRO] %d regression(s) against %zu baseline cases, "
+                        "tolerance %lu%%\n",
+                        regressions, baseline.size(),
+                        static_cast<unsigned long>(options.tolerance_pct));
+        } else {
+            std::printf("[MICRO] %d missing of %zu baseline cases; host "
+                        "baseline not gated, see --tolerance_pct\n",
+                        regressions, baseline.size());
+        }
+        return regressions;
+    }
+
+    /**
+     * @brief Prints the cost of draining a backlog in slices against
+     * draining it in one invocation, when both cases were run.
+     */
+    void print_drain_comparison(const std::map<std::string, uint32_t> &medians) {
+        const auto monolithic =
+            medians.find("handler.qotd_fin.drain_4KiB.monolithic");
+        const auto sliced = medians.find("handler.qotd_fin.drain_4KiB.sliced");
+        if (monolithic == medians.end() || sliced == medians.end() ||
+            monolithic->second == 0) {
+            return;
+        }
+        std::printf("[MICRO] qotd_fin 4 KiB drain: sliced %lu ns, monolithic "
+                    "%lu ns, %+.1f%%\n",
+                    static_cast<unsigned long>(sliced->second),
+                    static_cast<unsigned long>(monolithic->second),
+                    (static_cast<double>(sliced->second) - monolithic->second) *
+                        100.0 / monolithic->second);
+    }
+
+    bool parse(const int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; ++i) {
+            const char *arg = argv[i];
+            if (std::strncmp(arg, "--batch=", 8) == 0) {
+                options.batch = std::strtoul(arg + 8, nullptr, 10);
+            } else if (std::strncmp(arg, "--repeat=", 9) == 0) {
+                options.repeat = std::strtoul(arg + 9, nullptr, 10);
+            } else if (std::strncmp(arg, "--tolerance_pct=", 16) == 0) {
+                options.tolerance_pct = std::strtoul(arg + 16, nullptr, 10);
+            } else if (std::strncmp(arg, "--floor_ns=", 11) == 0) {
+                options.floor_ns = std::strtoul(arg + 11, nullptr, 10);
+            } else if (std::strncmp(arg, "--baseline=", 11) == 0) {
+                options.baseline = arg + 11;
+            } else if (std::strncmp(arg, "--compare=", 10) == 0) {
+                options.compare = arg + 10;
+            } else if (std::strncmp(arg, "--write_baseline=", 17) == 0) {
+                options.write_baseline = arg + 17;
+            } else if (std::strcmp(arg, "--suite=bridge") == 0) {
+                options.bridges = true;
+            } else if (std::strcmp(arg, "--suite=micro") == 0) {
+                options.bridges = false;
+            } else if (std::strncmp(arg, "--messages=", 11) == 0) {
+                options.messages = std::strtoul(arg + 11, nullptr, 10);
+            } else {
+                std::fprintf(stderr, "unknown option %s\n", arg);
+                return false;
+            }
+        }
+        return options.batch > 0 && options.repeat > 0 && options.messages > 0 &&
+               (options.compare.empty() || !options.baseline.empty());
+    }
+
+    void start_contexts() {
+        std::thread core1([] {
+            set_core_num(1);
+            auto config = async_context_threadsafe_background_default_config();
+            if (!ctx1.initDefaultContext(config)) {
+                panic_compact("CTX init failed on Core 1\n");
+            }
+        });
+        core1.join();
+        auto config = async_context_threadsafe_background_default_config();
+        if (!ctx0.initDefaultContext(config)) {
+            panic_compact("CTX init failed on Core 0\n");
+        }
+    }
+
+    /**
+     * @brief Measures every case @p repeat times and returns the best
+     * [MICRO] line of each.
+     */
+    std::string run(const uint32_t batch, const uint32_t repeat) {
+        std::string results;
+        Serial1.setSink(capture, &results);
+        start_contexts();
+
+        e5::QuoteBuffer buffer(ctx1);
+        e5::SerialPrinter printer(ctx1);
+
+        std::string handlers;
+        for (uint32_t i = 0; i < repeat; ++i) {
+            // Same-core cases from a thread that counts as core 1, as setup1()
+            std::thread same_core([&] {
+                set_core_num(1);
+                e5::runSameCoreBenchmarks(printer, buffer, batch);
+            });
+            same_core.join();
+            e5::runCrossCoreBenchmarks(printer, buffer, batch);
+            handlers += run_handler_benchmarks(printer, buffer, batch);
+        }
+
+        // Results are printed by ctx1; wait until they all are
+        delay(50);
+        ctx0.stop();
+        ctx1.stop();
+        Serial1.setSink(nullptr, nullptr);
+        return best_of(results + handlers);
+    }
+
+    /**
+     * @brief Runs the bridge cases, with ctx1 as the target, as setup1()
+     * and loop() do in the bridgebench build.
+     */
+    std::string run_bridges(const uint32_t messages) {
+        std::string results;
+        Serial1.setSink(capture, &results);
+        start_contexts();
+
+        e5::SerialPrinter printer(ctx1);
+        e5::BridgeBenchmark bench(ctx1);
+        bench.begin();
+        std::thread same_core([&] {
+            set_core_num(1);
+            bench.run(printer, false, messages);
+        });
+        same_core.join();
+
+        // loop1(): serves the mailbox and plays the target loads
+        std::atomic<bool> serving{true};
+        std::thread loop1([&] {
+            set_core_num(1);
+            while (serving.load(std::memory_order_relaxed)) {
+                bench.serve();
+                tight_loop_contents();
+            }
+        });
+        bench.run(printer, true, messages);
+        serving.store(false, std::memory_order_relaxed);
+        loop1.join();
+
+        delay(50);
+        ctx0.stop();
+        ctx1.stop();
+        Serial1.setSink(nullptr, nullptr);
+        return results;
+    }
+
+} // namespace
+
+int main(const int argc, char **argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr,
+                     "usage: %s [--batch=N] [--repeat=N] [--baseline=file] [--compare=file] "
+                     "[--write_baseline=file] [--tolerance_pct=N] "
+                     "[--floor_ns=N] [--suite=micro|bridge] [--messages=N]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (options.bridges) {
+        std::fputs(run_bridges(options.messages).c_str(), stdout);
+        return EXIT_SUCCESS;
+    }
+
+    std::string results;
+    if (options.compare.empty()) {
+        results = run(options.batch, options.repeat);
+        std::fputs(results.c_str(), stdout);
+    } else {
+        std::ifstream in(options.compare);
+        if (!in) {
+            std::fprintf(stderr, "cannot read %s\n", options.compare.c_str());
+            return EXIT_FAILURE;
+        }
+        std::ostringstream text;
+        text << in.rdbuf();
+        results = text.str();
+    }
+
+    std::istringstream result_lines(results);
+    print_drain_comparison(parse_results(result_lines));
+
+    if (!options.write_baseline.empty()) {
+        std::ofstream out(options.write_baseline);
+        std::istringstream lines(results);
+        std::string line;
+        while (std::getline(lines, line)) {
+            // Only the JSON object, without the [MICRO] prefix
+            if (const auto brace = line.find('{'); brace != std::string::npos &&
+                                                  line.find("\"bench\"") != std::string::npos) {
+                out << line.substr(brace) << '\n';
+            }
+        }
+        if (!out) {
+            std::fprintf(stderr, "cannot write %s\n",
+                         options.write_baseline.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (options.baseline.empty()) {
+        return EXIT_SUCCESS;
+    }
+    std::ifstream base_file(options.baseline);
+    if (!base_file) {
+        std::fprintf(stderr, "cannot read %s\n", options.baseline.c_str());
+        return EXIT_FAILURE;
+    }
+    std::ostringstream base_text;
+    base_text << base_file.rdbuf();
+    if (options.tolerance_pct == 0) {
+        // The device's cycle counts repeat to a few percent; a PC's do not
+        const bool device = base_text.str().find("\"platform\":\"rp2040\"") !=
+                            std::string::npos;
+        options.tolerance_pct = DEVICE_TOLERANCE_PCT;
+        options.gate = device;
+    }
+    std::istringstream base_in(base_text.str());
+    std::istringstream current_in(results);
+    return compare(parse_results(base_in), parse_results(current_in), options) == 0
+               ? EXIT_SUCCESS
+               : EXIT_FAILURE;
+}
@@ -13,6 +13,7 @@
 #include "QotdFinHandler.hpp"
 #include "QotdConfig.hpp"
 
+#include <lwip/opt.h>
 #include <lwip/tcpbase.h>
 #ifndef ESPHOSTSPI
 #error This example requires an ESP-Hosted-FG WiFi chip to be defined, see the documentation
@@ -21,28 +22,56 @@
 // -DESPHOST_DATA_READY=D6 -DESPHOST_CS=D1 -DESPHOSTSPI=SPI
 #endif
 
+#include "BootSequence.hpp"
+#include "BridgeBenchmark.hpp"
+#include "ClosePolicy.hpp"
+#include "ConnectionManager.hpp"
+#include "ConnectionTable.hpp"
 #include "ContextManager.hpp"
+#include "CycleLatencyReport.hpp"
+#include "CycleTimeline.hpp"
+#include "DispatchBenchmark.hpp"
+#include "DnsCache.hpp"
 #include "EchoConnectedHandler.hpp"
 #include "EchoReceivedHandler.hpp"
+#include "EndpointRace.hpp"
+#include "EndpointSelector.hpp"
+#include "Latch.hpp"
+#include "LockProfiler.hpp"
+#include "LwipPoolMonitor.hpp"
 #include "LoopScheduler.hpp"
+#include "MicroBenchmark.hpp"
+#include "Placement.hpp"
+#include "PrintHandler.hpp"
+#include "PriorityDispatcher.hpp"
+#ifdef E5_QOTD_BATCH
+#include "QotdBatchFinHandler.hpp"
+#include "QotdBatchReceivedHandler.hpp"
+#endif
 #include "QotdConnectedHandler.hpp"
 #include "QotdReceivedHandler.hpp"
+#include "QotdSession.hpp"
 #include "QuoteBuffer.hpp"
+#include "QuoteClaim.hpp"
+#include "QuoteHistory.hpp"
+#include "QuoteRecordParser.hpp"
 #include "SerialPrinter.hpp"
 #include "TcpClient.hpp"
 #include "TcpWriter.hpp"
 #include "TcpPollHandler.hpp"
 #include "TcpErrorHandler.hpp"
 #include "TcpAckHandler.hpp"
+#include "WriteDeadline.hpp"
 #include "secrets.h" // Contains STASSID, STAPSK, QOTD_HOST, ECHO_HOST, QOTD_PORT, ECHO_PORT
 #include <WiFi.h>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 
 using namespace async_tcp;
 
 // Global configuration values for QOTD test app
-const std::size_t QOTD_PARTIAL_CONSUMPTION_THRESHOLD = 88;
+std::size_t QOTD_PARTIAL_CONSUMPTION_THRESHOLD = 88;
 
 /**
  * Allocate separate 8KB stack for core1
@@ -52,38 +81,174 @@ const std::size_t QOTD_PARTIAL_CONSUMPTION_THRESHOLD = 88;
  */
 bool core1_separate_stack = true;
 
-volatile bool operational = false; // Global flag for core synchronization
-volatile bool ctx1_ready = false;  // For loop() to wait for setup1()
-volatile bool qotd_in_progress = false;
-volatile bool echo_connected = false;
+// Cross-core startup handshakes
+e5::Latch operational; // Both profilers attached; setup1() may init ctx1
+e5::Latch ctx0_ready;  // Clients and handlers wired by setup()
+e5::Latch ctx1_ready;  // For loop() to wait for setup1()
+static uint32_t ctx1_handoff_us = 0; // ctx1_ready opened to loop() running
 // WiFi credentials from secrets.h
 const auto *ssid = STASSID;
 const auto *password = STAPSK;
-WiFiMulti multi;
 
-// Server details
+// Server details. secrets.h may add QOTD_HOST_2/QOTD_PORT_2 and
+// ECHO_HOST_2/ECHO_PORT_2 as failover endpoints.
 const auto *qotd_host = QOTD_HOST;
 const auto *echo_host = ECHO_HOST;
+#ifdef E5_QOTD_BATCH
+// Batch mode: K length-prefixed quotes per connection from a stand-in
+// server on its own port (scripts/qotd_server.bash with QOTD_BATCH=K)
+#ifndef QOTD_BATCH_PORT
+#define QOTD_BATCH_PORT 1717
+#endif
+constexpr uint16_t qotd_port = QOTD_BATCH_PORT;
+#else
 constexpr uint16_t qotd_port = QOTD_PORT;
+#endif
 constexpr uint16_t echo_port = ECHO_PORT;
 
-// TCP clients
+// TCP clients; each QOTD cycle races qotd_client and qotd_client_alt
 TcpClient qotd_client;
+TcpClient qotd_client_alt;
 TcpClient echo_client;
 
-// IP addresses
-IPAddress qotd_ip_address;
-IPAddress echo_ip_address;
+// Candidate endpoints ranked by measured connect and cycle time
+e5::EndpointSelector qotd_endpoints;
+e5::EndpointSelector echo_endpoints;
+e5::EndpointSelector::Index echo_endpoint = e5::EndpointSelector::NO_ENDPOINT;
+
+// Link and DNS are brought up from loop(); addresses survive reboots in flash
+e5::DnsCache dns_cache;
+e5::BootSequence boot(dns_cache, ssid, password);
 
 // Global asynchronous context managers for each core
 static AsyncCtx ctx0 = {}; // TCP Client Core 0
 static AsyncCtx ctx1 = {}; // SerialPrinter and QuoteBuffer on Core 1
+#if E5_PLACEMENT_CTX2
+static AsyncCtx ctx2 = {}; // Third context on Core 1, see Placement.hpp
+#endif
+
+#ifdef E5_MICROBENCH
+#if E5_QUOTE_BUFFER_CTX != 1 || E5_PRINTER_CTX != 1
+#error E5_MICROBENCH times QuoteBuffer and SerialPrinter on ctx1
+#endif
+#endif
 
 // Thread-safe buffer for storing the quote
-e5::QuoteBuffer qotd_buffer(ctx1);
+e5::QuoteBuffer qotd_buffer(E5_PLACED(ctx, E5_QUOTE_BUFFER_CTX));
+
+// Set up the SerialPrinter, on Core 1 unless placed elsewhere
+e5::SerialPrinter serial_printer(E5_PLACED(ctx, E5_PRINTER_CTX));
+
+#ifdef E5_BRIDGEBENCH
+// Hand-off primitives timed into ctx1, from core 1 and from core 0
+e5::BridgeBenchmark bridge_bench(ctx1);
+#endif
+
+// Priority-ordered dispatch of handler and print work on each context
+e5::PriorityDispatcher dispatcher0(ctx0);
+e5::PriorityDispatcher dispatcher1(ctx1);
+e5::LockProfiler lock_profiler0("ctx0");
+e5::LockProfiler lock_profiler1("ctx1");
+#if E5_PLACEMENT_CTX2
+e5::PriorityDispatcher dispatcher2(ctx2);
+e5::LockProfiler lock_profiler2("ctx2");
+#endif
+
+// Per-connection handler state, keyed by client ID
+e5::ConnectionTable connections;
+
+// One handler per event type, shared by every connection
+e5::TcpAckHandler ack_handler(connections);
+e5::TcpErrorHandler error_handler(connections);
+e5::TcpPollHandler poll_handler(connections);
+e5::EchoConnectedHandler echo_connected_handler(connections, serial_printer);
+e5::EchoReceivedHandler echo_received_handler(connections, serial_printer,
+                                              qotd_buffer);
+#ifdef E5_QOTD_BATCH
+// Quotes parsed from batch connections wait here for the echo ticks
+e5::QuoteHistory quote_history;
+e5::QuoteRecordParser quote_parser(quote_history);
+e5::QotdConnectedHandler qotd_connected_handler(connections, serial_printer,
+                                                qotd_buffer);
+e5::QotdBatchReceivedHandler qotd_received_handler(connections, quote_parser);
+e5::QotdBatchFinHandler qotd_fin_handler(connections, quote_parser);
+#else
+// Both racers write qotd_buffer; the first connection to claim it owns it
+e5::QuoteClaim qotd_claim;
+e5::QotdConnectedHandler qotd_connected_handler(connections, serial_printer,
+                                                qotd_buffer, &qotd_claim);
+e5::QotdReceivedHandler qotd_received_handler(connections, qotd_buffer,
+                                              &qotd_claim);
+e5::QotdFinHandler qotd_fin_handler(connections, qotd_buffer, &qotd_claim);
+#endif
 
-// Set up the SerialPrinter for Core 1
-e5::SerialPrinter serial_printer(ctx1);
+// Stage timestamps of the last QOTD cycles, from connect to echo printed
+e5::CycleTimeline cycle_timeline;
+
+#ifdef E5_PIPELINE_BENCH
+#ifdef E5_QOTD_BATCH
+#error The pipeline benchmark measures single-quote cycles
+#endif
+#ifndef E5_PIPELINE_CYCLES
+#define E5_PIPELINE_CYCLES 10000
+#endif
+#ifndef E5_PIPELINE_BUDGETS
+#define E5_PIPELINE_BUDGETS "" // e.g. "cycle:p99=50000,printed:p99.9=2000"
+#endif
+#ifndef E5_PIPELINE_TIMEOUT_MS
+#define E5_PIPELINE_TIMEOUT_MS 2000 // Wait for a cycle's echo to be printed
+#endif
+// Latency of every benchmark cycle, reported once they have all run
+e5::CycleLatencyReport pipeline_report;
+#endif
+
+#ifndef E5_ECHO_WRITE_TIMEOUT_MS
+#define E5_ECHO_WRITE_TIMEOUT_MS 2000 // Echo write without ACK progress
+#endif
+// Write timeout for the echo connection, replacing poll-driven detection;
+// 0 falls back to TcpPollHandler for comparison
+e5::WriteDeadline echo_deadline(ctx0, echo_client,
+                                E5_ECHO_WRITE_TIMEOUT_MS * 1000u);
+
+// Connection lifecycle; addresses are set once DNS has resolved
+e5::ConnectionManager qotd_manager(connections, qotd_client, IPAddress(),
+                                   qotd_port, e5::ConnectionMode::PER_CYCLE);
+e5::ConnectionManager qotd_manager_alt(connections, qotd_client_alt,
+                                       IPAddress(), qotd_port,
+                                       e5::ConnectionMode::PER_CYCLE);
+e5::EndpointRace qotd_race(qotd_endpoints);
+
+#ifdef E5_QOTD_LOAD
+#ifndef E5_QOTD_SESSIONS
+#define E5_QOTD_SESSIONS 4
+#endif
+#ifndef E5_QOTD_MAX_RATE
+#define E5_QOTD_MAX_RATE 40
+#endif
+// Load generator: concurrent QOTD sessions at a rate stepped every phase
+e5::QotdSessionPool qotd_pool(connections,
+                              E5_PLACED(ctx, E5_QUOTE_BUFFER_CTX),
+                              serial_printer, qotd_endpoints);
+static constexpr uint32_t load_rate_step = 2;       // cycles/s per phase
+static constexpr uint32_t load_phase_us = 10000000; // 10 s
+static uint32_t load_rate = load_rate_step;
+static uint32_t load_sustained = 0; // Highest rate met without failures
+#endif
+#ifndef E5_PBUF_THROTTLE
+#define E5_PBUF_THROTTLE 0 // Free pbufs below which QOTD connects wait; 0 = off
+#endif
+#if E5_PBUF_THROTTLE > 0 && !(LWIP_STATS && MEMP_STATS)
+#error E5_PBUF_THROTTLE needs lwIP stats; without them it never holds back
+#endif
+// lwIP pool usage, sampled by the loop on core 0
+e5::LwipPoolMonitor pool_monitor;
+#ifndef E5_QOTD_CLOSE
+#define E5_QOTD_CLOSE 0 // CloseStrategy of QOTD connections; echo is graceful
+#endif
+static constexpr auto qotd_close = static_cast<e5::CloseStrategy>(E5_QOTD_CLOSE);
+static e5::PcbCensus pcb_census; // Taken by the loop, printed on core 1
+e5::ConnectionManager echo_manager(connections, echo_client, IPAddress(),
+                                   echo_port, e5::ConnectionMode::PERSISTENT);
 
 // Timing variables
 static e5::LoopScheduler scheduler0; // For Core 0
@@ -94,6 +259,14 @@ static constexpr int8_t stack_0 = 2;
 static constexpr int8_t stack_1 = 3;
 static constexpr int8_t heap = 4;
 static constexpr int8_t board_temperature = 5;
+static constexpr int8_t dispatch_stats = 6;
+static constexpr int8_t log_storm = 7;
+static constexpr int8_t priority_phase = 8;
+static constexpr int8_t lock_stats = 9;
+static constexpr int8_t connection_stats = 10;
+static constexpr int8_t deadline_stats = 11;
+static constexpr int8_t timeline_stats = 12;
+static constexpr int8_t pool_sample = 13;
 /**
  * Reads the board temperature from internal temperature sensor
  * @return Temperature value in Celsius
@@ -113,60 +286,169 @@ std::string formatTemperatureMessage(const float temperature) {
 }
 
 /**
- * @brief Connects to the "quote of the day" server and initiates a connection.
+ * @brief Starts a "quote of the day" cycle.
  *
- * Connects to the QOTD server if there isn't another active connection.
+ * The cycle races the two best QOTD endpoints; the first connection to
+ * claim the quote buffer (in batch mode, to connect) wins and the other is
+ * abandoned. Ticks while a cycle is still
+ * running, or while both racers are backing off, are counted as wasted.
+ * While the pbuf pool is below E5_PBUF_THROTTLE free buffers, the tick is
+ * held back so that queued RX data can drain first. In batch mode the tick
+ * is skipped while quotes of the last batch are still waiting, unless
+ * cycles run back to back.
  */
 void get_quote_of_the_day() {
-    if (qotd_client.status() == CLOSED) {
-        if (const auto err = qotd_client.connect(qotd_ip_address, qotd_port);
-            err != PICO_OK) {
-            DEBUGCORE("[WARNING][:i%d] :err %d\n", qotd_client.getClientId(),
-                      err);
-            return;
-        }
-        DEBUGCORE("[INFO][:i%d] connecting.\n", qotd_client.getClientId());
+#if defined(E5_QOTD_BATCH) && !defined(E5_QOTD_BACK_TO_BACK)
+    if (quote_history.pending() > 0) {
+        return;
+    }
+#endif
+    if (!pool_monitor.allowConnect()) {
+        DEBUGCORE("[INFO][QOTD] pbuf pool low, holding back.\n");
+        return;
+    }
+    // Opened first: ctx0 may stamp CONNECTED before requestCycle() returns
+    cycle_timeline.begin();
+    if (qotd_race.requestCycle()) {
+        pool_monitor.cycleStarted();
+        boot.mark(e5::BootPhase::FIRST_CONNECT);
+        DEBUGCORE("[INFO][QOTD] connecting.\n");
         return;
     }
-    DEBUGCORE("[INFO][:i%d] skipping.\n", qotd_client.getClientId());
+    cycle_timeline.discard();
+    DEBUGCORE("[INFO][QOTD] skipping.\n");
 }
 
 /**
- * @brief Connects to the echo server and sends data if available.
+ * @brief Points the echo connection at the best echo endpoint.
+ */
+void select_echo_endpoint() {
+    if (e5::EndpointSelector::Index best;
+        echo_endpoints.best(&best, 1) == 1) {
+        const auto &endpoint = echo_endpoints.endpoint(best);
+        echo_manager.setEndpoint(endpoint.address, endpoint.port);
+        echo_endpoint = best;
+    }
+}
+
+/**
+ * @brief Feeds echo connection outcomes into the endpoint ranking.
  *
- * This function checks if the echo client is connected. If not, it attempts to
- * connect. If connected and there is data in the transmission buffer.
+ * A failed attempt or a dropped connection counts against the current
+ * endpoint and the next reconnect goes to the best endpoint at that time.
+ */
+void update_echo_endpoint() {
+    static uint32_t seen_connects = 0;
+    static uint32_t seen_failed = 0;
+    if (echo_endpoint == e5::EndpointSelector::NO_ENDPOINT) {
+        // Nothing resolved at boot; pick one up once DNS answers late
+        select_echo_endpoint();
+        return;
+    }
+    if (echo_manager.connects() != seen_connects) {
+        seen_connects = echo_manager.connects();
+        echo_endpoints.recordConnect(echo_endpoint,
+                                     echo_manager.lastConnectUs());
+    }
+    if (echo_manager.failedAttempts() != seen_failed) {
+        seen_failed = echo_manager.failedAttempts();
+        echo_endpoints.recordFailure(echo_endpoint);
+        select_echo_endpoint();
+    }
+}
+
+/**
+ * @brief Sends the current quote to the echo server.
+ *
+ * The echo connection is kept open by its connection manager; data written
+ * while it is (re)connecting is queued and sent once it is established.
+ * In batch mode the next waiting quote of the history is sent instead.
  */
 void get_echo() {
+#ifdef E5_QOTD_BATCH
+    // One quote of the batch per tick
+    if (std::string quote; quote_history.pop(quote)) {
+        cycle_timeline.echoWrite(quote.size());
+        echo_manager.write(std::move(quote));
+    }
+#else
     if (qotd_buffer.isComplete()) {
-        if (echo_client.status() != ESTABLISHED) {
-            if (const auto err =
-                    echo_client.connect(echo_ip_address, echo_port);
-                err != PICO_OK) {
-                DEBUGCORE("[WARNING][:i%d] :err %d\n",
-                          echo_client.getClientId(), err);
-                return;
-            }
-        }
-
-        const std::string buffer_content = qotd_buffer.get();
+        std::string buffer_content = qotd_buffer.get();
 
         if (buffer_content.empty()) {
             DEBUGCORE("[INFO] No data to send to echo server.\n");
             return;
         }
 
-        if (const size_t error = echo_client.write(
-                reinterpret_cast<const uint8_t *>(buffer_content.c_str()),
-                buffer_content.size());
-            error != PICO_OK) {
-            DEBUGCORE("[DEBUG] echo_client.write returned error %d\n", error);
+        cycle_timeline.echoWrite(buffer_content.size());
+        echo_manager.write(std::move(buffer_content));
+    }
+#endif
+}
+
+#ifdef E5_PIPELINE_BENCH
+/**
+ * @brief Runs the end-to-end benchmark in place of the QOTD and echo ticks.
+ *
+ * Cycles run one at a time. Each quote is echoed as soon as its cycle
+ * completes, and the next cycle starts once the echo has been printed, the
+ * cycle has failed, or E5_PIPELINE_TIMEOUT_MS has passed. After
+ * E5_PIPELINE_CYCLES cycles the [PIPELINE] report is printed once, ending
+ * in PASS or FAIL against E5_PIPELINE_BUDGETS.
+ */
+void run_pipeline() {
+    static bool started = false;
+    static bool reported = false;
+    static uint32_t echoed_through = 0;
+    if (!started) {
+        started = true;
+        if (!pipeline_report.setBudgets(E5_PIPELINE_BUDGETS)) {
+            serial_printer.print(std::make_unique<std::string>(
+                "[PIPELINE] E5_PIPELINE_BUDGETS does not parse, ignored\n"));
         }
     }
+
+    if (qotd_race.completed() > echoed_through && qotd_buffer.isComplete()) {
+        echoed_through = qotd_race.completed();
+        get_echo();
+    }
+    if (reported) {
+        return;
+    }
+
+    e5::CycleRecord last;
+    const bool has_last = cycle_timeline.record(0, last);
+    const bool ended =
+        qotd_race.completed() + qotd_race.failed() == qotd_race.cycles();
+    if (has_last && !e5::CycleLatencyReport::settled(
+                        last, ended, E5_PIPELINE_TIMEOUT_MS * 1000)) {
+        return;
+    }
+    if (qotd_race.cycles() < E5_PIPELINE_CYCLES) {
+        const uint32_t cycles = qotd_race.cycles();
+        get_quote_of_the_day();
+        if (has_last && qotd_race.cycles() != cycles) {
+            pipeline_report.add(last);
+        }
+        return;
+    }
+    if (has_last) {
+        pipeline_report.add(last);
+    }
+    reported = true;
+    serial_printer.print(
+        std::make_unique<std::string>(
+            pipeline_report.report(qotd_race.failed())));
 }
+#endif
 
 /**
- * @brief Prints heap statistics using the SerialPrinter.
+ * @brief Prints heap and lwIP pool statistics using the SerialPrinter.
+ *
+ * The PCB line shows the last census taken by the loop on core 0. The pool
+ * line reports, per pool, used/available and lwIP's high-water
+ * mark, then the lowest free pbuf count seen, throttled connects, cycles
+ * that ended with pbufs still outstanding and detected leaks.
  */
 void print_heap_stats() {
     // Get heap data
@@ -181,6 +463,37 @@ void print_heap_stats() {
         ", Total: " + std::to_string(totalHeap) + "\n");
 
     serial_printer.print(std::move(heap_stats));
+
+    const e5::PcbCensus census = pcb_census;
+    auto pcb_stats = std::make_unique<std::string>(
+        "[INFO] TCP PCBs: active " + std::to_string(census.active) +
+        " (closing " + std::to_string(census.closing) + "), time_wait " +
+        std::to_string(census.time_wait) + ", capacity " +
+        std::to_string(census.capacity) + ", QOTD close " +
+        e5::closeStrategyName(qotd_close) + "\n");
+    serial_printer.print(std::move(pcb_stats));
+
+    if (!e5::LwipPoolMonitor::available()) {
+        return;
+    }
+    auto pool_stats = std::make_unique<std::string>("[INFO] lwIP");
+    for (std::size_t i = 0; i < static_cast<std::size_t>(e5::LwipPool::COUNT);
+         ++i) {
+        const auto pool = static_cast<e5::LwipPool>(i);
+        const auto &stats = pool_monitor.pool(pool);
+        *pool_stats += std::string(" ") + e5::poolName(pool) + ": " +
+                       std::to_string(stats.used) + "/" +
+                       std::to_string(stats.avail) +
+                       " max " + std::to_string(stats.max) +
+                       " err " + std::to_string(stats.errors) + ",";
+    }
+    *pool_stats +=
+        " min free " + std::to_string(pool_monitor.minFreePbufs()) +
+        ", throttled " + std::to_string(pool_monitor.throttled()) +
+        ", outstanding " + std::to_string(pool_monitor.outstanding()) +
+        " (max " + std::to_string(pool_monitor.outstandingMax()) + ")" +
+        ", leaks " + std::to_string(pool_monitor.leaks()) + "\n";
+    serial_printer.print(std::move(pool_stats));
 }
 
 /**
@@ -209,19 +522,664 @@ void print_board_temperature() {
     serial_printer.print(std::move(temperature_message));
 }
 
+/// Whether handlers and printing currently go through the dispatchers
+static std::atomic<bool> priority_dispatch_on{false};
+
 /**
- * @brief Initializes the Wi-Fi connection and asynchronous context on Core 0.
+ * @brief Enables or disables priority dispatch for handlers and printing.
+ *
+ * With priorities off, handler bridges run their handler directly and every
+ * print queues its own PrintHandler, as before the dispatcher existed.
  */
-void setup() {
-    Serial.begin(); // baud rate is ignored for USB CDC
-    // Wait up to 1 second for Serial to become ready, but do not block
-    // indefinitely.
-    for (int i = 0; i < 100; ++i) {
-        if (Serial)
-            break;
-        delay(10);
+void set_priority_dispatch(const bool enabled) {
+    priority_dispatch_on = enabled;
+    e5::ConnectionHandler *handlers[] = {
+        &ack_handler,           &error_handler,
+        &poll_handler,          &echo_connected_handler,
+        &echo_received_handler, &qotd_connected_handler,
+        &qotd_received_handler, &qotd_fin_handler};
+    for (auto *handler : handlers) {
+        handler->setDispatcher(enabled ? &dispatcher0 : nullptr);
+    }
+    serial_printer.setDispatcher(
+        enabled ? &E5_PLACED(dispatcher, E5_PRINTER_CTX) : nullptr);
+#ifdef E5_QOTD_LOAD
+    qotd_pool.setDispatcher(enabled ? &dispatcher0 : nullptr);
+#endif
+}
+
+/**
+ * @brief Prints ACK-to-writer latency and dispatcher counters.
+ *
+ * @param label Name of the measurement phase
+ */
+void print_priority_stats(const char *label) {
+    using e5::WorkPriority;
+    auto priority_message = std::make_unique<std::string>(
+        std::string("[INFO] Priorities ") + label +
+        ": ACK latency avg/max us " +
+        std::to_string(ack_handler.latencyAvgUs()) + "/" +
+        std::to_string(ack_handler.latencyMaxUs()) + " over " +
+        std::to_string(ack_handler.latencyCount()) +
+        " ACKs; ctx0 critical/normal/background " +
+        std::to_string(dispatcher0.executed(WorkPriority::NETWORK_CRITICAL)) +
+        "/" + std::to_string(dispatcher0.executed(WorkPriority::NORMAL)) +
+        "/" + std::to_string(dispatcher0.executed(WorkPriority::BACKGROUND)) +
+        ", ctx1 background " +
+        std::to_string(dispatcher1.executed(WorkPriority::BACKGROUND)) +
+        " (rejected " +
+        std::to_string(dispatcher1.rejected(WorkPriority::BACKGROUND)) +
+        ")\n");
+    serial_printer.print(std::move(priority_message));
+}
+
+/**
+ * @class PriorityDispatchSwitch
+ * @brief Turns priority dispatch on, or ends a measurement phase, on ctx0.
+ *
+ * The handlers' dispatcher pointers and the ACK latency totals are used by
+ * ctx0, so core 1 posts this item to dispatcher0 instead of changing them
+ * from its own loop. A phase end reports the phase, resets the latency and
+ * toggles priorities.
+ */
+class PriorityDispatchSwitch final : public e5::PrioritizedWork {
+        const bool m_phase_end;
+
+    public:
+        explicit PriorityDispatchSwitch(const bool phase_end)
+            : m_phase_end(phase_end) {}
+
+        void runPrioritized() override {
+            if (!m_phase_end) {
+                set_priority_dispatch(true);
+                return;
+            }
+            print_priority_stats(priority_dispatch_on ? "on" : "off");
+            ack_handler.resetLatency();
+            set_priority_dispatch(!priority_dispatch_on);
+        }
+};
+
+static PriorityDispatchSwitch priority_start(false);
+static PriorityDispatchSwitch priority_phase_end(true);
+
+/**
+ * @brief Prints slice counts and the longest slice of resumable handlers.
+ */
+void print_slice_stats() {
+    auto slice_message = std::make_unique<std::string>(
+        "[INFO] Slices FIN " + std::to_string(qotd_fin_handler.slices()) +
+        " (yields " + std::to_string(qotd_fin_handler.yields()) + ", max " +
+        std::to_string(qotd_fin_handler.maxSliceUs()) + " us), echo RX " +
+        std::to_string(echo_received_handler.slices()) + " (yields " +
+        std::to_string(echo_received_handler.yields()) + ", max " +
+        std::to_string(echo_received_handler.maxSliceUs()) + " us)\n");
+    serial_printer.print(std::move(slice_message));
+}
+
+/**
+ * @class LogStormLine
+ * @brief One line of the log storm, formatted on ctx0 as BACKGROUND work.
+ *
+ * The busy wait stands in for a blocking serial write from the TCP
+ * context, which is the load the priority classes must keep away from the
+ * ACK handlers.
+ */
+class LogStormLine final : public e5::PrioritizedWork {
+        static constexpr uint32_t WRITE_US = 200; ///< Simulated write time
+        int m_line = 0;
+
+    public:
+        void setLine(const int line) { m_line = line; }
+
+        void runPrioritized() override {
+            auto line = std::make_unique<std::string>(
+                "[DEBUG] log storm line " + std::to_string(m_line) +
+                " ------------------------------------------\n");
+            busy_wait_us_32(WRITE_US);
+            serial_printer.print(std::move(line));
+        }
+};
+
+static std::array<LogStormLine, 8> log_storm_lines;
+
+/**
+ * @brief Generates heavy logging load on ctx0 for priority measurements.
+ *
+ * The lines are posted to dispatcher0 whether priorities are on or off, so
+ * they compete with the ACK handlers on the same context either way.
+ */
+void print_log_storm() {
+    for (std::size_t i = 0; i < log_storm_lines.size(); ++i) {
+        log_storm_lines[i].setLine(static_cast<int>(i));
+        dispatcher0.post(log_storm_lines[i], e5::WorkPriority::BACKGROUND);
+    }
+}
+
+/**
+ * @brief Prints connect latency and cycle outcomes of a connection.
+ *
+ * @param name Connection name used in the output
+ * @param manager Manager of the connection
+ */
+void print_connection_stats(const char *name,
+                            const e5::ConnectionManager &manager) {
+    auto connection_message = std::make_unique<std::string>(
+        std::string("[INFO] Connection ") + name + ": connects " +
+        std::to_string(manager.connects()) + ", latency avg/max us " +
+        std::to_string(manager.connectLatencyAvgUs()) + "/" +
+        std::to_string(manager.connectLatencyMaxUs()) + ", cycles " +
+        std::to_string(manager.cycles()) + ", completed " +
+        std::to_string(manager.completedCycles()) + ", failed " +
+        std::to_string(manager.failedCycles()) + ", abandoned " +
+        std::to_string(manager.abandonedCycles()) + ", failed attempts " +
+        std::to_string(manager.failedAttempts()) + ", wasted " +
+        std::to_string(manager.wastedCycles()) + ", dropped writes " +
+        std::to_string(manager.droppedWrites()) + "\n");
+    serial_printer.print(std::move(connection_message));
+}
+
+/**
+ * @brief Prints the counters of every connection in the table.
+ *
+ * Reads lock-free snapshots; error counts are listed by lwIP error code.
+ */
+void print_table_stats() {
+    for (std::size_t i = 0; i < connections.size(); ++i) {
+        const auto stats =
+            connections.snapshot(static_cast<e5::ConnectionTable::Slot>(i));
+        std::string by_code;
+        for (std::size_t code = 1; code < e5::ERROR_CODES; ++code) {
+            if (stats.errors_by_code[code] > 0) {
+                by_code += " " + std::to_string(-static_cast<int>(code)) +
+                           ":" + std::to_string(stats.errors_by_code[code]);
+            }
+        }
+        auto table_message = std::make_unique<std::string>(
+            "[INFO] Client " + std::to_string(stats.client_id) + ": rx " +
+            std::to_string(stats.rx_bytes) + " B/" +
+            std::to_string(stats.rx_events) + " events, tx " +
+            std::to_string(stats.tx_bytes) + " B/" +
+            std::to_string(stats.writes) + " writes, acks " +
+            std::to_string(stats.acks) + "/" +
+            std::to_string(stats.acked_bytes) + " B, rtt avg us " +
+            std::to_string(stats.rtt_avg_us) + ", errors " +
+            std::to_string(stats.errors) + by_code + ", timeouts " +
+            std::to_string(stats.timeouts) + ", connects/closes " +
+            std::to_string(stats.connects) + "/" +
+            std::to_string(stats.closes) + " (" +
+            std::to_string(stats.aborts) + " aborted)\n");
+        serial_printer.print(std::move(table_message));
+    }
+}
+
+/**
+ * @brief Prints the quote rate and the wire overhead per quote.
+ *
+ * Overhead is estimated from the QOTD connections' counters: 40 bytes of
+ * IPv4 and TCP header for each of the 7 segments of a handshake and an
+ * orderly close, 40 bytes per received data segment (one per RX event) and,
+ * in batch mode, the 2-byte record headers. The rate is taken over the
+ * interval since the previous call.
+ */
+void print_quote_stats() {
+    static constexpr uint32_t header_bytes = 40;
+    static constexpr uint32_t setup_segments = 7;
+    static uint32_t last_us = time_us_32();
+    static uint32_t last_quotes = 0;
+
+    uint32_t connects = 0;
+    uint32_t data_segments = 0;
+    uint32_t payload = 0;
+    for (const auto *client : {&qotd_client, &qotd_client_alt}) {
+        const auto stats =
+            connections.snapshot(connections.find(client->getClientId()));
+        connects += stats.connects;
+        data_segments += stats.rx_events;
+        payload += stats.rx_bytes;
+    }
+#ifdef E5_QOTD_BATCH
+    const uint32_t quotes = quote_parser.records();
+    const uint32_t framing = quote_parser.framingBytes();
+    payload -= std::min(payload, framing);
+#else
+    const uint32_t quotes = qotd_race.completed();
+    const uint32_t framing = 0;
+#endif
+    const uint32_t now = time_us_32();
+    const uint32_t elapsed_ms = std::max<uint32_t>((now - last_us) / 1000, 1);
+    const uint32_t rate_mhz = (quotes - last_quotes) * 1000000ull / elapsed_ms;
+    last_us = now;
+    last_quotes = quotes;
+
+    const uint64_t overhead =
+        static_cast<uint64_t>(connects) * setup_segments * header_bytes +
+        static_cast<uint64_t>(data_segments) * header_bytes + framing;
+    const uint32_t per_quote = std::max<uint32_t>(quotes, 1);
+    auto quote_message = std::make_unique<std::string>(
+        "[QUOTES] quotes " + std::to_string(quotes) + ", connects " +
+        std::to_string(connects) + ", rate_mHz " + std::to_string(rate_mhz) +
+        ", payload B/quote " + std::to_string(payload / per_quote) +
+        ", overhead B/quote " + std::to_string(overhead / per_quote) +
+#ifdef E5_QOTD_BATCH
+        ", truncated " + std::to_string(quote_parser.truncated()) +
+        ", incomplete " + std::to_string(quote_parser.incomplete()) +
+        ", dropped " + std::to_string(quote_history.dropped()) +
+#endif
+        "\n");
+    serial_printer.print(std::move(quote_message));
+}
+
+/**
+ * @brief Prints the ranking inputs of every endpoint of a service.
+ *
+ * @param name Service name used in the output
+ * @param selector Endpoints of the service
+ */
+void print_endpoint_stats(const char *name,
+                          const e5::EndpointSelector &selector) {
+    for (std::size_t i = 0; i < selector.size(); ++i) {
+        const auto index = static_cast<e5::EndpointSelector::Index>(i);
+        const auto &endpoint = selector.endpoint(index);
+        auto endpoint_message = std::make_unique<std::string>(
+            std::string("[INFO] Endpoint ") + name + " " + endpoint.host +
+            ":" + std::to_string(endpoint.port) + ": connect ewma us " +
+            std::to_string(endpoint.connect_ewma_us) + ", cycle ewma us " +
+            std::to_string(endpoint.cycle_ewma_us) + ", wins " +
+            std::to_string(endpoint.wins) + ", failures " +
+            std::to_string(endpoint.failures) +
+            (selector.quarantined(index) ? ", quarantined" : "") + "\n");
+        serial_printer.print(std::move(endpoint_message));
+    }
+}
+
+/**
+ * @brief Prints QOTD race outcomes and the last cycle time.
+ */
+void print_race_stats() {
+    auto race_message = std::make_unique<std::string>(
+        "[INFO] QOTD race: cycles " + std::to_string(qotd_race.cycles()) +
+        ", raced " + std::to_string(qotd_race.raced()) + ", failed " +
+        std::to_string(qotd_race.failed()) + ", wasted " +
+        std::to_string(qotd_race.wasted()) + ", last cycle us " +
+        std::to_string(qotd_race.lastCycleUs()) + "\n");
+    serial_printer.print(std::move(race_message));
+}
+
+/**
+ * @brief Prints per-stage latency percentiles of the recent QOTD cycles.
+ *
+ * Each stage is measured from the stage before it, so the largest figures
+ * show which stage dominates the cycle; the last line is the whole cycle.
+ */
+void print_timeline_stats() {
+    using e5::CycleStage;
+    const auto print_span = [](const CycleStage from, const CycleStage to,
+                               const char *name) {
+        const auto span = cycle_timeline.latency(from, to);
+        if (span.count == 0) {
+            return;
+        }
+        auto timeline_message = std::make_unique<std::string>(
+            std::string("[TIMELINE] ") + name + " p50/p90/p99/max us " +
+            std::to_string(span.p50_us) + "/" + std::to_string(span.p90_us) +
+            "/" + std::to_string(span.p99_us) + "/" +
+            std::to_string(span.max_us) + " over " +
+            std::to_string(span.count) + " cycles\n");
+        serial_printer.print(std::move(timeline_message));
+    };
+    for (auto stage = 1; stage < static_cast<int>(CycleStage::COUNT);
+         ++stage) {
+        const auto to = static_cast<CycleStage>(stage);
+        print_span(static_cast<CycleStage>(stage - 1), to, e5::stageName(to));
     }
+    print_span(CycleStage::CONNECT, CycleStage::PRINTED, "cycle");
+}
+
+/**
+ * @brief Streams the raw cycle records, oldest first, for offline analysis.
+ *
+ * One CSV line per record after a header line, each prefixed with
+ * [TIMELINE-DUMP]; timestamps are time_us_32() values, 0 when the stage was
+ * not reached. The received chunks' timestamps follow the counts, 0 past
+ * the last one stamped.
+ */
+void dump_cycle_timeline() {
+    using e5::CycleStage;
+    std::string header = "[TIMELINE-DUMP] id";
+    for (auto stage = 0; stage < static_cast<int>(CycleStage::COUNT);
+         ++stage) {
+        header += ",";
+        header += e5::stageName(static_cast<CycleStage>(stage));
+    }
+    header += ",rx_bytes,chunks,rx_chunks,echo_bytes,echo_acked,echo_rx_bytes";
+    for (std::size_t i = 0; i < e5::CycleRecord::CHUNK_STAMPS; ++i) {
+        header += ",chunk" + std::to_string(i);
+    }
+    header += "\n";
+    serial_printer.print(std::make_unique<std::string>(std::move(header)));
 
+    for (auto age = cycle_timeline.size(); age-- > 0;) {
+        e5::CycleRecord record;
+        if (!cycle_timeline.record(age, record)) {
+            continue;
+        }
+        auto line = std::make_unique<std::string>(
+            "[TIMELINE-DUMP] " + std::to_string(record.id));
+        for (const auto at : record.stage_us) {
+            *line += "," + std::to_string(at);
+        }
+        *line += "," + std::to_string(record.rx_bytes) + "," +
+                 std::to_string(record.chunks) + "," +
+                 std::to_string(record.rx_chunks) + "," +
+                 std::to_string(record.echo_bytes) + "," +
+                 std::to_string(record.echo_acked) + "," +
+                 std::to_string(record.echo_rx_bytes);
+        for (const auto at : record.chunk_us) {
+            *line += "," + std::to_string(at);
+        }
+        *line += "\n";
+        serial_printer.print(std::move(line));
+    }
+}
+
+/**
+ * @brief Reads line commands from the serial console on core 1.
+ *
+ * Supported commands:
+ * - dump: stream the cycle timeline records
+ */
+void poll_serial_commands() {
+    static std::string command;
+    while (Serial1.available() > 0) {
+        const int c = Serial1.read();
+        if (c != '\n' && c != '\r') {
+            if (command.size() < 32) {
+                command += static_cast<char>(c);
+            }
+            continue;
+        }
+        if (command == "dump") {
+            dump_cycle_timeline();
+        }
+        command.clear();
+    }
+}
+
+#ifdef E5_QOTD_LOAD
+/**
+ * @brief Reports the finished load phase and steps the target rate.
+ *
+ * Runs on core 0, which owns the pool. Achieved rate is completed cycles
+ * over the phase length; latency is connect to FIN per session cycle.
+ */
+void step_load_phase() {
+    const uint32_t phase_ms = qotd_pool.phaseUs() / 1000;
+    const auto &latency = qotd_pool.latency();
+    // Met: at least 95% of the target rate with no failed cycles
+    const uint64_t target = static_cast<uint64_t>(load_rate) * phase_ms;
+    if (qotd_pool.failed() == 0 &&
+        qotd_pool.completed() * 1000ull * 100 >= target * 95) {
+        load_sustained = std::max(load_sustained, load_rate);
+    }
+    const auto census = e5::takePcbCensus();
+    auto load_message = std::make_unique<std::string>(
+        "[LOAD] rate=" + std::to_string(load_rate) +
+        "/s sessions=" + std::to_string(qotd_pool.size()) +
+        " started=" + std::to_string(qotd_pool.started()) +
+        " completed=" + std::to_string(qotd_pool.completed()) +
+        " achieved_mHz=" +
+        std::to_string(qotd_pool.completed() * 1000000ull /
+                       std::max<uint32_t>(phase_ms, 1)) +
+        " failed=" + std::to_string(qotd_pool.failed()) +
+        " missed=" + std::to_string(qotd_pool.missed()) +
+        " p50/p99/max_us=" + std::to_string(latency.percentileUs(50)) + "/" +
+        std::to_string(latency.percentileUs(99)) + "/" +
+        std::to_string(latency.max_us) +
+        " close=" + e5::closeStrategyName(qotd_close) +
+        " pcbs=" + std::to_string(census.active) + "/" +
+        std::to_string(census.time_wait) + "tw" +
+        " sustained=" + std::to_string(load_sustained) + "/s\n");
+    // Totals since boot per session, to spot one lagging behind the others
+    for (std::size_t i = 0; i < qotd_pool.size(); ++i) {
+        const auto &session = qotd_pool.session(i);
+        *load_message += "[LOAD] session " + std::to_string(i) +
+                         " cycles=" + std::to_string(session.cycles()) +
+                         " completed=" + std::to_string(session.completed()) +
+                         " failed=" + std::to_string(session.failed()) +
+                         " max_us=" + std::to_string(session.latencyMaxUs()) +
+                         "\n";
+    }
+    serial_printer.print(std::move(load_message));
+
+    load_rate = std::min<uint32_t>(load_rate + load_rate_step,
+                                   E5_QOTD_MAX_RATE);
+    qotd_pool.setRate(load_rate);
+    qotd_pool.resetPhase();
+}
+#endif
+
+/**
+ * @brief Prints write-timeout detection and wakeup rates.
+ *
+ * Wakeups per minute are computed over the interval since the previous call,
+ * for the echo deadline timer and for the poll handler. Only one of them is
+ * registered, depending on E5_ECHO_WRITE_TIMEOUT_MS.
+ */
+void print_deadline_stats() {
+    static uint32_t last_us = time_us_32();
+    static uint32_t last_timer = 0;
+    static uint32_t last_poll = 0;
+    const uint32_t now = time_us_32();
+    const uint32_t elapsed_ms = std::max<uint32_t>((now - last_us) / 1000, 1);
+    const uint32_t timer = echo_deadline.wakeups();
+    const uint32_t poll = poll_handler.wakeups();
+    auto deadline_message = std::make_unique<std::string>(
+        "[INFO] Write deadline: timeouts " +
+        std::to_string(echo_deadline.timeouts()) +
+        ", stall to detection avg/max us " +
+        std::to_string(echo_deadline.detectAvgUs()) + "/" +
+        std::to_string(echo_deadline.detectMaxUs()) + ", late max us " +
+        std::to_string(echo_deadline.lateMaxUs()) +
+        ", wakeups/min timer " +
+        std::to_string((timer - last_timer) * 60000ull / elapsed_ms) +
+        " poll " + std::to_string((poll - last_poll) * 60000ull / elapsed_ms) +
+        "\n");
+    serial_printer.print(std::move(deadline_message));
+    last_us = now;
+    last_timer = timer;
+    last_poll = poll;
+}
+
+/**
+ * @brief Prints lock wait/hold percentiles per caller class for each context.
+ */
+void print_lock_stats() {
+#if E5_PLACEMENT_CTX2
+    for (const auto *profiler :
+         {&lock_profiler0, &lock_profiler1, &lock_profiler2}) {
+#else
+    for (const auto *profiler : {&lock_profiler0, &lock_profiler1}) {
+#endif
+        if (auto report = profiler->report(); !report.empty()) {
+            serial_printer.print(
+                std::make_unique<std::string>(std::move(report)));
+        }
+    }
+}
+
+/**
+ * @brief Prints inline vs queued dispatch counts for the placed components.
+ */
+void print_dispatch_stats() {
+    const auto &printer = serial_printer.dispatch();
+    const auto &buffer = qotd_buffer.dispatch();
+    auto dispatch_message = std::make_unique<std::string>(
+        "[INFO] Dispatch printer inline/queued: " +
+        std::to_string(printer.inlineCount()) + "/" +
+        std::to_string(printer.queuedCount()) +
+        ", quote buffer inline/queued: " +
+        std::to_string(buffer.inlineCount()) + "/" +
+        std::to_string(buffer.queuedCount()) + "\n");
+    serial_printer.print(std::move(dispatch_message));
+}
+
+/**
+ * Layouts of the handlers before the ConnectionTable: each connection owned
+ * one PerpetualBridge-derived handler per event type, holding references to
+ * its client and the shared buffers (pointers here, of the same size). Only
+ * their sizes are used.
+ */
+namespace legacy_handlers {
+    struct QotdConnected : PerpetualBridge {
+            TcpClient *io;
+            e5::SerialPrinter *printer;
+            e5::QuoteBuffer *quote_buffer;
+    };
+    struct QotdReceived : PerpetualBridge {
+            e5::QuoteBuffer *quote_buffer;
+            IoRxBuffer *rx_buffer;
+    };
+    struct QotdFin : PerpetualBridge {
+            TcpClient *io;
+            IoRxBuffer *rx_buffer;
+            e5::QuoteBuffer *quote_buffer;
+    };
+    struct Error : PerpetualBridge {
+            TcpClient *io;
+            err_t error;
+    };
+
+    /// The handlers of one connection, each replaced by one ConnectionBridge
+    template <typename... Handlers> struct Connection {
+            static constexpr std::size_t handlers = sizeof...(Handlers);
+            static constexpr std::size_t bytes = (sizeof(Handlers) + ...);
+    };
+    using Qotd = Connection<QotdConnected, QotdReceived, QotdFin, Error>;
+} // namespace legacy_handlers
+
+/**
+ * @brief Prints QOTD handler memory for 2, 8 and 32 connections.
+ *
+ * Compares the shared-handler layout against the previous layout, where every
+ * connection owned one handler object per event type. A QOTD connection
+ * registers connected, received, FIN and error callbacks. In the shared
+ * layout each of them is a ConnectionBridge on the heap, and the connection
+ * takes a ConnectionTable slot; the handlers themselves are fixed.
+ */
+void print_connection_footprint() {
+    constexpr std::size_t legacy_per_connection = legacy_handlers::Qotd::bytes;
+    constexpr std::size_t bridges_per_connection =
+        legacy_handlers::Qotd::handlers * sizeof(e5::ConnectionBridge);
+    constexpr std::size_t shared_per_connection =
+        bridges_per_connection + e5::ConnectionTable::bytesPerSlot();
+    constexpr std::size_t shared =
+        sizeof(e5::QotdConnectedHandler) + sizeof(e5::QotdReceivedHandler) +
+        sizeof(e5::QotdFinHandler) + sizeof(e5::TcpErrorHandler);
+
+    for (const std::size_t n : {2u, 8u, 32u}) {
+        auto message = std::make_unique<std::string>(
+            "[INFO] Handlers for " + std::to_string(n) +
+            " QOTD connections: legacy " +
+            std::to_string(n * legacy_per_connection) + " B (" +
+            std::to_string(legacy_per_connection) + " B/conn), shared " +
+            std::to_string(shared + n * shared_per_connection) + " B (" +
+            std::to_string(bridges_per_connection) + " B bridges + " +
+            std::to_string(e5::ConnectionTable::bytesPerSlot()) +
+            " B table slot per conn, " + std::to_string(shared) +
+            " B fixed)\n");
+        serial_printer.print(std::move(message));
+    }
+}
+
+/**
+ * @brief Prints the boot phase timings, once the first quote has arrived.
+ *
+ * Times are milliseconds since reset. READY is when connections were
+ * allowed to start: right after LINK when every service had a cached
+ * address, otherwise when DNS answered.
+ */
+void print_boot_report() {
+    using e5::BootPhase;
+    auto boot_message = std::make_unique<std::string>(
+        "[BOOT] ctx0 " + std::to_string(boot.phaseMs(BootPhase::CTX0)) +
+        " ms, ctx1 " + std::to_string(boot.phaseMs(BootPhase::CTX1)) +
+        " ms, link " + std::to_string(boot.phaseMs(BootPhase::LINK)) +
+        " ms, ready " + std::to_string(boot.phaseMs(BootPhase::READY)) +
+        " ms, dns " + std::to_string(boot.phaseMs(BootPhase::DNS)) +
+        " ms, first connect " +
+        std::to_string(boot.phaseMs(BootPhase::FIRST_CONNECT)) +
+        " ms (setup end +" +
+        std::to_string(boot.phaseUs(BootPhase::FIRST_CONNECT) -
+                       boot.phaseUs(BootPhase::CTX0)) +
+        " us), first quote " +
+        std::to_string(boot.phaseMs(BootPhase::FIRST_QUOTE)) +
+        " ms; dns cached/resolved/failed/changed " +
+        std::to_string(boot.cached()) + "/" + std::to_string(boot.resolved()) +
+        "/" + std::to_string(boot.failed()) + "/" +
+        std::to_string(boot.changed()) + ", boot " +
+        std::to_string(dns_cache.boots()) + ", ctx1 handoff " +
+        std::to_string(ctx1_handoff_us) + " us\n");
+    serial_printer.print(std::move(boot_message));
+}
+
+// Statistics printed by loop1(); with E5_STATS_CTX each task runs as
+// BACKGROUND work on the placed context instead
+static e5::FunctionWork stack_1_task(print_stack_stats);
+static e5::FunctionWork heap_task(print_heap_stats);
+static e5::FunctionWork temperature_task(print_board_temperature);
+static e5::FunctionWork dispatch_task([] {
+    print_dispatch_stats();
+    print_priority_stats(priority_dispatch_on ? "on" : "off");
+    print_slice_stats();
+});
+static e5::FunctionWork lock_task(print_lock_stats);
+static e5::FunctionWork connection_task([] {
+    print_connection_stats("qotd", qotd_manager);
+    print_connection_stats("qotd-alt", qotd_manager_alt);
+    print_connection_stats("echo", echo_manager);
+    print_quote_stats();
+    print_endpoint_stats("qotd", qotd_endpoints);
+    print_endpoint_stats("echo", echo_endpoints);
+    print_race_stats();
+    print_table_stats();
+});
+static e5::FunctionWork deadline_task(print_deadline_stats);
+static e5::FunctionWork timeline_task(print_timeline_stats);
+
+/**
+ * @brief Runs a statistics task where the placement puts it.
+ *
+ * A task still queued from its last period is not queued again; if the
+ * stats context's queue is full the task runs here, as without placement.
+ */
+void run_stats(e5::FunctionWork &task) {
+#ifdef E5_STATS_CTX
+    if (E5_PLACED(dispatcher, E5_STATS_CTX)
+            .post(task, e5::WorkPriority::BACKGROUND)) {
+        return;
+    }
+#endif
+    task.runPrioritized();
+}
+
+/**
+ * @brief Starts the Wi-Fi link and sets up the asynchronous context on
+ * Core 0.
+ *
+ * Nothing here waits for the network: the link and DNS are driven by
+ * boot.poll() from loop(), while both cores set up their contexts.
+ */
+void setup() {
+    // Attach before either context is initialised; setup1() waits for this
+    e5::LockProfiler::attach(ctx0, lock_profiler0);
+    e5::LockProfiler::attach(ctx1, lock_profiler1);
+#if E5_PLACEMENT_CTX2
+    e5::LockProfiler::attach(ctx2, lock_profiler2);
+#endif
+    operational.open();
+
+    Serial.begin(); // baud rate is ignored for USB CDC; not waited for
     Serial1.begin(115200);
     while (!Serial1) {
         tight_loop_contents();
@@ -229,26 +1187,32 @@ void setup() {
 
     RP2040::enableDoubleResetBootloader();
 
-    multi.addAP(ssid, password);
-
-    if (multi.run() != WL_CONNECTED) {
-        DEBUGV("Unable to connect to network, rebooting in 10 seconds...\n");
-        delay(10000);
-        rp2040.reboot();
-    }
-
-    hostByName(qotd_host, qotd_ip_address, 1000);
-    hostByName(echo_host, echo_ip_address, 1000);
+    qotd_endpoints.add(qotd_host, qotd_port);
+#if defined(QOTD_HOST_2) && !defined(E5_QOTD_BATCH)
+    qotd_endpoints.add(QOTD_HOST_2, QOTD_PORT_2);
+#endif
+    echo_endpoints.add(echo_host, echo_port);
+#ifdef ECHO_HOST_2
+    echo_endpoints.add(ECHO_HOST_2, ECHO_PORT_2);
+#endif
+    dns_cache.load();
+    boot.addService(qotd_endpoints);
+    boot.addService(echo_endpoints);
+    boot.begin();
 
     auto config = async_context_threadsafe_background_default_config();
     config.custom_alarm_pool = alarm_pool_create_with_unused_hardware_alarm(16);
     if (!ctx0.initDefaultContext(config)) {
         panic_compact("CTX init failed on Core 0\n");
     }
+    dispatcher0.initialiseBridge();
 
     // Create TcpClientSyncAccessor for each client and assign
     auto qotd_sync = std::make_unique<TcpClientSyncAccessor>(ctx0, qotd_client);
     qotd_client.setSyncAccessor(std::move(qotd_sync));
+    auto qotd_alt_sync =
+        std::make_unique<TcpClientSyncAccessor>(ctx0, qotd_client_alt);
+    qotd_client_alt.setSyncAccessor(std::move(qotd_alt_sync));
     auto echo_sync = std::make_unique<TcpClientSyncAccessor>(ctx0, echo_client);
     echo_client.setSyncAccessor(std::move(echo_sync));
 
@@ -256,81 +1220,141 @@ void setup() {
     auto echo_writer = std::make_unique<TcpWriter>(ctx0, echo_client);
     echo_client.setWriter(std::move(echo_writer));
 
-    auto echo_connected_handler = std::make_unique<e5::EchoConnectedHandler>(
-        ctx0, echo_client, serial_printer);
-    echo_connected_handler->initialiseBridge();
-    echo_client.setOnConnectedCallback(std::move(echo_connected_handler));
-
-    auto echo_received_handler = std::make_unique<e5::EchoReceivedHandler>(
-        ctx0, serial_printer, qotd_buffer);
-    echo_received_handler->initialiseBridge();
-    ;
-    echo_client.setOnReceivedCallback(std::move(echo_received_handler));
-
-    // Register lwIP poll handler for echo client
-    auto echo_poll_handler = std::make_unique<e5::TcpPollHandler>(ctx0, echo_client);
-    echo_poll_handler->initialiseBridge();
-    echo_client.setOnPollCallback(std::move(echo_poll_handler));
-
-    // Register ACK handler for echo client (bridged to async context)
-    auto echo_ack_handler = std::make_unique<e5::TcpAckHandler>(ctx0, echo_client);
-    echo_ack_handler->initialiseBridge();
-    echo_client.setOnAckCallback(std::move(echo_ack_handler));
-
-    // Register error handlers for both clients (bridged to async context)
-    auto echo_error_handler = std::make_unique<e5::TcpErrorHandler>(ctx0, echo_client);
-    echo_error_handler->initialiseBridge();
-    echo_client.setOnErrorCallback(std::move(echo_error_handler));
-
-    auto qotd_error_handler = std::make_unique<e5::TcpErrorHandler>(ctx0, qotd_client);
-    qotd_error_handler->initialiseBridge();
-    qotd_client.setOnErrorCallback(std::move(qotd_error_handler));
-
-    auto qotd_connected_handler = std::make_unique<e5::QotdConnectedHandler>(
-        ctx0, qotd_client, serial_printer, qotd_buffer);
-    qotd_connected_handler->initialiseBridge();
-    qotd_client.setOnConnectedCallback(std::move(qotd_connected_handler));
-
-    auto qotd_received_handler =
-        std::make_unique<e5::QotdReceivedHandler>(ctx0, qotd_buffer);
-    qotd_received_handler->initialiseBridge();
-    qotd_client.setOnReceivedCallback(std::move(qotd_received_handler));
-
-    auto qotd_fin_handler =
-        std::make_unique<e5::QotdFinHandler>(ctx0, qotd_client, qotd_buffer);
-    qotd_fin_handler->initialiseBridge();
-    qotd_client.setOnFinCallback(std::move(qotd_fin_handler));
+    // Set unique client IDs; handler state is keyed by them
+    qotd_client.setClientId(1);
+    qotd_client_alt.setClientId(3);
+    echo_client.setClientId(2);
+
+    // Register the shared handlers through per-connection bridges
+    echo_client.setOnConnectedCallback(
+        echo_connected_handler.bridge(ctx0, echo_client));
+    echo_client.setOnReceivedCallback(
+        echo_received_handler.bridge(ctx0, echo_client));
+    echo_client.setOnAckCallback(ack_handler.bridge(ctx0, echo_client));
+    echo_client.setOnErrorCallback(error_handler.bridge(ctx0, echo_client));
+
+    qotd_client.setOnErrorCallback(error_handler.bridge(ctx0, qotd_client));
+    qotd_client.setOnConnectedCallback(
+        qotd_connected_handler.bridge(ctx0, qotd_client));
+    qotd_client.setOnReceivedCallback(
+        qotd_received_handler.bridge(ctx0, qotd_client));
+    qotd_client.setOnFinCallback(qotd_fin_handler.bridge(ctx0, qotd_client));
+
+    qotd_client_alt.setOnErrorCallback(
+        error_handler.bridge(ctx0, qotd_client_alt));
+    qotd_client_alt.setOnConnectedCallback(
+        qotd_connected_handler.bridge(ctx0, qotd_client_alt));
+    qotd_client_alt.setOnReceivedCallback(
+        qotd_received_handler.bridge(ctx0, qotd_client_alt));
+    qotd_client_alt.setOnFinCallback(
+        qotd_fin_handler.bridge(ctx0, qotd_client_alt));
+
+    // Write timeouts on the echo connection come from its own timer. The
+    // poll bridge is then left out, so lwIP polls of the idle connection
+    // never wake ctx0.
+#if E5_ECHO_WRITE_TIMEOUT_MS > 0
+    connections.setWriteDeadline(connections.find(echo_client.getClientId()),
+                                 &echo_deadline);
+#else
+    echo_client.setOnPollCallback(poll_handler.bridge(ctx0, echo_client));
+#endif
+
+    // Racers and echo stamp the cycle timeline; load sessions do not
+    for (const auto *client : {&qotd_client, &qotd_client_alt, &echo_client}) {
+        connections.setTimeline(connections.find(client->getClientId()),
+                                &cycle_timeline);
+    }
+    e5::PrintHandler::setObserver(&e5::CycleTimeline::onEmit, &cycle_timeline);
+
+    // The echo connection is opened on the first loop() pass
+    qotd_manager.start();
+    qotd_manager_alt.start();
+    echo_manager.start();
+    qotd_race.addRacer(qotd_manager);
+    qotd_race.addRacer(qotd_manager_alt);
+#ifndef E5_QOTD_BATCH
+    qotd_race.setClaim(qotd_claim);
+#endif
+    pool_monitor.setThrottle(E5_PBUF_THROTTLE);
+#ifdef E5_QOTD_LOAD
+    // Session client IDs start at 10, clear of the application's clients
+    qotd_pool.begin(E5_QOTD_SESSIONS, ctx0, 10, error_handler);
+#endif
+    // Every connection but echo is a per-cycle QOTD connection
+    for (std::size_t i = 0; i < connections.size(); ++i) {
+        const auto slot = static_cast<e5::ConnectionTable::Slot>(i);
+        if (slot != connections.find(echo_client.getClientId())) {
+            connections.setCloseStrategy(slot, qotd_close);
+        }
+    }
 
     scheduler0.setEntry(qotd, 80808);
     scheduler0.setEntry(echo, 30303);
     scheduler0.setEntry(stack_0, 404040);
+    scheduler0.setEntry(pool_sample, 20202);
 
     pinMode(LED_BUILTIN, OUTPUT);
 
-    // Set unique client IDs
-    qotd_client.setClientId(1);
-    echo_client.setClientId(2);
-
-    operational = true;
+    boot.mark(e5::BootPhase::CTX0);
+    ctx0_ready.open();
 }
 
 /**
  * @brief Initializes the asynchronous context on Core 1.
  */
 void setup1() {
-    while (!operational) {
-        tight_loop_contents();
-    }
+    operational.wait();
 
+    // ctx1 does not need the network; bring it up while core 0 connects
     if (auto config = async_context_threadsafe_background_default_config();
         !ctx1.initDefaultContext(config)) {
         panic_compact("CTX init failed on Core 1\n");
     }
+    dispatcher1.initialiseBridge();
+#if E5_PLACEMENT_CTX2
+    // Only two cores: the third context shares core 1 with ctx1
+    if (auto config = async_context_threadsafe_background_default_config();
+        !ctx2.initDefaultContext(config)) {
+        panic_compact("CTX2 init failed on Core 1\n");
+    }
+    dispatcher2.initialiseBridge();
+#endif
+    boot.mark(e5::BootPhase::CTX1);
+
+    // Handlers and sessions are wired by setup() on core 0
+    ctx0_ready.wait();
+    dispatcher0.post(priority_start, e5::WorkPriority::NETWORK_CRITICAL);
 
     scheduler1.setEntry(stack_1, 808080);
     scheduler1.setEntry(heap, 707070);
     scheduler1.setEntry(board_temperature, 505050);
-    ctx1_ready = true;
+    scheduler1.setEntry(dispatch_stats, 909090);
+    scheduler1.setEntry(lock_stats, 1010101);
+    scheduler1.setEntry(connection_stats, 1111111);
+    scheduler1.setEntry(deadline_stats, 1212121);
+    scheduler1.setEntry(timeline_stats, 1313131);
+#ifdef E5_BENCH
+    scheduler1.setEntry(log_storm, 2000);
+    scheduler1.setEntry(priority_phase, 3000000);
+#endif
+
+    print_connection_footprint();
+    serial_printer.print(std::make_unique<std::string>(
+        std::string("[INFO] Placement ") + e5::PLACEMENT_LABEL + "\n"));
+
+#ifdef E5_BENCH
+    // Run before releasing loop() so core 0 does not touch the buffer
+    e5::runDispatchBenchmark(serial_printer, qotd_buffer, 1000);
+#endif
+#ifdef E5_MICROBENCH
+    e5::runSameCoreBenchmarks(serial_printer, qotd_buffer, 32);
+#endif
+#ifdef E5_BRIDGEBENCH
+    bridge_bench.begin();
+    bridge_bench.run(serial_printer, false, 1000);
+#endif
+
+    ctx1_ready.open();
 }
 
 /**
@@ -338,30 +1362,128 @@ void setup1() {
  * Handles periodic requests to the QOTD and echo servers.
  */
 void loop() {
+    boot.poll();
+    if (boot.linkFailed()) {
+        DEBUGV("Unable to connect to network, rebooting in 10 seconds...\n");
+        delay(10000);
+        rp2040.reboot();
+    }
 
-    if (!ctx1_ready) {
-        delay(1);
+    if (!ctx1_ready.isOpen()) {
+        // Sleeps until setup1() opens the latch; no polling delay
+        ctx1_ready.wait();
+        ctx1_handoff_us = time_us_32() - ctx1_ready.openedUs();
+#ifdef E5_MICROBENCH
+        // Before the first cycle, while no handler uses the buffer
+        e5::runCrossCoreBenchmarks(serial_printer, qotd_buffer, 32);
+#endif
+#ifdef E5_BRIDGEBENCH
+        // loop1() serves the target side meanwhile
+        bridge_bench.run(serial_printer, true, 1000);
+#endif
+    }
+    if (!boot.ready()) {
         return;
     }
 
+    // Fetch the first quote as soon as an address is known
+    static bool first_cycle = true;
+    if (first_cycle) {
+        first_cycle = false;
+        get_quote_of_the_day();
+    }
+
+    qotd_race.poll();
+    echo_manager.poll();
+    update_echo_endpoint();
+
+    // The FIN handler has reset its RX buffer by the time a cycle ends
+    static uint32_t seen_ended = 0;
+    if (const uint32_t ended = qotd_race.completed() + qotd_race.failed();
+        ended != seen_ended) {
+        seen_ended = ended;
+        pool_monitor.cycleEnded();
+#ifdef E5_QOTD_BATCH
+        // Frees the parser of a batch cut short by an error or deadline
+        quote_parser.reset();
+#endif
+    }
+
+    if (!boot.reached(e5::BootPhase::FIRST_QUOTE) &&
+        qotd_race.completed() > 0) {
+        boot.mark(e5::BootPhase::FIRST_QUOTE);
+        print_boot_report();
+        // Written once per boot, after the first quote, so the flash
+        // stall does not delay it
+        dns_cache.commit();
+    }
+
+#if defined(E5_PIPELINE_BENCH)
+    run_pipeline();
+#elif defined(E5_QOTD_BACK_TO_BACK)
+    // Throughput runs: the next cycle starts as soon as the last has closed
+    get_quote_of_the_day();
+#else
     if (scheduler0.timeToRun(qotd))
         get_quote_of_the_day();
+#endif
 
+#ifndef E5_PIPELINE_BENCH
     if (scheduler0.timeToRun(echo))
         get_echo();
+#endif
 
     if (scheduler0.timeToRun(stack_0))
         print_stack_stats();
+
+    if (scheduler0.timeToRun(pool_sample)) {
+        pool_monitor.sample();
+        pcb_census = e5::takePcbCensus();
+    }
+
+#ifdef E5_QOTD_LOAD
+    static bool load_started = false;
+    if (!load_started) {
+        qotd_pool.setRate(load_rate);
+        qotd_pool.resetPhase();
+        load_started = true;
+    }
+    qotd_pool.poll();
+    if (qotd_pool.phaseUs() >= load_phase_us)
+        step_load_phase();
+#endif
 }
 
 /**
  * @brief Loop function for Core 1.
  */
 void loop1() {
+#ifdef E5_BRIDGEBENCH
+    bridge_bench.serve();
+#endif
     if (scheduler1.timeToRun(stack_1))
-        print_stack_stats();
+        run_stats(stack_1_task);
     if (scheduler1.timeToRun(heap))
-        print_heap_stats();
+        run_stats(heap_task);
     if (scheduler1.timeToRun(board_temperature))
-        print_board_temperature();
+        run_stats(temperature_task);
+    if (scheduler1.timeToRun(dispatch_stats))
+        run_stats(dispatch_task);
+    if (scheduler1.timeToRun(lock_stats))
+        run_stats(lock_task);
+    if (scheduler1.timeToRun(connection_stats))
+        run_stats(connection_task);
+    if (scheduler1.timeToRun(deadline_stats))
+        run_stats(deadline_task);
+    if (scheduler1.timeToRun(timeline_stats))
+        run_stats(timeline_task);
+    poll_serial_commands();
+#ifdef E5_BENCH
+    // Alternate priorities off/on under heavy logging and report each phase
+    if (scheduler1.timeToRun(log_storm))
+        print_log_storm();
+    if (scheduler1.timeToRun(priority_phase)) {
+        dispatcher0.post(priority_phase_end, e5::WorkPriority::NORMAL);
+    }
+#endif
 }
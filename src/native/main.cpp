@@ -0,0 +1,635 @@
+/*
+ * AsyncTCPClient Host Driver
+ *
+ * Runs the QOTD/echo application on a PC, for fast iteration without a
+ * board. The handlers, connection managers, QuoteBuffer and SerialPrinter
+ * are the same sources as on the Pico; the async-tcp library, Arduino core
+ * and lwIP are replaced by the stand-ins in host/AsyncTcpHost, which give
+ * each context an event-loop thread and each TcpClient a non-blocking
+ * POSIX socket. The main thread plays core 0 and a second thread runs the
+ * core 1 setup.
+ *
+ * Usage: e5_native [qotd_host:port] [echo_host:port] [cycles] [interval_ms]
+ *                  [--budget=span:pNN=us,...] [--timeout_ms=N]
+ *                  [--stats_ms=N] [--thresholds=N,...,unlimited]
+ *
+ * Defaults: 127.0.0.1:10017, 127.0.0.1:10007, 100 cycles, interval 0
+ * (cycles run back to back). Cycles run one at a time: each quote is echoed
+ * as soon as its cycle completes, and the next cycle waits until the echo
+ * has been printed, or for --timeout_ms (default 1000). The quote stream
+ * and echoes go to stdout; the summary is the [PIPELINE] latency report of
+ * all cycles, then the [HOST] lines: the cycle totals and the counters of
+ * each client. --budget sets latency budgets as CycleLatencyReport parses
+ * them; the exit status is non-zero if one is exceeded, a cycle failed or
+ * no quote arrived, as the [PIPELINE] verdict says.
+ * Put src/proxy in front of a server to see the handlers under
+ * segmentation, delay and resets.
+ *
+ * QuoteBuffer, SerialPrinter and the statistics tasks are placed on
+ * contexts as the board build places them (Placement.hpp). --stats_ms
+ * starts a "core 1" loop thread that runs the statistics tasks every N ms,
+ * on the stats context when E5_STATS_CTX is set. The last [HOST] line gives
+ * the placement and the CPU time of each core, its loop and its contexts as
+ * a percentage of the run; scripts/placement_matrix.bash compares them.
+ *
+ * --thresholds=1,8,...,unlimited sweeps QOTD_PARTIAL_CONSUMPTION_THRESHOLD:
+ * [cycles] cycles per threshold, each printed as a [SWEEP] row in place of
+ * the [PIPELINE] report. scripts/threshold_sweep.bash runs it across quote
+ * sizes and segmentations.
+ */
+#include "ConnectionManager.hpp"
+#include "ConnectionTable.hpp"
+#include "ContextManager.hpp"
+#include "CycleLatencyReport.hpp"
+#include "CycleTimeline.hpp"
+#include "EchoConnectedHandler.hpp"
+#include "EchoReceivedHandler.hpp"
+#include "EndpointRace.hpp"
+#include "EndpointSelector.hpp"
+#include "Latch.hpp"
+#include "LockProfiler.hpp"
+#include "Placement.hpp"
+#include "PrintHandler.hpp"
+#include "PriorityDispatcher.hpp"
+#include "QotdConfig.hpp"
+#include "QotdConnectedHandler.hpp"
+#include "QotdFinHandler.hpp"
+#include "QotdReceivedHandler.hpp"
+#include "QuoteBuffer.hpp"
+#include "QuoteClaim.hpp"
+#include "SerialPrinter.hpp"
+#include "TcpAckHandler.hpp"
+#include "TcpClient.hpp"
+#include "TcpErrorHandler.hpp"
+#include "TcpPollHandler.hpp"
+#include "TcpWriter.hpp"
+#include <Arduino.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <time.h>
+#include <vector>
+
+using namespace async_tcp;
+
+// Global configuration values for QOTD test app
+std::size_t QOTD_PARTIAL_CONSUMPTION_THRESHOLD = 88;
+
+static AsyncCtx ctx0 = {}; // TCP clients, "core 0"
+static AsyncCtx ctx1 = {}; // SerialPrinter and QuoteBuffer, "core 1"
+#if E5_PLACEMENT_CTX2
+static AsyncCtx ctx2 = {}; // Third context, "core 1"
+#endif
+
+TcpClient qotd_client;
+TcpClient qotd_client_alt;
+TcpClient echo_client;
+
+e5::EndpointSelector qotd_endpoints;
+e5::QuoteBuffer qotd_buffer(E5_PLACED(ctx, E5_QUOTE_BUFFER_CTX));
+e5::SerialPrinter serial_printer(E5_PLACED(ctx, E5_PRINTER_CTX));
+e5::PriorityDispatcher dispatcher0(ctx0);
+e5::PriorityDispatcher dispatcher1(ctx1);
+e5::LockProfiler lock_profiler0("ctx0");
+e5::LockProfiler lock_profiler1("ctx1");
+#if E5_PLACEMENT_CTX2
+e5::PriorityDispatcher dispatcher2(ctx2);
+e5::LockProfiler lock_profiler2("ctx2");
+#endif
+e5::ConnectionTable connections;
+
+e5::TcpAckHandler ack_handler(connections);
+e5::TcpErrorHandler error_handler(connections);
+e5::TcpPollHandler poll_handler(connections);
+e5::EchoConnectedHandler echo_connected_handler(connections, serial_printer);
+e5::EchoReceivedHandler echo_received_handler(connections, serial_printer,
+                                              qotd_buffer);
+// Both racers write qotd_buffer; the first connection to claim it owns it
+e5::QuoteClaim qotd_claim;
+e5::QotdConnectedHandler qotd_connected_handler(connections, serial_printer,
+                                                qotd_buffer, &qotd_claim);
+e5::QotdReceivedHandler qotd_received_handler(connections, qotd_buffer,
+                                              &qotd_claim);
+e5::QotdFinHandler qotd_fin_handler(connections, qotd_buffer, &qotd_claim);
+
+e5::ConnectionManager qotd_manager(connections, qotd_client, IPAddress(), 0,
+                                   e5::ConnectionMode::PER_CYCLE);
+e5::ConnectionManager qotd_manager_alt(connections, qotd_client_alt,
+                                       IPAddress(), 0,
+                                       e5::ConnectionMode::PER_CYCLE);
+e5::ConnectionManager echo_manager(connections, echo_client, IPAddress(), 0,
+                                   e5::ConnectionMode::PERSISTENT);
+e5::EndpointRace qotd_race(qotd_endpoints);
+e5::CycleTimeline cycle_timeline;
+e5::CycleLatencyReport pipeline_report;
+
+// Startup handshakes between the main thread and the core 1 thread, as on
+// the board
+e5::Latch operational; // Profilers attached; setup_core1() may init ctx1
+e5::Latch ctx1_ready;  // For setup() to wait for setup_core1()
+e5::Latch ctx0_ready;  // Clients and handlers wired by setup()
+
+namespace {
+
+    struct Endpoint {
+            std::string host = "127.0.0.1";
+            uint16_t port = 0;
+            IPAddress address;
+    };
+
+    /**
+     * @brief Parses "host:port" (dotted IPv4 only; there is no DNS here).
+     */
+    bool parse_endpoint(const char *text, Endpoint &endpoint) {
+        const char *colon = std::strrchr(text, ':');
+        if (colon) {
+            endpoint.host.assign(text, colon - text);
+            endpoint.port = static_cast<uint16_t>(std::atoi(colon + 1));
+        } else {
+            endpoint.host = text;
+        }
+        return endpoint.address.fromString(endpoint.host.c_str()) &&
+               endpoint.port != 0;
+    }
+
+    /**
+     * @brief Parses "1,8,88,unlimited"; 0 is unlimited too.
+     */
+    bool parse_thresholds(const char *text,
+                          std::vector<std::size_t> &thresholds) {
+        while (*text != '\0') {
+            const char *end = text + 9;
+            std::size_t threshold = SIZE_MAX;
+            if (std::strncmp(text, "unlimited", 9) != 0) {
+                char *number_end = nullptr;
+                threshold = std::strtoul(text, &number_end, 10);
+                if (number_end == text) {
+                    return false;
+                }
+                end = number_end;
+                threshold = threshold == 0 ? SIZE_MAX : threshold;
+            }
+            if (*end != ',' && *end != '\0') {
+                return false;
+            }
+            thresholds.push_back(threshold);
+            text = *end == ',' ? end + 1 : end;
+        }
+        return !thresholds.empty();
+    }
+
+    void setup_core1() {
+        set_core_num(1);
+        operational.wait();
+        auto config = async_context_threadsafe_background_default_config();
+        if (!ctx1.initDefaultContext(config)) {
+            panic_compact("CTX init failed on Core 1\n");
+        }
+        dispatcher1.initialiseBridge();
+#if E5_PLACEMENT_CTX2
+        if (!ctx2.initDefaultContext(config)) {
+            panic_compact("CTX2 init failed on Core 1\n");
+        }
+        dispatcher2.initialiseBridge();
+#endif
+        ctx1_ready.open();
+        ctx0_ready.wait();
+    }
+
+    void setup(const Endpoint &qotd, const Endpoint &echo) {
+        e5::LockProfiler::attach(ctx0, lock_profiler0);
+        e5::LockProfiler::attach(ctx1, lock_profiler1);
+#if E5_PLACEMENT_CTX2
+        e5::LockProfiler::attach(ctx2, lock_profiler2);
+#endif
+        operational.open();
+        ctx1_ready.wait();
+
+        auto config = async_context_threadsafe_background_default_config();
+        if (!ctx0.initDefaultContext(config)) {
+            panic_compact("CTX init failed on Core 0\n");
+        }
+        dispatcher0.initialiseBridge();
+
+        for (auto *client : {&qotd_client, &qotd_client_alt, &echo_client}) {
+            client->setSyncAccessor(
+                std::make_unique<TcpClientSyncAccessor>(ctx0, *client));
+        }
+        echo_client.setWriter(std::make_unique<TcpWriter>(ctx0, echo_client));
+
+        qotd_client.setClientId(1);
+        qotd_client_alt.setClientId(3);
+        echo_client.setClientId(2);
+
+        echo_client.setOnConnectedCallback(
+            echo_connected_handler.bridge(ctx0, echo_client));
+        echo_client.setOnReceivedCallback(
+            echo_received_handler.bridge(ctx0, echo_client));
+        echo_client.setOnPollCallback(poll_handler.bridge(ctx0, echo_client));
+        echo_client.setOnAckCallback(ack_handler.bridge(ctx0, echo_client));
+        echo_client.setOnErrorCallback(error_handler.bridge(ctx0, echo_client));
+
+        for (auto *client : {&qotd_client, &qotd_client_alt}) {
+            client->setOnErrorCallback(error_handler.bridge(ctx0, *client));
+            client->setOnConnectedCallback(
+                qotd_connected_handler.bridge(ctx0, *client));
+            client->setOnReceivedCallback(
+                qotd_received_handler.bridge(ctx0, *client));
+            client->setOnFinCallback(qotd_fin_handler.bridge(ctx0, *client));
+        }
+
+        qotd_endpoints.setAddress(
+            qotd_endpoints.add(qotd.host.c_str(), qotd.port), qotd.address);
+        echo_manager.setEndpoint(echo.address, echo.port);
+
+        qotd_manager.start();
+        qotd_manager_alt.start();
+        echo_manager.start();
+        qotd_race.addRacer(qotd_manager);
+        qotd_race.addRacer(qotd_manager_alt);
+        qotd_race.setClaim(qotd_claim);
+
+        for (const auto *client : {&qotd_client, &qotd_client_alt, &echo_client}) {
+            connections.setTimeline(connections.find(client->getClientId()),
+                                    &cycle_timeline);
+        }
+        e5::PrintHandler::setObserver(&e5::CycleTimeline::onEmit,
+                                      &cycle_timeline);
+        ctx0_ready.open();
+    }
+
+    uint64_t thread_cpu_us() {
+        timespec used{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &used);
+        return static_cast<uint64_t>(used.tv_sec) * 1000000u +
+               static_cast<uint64_t>(used.tv_nsec) / 1000u;
+    }
+
+    /**
+     * @brief A statistics round like the board's loop1() prints: client
+     * counters, lock profiles and dispatch counts.
+     */
+    void print_stats() {
+        for (const auto *client :
+             {&qotd_client, &qotd_client_alt, &echo_client}) {
+            const auto stats =
+                connections.snapshot(connections.find(client->getClientId()));
+            serial_printer.print(std::make_unique<std::string>(
+                "[STATS] client " + std::to_string(stats.client_id) + ": rx " +
+                std::to_string(stats.rx_bytes) + " B, tx " +
+                std::to_string(stats.tx_bytes) + " B, connects " +
+                std::to_string(stats.connects) + "\n"));
+        }
+#if E5_PLACEMENT_CTX2
+        for (const auto *profiler :
+             {&lock_profiler0, &lock_profiler1, &lock_profiler2}) {
+#else
+        for (const auto *profiler : {&lock_profiler0, &lock_profiler1}) {
+#endif
+            if (auto report = profiler->report(); !report.empty()) {
+                serial_printer.print(
+                    std::make_unique<std::string>(std::move(report)));
+            }
+        }
+        const auto &printer = serial_printer.dispatch();
+        const auto &buffer = qotd_buffer.dispatch();
+        serial_printer.print(std::make_unique<std::string>(
+            "[STATS] dispatch printer inline/queued " +
+            std::to_string(printer.inlineCount()) + "/" +
+            std::to_string(printer.queuedCount()) + ", quote buffer " +
+            std::to_string(buffer.inlineCount()) + "/" +
+            std::to_string(buffer.queuedCount()) + "\n"));
+    }
+
+    e5::FunctionWork stats_task(print_stats);
+    std::atomic<bool> loop1_running{false};
+    uint64_t loop1_cpu_us = 0; // Written by loop1() as it returns
+
+    /**
+     * @brief The "core 1" loop: the statistics task every @p period_us, on
+     * the stats context if one is placed, else right here.
+     */
+    void loop1(const uint32_t period_us) {
+        set_core_num(1);
+        uint32_t last_us = time_us_32();
+        while (loop1_running.load(std::memory_order_acquire)) {
+            if (time_us_32() - last_us >= period_us) {
+                last_us = time_us_32();
+#ifdef E5_STATS_CTX
+                if (!E5_PLACED(dispatcher, E5_STATS_CTX)
+                         .post(stats_task, e5::WorkPriority::BACKGROUND)) {
+                    stats_task.runPrioritized();
+                }
+#else
+                stats_task.runPrioritized();
+#endif
+            }
+            delayMicroseconds(100);
+        }
+        loop1_cpu_us = thread_cpu_us();
+    }
+
+    /**
+     * @brief The "core 1" thread: setup_core1(), then loop1() if
+     * loop1_running was set before the thread started.
+     */
+    void core1_main(const uint32_t period_us) {
+        setup_core1();
+        if (loop1_running.load(std::memory_order_acquire)) {
+            loop1(period_us);
+        }
+    }
+
+    struct RunResult {
+            uint32_t completed = 0;
+            uint32_t failed = 0;
+            uint32_t mismatched = 0; ///< Echo length differs from the quote
+            uint32_t echoed = 0;
+            uint32_t chunks = 0;   ///< peekConsume() calls of the QOTD handlers
+            uint64_t quote_bytes = 0; ///< Of the quotes echoed
+            std::size_t exceeded = 0; ///< Budgets
+    };
+
+    /**
+     * @brief Runs @p cycles cycles, a cycle per interval, but only once the
+     * last one has been echoed and printed; each finished record goes into
+     * @p report.
+     */
+    RunResult run_cycles(const uint32_t cycles, const uint32_t interval_us,
+                         const uint32_t timeout_us,
+                         e5::CycleLatencyReport &report) {
+        RunResult result;
+        const uint32_t cycles_before = qotd_race.cycles();
+        const uint32_t completed_before = qotd_race.completed();
+        const uint32_t failed_before = qotd_race.failed();
+        // Records of earlier runs are already in their reports
+        e5::CycleRecord previous;
+        const uint32_t first_id =
+            cycle_timeline.record(0, previous) ? previous.id + 1 : 1;
+        const auto finish = [&](const e5::CycleRecord &record) {
+            if (record.id >= first_id) {
+                report.add(record);
+                result.chunks += record.chunks;
+                result.quote_bytes += record.echo_bytes;
+            }
+        };
+
+        uint32_t last_request_us = time_us_32() - interval_us;
+        uint32_t echoed_through = completed_before; // Quotes echoed
+        const auto ended = [] {
+            return qotd_race.completed() + qotd_race.failed();
+        };
+        const auto last_settled = [timeout_us, &ended] {
+            e5::CycleRecord last;
+            return !cycle_timeline.record(0, last) ||
+                   e5::CycleLatencyReport::settled(
+                       last, ended() == qotd_race.cycles(), timeout_us);
+        };
+        while (ended() - completed_before - failed_before < cycles ||
+               !last_settled()) {
+            qotd_race.poll();
+            echo_manager.poll();
+            // Once per completed cycle: the buffer stays complete until the
+            // next quote starts, which a slow or failed cycle can put off
+            if (qotd_race.completed() > echoed_through &&
+                qotd_buffer.isComplete()) {
+                echoed_through = qotd_race.completed();
+                if (std::string quote = qotd_buffer.get(); !quote.empty()) {
+                    cycle_timeline.echoWrite(quote.size());
+                    echo_manager.write(std::move(quote));
+                    ++result.echoed;
+                }
+            }
+            if (qotd_race.cycles() - cycles_before < cycles &&
+                time_us_32() - last_request_us >= interval_us &&
+                last_settled()) {
+                e5::CycleRecord last;
+                const bool has_last = cycle_timeline.record(0, last);
+                // Opened first: connect() may run the cycle at once
+                cycle_timeline.begin();
+                if (qotd_race.requestCycle()) {
+                    last_request_us = time_us_32();
+                    if (has_last) {
+                        finish(last);
+                    }
+                } else {
+                    cycle_timeline.discard();
+                }
+            }
+            delayMicroseconds(50);
+        }
+        if (e5::CycleRecord last; cycle_timeline.record(0, last)) {
+            finish(last);
+        }
+        result.completed = qotd_race.completed() - completed_before;
+        result.failed = qotd_race.failed() - failed_before;
+        // A segmented quote that lost segments still completes
+        result.mismatched = report.mismatches();
+        result.exceeded = report.exceeded();
+        return result;
+    }
+
+    /**
+     * @brief Runs one threshold of a sweep and prints its [SWEEP] row.
+     *
+     * Per completed cycle: QuoteBuffer calls that crossed to its context,
+     * peekConsume() calls of the QOTD handlers, ctx0 CPU time (its handlers
+     * and socket polling) and the time core 0 spent blocked in those
+     * QuoteBuffer calls; then the cycle latency.
+     */
+    RunResult sweep_point(const uint32_t cycles, const uint32_t interval_us,
+                          const uint32_t timeout_us, const char *budgets) {
+        static e5::CycleLatencyReport report;
+        report = e5::CycleLatencyReport();
+        report.setBudgets(budgets);
+        auto *buffer_profiler =
+            e5::LockProfiler::of(qotd_buffer.dispatch().context());
+        if (buffer_profiler) {
+            buffer_profiler->reset();
+        }
+        const uint32_t queued_before = qotd_buffer.dispatch().queuedCount();
+        const uint64_t ctx0_before = ctx0.cpuUs();
+
+        const RunResult result = run_cycles(cycles, interval_us, timeout_us,
+                                            report);
+
+        const double per_cycle = result.completed ? result.completed : 1;
+        uint64_t blocked_us = 0;
+        for (const bool worker : {false, true}) {
+            if (buffer_profiler) {
+                blocked_us += buffer_profiler
+                                  ->series(e5::LockCaller::BRIDGE_EXECUTE,
+                                           e5::LockProfiler::lane(0, worker))
+                                  .latency.total_us;
+            }
+        }
+        const std::string threshold =
+            QOTD_PARTIAL_CONSUMPTION_THRESHOLD == SIZE_MAX
+                ? "unlimited"
+                : std::to_string(QOTD_PARTIAL_CONSUMPTION_THRESHOLD);
+        std::fprintf(
+            stdout,
+            "[SWEEP] threshold %s quote_bytes %.0f cycles %lu failed %lu: "
+            "xcore/cycle %.2f peek/cycle %.2f ctx0_us/cycle %.1f "
+            "blocked_us/cycle %.1f cycle p50/p99/avg us %lu/%lu/%lu%s\n",
+            threshold.c_str(),
+            result.echoed ? static_cast<double>(result.quote_bytes) / result.echoed
+                          : 0.0,
+            static_cast<unsigned long>(result.completed),
+            static_cast<unsigned long>(result.failed + result.mismatched),
+            (qotd_buffer.dispatch().queuedCount() - queued_before) / per_cycle,
+            result.chunks / per_cycle,
+            (ctx0.cpuUs() - ctx0_before) / per_cycle, blocked_us / per_cycle,
+            static_cast<unsigned long>(report.percentileUs(0, 500)),
+            static_cast<unsigned long>(report.percentileUs(0, 990)),
+            static_cast<unsigned long>(report.meanUs(0)),
+            result.exceeded ? ", budget EXCEEDED" : "");
+        return result;
+    }
+
+} // namespace
+
+int main(const int argc, char **argv) {
+    Endpoint qotd{"127.0.0.1", 10017, {}};
+    Endpoint echo{"127.0.0.1", 10007, {}};
+    const char *positional[4] = {};
+    std::size_t positionals = 0;
+    const char *budgets = "";
+    uint32_t timeout_us = 1000000;
+    uint32_t stats_us = 0;
+    std::vector<std::size_t> thresholds;
+    bool usage = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--budget=", 9) == 0) {
+            budgets = argv[i] + 9;
+        } else if (std::strncmp(argv[i], "--timeout_ms=", 13) == 0) {
+            timeout_us = std::strtoul(argv[i] + 13, nullptr, 10) * 1000;
+        } else if (std::strncmp(argv[i], "--stats_ms=", 11) == 0) {
+            stats_us = std::strtoul(argv[i] + 11, nullptr, 10) * 1000;
+        } else if (std::strncmp(argv[i], "--thresholds=", 13) == 0) {
+            usage = !parse_thresholds(argv[i] + 13, thresholds);
+        } else if (argv[i][0] != '-' && positionals < std::size(positional)) {
+            positional[positionals++] = argv[i];
+        } else {
+            usage = true;
+        }
+    }
+    if (usage || (positional[0] && !parse_endpoint(positional[0], qotd)) ||
+        (positional[1] && !parse_endpoint(positional[1], echo)) ||
+        !qotd.address.fromString(qotd.host.c_str()) ||
+        !echo.address.fromString(echo.host.c_str()) ||
+        !pipeline_report.setBudgets(budgets)) {
+        std::fprintf(stderr,
+                     "usage: %s [qotd_host:port] [echo_host:port] [cycles] "
+                     "[interval_ms] [--budget=span:pNN=us,...] "
+                     "[--timeout_ms=N] [--stats_ms=N] "
+                     "[--thresholds=N,...,unlimited]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+    const uint32_t cycles =
+        positional[2] ? std::strtoul(positional[2], nullptr, 10) : 100;
+    const uint32_t interval_us =
+        positional[3] ? std::strtoul(positional[3], nullptr, 10) * 1000 : 0;
+
+    loop1_running = stats_us != 0;
+    std::thread core1(core1_main, stats_us);
+    setup(qotd, echo);
+#if E5_PLACEMENT_CTX2
+    AsyncCtx *contexts[] = {&ctx0, &ctx1, &ctx2};
+#else
+    AsyncCtx *contexts[] = {&ctx0, &ctx1};
+#endif
+    uint64_t ctx_cpu_us[std::size(contexts)];
+    for (std::size_t i = 0; i < std::size(contexts); ++i) {
+        ctx_cpu_us[i] = contexts[i]->cpuUs();
+    }
+    const uint64_t loop0_start_cpu_us = thread_cpu_us();
+
+    const uint32_t start_us = time_us_32();
+    RunResult total;
+    if (thresholds.empty()) {
+        total = run_cycles(cycles, interval_us, timeout_us, pipeline_report);
+    }
+    for (const std::size_t threshold : thresholds) {
+        QOTD_PARTIAL_CONSUMPTION_THRESHOLD = threshold;
+        const RunResult point =
+            sweep_point(cycles, interval_us, timeout_us, budgets);
+        total.completed += point.completed;
+        total.failed += point.failed;
+        total.mismatched += point.mismatched;
+        total.echoed += point.echoed;
+        total.exceeded += point.exceeded;
+    }
+    const uint32_t elapsed_us = time_us_32() - start_us;
+    const uint64_t loop0_cpu_us = thread_cpu_us() - loop0_start_cpu_us;
+    loop1_running = false;
+    core1.join();
+    for (std::size_t i = 0; i < std::size(contexts); ++i) {
+        ctx_cpu_us[i] = contexts[i]->cpuUs() - ctx_cpu_us[i];
+    }
+
+    for (auto *context : contexts) {
+        context->stop();
+    }
+    Serial1.flush();
+    if (thresholds.empty()) {
+        std::fputs(pipeline_report.report(total.failed).c_str(), stdout);
+    }
+
+    std::fprintf(stdout,
+                 "[HOST] cycles %lu completed %lu failed %lu echoed %lu in "
+                 "%lu ms: %.1f cycles/s, qotd connect avg us %lu\n",
+                 static_cast<unsigned long>(qotd_race.cycles()),
+                 static_cast<unsigned long>(qotd_race.completed()),
+                 static_cast<unsigned long>(qotd_race.failed()),
+                 static_cast<unsigned long>(total.echoed),
+                 static_cast<unsigned long>(elapsed_us / 1000),
+                 elapsed_us ? qotd_race.completed() * 1e6 / elapsed_us : 0.0,
+                 static_cast<unsigned long>(qotd_manager.connectLatencyAvgUs()));
+    // RX events count QotdReceivedHandler/EchoReceivedHandler invocations,
+    // which is what a segmenting proxy in front of the servers changes
+    for (const auto *client : {&qotd_client, &qotd_client_alt, &echo_client}) {
+        const auto stats =
+            connections.snapshot(connections.find(client->getClientId()));
+        std::fprintf(stdout,
+                     "[HOST] client %d: rx %lu B/%lu events, tx %lu B/%lu "
+                     "writes, connects/closes %u/%u (%u aborted), errors %u\n",
+                     stats.client_id, static_cast<unsigned long>(stats.rx_bytes),
+                     static_cast<unsigned long>(stats.rx_events),
+                     static_cast<unsigned long>(stats.tx_bytes),
+                     static_cast<unsigned long>(stats.writes), stats.connects,
+                     stats.closes, stats.aborts, stats.errors);
+    }
+    // Core 0 is the main loop and ctx0, core 1 the loop1() thread and the
+    // other contexts; several threads may share a host CPU, so a sum over
+    // 100% shows the placement needs more than one core's worth there
+    const auto percent = [elapsed_us](const uint64_t cpu_us) {
+        return elapsed_us ? cpu_us * 100.0 / elapsed_us : 0.0;
+    };
+    uint64_t core1_cpu_us = loop1_cpu_us;
+    std::string contexts_line;
+    for (std::size_t i = 0; i < std::size(contexts); ++i) {
+        core1_cpu_us += i == 0 ? 0 : ctx_cpu_us[i];
+        char figure[32];
+        std::snprintf(figure, sizeof(figure), " ctx%zu %.1f", i,
+                      percent(ctx_cpu_us[i]));
+        contexts_line += figure;
+    }
+    std::fprintf(stdout,
+                 "[HOST] placement %s: cpu%% core0 %.1f core1 %.1f, loop0 "
+                 "%.1f loop1 %.1f%s\n",
+                 e5::PLACEMENT_LABEL, percent(loop0_cpu_us + ctx_cpu_us[0]),
+                 percent(core1_cpu_us), percent(loop0_cpu_us),
+                 percent(loop1_cpu_us), contexts_line.c_str());
+    const bool passed =
+        thresholds.empty()
+            ? pipeline_report.passed(total.failed)
+            : total.completed > 0 && total.failed == 0 &&
+                  total.mismatched == 0 && total.exceeded == 0;
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,745 @@
+/*
+ * AsyncTCPClient Impairment Proxy
+ *
+ * A TCP proxy for testing the host build (src/native) under wire behaviour
+ * that a local server never shows: the client connects to the proxy, the
+ * proxy connects to the real server and relays both directions, cutting the
+ * stream into segments and delaying each one as configured. Local servers
+ * hand a quote over in one piece, so without the proxy the partial
+ * consumption and drain paths of the QOTD handlers barely run.
+ *
+ * Usage: e5_proxy [--name=value ...] [--script=file] [--verbose]
+ *
+ *   --listen, --target          proxy port, server host:port
+ *                               (default 10117 -> 127.0.0.1:10017)
+ *   --connections, --duration_ms
+ *                               exit after that many connections or ms
+ *   --seed                      seed of every random choice
+ *   any Profile field           e.g. --segment=1 --delay_us=500
+ *   --script=file               a profile per run of connections
+ *   --verbose                   a line per connection as it ends
+ *
+ * Impairments apply to the server-to-client direction; --upstream=1 applies
+ * them to the client-to-server direction too. Each segment is sent with its
+ * own send() on a TCP_NODELAY socket. Segments due at the same time may
+ * still reach the client as one read, as they would from a real network;
+ * a gap_us or rate_bps keeps them apart.
+ *
+ * Each line of a script file is a number of connections followed by
+ * options, applied on top of the command line profile to that many
+ * following connections; 0 means all remaining. The last line holds once
+ * the script has run out. Lines starting with # are comments:
+ *
+ *   # 20 clean, 20 dribbled a byte at a time, then random splits with loss
+ *   20
+ *   20 --segment=1 --gap_us=200
+ *   0  --segment_min=1 --segment_max=64 --loss_permille=20
+ *
+ * The summary is the final [PROXY] line, on stdout.
+ */
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <fstream>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    /**
+     * @brief How one connection is impaired.
+     *
+     * Delivery times are kept in order: a segment never overtakes the one
+     * before it, as TCP's receive queue would not let it. A lost segment is
+     * therefore seen by the client as a stall of rto_us followed by a burst
+     * of everything sent meanwhile; a reordered one as a shorter stall of
+     * reorder_us.
+     */
+    struct Profile {
+            uint32_t segment_min = 0;  ///< Bytes per segment; 0 relays reads
+            uint32_t segment_max = 0;  ///< Random split up to this size
+            uint32_t delay_us = 0;     ///< Added to every segment
+            uint32_t jitter_us = 0;    ///< Random extra delay up to this
+            uint32_t gap_us = 0;       ///< Minimum time between segments
+            uint32_t rate_bps = 0;     ///< Bytes per second; 0 unlimited
+            uint32_t loss_permille = 0;
+            uint32_t rto_us = 200000;  ///< Stall of a lost segment
+            uint32_t reorder_permille = 0;
+            uint32_t reorder_us = 2000; ///< Stall of a reordered segment
+            uint32_t fin_delay_us = 0; ///< Between the last segment and FIN
+            uint32_t rst_permille = 0; ///< Connections that get a RST
+            uint32_t rst_after_bytes = 0; ///< Bytes relayed before the RST
+            uint32_t upstream = 0;     ///< Impair client to server too
+    };
+
+    struct Options {
+            uint32_t listen = 10117;
+            sockaddr_in target{};
+            uint32_t connections = 0; ///< 0 runs until a signal
+            uint32_t duration_ms = 0;
+            uint32_t seed = 1;
+            bool verbose = false;
+            Profile base;
+            std::vector<std::pair<uint32_t, Profile>> script;
+    };
+
+    struct Segment {
+            uint64_t at_us;
+            std::string data;
+            std::size_t offset = 0; ///< Bytes already sent
+    };
+
+    /**
+     * @brief One direction of a connection.
+     */
+    struct Pipe {
+            int from = -1;
+            int to = -1;
+            bool impaired = false;
+            std::deque<Segment> queue;
+            std::size_t queued_bytes = 0;
+            uint64_t last_at_us = 0;   ///< Delivery of the newest segment
+            uint64_t link_free_us = 0; ///< End of the rate limiter's busy time
+            bool eof = false;          ///< The sender has closed
+            bool shut = false;         ///< FIN passed on
+            uint64_t fin_at_us = 0;
+            uint64_t bytes = 0;
+            uint64_t segments = 0;
+    };
+
+    struct Connection {
+            uint32_t id = 0;
+            Profile profile;
+            int client = -1;
+            int server = -1;
+            bool connecting = true;
+            bool reset_armed = false;
+            bool closed = false;
+            bool was_reset = false;
+            Pipe down; ///< Server to client
+            Pipe up;   ///< Client to server
+    };
+
+    struct Totals {
+            uint32_t connections = 0;
+            uint32_t refused = 0;
+            uint32_t resets = 0;    ///< Injected
+            uint32_t peer_resets = 0;
+            uint32_t lost = 0;
+            uint32_t reordered = 0;
+            uint32_t fins_delayed = 0;
+            uint64_t down_bytes = 0;
+            uint64_t down_segments = 0;
+            uint64_t up_bytes = 0;
+            uint64_t up_segments = 0;
+    };
+
+    constexpr std::size_t READ_BYTES = 16384;
+    constexpr std::size_t MAX_QUEUED_BYTES = 262144; ///< Stop reading above
+
+    volatile std::sig_atomic_t stop_requested = 0;
+
+    uint64_t now_us() {
+        static const auto start = std::chrono::steady_clock::now();
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+    }
+
+    bool set_nonblocking(const int fd) {
+        const int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    void set_nodelay(const int fd) {
+        const int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    /**
+     * @brief Closes @p fd with a RST instead of a FIN.
+     */
+    void close_abortive(const int fd) {
+        if (fd < 0) {
+            return;
+        }
+        const linger abort_linger{1, 0};
+        setsockopt(fd, SOL_SOCKET, SO_LINGER, &abort_linger,
+                   sizeof(abort_linger));
+        close(fd);
+    }
+
+    /**
+     * @brief Parses "host:port" (dotted IPv4 only).
+     */
+    bool parse_endpoint(const char *text, sockaddr_in &address) {
+        const char *colon = std::strrchr(text, ':');
+        if (!colon) {
+            return false;
+        }
+        const std::string host(text, colon - text);
+        address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(std::atoi(colon + 1)));
+        return inet_pton(AF_INET, host.c_str(), &address.sin_addr) == 1 &&
+               address.sin_port != 0;
+    }
+
+    /**
+     * @brief Applies one --name=value option to @p profile.
+     *
+     * --segment=N is short for --segment_min=N --segment_max=N.
+     */
+    bool parse_profile_option(const char *arg, Profile &profile) {
+        const std::pair<const char *, uint32_t *> fields[] = {
+            {"segment_min", &profile.segment_min},
+            {"segment_max", &profile.segment_max},
+            {"delay_us", &profile.delay_us},
+            {"jitter_us", &profile.jitter_us},
+            {"gap_us", &profile.gap_us},
+            {"rate_bps", &profile.rate_bps},
+            {"loss_permille", &profile.loss_permille},
+            {"rto_us", &profile.rto_us},
+            {"reorder_permille", &profile.reorder_permille},
+            {"reorder_us", &profile.reorder_us},
+            {"fin_delay_us", &profile.fin_delay_us},
+            {"rst_permille", &profile.rst_permille},
+            {"rst_after_bytes", &profile.rst_after_bytes},
+            {"upstream", &profile.upstream},
+        };
+        const char *equals = std::strchr(arg, '=');
+        if (!equals || std::strncmp(arg, "--", 2) != 0) {
+            return false;
+        }
+        const std::string name(arg + 2, equals - arg - 2);
+        const auto value =
+            static_cast<uint32_t>(std::strtoul(equals + 1, nullptr, 10));
+        if (name == "segment") {
+            profile.segment_min = value;
+            profile.segment_max = value;
+            return true;
+        }
+        for (const auto &[field, target] : fields) {
+            if (name == field) {
+                *target = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool load_script(const char *path, Options &options) {
+        std::ifstream file(path);
+        if (!file) {
+            std::fprintf(stderr, "cannot read %s\n", path);
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream words(line);
+            std::string word;
+            if (!(words >> word) || word[0] == '#') {
+                continue;
+            }
+            const auto count =
+                static_cast<uint32_t>(std::strtoul(word.c_str(), nullptr, 10));
+            Profile profile = options.base;
+            while (words >> word) {
+                if (!parse_profile_option(word.c_str(), profile)) {
+                    std::fprintf(stderr, "%s: unknown option %s\n", path,
+                                 word.c_str());
+                    return false;
+                }
+            }
+            options.script.emplace_back(count, profile);
+        }
+        return true;
+    }
+
+    bool parse(const int argc, char **argv, Options &options) {
+        parse_endpoint("127.0.0.1:10017", options.target);
+        const char *script = nullptr;
+        for (int i = 1; i < argc; ++i) {
+            const char *arg = argv[i];
+            if (std::strcmp(arg, "--verbose") == 0) {
+                options.verbose = true;
+            } else if (std::strncmp(arg, "--target=", 9) == 0) {
+                if (!parse_endpoint(arg + 9, options.target)) {
+                    std::fprintf(stderr, "bad target %s\n", arg + 9);
+                    return false;
+                }
+            } else if (std::strncmp(arg, "--script=", 9) == 0) {
+                script = arg + 9;
+            } else if (std::strncmp(arg, "--listen=", 9) == 0) {
+                options.listen = std::strtoul(arg + 9, nullptr, 10);
+            } else if (std::strncmp(arg, "--connections=", 14) == 0) {
+                options.connections = std::strtoul(arg + 14, nullptr, 10);
+            } else if (std::strncmp(arg, "--duration_ms=", 14) == 0) {
+                options.duration_ms = std::strtoul(arg + 14, nullptr, 10);
+            } else if (std::strncmp(arg, "--seed=", 7) == 0) {
+                options.seed = std::strtoul(arg + 7, nullptr, 10);
+            } else if (!parse_profile_option(arg, options.base)) {
+                std::fprintf(stderr, "unknown option %s\n", arg);
+                return false;
+            }
+        }
+        // The script applies on top of every other option, wherever it is
+        return options.listen > 0 && options.listen <= 65535 &&
+               (!script || load_script(script, options));
+    }
+
+    class Proxy {
+            Options m_options;
+            Totals m_totals;
+            std::mt19937 m_random;
+            int m_listener = -1;
+            std::vector<std::unique_ptr<Connection>> m_connections;
+            uint32_t m_accepted = 0;
+
+            bool roll(const uint32_t permille) {
+                return permille > 0 &&
+                       std::uniform_int_distribution<uint32_t>(0, 999)(
+                           m_random) < permille;
+            }
+
+            uint32_t uniform(const uint32_t min, const uint32_t max) {
+                return max > min ? std::uniform_int_distribution<uint32_t>(
+                                       min, max)(m_random)
+                                 : min;
+            }
+
+            const Profile &profileFor(uint32_t index) const {
+                for (const auto &[count, profile] : m_options.script) {
+                    if (count == 0 || index < count) {
+                        return profile;
+                    }
+                    index -= count;
+                }
+                return m_options.script.empty() ? m_options.base
+                                                : m_options.script.back().second;
+            }
+
+            void accept() {
+                while (true) {
+                    const int client = accept4(m_listener, nullptr, nullptr,
+                                               SOCK_NONBLOCK);
+                    if (client < 0) {
+                        return;
+                    }
+                    auto connection = std::make_unique<Connection>();
+                    connection->id = m_accepted;
+                    connection->profile = profileFor(m_accepted++);
+                    connection->client = client;
+                    connection->reset_armed =
+                        roll(connection->profile.rst_permille);
+                    set_nodelay(client);
+
+                    const int server = socket(AF_INET, SOCK_STREAM, 0);
+                    if (server < 0 || !set_nonblocking(server)) {
+                        close_abortive(client);
+                        if (server >= 0) {
+                            close(server);
+                        }
+                        continue;
+                    }
+                    set_nodelay(server);
+                    if (connect(server,
+                                reinterpret_cast<const sockaddr *>(
+                                    &m_options.target),
+                                sizeof(m_options.target)) < 0 &&
+                        errno != EINPROGRESS) {
+                        ++m_totals.refused;
+                        close_abortive(client);
+                        close(server);
+                        continue;
+                    }
+                    connection->server = server;
+                    connection->down.from = server;
+                    connection->down.to = client;
+                    connection->down.impaired = true;
+                    connection->up.from = client;
+                    connection->up.to = server;
+                    connection->up.impaired = connection->profile.upstream != 0;
+                    ++m_totals.connections;
+                    m_connections.push_back(std::move(connection));
+                }
+            }
+
+            /**
+             * @brief Queues @p size bytes read from the pipe's sender.
+             */
+            void enqueue(Connection &connection, Pipe &pipe, const char *data,
+                         const std::size_t size, const uint64_t now) {
+                const Profile &profile = connection.profile;
+                if (!pipe.impaired) {
+                    pipe.queue.push_back({now, std::string(data, size)});
+                    pipe.queued_bytes += size;
+                    pipe.last_at_us = now;
+                    return;
+                }
+                std::size_t offset = 0;
+                while (offset < size) {
+                    std::size_t take = size - offset;
+                    if (profile.segment_max > 0) {
+                        take = std::min<std::size_t>(
+                            take, uniform(std::max(profile.segment_min, 1u),
+                                          std::max(profile.segment_min,
+                                                   profile.segment_max)));
+                    }
+                    uint64_t at =
+                        now + profile.delay_us + uniform(0, profile.jitter_us);
+                    if (roll(profile.loss_permille)) {
+                        at += profile.rto_us;
+                        ++m_totals.lost;
+                    } else if (roll(profile.reorder_permille)) {
+                        at += profile.reorder_us;
+                        ++m_totals.reordered;
+                    }
+                    if (pipe.segments + pipe.queue.size() > 0) {
+                        at = std::max(at, pipe.last_at_us + profile.gap_us);
+                    }
+                    if (profile.rate_bps > 0) {
+                        const uint64_t start = std::max(at, pipe.link_free_us);
+                        pipe.link_free_us =
+                            start + take * 1000000ull / profile.rate_bps;
+                        at = pipe.link_free_us;
+                    }
+                    at = std::max(at, pipe.last_at_us);
+                    pipe.queue.push_back({at, std::string(data + offset, take)});
+                    pipe.queued_bytes += take;
+                    pipe.last_at_us = at;
+                    offset += take;
+                }
+            }
+
+            void reset(Connection &connection, const bool injected) {
+                close_abortive(connection.client);
+                close_abortive(connection.server);
+                connection.closed = true;
+                connection.was_reset = true;
+                ++(injected ? m_totals.resets : m_totals.peer_resets);
+            }
+
+            void read(Connection &connection, Pipe &pipe, const uint64_t now) {
+                if (pipe.eof) {
+                    return;
+                }
+                char chunk[READ_BYTES];
+                const ssize_t count = recv(pipe.from, chunk, sizeof(chunk), 0);
+                if (count > 0) {
+                    enqueue(connection, pipe, chunk,
+                            static_cast<std::size_t>(count), now);
+                    return;
+                }
+                if (count == 0) {
+                    pipe.eof = true;
+                    const uint32_t fin_delay =
+                        pipe.impaired ? connection.profile.fin_delay_us : 0;
+                    pipe.fin_at_us = std::max(pipe.last_at_us, now) + fin_delay;
+                    m_totals.fins_delayed += fin_delay > 0 ? 1 : 0;
+                    return;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    reset(connection, false);
+                }
+            }
+
+            /**
+             * @brief Sends the pipe's due segments, then its FIN once due.
+             */
+            void flush(Connection &connection, Pipe &pipe, const uint64_t now) {
+                while (!pipe.queue.empty() && pipe.queue.front().at_us <= now) {
+                    Segment &segment = pipe.queue.front();
+                    const ssize_t sent =
+                        send(pipe.to, segment.data.data() + segment.offset,
+                             segment.data.size() - segment.offset,
+                             MSG_NOSIGNAL);
+                    if (sent < 0) {
+                        if (errno != EAGAIN && errno != EWOULDBLOCK &&
+                            errno != EINTR) {
+                            reset(connection, false);
+                        }
+                        return;
+                    }
+                    segment.offset += static_cast<std::size_t>(sent);
+                    pipe.bytes += static_cast<std::size_t>(sent);
+                    if (segment.offset < segment.data.size()) {
+                        return;
+                    }
+                    pipe.queued_bytes -= segment.data.size();
+                    ++pipe.segments;
+                    pipe.queue.pop_front();
+                    if (&pipe == &connection.down && connection.reset_armed &&
+                        pipe.bytes >= connection.profile.rst_after_bytes) {
+                        reset(connection, true);
+                        return;
+                    }
+                }
+                if (pipe.eof && !pipe.shut && pipe.queue.empty() &&
+                    pipe.fin_at_us <= now) {
+                    shutdown(pipe.to, SHUT_WR);
+                    pipe.shut = true;
+                }
+            }
+
+            void finishConnect(Connection &connection) {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                getsockopt(connection.server, SOL_SOCKET, SO_ERROR, &error,
+                           &length);
+                if (error != 0) {
+                    // Pass the refusal on as a RST, as the server would have
+                    ++m_totals.refused;
+                    close_abortive(connection.client);
+                    close(connection.server);
+                    connection.closed = true;
+                    return;
+                }
+                connection.connecting = false;
+                if (connection.reset_armed &&
+                    connection.profile.rst_after_bytes == 0) {
+                    reset(connection, true);
+                }
+            }
+
+            void retire(const Connection &connection) {
+                m_totals.down_bytes += connection.down.bytes;
+                m_totals.down_segments += connection.down.segments;
+                m_totals.up_bytes += connection.up.bytes;
+                m_totals.up_segments += connection.up.segments;
+                if (m_options.verbose) {
+                    std::printf(
+                        "[PROXY] connection %lu: down %llu B/%llu segments, "
+                        "up %llu B/%llu segments, %s\n",
+                        static_cast<unsigned long>(connection.id),
+                        static_cast<unsigned long long>(connection.down.bytes),
+                        static_cast<unsigned long long>(
+                            connection.down.segments),
+                        static_cast<unsigned long long>(connection.up.bytes),
+                        static_cast<unsigned long long>(connection.up.segments),
+                        connection.was_reset ? "reset" : "closed");
+                }
+            }
+
+            /**
+             * @brief Time until the next segment or FIN falls due.
+             */
+            int64_t nextDueUs(const uint64_t now) const {
+                int64_t wait = 100000;
+                for (const auto &connection : m_connections) {
+                    for (const Pipe *pipe : {&connection->down, &connection->up}) {
+                        uint64_t at = UINT64_MAX;
+                        if (!pipe->queue.empty()) {
+                            at = pipe->queue.front().at_us;
+                        } else if (pipe->eof && !pipe->shut) {
+                            at = pipe->fin_at_us;
+                        }
+                        if (at != UINT64_MAX) {
+                            wait = std::min<int64_t>(
+                                wait, at > now ? static_cast<int64_t>(at - now)
+                                               : 0);
+                        }
+                    }
+                }
+                return wait;
+            }
+
+            bool done(const uint64_t now) const {
+                if (stop_requested) {
+                    return true;
+                }
+                if (m_options.duration_ms > 0 &&
+                    now >= m_options.duration_ms * 1000ull) {
+                    return true;
+                }
+                return m_options.connections > 0 &&
+                       m_accepted >= m_options.connections &&
+                       m_connections.empty();
+            }
+
+        public:
+            explicit Proxy(Options options)
+                : m_options(std::move(options)), m_random(m_options.seed) {}
+
+            bool listen() {
+                m_listener = socket(AF_INET, SOCK_STREAM, 0);
+                const int one = 1;
+                setsockopt(m_listener, SOL_SOCKET, SO_REUSEADDR, &one,
+                           sizeof(one));
+                sockaddr_in address{};
+                address.sin_family = AF_INET;
+                address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                address.sin_port = htons(static_cast<uint16_t>(m_options.listen));
+                if (m_listener < 0 || !set_nonblocking(m_listener) ||
+                    bind(m_listener, reinterpret_cast<sockaddr *>(&address),
+                         sizeof(address)) < 0 ||
+                    ::listen(m_listener, 64) < 0) {
+                    std::perror("listen");
+                    return false;
+                }
+                return true;
+            }
+
+            void run() {
+                std::vector<pollfd> fds;
+                while (!done(now_us())) {
+                    fds.clear();
+                    const bool accepting = m_options.connections == 0 ||
+                                           m_accepted < m_options.connections;
+                    fds.push_back({m_listener,
+                                   static_cast<short>(accepting ? POLLIN : 0), 0});
+                    for (const auto &connection : m_connections) {
+                        short client_events = 0;
+                        short server_events = 0;
+                        if (connection->connecting) {
+                            server_events = POLLOUT;
+                        } else {
+                            const Pipe &down = connection->down;
+                            const Pipe &up = connection->up;
+                            if (!down.eof && down.queued_bytes < MAX_QUEUED_BYTES) {
+                                server_events |= POLLIN;
+                            }
+                            if (!up.eof && up.queued_bytes < MAX_QUEUED_BYTES) {
+                                client_events |= POLLIN;
+                            }
+                            // A segment part-sent is waiting for buffer space
+                            if (!down.queue.empty() && down.queue.front().offset > 0) {
+                                client_events |= POLLOUT;
+                            }
+                            if (!up.queue.empty() && up.queue.front().offset > 0) {
+                                server_events |= POLLOUT;
+                            }
+                        }
+                        // poll() skips negative descriptors, so a socket that
+                        // has hung up does not wake the loop while it waits
+                        fds.push_back({client_events ? connection->client : -1,
+                                       client_events, 0});
+                        fds.push_back({server_events ? connection->server : -1,
+                                       server_events, 0});
+                    }
+
+                    const int64_t wait_us = nextDueUs(now_us());
+                    const timespec timeout{
+                        static_cast<time_t>(wait_us / 1000000),
+                        static_cast<long>(wait_us % 1000000 * 1000)};
+                    if (ppoll(fds.data(), fds.size(), &timeout, nullptr) < 0 &&
+                        errno != EINTR) {
+                        std::perror("ppoll");
+                        return;
+                    }
+
+                    const uint64_t now = now_us();
+                    if (fds[0].revents & POLLIN) {
+                        accept();
+                    }
+                    // Connections accepted above have no pollfd yet
+                    for (std::size_t i = 0; 1 + 2 * i < fds.size(); ++i) {
+                        Connection &connection = *m_connections[i];
+                        const short client_revents = fds[1 + 2 * i].revents;
+                        const short server_revents = fds[2 + 2 * i].revents;
+                        if (connection.connecting) {
+                            if (server_revents & (POLLOUT | POLLERR | POLLHUP)) {
+                                finishConnect(connection);
+                            }
+                            continue;
+                        }
+                        if (server_revents & (POLLIN | POLLHUP | POLLERR) &&
+                            !connection.closed) {
+                            read(connection, connection.down, now);
+                        }
+                        if (client_revents & (POLLIN | POLLHUP | POLLERR) &&
+                            !connection.closed) {
+                            read(connection, connection.up, now);
+                        }
+                    }
+                    for (auto &connection : m_connections) {
+                        if (!connection->closed && !connection->connecting) {
+                            flush(*connection, connection->down, now);
+                        }
+                        if (!connection->closed && !connection->connecting) {
+                            flush(*connection, connection->up, now);
+                        }
+                        if (!connection->closed && connection->down.shut &&
+                            connection->up.shut) {
+                            close(connection->client);
+                            close(connection->server);
+                            connection->closed = true;
+                        }
+                    }
+                    m_connections.erase(
+                        std::remove_if(m_connections.begin(),
+                                       m_connections.end(),
+                                       [this](const auto &connection) {
+                                           if (connection->closed) {
+                                               retire(*connection);
+                                           }
+                                           return connection->closed;
+                                       }),
+                        m_connections.end());
+                }
+            }
+
+            void printSummary() const {
+                std::printf(
+                    "[PROXY] connections %lu refused %lu, down %llu B in %llu "
+                    "segments, up %llu B in %llu segments, lost %lu "
+                    "reordered %lu, fins delayed %lu, resets injected %lu "
+                    "by peer %lu\n",
+                    static_cast<unsigned long>(m_totals.connections),
+                    static_cast<unsigned long>(m_totals.refused),
+                    static_cast<unsigned long long>(m_totals.down_bytes),
+                    static_cast<unsigned long long>(m_totals.down_segments),
+                    static_cast<unsigned long long>(m_totals.up_bytes),
+                    static_cast<unsigned long long>(m_totals.up_segments),
+                    static_cast<unsigned long>(m_totals.lost),
+                    static_cast<unsigned long>(m_totals.reordered),
+                    static_cast<unsigned long>(m_totals.fins_delayed),
+                    static_cast<unsigned long>(m_totals.resets),
+                    static_cast<unsigned long>(m_totals.peer_resets));
+                std::fflush(stdout);
+            }
+    };
+
+    void request_stop(int) { stop_requested = 1; }
+
+} // namespace
+
+int main(const int argc, char **argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr,
+                     "usage: %s [--listen=port] [--target=host:port] "
+                     "[--name=value ...] [--script=file] [--verbose]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    Proxy proxy(std::move(options));
+    if (!proxy.listen()) {
+        return EXIT_FAILURE;
+    }
+    proxy.run();
+    proxy.printSummary();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file QuoteIndex.hpp
+ * @brief The quotes of a fortune file for the stand-in servers.
+ *
+ * A fortune file holds quotes separated by lines of a single "%". The
+ * file is memory-mapped once and indexed into offset and length pairs;
+ * the trailing newlines of each quote are not part of it, and quotes are
+ * cut to MAX_QUOTE_BYTES. A last quote without a closing "%" line, and a
+ * closing "%" line without a final newline, are both accepted.
+ *
+ * @author Goran
+ * @date 2025-09-27
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace e5::servers {
+
+    constexpr std::size_t MAX_QUOTE_BYTES = 512;
+
+    /**
+     * @brief The quotes of a fortune file: entries ending in a "%" line.
+     */
+    class QuoteIndex {
+            const char *m_data = nullptr;
+            std::size_t m_size = 0;
+            bool m_mapped = false;
+            std::vector<std::pair<uint32_t, uint32_t>> m_quotes; ///< Offset, length
+
+            void add(const std::size_t start, std::size_t end) {
+                while (end > start &&
+                       (m_data[end - 1] == '\n' || m_data[end - 1] == '\r')) {
+                    --end;
+                }
+                if (end > start) {
+                    m_quotes.emplace_back(
+                        static_cast<uint32_t>(start),
+                        static_cast<uint32_t>(
+                            std::min(end - start, MAX_QUOTE_BYTES)));
+                }
+            }
+
+        public:
+            QuoteIndex() = default;
+            QuoteIndex(const QuoteIndex &) = delete;
+            QuoteIndex &operator=(const QuoteIndex &) = delete;
+
+            ~QuoteIndex() {
+                if (m_mapped) {
+                    munmap(const_cast<char *>(m_data), m_size);
+                }
+            }
+
+            /**
+             * @brief Maps the file at @p path and indexes its quotes.
+             * @return false if the file cannot be read or holds no quote
+             */
+            bool load(const char *path) {
+                const int fd = open(path, O_RDONLY);
+                struct stat info{};
+                if (fd < 0 || fstat(fd, &info) < 0 || info.st_size == 0) {
+                    if (fd >= 0) {
+                        close(fd);
+                    }
+                    return false;
+                }
+                const auto size = static_cast<std::size_t>(info.st_size);
+                void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                close(fd);
+                if (map == MAP_FAILED) {
+                    return false;
+                }
+                m_mapped = true;
+                return index(static_cast<const char *>(map), size);
+            }
+
+            /**
+             * @brief Indexes the quotes of @p size bytes at @p data.
+             *
+             * The data is not copied and must outlive the index.
+             * @return false if the data holds no quote
+             */
+            bool index(const char *data, const std::size_t size) {
+                m_data = data;
+                m_size = size;
+                m_quotes.clear();
+
+                std::size_t start = 0;
+                std::size_t line = 0;
+                while (line < m_size) {
+                    const void *newline =
+                        std::memchr(m_data + line, '\n', m_size - line);
+                    const std::size_t end =
+                        newline ? static_cast<const char *>(newline) - m_data
+                                : m_size;
+                    // A "%" line closes a quote, with or without a newline
+                    if (end - line == 1 && m_data[line] == '%') {
+                        add(start, line);
+                        start = end + 1;
+                    }
+                    line = end + 1;
+                }
+                if (start < m_size) {
+                    add(start, m_size); // A last quote without a "%" line
+                }
+                return !m_quotes.empty();
+            }
+
+            [[nodiscard]] std::size_t size() const { return m_quotes.size(); }
+
+            [[nodiscard]] std::pair<const char *, std::size_t>
+            quote(const std::size_t index) const {
+                const auto &[offset, length] = m_quotes[index % m_quotes.size()];
+                return {m_data + offset, length};
+            }
+    };
+
+} // namespace e5::servers
@@ -0,0 +1,620 @@
+/*
+ * AsyncTCPClient Stand-in Servers
+ *
+ * One epoll process serving the protocols the application talks to, fast
+ * enough that the board, not the fixture, limits a load run:
+ *
+ *   qotd     RFC 865: a quote, then close
+ *   batch    the extended batch mode: K length-prefixed quotes, then close
+ *   echo     RFC 862: everything received is sent back
+ *   chargen  RFC 864: 72-character lines until the client closes
+ *   discard  RFC 863: everything received is dropped
+ *
+ * Quotes come from a fortune file (scripts/quotes.txt), memory-mapped and
+ * indexed once at start. Quotes are served the way scripts/qotd_server.bash
+ * serves them offline: RFC 865 quotes end in a newline, batch records do
+ * not, and both are cut to 512 bytes.
+ *
+ * Usage: e5_servers [--name=value ...] [--events] [--quiet]
+ *
+ *   --qotd, --batch, --echo, --chargen, --discard
+ *                        ports; 0 disables a service
+ *                        (default 10017, 1717, 10007, 10019, 10009)
+ *   --bind               listen address (default 0.0.0.0)
+ *   --quotes             quote file (default scripts/quotes.txt)
+ *   --batch_quotes       quotes per batch connection (default 8)
+ *   --qotd_delay_ms      delay before a QOTD or batch reply
+ *   --chargen_bytes      bytes per chargen connection; 0 unlimited
+ *   --report_ms          interval of the [SRV] totals lines; 0 only at exit
+ *   --seed               quote order; 0 serves the quotes in file order
+ *   --events             a timestamped line per accept, read, write and close
+ *   --quiet              no per-connection lines
+ *
+ * Each connection prints a line as it closes: service, number, peer,
+ * bytes in and out, time to first byte out, lifetime and how it ended.
+ * Timestamps are seconds since start on the monotonic clock; the first
+ * line gives the wall-clock time of the start. SIGINT or SIGTERM prints
+ * the totals and exits.
+ */
+#include "QuoteIndex.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <queue>
+#include <random>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using e5::servers::QuoteIndex;
+
+    enum class Service : uint8_t { QOTD, BATCH, ECHO, CHARGEN, DISCARD };
+    constexpr std::size_t SERVICES = 5;
+    constexpr const char *SERVICE_NAMES[SERVICES] = {"qotd", "batch", "echo",
+                                                     "chargen", "discard"};
+
+    constexpr std::size_t READ_BYTES = 65536;
+    constexpr std::size_t MAX_PENDING_BYTES = 262144; ///< Echo backlog cap
+    constexpr std::size_t CHARGEN_LINE = 72;
+
+    struct Options {
+            uint32_t ports[SERVICES] = {10017, 1717, 10007, 10019, 10009};
+            in_addr bind{};
+            std::string quotes = "scripts/quotes.txt";
+            uint32_t batch_quotes = 8;
+            uint32_t qotd_delay_ms = 0;
+            uint32_t chargen_bytes = 0;
+            uint32_t report_ms = 0;
+            uint32_t seed = 1;
+            bool events = false;
+            bool quiet = false;
+    };
+
+    struct Connection {
+            uint64_t id = 0;
+            int fd = -1;
+            Service service = Service::QOTD;
+            sockaddr_in peer{};
+            uint64_t accepted_us = 0;
+            uint64_t first_out_us = 0;
+            uint64_t bytes_in = 0;
+            uint64_t bytes_out = 0;
+            std::string outbox;
+            std::size_t out_offset = 0;
+            uint32_t chargen_line = 0;
+            bool close_when_sent = false;
+            bool writing = false; ///< EPOLLOUT registered
+            bool reading = true;  ///< EPOLLIN registered
+    };
+
+    struct ServiceTotals {
+            uint64_t connections = 0;
+            uint64_t resets = 0;
+            uint64_t bytes_in = 0;
+            uint64_t bytes_out = 0;
+            uint32_t active = 0;
+            uint32_t max_active = 0;
+    };
+
+    volatile std::sig_atomic_t stop_requested = 0;
+
+    uint64_t now_us() {
+        static const auto start = std::chrono::steady_clock::now();
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+    }
+
+    bool set_nonblocking(const int fd) {
+        const int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    bool parse(const int argc, char **argv, Options &options) {
+        const std::pair<const char *, uint32_t *> fields[] = {
+            {"qotd", &options.ports[0]},
+            {"batch", &options.ports[1]},
+            {"echo", &options.ports[2]},
+            {"chargen", &options.ports[3]},
+            {"discard", &options.ports[4]},
+            {"batch_quotes", &options.batch_quotes},
+            {"qotd_delay_ms", &options.qotd_delay_ms},
+            {"chargen_bytes", &options.chargen_bytes},
+            {"report_ms", &options.report_ms},
+            {"seed", &options.seed},
+        };
+        options.bind.s_addr = htonl(INADDR_ANY);
+        for (int i = 1; i < argc; ++i) {
+            const char *arg = argv[i];
+            if (std::strcmp(arg, "--events") == 0) {
+                options.events = true;
+                continue;
+            }
+            if (std::strcmp(arg, "--quiet") == 0) {
+                options.quiet = true;
+                continue;
+            }
+            if (std::strncmp(arg, "--quotes=", 9) == 0) {
+                options.quotes = arg + 9;
+                continue;
+            }
+            if (std::strncmp(arg, "--bind=", 7) == 0) {
+                if (inet_pton(AF_INET, arg + 7, &options.bind) != 1) {
+                    std::fprintf(stderr, "bad address %s\n", arg + 7);
+                    return false;
+                }
+                continue;
+            }
+            const char *equals = std::strchr(arg, '=');
+            bool known = false;
+            for (const auto &[name, value] : fields) {
+                if (equals && std::strncmp(arg, "--", 2) == 0 &&
+                    std::strlen(name) == static_cast<std::size_t>(equals - arg - 2) &&
+                    std::strncmp(arg + 2, name, equals - arg - 2) == 0) {
+                    *value = static_cast<uint32_t>(std::strtoul(equals + 1, nullptr, 10));
+                    known = true;
+                }
+            }
+            if (!known) {
+                std::fprintf(stderr, "unknown option %s\n", arg);
+                return false;
+            }
+        }
+        return std::all_of(std::begin(options.ports), std::end(options.ports),
+                           [](const uint32_t port) { return port <= 65535; }) &&
+               options.batch_quotes <= 65535;
+    }
+
+    class Servers {
+            Options m_options;
+            QuoteIndex m_quotes;
+            std::mt19937 m_random;
+            uint64_t m_next_quote = 0;
+            int m_epoll = -1;
+            int m_listeners[SERVICES] = {-1, -1, -1, -1, -1};
+            std::vector<std::unique_ptr<Connection>> m_by_fd;
+            uint64_t m_accepted = 0;
+            ServiceTotals m_totals[SERVICES];
+
+            /// Delayed QOTD replies: due time, then fd and connection number
+            using Timer = std::pair<uint64_t, std::pair<int, uint64_t>>;
+            std::priority_queue<Timer, std::vector<Timer>, std::greater<>>
+                m_timers;
+
+            void event(const Connection &connection, const char *what,
+                       const std::size_t bytes) const {
+                if (m_options.events) {
+                    std::printf("[SRV] %.6f %s #%llu %s %zu\n", now_us() / 1e6,
+                                SERVICE_NAMES[static_cast<int>(connection.service)],
+                                static_cast<unsigned long long>(connection.id),
+                                what, bytes);
+                }
+            }
+
+            std::pair<const char *, std::size_t> nextQuote() {
+                const std::size_t index =
+                    m_options.seed == 0
+                        ? m_next_quote++
+                        : std::uniform_int_distribution<std::size_t>(
+                              0, m_quotes.size() - 1)(m_random);
+                return m_quotes.quote(index);
+            }
+
+            void watch(Connection &connection, const bool read,
+                       const bool write) {
+                if (connection.reading == read && connection.writing == write) {
+                    return;
+                }
+                // A level-triggered EPOLLRDHUP would fire on every wait while
+                // the connection is not reading, so it goes with EPOLLIN
+                epoll_event ev{};
+                ev.events = read ? EPOLLIN | EPOLLRDHUP : 0u;
+                ev.events |= write ? static_cast<uint32_t>(EPOLLOUT) : 0u;
+                ev.data.fd = connection.fd;
+                epoll_ctl(m_epoll, EPOLL_CTL_MOD, connection.fd, &ev);
+                connection.reading = read;
+                connection.writing = write;
+            }
+
+            void finish(Connection &connection, const bool reset) {
+                auto &totals = m_totals[static_cast<int>(connection.service)];
+                --totals.active;
+                totals.resets += reset ? 1 : 0;
+                event(connection, reset ? "reset" : "close", 0);
+                if (!m_options.quiet) {
+                    char peer[INET_ADDRSTRLEN] = {};
+                    inet_ntop(AF_INET, &connection.peer.sin_addr, peer,
+                              sizeof(peer));
+                    const uint64_t now = now_us();
+                    std::printf(
+                        "[SRV] %.6f %s #%llu %s:%u in %llu B out %llu B, "
+                        "first out %.3f ms, lifetime %.3f ms, %s\n",
+                        now / 1e6,
+                        SERVICE_NAMES[static_cast<int>(connection.service)],
+                        static_cast<unsigned long long>(connection.id), peer,
+                        ntohs(connection.peer.sin_port),
+                        static_cast<unsigned long long>(connection.bytes_in),
+                        static_cast<unsigned long long>(connection.bytes_out),
+                        connection.first_out_us
+                            ? (connection.first_out_us - connection.accepted_us) /
+                                  1e3
+                            : 0.0,
+                        (now - connection.accepted_us) / 1e3,
+                        reset ? "reset" : "closed");
+                }
+                close(connection.fd);
+                m_by_fd[connection.fd].reset();
+            }
+
+            /**
+             * @brief Queues a service's reply: a quote or a batch of them.
+             */
+            void reply(Connection &connection) {
+                if (connection.service == Service::QOTD) {
+                    const auto [text, length] = nextQuote();
+                    connection.outbox.assign(text, length);
+                    connection.outbox += '\n';
+                } else {
+                    connection.outbox.clear();
+                    for (uint32_t i = 0; i < m_options.batch_quotes; ++i) {
+                        const auto [text, length] = nextQuote();
+                        connection.outbox += static_cast<char>(length >> 8);
+                        connection.outbox += static_cast<char>(length & 0xFF);
+                        connection.outbox.append(text, length);
+                    }
+                }
+                connection.close_when_sent = true;
+                flush(connection);
+            }
+
+            /**
+             * @brief Appends chargen lines up to about @p bytes.
+             */
+            void generate(Connection &connection, std::size_t bytes) {
+                if (m_options.chargen_bytes > 0) {
+                    const uint64_t left =
+                        m_options.chargen_bytes - connection.bytes_out;
+                    bytes = std::min<uint64_t>(bytes, left);
+                    connection.close_when_sent = bytes == left;
+                }
+                while (bytes > 0) {
+                    char line[CHARGEN_LINE + 2];
+                    for (std::size_t i = 0; i < CHARGEN_LINE; ++i) {
+                        line[i] = static_cast<char>(
+                            ' ' + (connection.chargen_line + i) % 95);
+                    }
+                    line[CHARGEN_LINE] = '\r';
+                    line[CHARGEN_LINE + 1] = '\n';
+                    const std::size_t take = std::min(bytes, sizeof(line));
+                    connection.outbox.append(line, take);
+                    bytes -= take;
+                    ++connection.chargen_line;
+                }
+            }
+
+            /**
+             * @brief Sends the outbox until it is empty or the socket is
+             * full; refills it for chargen.
+             *
+             * @return false if the connection was finished
+             */
+            bool flush(Connection &connection) {
+                while (true) {
+                    if (connection.out_offset == connection.outbox.size()) {
+                        connection.outbox.clear();
+                        connection.out_offset = 0;
+                        if (connection.close_when_sent) {
+                            finish(connection, false);
+                            return false;
+                        }
+                        if (connection.service != Service::CHARGEN) {
+                            watch(connection, true, false);
+                            return true;
+                        }
+                        generate(connection, READ_BYTES);
+                        if (connection.outbox.empty()) {
+                            finish(connection, false);
+                            return false;
+                        }
+                    }
+                    const ssize_t sent =
+                        send(connection.fd,
+                             connection.outbox.data() + connection.out_offset,
+                             connection.outbox.size() - connection.out_offset,
+                             MSG_NOSIGNAL);
+                    if (sent < 0) {
+                        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                            // Echo stops reading while its backlog is full
+                            watch(connection,
+                                  connection.service != Service::ECHO ||
+                                      connection.outbox.size() -
+                                              connection.out_offset <
+                                          MAX_PENDING_BYTES,
+                                  true);
+                            return true;
+                        }
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        finish(connection, true);
+                        return false;
+                    }
+                    if (connection.first_out_us == 0) {
+                        connection.first_out_us = now_us();
+                    }
+                    connection.out_offset += static_cast<std::size_t>(sent);
+                    connection.bytes_out += static_cast<uint64_t>(sent);
+                    m_totals[static_cast<int>(connection.service)].bytes_out +=
+                        static_cast<uint64_t>(sent);
+                    event(connection, "tx", static_cast<std::size_t>(sent));
+                }
+            }
+
+            void receive(Connection &connection) {
+                char chunk[READ_BYTES];
+                const ssize_t count = recv(connection.fd, chunk, sizeof(chunk), 0);
+                if (count < 0) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                        finish(connection, true);
+                    }
+                    return;
+                }
+                if (count == 0) {
+                    if (connection.close_when_sent) {
+                        return;
+                    }
+                    event(connection, "fin", 0);
+                    if (connection.service == Service::ECHO &&
+                        connection.out_offset < connection.outbox.size()) {
+                        // Send back what is left, then close
+                        connection.close_when_sent = true;
+                        watch(connection, false, true);
+                        return;
+                    }
+                    finish(connection, false);
+                    return;
+                }
+                connection.bytes_in += static_cast<uint64_t>(count);
+                m_totals[static_cast<int>(connection.service)].bytes_in +=
+                    static_cast<uint64_t>(count);
+                event(connection, "rx", static_cast<std::size_t>(count));
+                if (connection.service == Service::ECHO) {
+                    connection.outbox.append(chunk, static_cast<std::size_t>(count));
+                    flush(connection);
+                }
+            }
+
+            void accept(const Service service) {
+                const int listener = m_listeners[static_cast<int>(service)];
+                while (true) {
+                    sockaddr_in peer{};
+                    socklen_t length = sizeof(peer);
+                    const int fd =
+                        accept4(listener, reinterpret_cast<sockaddr *>(&peer),
+                                &length, SOCK_NONBLOCK);
+                    if (fd < 0) {
+                        return;
+                    }
+                    const int one = 1;
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    if (static_cast<std::size_t>(fd) >= m_by_fd.size()) {
+                        m_by_fd.resize(fd + 1);
+                    }
+                    m_by_fd[fd] = std::make_unique<Connection>();
+                    Connection &connection = *m_by_fd[fd];
+                    connection.id = ++m_accepted;
+                    connection.fd = fd;
+                    connection.service = service;
+                    connection.peer = peer;
+                    connection.accepted_us = now_us();
+                    auto &totals = m_totals[static_cast<int>(service)];
+                    ++totals.connections;
+                    totals.max_active = std::max(totals.max_active, ++totals.active);
+
+                    epoll_event ev{};
+                    ev.events = EPOLLIN | EPOLLRDHUP;
+                    ev.data.fd = fd;
+                    epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &ev);
+                    event(connection, "accept", 0);
+
+                    if (service == Service::QOTD || service == Service::BATCH) {
+                        if (m_options.qotd_delay_ms > 0) {
+                            m_timers.push({connection.accepted_us +
+                                               m_options.qotd_delay_ms * 1000ull,
+                                           {fd, connection.id}});
+                        } else {
+                            reply(connection);
+                        }
+                    } else if (service == Service::CHARGEN) {
+                        flush(connection);
+                    }
+                }
+            }
+
+            void runTimers(const uint64_t now) {
+                while (!m_timers.empty() && m_timers.top().first <= now) {
+                    const auto [fd, id] = m_timers.top().second;
+                    m_timers.pop();
+                    // The client may have gone, and its fd been reused
+                    if (auto &connection = m_by_fd[fd];
+                        connection && connection->id == id) {
+                        reply(*connection);
+                    }
+                }
+            }
+
+            int timeoutMs(const uint64_t now, const uint64_t next_report) const {
+                uint64_t due = next_report;
+                if (!m_timers.empty()) {
+                    due = std::min(due, m_timers.top().first);
+                }
+                return due == UINT64_MAX ? -1
+                       : due <= now      ? 0
+                                    : static_cast<int>((due - now + 999) / 1000);
+            }
+
+        public:
+            explicit Servers(Options options)
+                : m_options(std::move(options)), m_random(m_options.seed) {}
+
+            bool start() {
+                if ((m_options.ports[0] || m_options.ports[1]) &&
+                    !m_quotes.load(m_options.quotes.c_str())) {
+                    std::fprintf(stderr, "no quotes in %s\n",
+                                 m_options.quotes.c_str());
+                    return false;
+                }
+                m_epoll = epoll_create1(0);
+                if (m_epoll < 0) {
+                    std::perror("epoll_create1");
+                    return false;
+                }
+                for (std::size_t i = 0; i < SERVICES; ++i) {
+                    if (m_options.ports[i] == 0) {
+                        continue;
+                    }
+                    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+                    const int one = 1;
+                    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+                    sockaddr_in address{};
+                    address.sin_family = AF_INET;
+                    address.sin_addr = m_options.bind;
+                    address.sin_port =
+                        htons(static_cast<uint16_t>(m_options.ports[i]));
+                    if (fd < 0 || !set_nonblocking(fd) ||
+                        bind(fd, reinterpret_cast<sockaddr *>(&address),
+                             sizeof(address)) < 0 ||
+                        listen(fd, SOMAXCONN) < 0) {
+                        std::fprintf(stderr, "%s port %u: %s\n", SERVICE_NAMES[i],
+                                     m_options.ports[i], std::strerror(errno));
+                        return false;
+                    }
+                    m_listeners[i] = fd;
+                    epoll_event ev{};
+                    ev.events = EPOLLIN;
+                    ev.data.fd = fd;
+                    epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &ev);
+                }
+
+                char started[32];
+                const std::time_t wall = std::time(nullptr);
+                std::strftime(started, sizeof(started), "%Y-%m-%dT%H:%M:%S%z",
+                              std::localtime(&wall));
+                std::printf("[SRV] 0.000000 started %s, %zu quotes, ports", started,
+                            m_quotes.size());
+                for (std::size_t i = 0; i < SERVICES; ++i) {
+                    if (m_options.ports[i]) {
+                        std::printf(" %s %u", SERVICE_NAMES[i], m_options.ports[i]);
+                    }
+                }
+                std::printf("\n");
+                now_us();
+                return true;
+            }
+
+            void run() {
+                epoll_event events[256];
+                const uint64_t report_us = m_options.report_ms * 1000ull;
+                uint64_t next_report = report_us ? report_us : UINT64_MAX;
+                while (!stop_requested) {
+                    const int ready = epoll_wait(m_epoll, events, 256,
+                                                 timeoutMs(now_us(), next_report));
+                    if (ready < 0 && errno != EINTR) {
+                        std::perror("epoll_wait");
+                        return;
+                    }
+                    for (int i = 0; i < ready; ++i) {
+                        const int fd = events[i].data.fd;
+                        const auto *listener =
+                            std::find(std::begin(m_listeners), std::end(m_listeners), fd);
+                        if (listener != std::end(m_listeners)) {
+                            accept(static_cast<Service>(listener - m_listeners));
+                            continue;
+                        }
+                        // An earlier event of this batch may have closed it
+                        if (static_cast<std::size_t>(fd) >= m_by_fd.size() ||
+                            !m_by_fd[fd]) {
+                            continue;
+                        }
+                        Connection &connection = *m_by_fd[fd];
+                        if (events[i].events & EPOLLOUT && !flush(connection)) {
+                            continue;
+                        }
+                        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR) &&
+                            m_by_fd[fd]) {
+                            receive(connection);
+                        }
+                    }
+                    const uint64_t now = now_us();
+                    runTimers(now);
+                    if (now >= next_report) {
+                        printTotals(now);
+                        next_report += report_us;
+                    }
+                }
+            }
+
+            void printTotals(const uint64_t now) const {
+                for (std::size_t i = 0; i < SERVICES; ++i) {
+                    if (m_options.ports[i] == 0) {
+                        continue;
+                    }
+                    const auto &totals = m_totals[i];
+                    std::printf(
+                        "[SRV] %.6f %s totals: connections %llu (%.1f/s), "
+                        "active %u max %u, resets %llu, in %llu B, out %llu B\n",
+                        now / 1e6, SERVICE_NAMES[i],
+                        static_cast<unsigned long long>(totals.connections),
+                        now ? totals.connections * 1e6 / now : 0.0, totals.active,
+                        totals.max_active,
+                        static_cast<unsigned long long>(totals.resets),
+                        static_cast<unsigned long long>(totals.bytes_in),
+                        static_cast<unsigned long long>(totals.bytes_out));
+                }
+                std::fflush(stdout);
+            }
+    };
+
+    void request_stop(int) { stop_requested = 1; }
+
+} // namespace
+
+int main(const int argc, char **argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr,
+                     "usage: %s [--qotd=port] [--batch=port] [--echo=port] "
+                     "[--chargen=port] [--discard=port] [--name=value ...] "
+                     "[--events] [--quiet]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    Servers servers(std::move(options));
+    if (!servers.start()) {
+        return EXIT_FAILURE;
+    }
+    servers.run();
+    servers.printTotals(now_us());
+    return EXIT_SUCCESS;
+}
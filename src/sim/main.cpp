@@ -0,0 +1,463 @@
+/*
+ * AsyncTCPClient Simulation Driver
+ *
+ * Runs the QOTD/echo application in the discrete-event simulator of the
+ * host library (host/AsyncTcpHost/Simulator.hpp): the real handlers,
+ * connection managers, QuoteBuffer and SerialPrinter on two virtual cores,
+ * against a modelled network and UART. Each run builds the application
+ * afresh, as setup() and setup1() do, and runs a number of QOTD race cycles
+ * with the loop() cadence. Runs are seeded; run i uses seed + i.
+ *
+ * Usage: e5_sim [--name=value ...] [--trace] [--uart] [--no-shuffle]
+ *
+ *   --runs, --seed, --cycles    runs, first seed, QOTD cycles per run
+ *   --loop_period_us            virtual time between loop() passes
+ *   --qotd_interval_us          QOTD tick, as scheduler0's qotd entry
+ *   --echo_interval_us          echo tick
+ *   any SimConfig field         e.g. --uart_baud=921600 --segment_bytes=64
+ *   --trace                     prints every event (use with --runs=1)
+ *   --uart                      prints Serial1 output
+ *
+ * The report gives, over all runs, the latency from connect() to each
+ * cycle stage as log2 histogram percentiles, and counters that flag
+ * anomalies such as echoed text that matches no served quote.
+ */
+#include "ConnectionManager.hpp"
+#include "ConnectionTable.hpp"
+#include "ContextManager.hpp"
+#include "CycleTimeline.hpp"
+#include "EchoConnectedHandler.hpp"
+#include "EchoReceivedHandler.hpp"
+#include "EndpointRace.hpp"
+#include "EndpointSelector.hpp"
+#include "Log2Histogram.hpp"
+#include "LoopScheduler.hpp"
+#include "PrintHandler.hpp"
+#include "PriorityDispatcher.hpp"
+#include "QotdConfig.hpp"
+#include "QotdConnectedHandler.hpp"
+#include "QotdFinHandler.hpp"
+#include "QotdReceivedHandler.hpp"
+#include "QuoteBuffer.hpp"
+#include "QuoteClaim.hpp"
+#include "SerialPrinter.hpp"
+#include "Simulator.hpp"
+#include "TcpAckHandler.hpp"
+#include "TcpClient.hpp"
+#include "TcpErrorHandler.hpp"
+#include "TcpPollHandler.hpp"
+#include "TcpWriter.hpp"
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace async_tcp;
+
+// Global configuration values for QOTD test app
+std::size_t QOTD_PARTIAL_CONSUMPTION_THRESHOLD = 88;
+
+namespace {
+
+    constexpr uint16_t qotd_port = 17;
+    constexpr uint16_t echo_port = 7;
+    constexpr uint8_t qotd = 0;
+    constexpr uint8_t echo = 1;
+
+    struct Scenario {
+            uint32_t runs = 100;
+            uint32_t seed = 1;
+            uint32_t cycles = 20;
+            uint32_t loop_period_us = 100;
+            uint32_t loop_cost_us = 2;
+            uint32_t qotd_interval_us = 80000;
+            uint32_t echo_interval_us = 30000;
+            uint32_t drain_us = 100000; ///< Run time after the last cycle
+            bool trace = false;
+            bool uart = false;
+    };
+
+    using StageHistogram = e5::Log2Histogram<24>;
+
+    struct Report {
+            StageHistogram stages[static_cast<std::size_t>(e5::CycleStage::COUNT)];
+            uint64_t cycles = 0;
+            uint64_t completed = 0;
+            uint64_t failed = 0;
+            uint64_t unprinted = 0; ///< Completed cycles whose echo was never printed
+            uint64_t virtual_us = 0;
+            SimStats sim{};
+
+            void add(const e5::CycleRecord &record) {
+                const uint32_t start = record.at(e5::CycleStage::CONNECT);
+                for (std::size_t i = 1; i < std::size(stages); ++i) {
+                    if (const uint32_t at = record.stage_us[i]; at != 0) {
+                        stages[i].add(at - start);
+                    }
+                }
+                if (record.at(e5::CycleStage::COMPLETE) != 0 &&
+                    record.at(e5::CycleStage::PRINTED) == 0) {
+                    ++unprinted;
+                }
+            }
+
+            void add(const SimStats &stats) {
+                sim.events += stats.events;
+                sim.connects += stats.connects;
+                sim.refused += stats.refused;
+                sim.aborts += stats.aborts;
+                sim.quotes_served += stats.quotes_served;
+                sim.segments += stats.segments;
+                sim.echo_writes += stats.echo_writes;
+                sim.echo_mismatches += stats.echo_mismatches;
+                sim.xcore_calls += stats.xcore_calls;
+                sim.xcore_wait_us += stats.xcore_wait_us;
+                sim.uart_bytes += stats.uart_bytes;
+                sim.uart_stall_us += stats.uart_stall_us;
+            }
+    };
+
+    /**
+     * @brief One instance of the application, wired as setup() does.
+     */
+    struct App {
+            Simulator &sim;
+            const Scenario &scenario;
+
+            AsyncCtx ctx0;
+            AsyncCtx ctx1;
+            TcpClient qotd_client;
+            TcpClient qotd_client_alt;
+            TcpClient echo_client;
+
+            e5::EndpointSelector qotd_endpoints;
+            e5::QuoteBuffer qotd_buffer{ctx1};
+            e5::SerialPrinter serial_printer{ctx1};
+            e5::PriorityDispatcher dispatcher0{ctx0};
+            e5::PriorityDispatcher dispatcher1{ctx1};
+            e5::ConnectionTable connections;
+            e5::CycleTimeline cycle_timeline;
+
+            e5::TcpAckHandler ack_handler{connections};
+            e5::TcpErrorHandler error_handler{connections};
+            e5::TcpPollHandler poll_handler{connections};
+            e5::EchoConnectedHandler echo_connected_handler{connections,
+                                                            serial_printer};
+            e5::EchoReceivedHandler echo_received_handler{
+                connections, serial_printer, qotd_buffer};
+            e5::QuoteClaim qotd_claim;
+            e5::QotdConnectedHandler qotd_connected_handler{
+                connections, serial_printer, qotd_buffer, &qotd_claim};
+            e5::QotdReceivedHandler qotd_received_handler{
+                connections, qotd_buffer, &qotd_claim};
+            e5::QotdFinHandler qotd_fin_handler{connections, qotd_buffer,
+                                                &qotd_claim};
+
+            e5::ConnectionManager qotd_manager{
+                connections, qotd_client, IPAddress(10, 0, 0, 17), qotd_port,
+                e5::ConnectionMode::PER_CYCLE};
+            e5::ConnectionManager qotd_manager_alt{
+                connections, qotd_client_alt, IPAddress(10, 0, 0, 17),
+                qotd_port, e5::ConnectionMode::PER_CYCLE};
+            e5::ConnectionManager echo_manager{
+                connections, echo_client, IPAddress(10, 0, 0, 7), echo_port,
+                e5::ConnectionMode::PERSISTENT};
+            e5::EndpointRace qotd_race{qotd_endpoints};
+            e5::LoopScheduler scheduler0;
+
+            Report &report;
+            uint64_t done_at = 0; ///< When the last cycle ended; 0 = running
+
+            App(Simulator &simulator, const Scenario &settings, Report &out)
+                : sim(simulator), scenario(settings), report(out) {
+                sim.onCore(1, [this] { setup1(); });
+                sim.onCore(0, [this] { setup(); });
+            }
+
+            void setup1() {
+                auto config = async_context_threadsafe_background_default_config();
+                ctx1.initDefaultContext(config);
+                dispatcher1.initialiseBridge();
+            }
+
+            void setup() {
+                auto config = async_context_threadsafe_background_default_config();
+                ctx0.initDefaultContext(config);
+                dispatcher0.initialiseBridge();
+
+                for (auto *client : {&qotd_client, &qotd_client_alt, &echo_client}) {
+                    client->setSyncAccessor(
+                        std::make_unique<TcpClientSyncAccessor>(ctx0, *client));
+                }
+                echo_client.setWriter(std::make_unique<TcpWriter>(ctx0, echo_client));
+                qotd_client.setClientId(1);
+                qotd_client_alt.setClientId(3);
+                echo_client.setClientId(2);
+
+                echo_client.setOnConnectedCallback(
+                    echo_connected_handler.bridge(ctx0, echo_client));
+                echo_client.setOnReceivedCallback(
+                    echo_received_handler.bridge(ctx0, echo_client));
+                echo_client.setOnPollCallback(poll_handler.bridge(ctx0, echo_client));
+                echo_client.setOnAckCallback(ack_handler.bridge(ctx0, echo_client));
+                echo_client.setOnErrorCallback(error_handler.bridge(ctx0, echo_client));
+                for (auto *client : {&qotd_client, &qotd_client_alt}) {
+                    client->setOnErrorCallback(error_handler.bridge(ctx0, *client));
+                    client->setOnConnectedCallback(
+                        qotd_connected_handler.bridge(ctx0, *client));
+                    client->setOnReceivedCallback(
+                        qotd_received_handler.bridge(ctx0, *client));
+                    client->setOnFinCallback(qotd_fin_handler.bridge(ctx0, *client));
+                }
+
+                for (const auto *client :
+                     {&qotd_client, &qotd_client_alt, &echo_client}) {
+                    connections.setTimeline(
+                        connections.find(client->getClientId()), &cycle_timeline);
+                }
+                e5::PrintHandler::setObserver(&e5::CycleTimeline::onEmit,
+                                              &cycle_timeline);
+
+                // Two endpoints on the same server, so every cycle is raced
+                qotd_endpoints.add("qotd-a", qotd_port);
+                qotd_endpoints.add("qotd-b", qotd_port);
+                qotd_endpoints.setAddress(0, IPAddress(10, 0, 0, 17));
+                qotd_endpoints.setAddress(1, IPAddress(10, 0, 0, 17));
+                qotd_manager.start();
+                qotd_manager_alt.start();
+                echo_manager.start();
+                qotd_race.addRacer(qotd_manager);
+                qotd_race.addRacer(qotd_manager_alt);
+                qotd_race.setClaim(qotd_claim);
+
+                // set_priority_dispatch(true), as setup1() does
+                e5::ConnectionHandler *handlers[] = {
+                    &ack_handler,           &error_handler,
+                    &poll_handler,          &echo_connected_handler,
+                    &echo_received_handler, &qotd_connected_handler,
+                    &qotd_received_handler, &qotd_fin_handler};
+                for (auto *handler : handlers) {
+                    handler->setDispatcher(&dispatcher0);
+                }
+                serial_printer.setDispatcher(&dispatcher1);
+
+                // LoopScheduler counts loop passes
+                scheduler0.setEntry(qotd, scenario.qotd_interval_us /
+                                              scenario.loop_period_us);
+                scheduler0.setEntry(echo, scenario.echo_interval_us /
+                                              scenario.loop_period_us);
+            }
+
+            [[nodiscard]] uint32_t ended() const {
+                return qotd_race.completed() + qotd_race.failed();
+            }
+
+            /**
+             * @brief One pass of loop(), reduced to the QOTD/echo beat.
+             */
+            void loop() {
+                sim.charge(scenario.loop_cost_us);
+                qotd_race.poll();
+                echo_manager.poll();
+
+                if (qotd_race.cycles() < scenario.cycles &&
+                    (qotd_race.cycles() == 0 || scheduler0.timeToRun(qotd))) {
+                    e5::CycleRecord last;
+                    const bool has_last = cycle_timeline.record(0, last);
+                    if (qotd_race.requestCycle()) {
+                        if (has_last) {
+                            report.add(last);
+                        }
+                        cycle_timeline.begin();
+                        sim.trace("loop: cycle %u", qotd_race.cycles());
+                    }
+                }
+                if (scheduler0.timeToRun(echo) && qotd_buffer.isComplete()) {
+                    if (std::string quote = qotd_buffer.get(); !quote.empty()) {
+                        cycle_timeline.echoWrite(quote.size());
+                        echo_manager.write(std::move(quote));
+                        sim.trace("loop: echo");
+                    }
+                }
+                if (done_at == 0 && ended() >= scenario.cycles) {
+                    done_at = sim.now();
+                }
+            }
+
+            void finish() {
+                if (e5::CycleRecord last; cycle_timeline.record(0, last)) {
+                    report.add(last);
+                }
+                report.cycles += qotd_race.cycles();
+                report.completed += qotd_race.completed();
+                report.failed += qotd_race.failed();
+                report.add(sim.stats());
+                report.virtual_us += sim.now();
+            }
+    };
+
+    void schedule_loop(Simulator &sim, App &app, const uint32_t period_us) {
+        sim.post(0, sim.now() + period_us, [&sim, &app, period_us] {
+            app.loop();
+            schedule_loop(sim, app, period_us);
+        });
+    }
+
+    bool parse(const int argc, char **argv, Scenario &scenario,
+               SimConfig &config) {
+        const std::pair<const char *, uint32_t *> fields[] = {
+            {"runs", &scenario.runs},
+            {"seed", &scenario.seed},
+            {"cycles", &scenario.cycles},
+            {"loop_period_us", &scenario.loop_period_us},
+            {"loop_cost_us", &scenario.loop_cost_us},
+            {"qotd_interval_us", &scenario.qotd_interval_us},
+            {"echo_interval_us", &scenario.echo_interval_us},
+            {"drain_us", &scenario.drain_us},
+            {"worker_cost_us", &config.worker_cost_us},
+            {"worker_latency_us", &config.worker_latency_us},
+            {"xcore_latency_us", &config.xcore_latency_us},
+            {"lwip_cost_us", &config.lwip_cost_us},
+            {"uart_baud", &config.uart_baud},
+            {"uart_fifo_bytes", &config.uart_fifo_bytes},
+            {"connect_us", &config.connect_us},
+            {"connect_jitter_us", &config.connect_jitter_us},
+            {"refuse_permille", &config.refuse_permille},
+            {"segment_bytes", &config.segment_bytes},
+            {"first_byte_us", &config.first_byte_us},
+            {"segment_gap_us", &config.segment_gap_us},
+            {"segment_jitter_us", &config.segment_jitter_us},
+            {"fin_gap_us", &config.fin_gap_us},
+            {"ack_us", &config.ack_us},
+            {"quote_min_bytes", &config.quote_min_bytes},
+            {"quote_max_bytes", &config.quote_max_bytes},
+        };
+        for (int i = 1; i < argc; ++i) {
+            const char *arg = argv[i];
+            if (std::strcmp(arg, "--trace") == 0) {
+                scenario.trace = true;
+                continue;
+            }
+            if (std::strcmp(arg, "--uart") == 0) {
+                scenario.uart = true;
+                continue;
+            }
+            if (std::strcmp(arg, "--no-shuffle") == 0) {
+                config.shuffle_ties = false;
+                continue;
+            }
+            const char *equals = std::strchr(arg, '=');
+            bool known = false;
+            for (const auto &[name, value] : fields) {
+                if (equals && std::strncmp(arg, "--", 2) == 0 &&
+                    std::strlen(name) == static_cast<std::size_t>(equals - arg - 2) &&
+                    std::strncmp(arg + 2, name, equals - arg - 2) == 0) {
+                    *value = static_cast<uint32_t>(std::strtoul(equals + 1, nullptr, 10));
+                    known = true;
+                }
+            }
+            if (!known) {
+                std::fprintf(stderr, "unknown option %s\n", arg);
+                return false;
+            }
+        }
+        return scenario.loop_period_us > 0 && config.segment_bytes > 0 &&
+               config.uart_baud > 0;
+    }
+
+    void print_report(const Scenario &scenario, const Report &report,
+                      const double wall_s) {
+        std::printf("[SIM] runs %lu, seeds %lu..%lu, virtual %.1f s, wall "
+                    "%.2f s, events %llu (%.1fM/s)\n",
+                    static_cast<unsigned long>(scenario.runs),
+                    static_cast<unsigned long>(scenario.seed),
+                    static_cast<unsigned long>(scenario.seed + scenario.runs - 1),
+                    report.virtual_us / 1e6, wall_s,
+                    static_cast<unsigned long long>(report.sim.events),
+                    wall_s > 0 ? report.sim.events / wall_s / 1e6 : 0.0);
+        std::printf("[SIM] cycles %llu, completed %llu, failed %llu, "
+                    "unprinted %llu; connects %lu, refused %lu, aborts %lu, "
+                    "segments %lu\n",
+                    static_cast<unsigned long long>(report.cycles),
+                    static_cast<unsigned long long>(report.completed),
+                    static_cast<unsigned long long>(report.failed),
+                    static_cast<unsigned long long>(report.unprinted),
+                    static_cast<unsigned long>(report.sim.connects),
+                    static_cast<unsigned long>(report.sim.refused),
+                    static_cast<unsigned long>(report.sim.aborts),
+                    static_cast<unsigned long>(report.sim.segments));
+        std::printf("[SIM] echo writes %lu, mismatches %lu; cross-core calls "
+                    "%lu, avg blocked %llu us; uart %llu B, stalled %llu us\n",
+                    static_cast<unsigned long>(report.sim.echo_writes),
+                    static_cast<unsigned long>(report.sim.echo_mismatches),
+                    static_cast<unsigned long>(report.sim.xcore_calls),
+                    static_cast<unsigned long long>(
+                        report.sim.xcore_calls
+                            ? report.sim.xcore_wait_us / report.sim.xcore_calls
+                            : 0),
+                    static_cast<unsigned long long>(report.sim.uart_bytes),
+                    static_cast<unsigned long long>(report.sim.uart_stall_us));
+        std::printf("[SIM] us from connect  count      p50      p90      p99"
+                    "      max      avg\n");
+        for (std::size_t i = 1; i < std::size(report.stages); ++i) {
+            const auto &stage = report.stages[i];
+            // Bucket bounds, capped at the exact maximum
+            const auto percentile = [&stage](const uint8_t percent) {
+                return static_cast<unsigned long>(
+                    std::min(stage.percentileUs(percent), stage.max_us));
+            };
+            std::printf("[SIM] %-15s %7lu %8lu %8lu %8lu %8lu %8lu\n",
+                        e5::stageName(static_cast<e5::CycleStage>(i)),
+                        static_cast<unsigned long>(stage.count),
+                        percentile(50), percentile(90), percentile(99),
+                        static_cast<unsigned long>(stage.max_us),
+                        static_cast<unsigned long>(stage.avgUs()));
+        }
+    }
+
+} // namespace
+
+int main(const int argc, char **argv) {
+    Scenario scenario;
+    SimConfig base;
+    if (!parse(argc, argv, scenario, base)) {
+        std::fprintf(stderr, "usage: %s [--name=value ...] [--trace] [--uart] "
+                             "[--no-shuffle]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Report report;
+    const auto wall_start = std::chrono::steady_clock::now();
+    for (uint32_t run = 0; run < scenario.runs; ++run) {
+        SimConfig config = base;
+        config.seed = scenario.seed + run;
+        Simulator sim(config);
+        sim.setTrace(scenario.trace ? stdout : nullptr);
+        sim.setUartOutput(scenario.uart ? stdout : nullptr);
+        sim.listen(qotd_port, SimService::QOTD);
+        sim.listen(echo_port, SimService::ECHO);
+        randomSeed(config.seed);
+
+        auto app = std::make_unique<App>(sim, scenario, report);
+        schedule_loop(sim, *app, scenario.loop_period_us);
+        while (sim.step()) {
+            if (app->done_at != 0 && sim.now() >= app->done_at + scenario.drain_us) {
+                break;
+            }
+        }
+        app->finish();
+        e5::PrintHandler::setObserver(nullptr, nullptr);
+        app.reset();
+    }
+    const double wall_s = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - wall_start)
+                              .count();
+
+    print_report(scenario, report, wall_s);
+    return report.failed == 0 && report.sim.echo_mismatches == 0 ? EXIT_SUCCESS
+                                                                 : EXIT_FAILURE;
+}
@@ -0,0 +1,90 @@
+/*
+ * Quote index of the stand-in servers: pio test -e servers
+ */
+#include "QuoteIndex.hpp"
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <unity.h>
+
+using e5::servers::QuoteIndex;
+
+namespace {
+
+    std::string quote(const QuoteIndex &index, const std::size_t n) {
+        const auto [data, length] = index.quote(n);
+        return {data, length};
+    }
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_separator_without_final_newline() {
+    const std::string file = "First quote.\n%\nSecond quote.\n\tAuthor\n%";
+    QuoteIndex index;
+    TEST_ASSERT_TRUE(index.index(file.data(), file.size()));
+    TEST_ASSERT_EQUAL_UINT(2, index.size());
+    TEST_ASSERT_EQUAL_STRING("First quote.", quote(index, 0).c_str());
+    TEST_ASSERT_EQUAL_STRING("Second quote.\n\tAuthor", quote(index, 1).c_str());
+}
+
+void test_separator_with_final_newline() {
+    const std::string file = "First quote.\n%\nSecond quote.\n%\n";
+    QuoteIndex index;
+    TEST_ASSERT_TRUE(index.index(file.data(), file.size()));
+    TEST_ASSERT_EQUAL_UINT(2, index.size());
+    TEST_ASSERT_EQUAL_STRING("Second quote.", quote(index, 1).c_str());
+}
+
+void test_last_quote_without_separator() {
+    const std::string file = "First quote.\n%\nSecond quote.";
+    QuoteIndex index;
+    TEST_ASSERT_TRUE(index.index(file.data(), file.size()));
+    TEST_ASSERT_EQUAL_UINT(2, index.size());
+    TEST_ASSERT_EQUAL_STRING("Second quote.", quote(index, 1).c_str());
+}
+
+void test_percent_inside_a_quote() {
+    const std::string file = "100% sure.\n%%\n%";
+    QuoteIndex index;
+    TEST_ASSERT_TRUE(index.index(file.data(), file.size()));
+    TEST_ASSERT_EQUAL_UINT(1, index.size());
+    TEST_ASSERT_EQUAL_STRING("100% sure.\n%%", quote(index, 0).c_str());
+}
+
+void test_only_separators() {
+    const std::string file = "%\n%\n%";
+    QuoteIndex index;
+    TEST_ASSERT_FALSE(index.index(file.data(), file.size()));
+}
+
+void test_load_file_without_final_newline() {
+    char path[] = "/tmp/e5_quotes_XXXXXX";
+    const int fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    const std::string file = "Only quote.\n%";
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(file.size()),
+                          static_cast<int>(write(fd, file.data(), file.size())));
+    close(fd);
+    {
+        QuoteIndex index;
+        TEST_ASSERT_TRUE(index.load(path));
+        TEST_ASSERT_EQUAL_UINT(1, index.size());
+        TEST_ASSERT_EQUAL_STRING("Only quote.", quote(index, 0).c_str());
+    }
+    std::remove(path);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_separator_without_final_newline);
+    RUN_TEST(test_separator_with_final_newline);
+    RUN_TEST(test_last_quote_without_separator);
+    RUN_TEST(test_percent_inside_a_quote);
+    RUN_TEST(test_only_separators);
+    RUN_TEST(test_load_file_without_final_newline);
+    return UNITY_END();
+}
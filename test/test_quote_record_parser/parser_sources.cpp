@@ -0,0 +1,7 @@
+/*
+ * The parser and its history under test; env:servers builds none of the
+ * application sources, so they are compiled here against the host
+ * stand-ins.
+ */
+#include "../../src/QuoteHistory.cpp"
+#include "../../src/QuoteRecordParser.cpp"
@@ -0,0 +1,111 @@
+/*
+ * Batch QOTD record parser: pio test -e servers
+ */
+#include "QuoteRecordParser.hpp"
+#include <string>
+#include <unity.h>
+
+using e5::QuoteHistory;
+using e5::QuoteRecordParser;
+
+namespace {
+
+    /**
+     * @brief A record: 16-bit big-endian length, then the text.
+     */
+    std::string record(const std::string &text) {
+        std::string out;
+        out += static_cast<char>(text.size() >> 8);
+        out += static_cast<char>(text.size() & 0xFF);
+        return out + text;
+    }
+
+    void feed(QuoteRecordParser &parser, const std::string &data) {
+        parser.feed(data.data(), data.size());
+    }
+
+    std::string pop(QuoteHistory &history) {
+        std::string quote;
+        TEST_ASSERT_TRUE(history.pop(quote));
+        return quote;
+    }
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_header_split_across_feeds() {
+    QuoteHistory history;
+    QuoteRecordParser parser(history);
+    const std::string data = record("Split header.");
+    feed(parser, data.substr(0, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, parser.records());
+    feed(parser, data.substr(1, 5));
+    feed(parser, data.substr(6));
+    TEST_ASSERT_EQUAL_UINT32(1, parser.records());
+    TEST_ASSERT_EQUAL_UINT32(2, parser.framingBytes());
+    TEST_ASSERT_EQUAL_STRING("Split header.", pop(history).c_str());
+}
+
+void test_zero_length_record() {
+    QuoteHistory history;
+    QuoteRecordParser parser(history);
+    feed(parser, record("") + record("After empty."));
+    TEST_ASSERT_EQUAL_UINT32(1, parser.records());
+    TEST_ASSERT_EQUAL_UINT32(4, parser.framingBytes());
+    TEST_ASSERT_EQUAL_UINT(1, history.pending());
+    TEST_ASSERT_EQUAL_STRING("After empty.", pop(history).c_str());
+}
+
+void test_record_over_512_bytes_is_truncated() {
+    QuoteHistory history;
+    QuoteRecordParser parser(history);
+    const std::string long_quote(600, 'q');
+    feed(parser, record(long_quote) + record("Next."));
+    TEST_ASSERT_EQUAL_UINT32(2, parser.records());
+    TEST_ASSERT_EQUAL_UINT32(1, parser.truncated());
+    TEST_ASSERT_EQUAL_UINT32(605, parser.payloadBytes());
+    TEST_ASSERT_EQUAL_UINT(QuoteHistory::MAX_QUOTE_BYTES,
+                           pop(history).size());
+    // The rest of the long record was skipped, not taken as framing
+    TEST_ASSERT_EQUAL_STRING("Next.", pop(history).c_str());
+}
+
+void test_batch_ending_mid_record() {
+    QuoteHistory history;
+    QuoteRecordParser parser(history);
+    TEST_ASSERT_TRUE(parser.claim(0));
+    feed(parser, record("Whole.") + record("Cut short").substr(0, 6));
+    parser.finish();
+    TEST_ASSERT_EQUAL_UINT32(1, parser.records());
+    TEST_ASSERT_EQUAL_UINT32(1, parser.incomplete());
+    TEST_ASSERT_EQUAL_UINT(1, history.pending());
+    // finish() releases the parser, and the next batch starts clean
+    TEST_ASSERT_TRUE(parser.claim(1));
+    feed(parser, record("Next batch."));
+    TEST_ASSERT_EQUAL_STRING("Whole.", pop(history).c_str());
+    TEST_ASSERT_EQUAL_STRING("Next batch.", pop(history).c_str());
+}
+
+void test_claim_from_second_slot_is_rejected() {
+    QuoteHistory history;
+    QuoteRecordParser parser(history);
+    TEST_ASSERT_TRUE(parser.claim(0));
+    TEST_ASSERT_FALSE(parser.claim(1));
+    TEST_ASSERT_TRUE(parser.claim(0));
+    parser.reset();
+    TEST_ASSERT_TRUE(parser.claim(1));
+    TEST_ASSERT_FALSE(parser.claim(0));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_header_split_across_feeds);
+    RUN_TEST(test_zero_length_record);
+    RUN_TEST(test_record_over_512_bytes_is_truncated);
+    RUN_TEST(test_batch_ending_mid_record);
+    RUN_TEST(test_claim_from_second_slot_is_rejected);
+    return UNITY_END();
+}